@@ -5,7 +5,10 @@
 # Copyright (C) 2025 Anthony Charretier
 
 import os
+import random
 import time
+import numpy as np
+import torch
 from fastapi import HTTPException
 from core.dj_system import DJSystem
 from server.api.models import GenerateRequest
@@ -51,6 +54,9 @@ class APIRequestHandler:
 
         musicgen_prompt = sample_details.get("musicgen_prompt", request.prompt)
 
+        if request.seed is not None:
+            self.seed_generation(request.seed)
+
         self.dj_system.music_gen.init_model()
         audio, sample_info = self.dj_system.music_gen.generate_sample(
             musicgen_prompt=musicgen_prompt,
@@ -61,6 +67,15 @@ class APIRequestHandler:
         self.dj_system.music_gen.destroy_model()
         return audio, sample_info
 
+    @staticmethod
+    def seed_generation(seed: int):
+        print(f"🎲 Seed: {seed}")
+        random.seed(seed)
+        np.random.seed(seed % (2**32))
+        torch.manual_seed(seed)
+        if torch.cuda.is_available():
+            torch.cuda.manual_seed_all(seed)
+
     def process_audio_pipeline(self, audio, request: GenerateRequest, request_id):
         temp_path = os.path.join(
             self.dj_system.output_dir_base, f"temp_raw_{request_id}.wav"
@@ -16,3 +16,5 @@ class GenerateRequest(BaseModel):
     preferred_stems: Optional[List[str]] = None
     generation_duration: Optional[float] = 6.0
     sample_rate: Optional[float] = 48000.00
+    seed: Optional[int] = None
+    audio_format: Optional[str] = "wav"
@@ -7,12 +7,15 @@
 import time
 import os
 from os import walk
+import io
 import random
+import struct
 import librosa
+import soundfile
 import hashlib
 from fastapi import APIRouter, HTTPException, Depends, Request
 from fastapi.security import APIKeyHeader
-from fastapi.responses import Response
+from fastapi.responses import Response, StreamingResponse
 from .models import GenerateRequest
 from config.config import API_KEYS, ENVIRONMENT, lock, IS_TEST
 from server.api.api_request_handler import APIRequestHandler
@@ -83,6 +86,159 @@ async def verify_key(_: str = Depends(verify_api_key)):
     return {"status": "valid", "message": "API Key valid"}
 
 
+STREAM_CHUNK_FRAMES = 4096
+UNKNOWN_WAV_SIZE = 0xFFFFFFFF
+
+
+async def run_generation(request, api_key, dj_system, request_id):
+    """Generates and post-processes one loop; returns (path, stems, duration)."""
+    print(f"===== 🎵 QUERY #{request_id} =====")
+    print(
+        f"📝 '{request.prompt}' | {request.bpm} BPM | {request.key} | SAMPLE RATE {str(int(request.sample_rate))} | GENERATION DURATION {str(int(request.generation_duration))}"
+    )
+    if not request.prompt or len(request.prompt.strip()) < 3:
+        raise create_error_response(
+            "INVALID_PROMPT", "Prompt must be at least 3 characters long"
+        )
+    user_id = get_user_id_from_api_key(api_key)
+    handler = APIRequestHandler(dj_system)
+    if not dj_system:
+        raise create_error_response(
+            "GPU_UNAVAILABLE",
+            "Audio generation system is currently unavailable. Please try again later.",
+            503,
+        )
+    if not IS_TEST:
+        async with lock:
+            handler.setup_llm_session(request, request_id, user_id)
+            llm_decision = handler.get_llm_decision()
+            audio, _ = handler.generate_simple(request, llm_decision)
+            processed_path, used_stems = handler.process_audio_pipeline(
+                audio, request, request_id
+            )
+    else:
+        test_files_path = "./testfiles"
+        test_files = []
+        for _, _, filenames in walk(test_files_path):
+            test_files.extend(filenames)
+            break
+        test_files.remove(".gitkeep")
+        processed_path = dj_system.layer_manager._prepare_sample_for_loop(
+            original_audio_path="./testfiles/" + random.choice(test_files),
+            layer_id=f"simple_loop_{request_id}",
+            sample_rate=int(request.sample_rate),
+        )
+        used_stems = None
+        time.sleep(3)
+    if not processed_path or not os.path.exists(processed_path):
+        raise create_error_response(
+            "SERVER_ERROR", "Audio generation completed but file not found", 500
+        )
+    try:
+        audio_data, sr = librosa.load(processed_path, sr=None)
+        duration = len(audio_data) / sr
+        if duration < 0.1:
+            raise create_error_response(
+                "SERVER_ERROR", "Generated audio is too short or empty", 500
+            )
+    except Exception:
+        os.remove(processed_path)
+        raise
+    return processed_path, used_stems, duration
+
+
+def build_response_headers(api_key, request, used_stems, duration):
+    increment_api_key_usage(api_key)
+    _, _, key_info = check_api_key_status(api_key)
+    remaining_credits = "unlimited"
+    if key_info.get("is_limited"):
+        remaining_credits = str(
+            key_info.get("total_credits", 0) - key_info.get("credits_used", 0)
+        )
+    headers = {
+        "X-Duration": str(duration),
+        "X-BPM": str(request.bpm),
+        "X-Key": str(request.key or ""),
+        "X-Stems-Used": ",".join(used_stems) if used_stems else "",
+        "X-Credits-Remaining": remaining_credits,
+    }
+    if key_info.get("is_limited") and key_info.get("date_of_expiration"):
+        headers["X-Key-Expires"] = key_info["date_of_expiration"]
+    return headers
+
+
+def open_ended_wav_header(sample_rate, channels):
+    """16-bit PCM header whose RIFF and data sizes are left unknown."""
+    block_align = channels * 2
+    return (
+        b"RIFF"
+        + struct.pack("<I", UNKNOWN_WAV_SIZE)
+        + b"WAVE"
+        + b"fmt "
+        + struct.pack(
+            "<IHHIIHH",
+            16,
+            1,
+            channels,
+            sample_rate,
+            sample_rate * block_align,
+            block_align,
+            16,
+        )
+        + b"data"
+        + struct.pack("<I", UNKNOWN_WAV_SIZE)
+    )
+
+
+def stream_wav_chunks(processed_path):
+    try:
+        with soundfile.SoundFile(processed_path) as source:
+            yield open_ended_wav_header(source.samplerate, source.channels)
+            for block in source.blocks(
+                blocksize=STREAM_CHUNK_FRAMES, dtype="int16", always_2d=True
+            ):
+                yield block.tobytes()
+    finally:
+        if os.path.exists(processed_path):
+            os.remove(processed_path)
+
+
+@router.post("/generate/stream")
+async def generate_loop_stream(
+    request: GenerateRequest,
+    api_key: str = Depends(verify_api_key),
+    dj_system=Depends(get_dj_system),
+):
+    """
+    Same generation as /generate, sent as a chunked WAV with an open-ended
+    data chunk so the client can decode and play the start of the loop
+    while the rest is still arriving. The pipeline produces the loop in
+    one piece, so streaming starts once post-processing has finished.
+    """
+    request_id = int(time.time())
+    try:
+        processed_path, used_stems, duration = await run_generation(
+            request, api_key, dj_system, request_id
+        )
+        headers = build_response_headers(api_key, request, used_stems, duration)
+    except HTTPException:
+        raise
+    except Exception as e:
+        print(f"❌ UNEXPECTED ERROR #{request_id}: {str(e)}")
+        raise create_error_response(
+            "SERVER_ERROR",
+            "An unexpected error occurred. Please try again or contact support.",
+            500,
+        )
+    print(f"✅ STREAMING: {duration:.1f}")
+    # The generator deletes the file once the last chunk is sent.
+    return StreamingResponse(
+        stream_wav_chunks(processed_path),
+        media_type="audio/wav",
+        headers=headers,
+    )
+
+
 @router.post("/generate")
 async def generate_loop(
     request: GenerateRequest,
@@ -92,76 +248,24 @@ async def generate_loop(
     processed_path = None
     try:
         request_id = int(time.time())
-        print(f"===== 🎵 QUERY #{request_id} =====")
-        print(
-            f"📝 '{request.prompt}' | {request.bpm} BPM | {request.key} | SAMPLE RATE {str(int(request.sample_rate))} | GENERATION DURATION {str(int(request.generation_duration))}"
+        processed_path, used_stems, duration = await run_generation(
+            request, api_key, dj_system, request_id
         )
-        if not request.prompt or len(request.prompt.strip()) < 3:
-            raise create_error_response(
-                "INVALID_PROMPT", "Prompt must be at least 3 characters long"
-            )
-        user_id = get_user_id_from_api_key(api_key)
-        handler = APIRequestHandler(dj_system)
-        if not dj_system:
-            raise create_error_response(
-                "GPU_UNAVAILABLE",
-                "Audio generation system is currently unavailable. Please try again later.",
-                503,
-            )
-        if not IS_TEST:
-            async with lock:
-                handler.setup_llm_session(request, request_id, user_id)
-                llm_decision = handler.get_llm_decision()
-                audio, _ = handler.generate_simple(request, llm_decision)
-                processed_path, used_stems = handler.process_audio_pipeline(
-                    audio, request, request_id
-                )
+        media_type = "audio/wav"
+        if (request.audio_format or "").lower() == "flac":
+            pcm, pcm_sr = soundfile.read(processed_path, dtype="int16", always_2d=True)
+            encoded = io.BytesIO()
+            soundfile.write(encoded, pcm, pcm_sr, format="FLAC", subtype="PCM_16")
+            wav_data = encoded.getvalue()
+            media_type = "audio/flac"
         else:
-            test_files_path = "./testfiles"
-            test_files = []
-            for _, _, filenames in walk(test_files_path):
-                test_files.extend(filenames)
-                break
-            test_files.remove(".gitkeep")
-            processed_path = dj_system.layer_manager._prepare_sample_for_loop(
-                original_audio_path="./testfiles/" + random.choice(test_files),
-                layer_id=f"simple_loop_{request_id}",
-                sample_rate=int(request.sample_rate),
-            )
-            used_stems = None
-            time.sleep(3)
-        if not processed_path or not os.path.exists(processed_path):
-            raise create_error_response(
-                "SERVER_ERROR", "Audio generation completed but file not found", 500
-            )
-        audio_data, sr = librosa.load(processed_path, sr=None)
-        duration = len(audio_data) / sr
-        if duration < 0.1:
-            raise create_error_response(
-                "SERVER_ERROR", "Generated audio is too short or empty", 500
-            )
-        with open(processed_path, "rb") as f:
-            wav_data = f.read()
-        increment_api_key_usage(api_key)
-        _, _, key_info = check_api_key_status(api_key)
-        remaining_credits = "unlimited"
-        if key_info.get("is_limited"):
-            remaining_credits = str(
-                key_info.get("total_credits", 0) - key_info.get("credits_used", 0)
-            )
+            with open(processed_path, "rb") as f:
+                wav_data = f.read()
+        headers = build_response_headers(api_key, request, used_stems, duration)
         print(f"✅ SUCCESS: {duration:.1f}")
-        headers = {
-            "X-Duration": str(duration),
-            "X-BPM": str(request.bpm),
-            "X-Key": str(request.key or ""),
-            "X-Stems-Used": ",".join(used_stems) if used_stems else "",
-            "X-Credits-Remaining": remaining_credits,
-        }
-        if key_info.get("is_limited") and key_info.get("date_of_expiration"):
-            headers["X-Key-Expires"] = key_info["date_of_expiration"]
         return Response(
             content=wav_data,
-            media_type="audio/wav",
+            media_type=media_type,
             headers=headers,
         )
 
@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "JuceHeader.h"
+#include "AudioAnalyzer.h"
+
+namespace
+{
+	juce::AudioBuffer<float> makeClickLoop(double sampleRate, double seconds, double bpm)
+	{
+		const int numSamples = static_cast<int>(sampleRate * seconds);
+		const int period = static_cast<int>(sampleRate * 60.0 / bpm);
+		juce::AudioBuffer<float> buffer(2, numSamples);
+		juce::Random random(42);
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const int phase = i % period;
+			float sample = 0.02f * (random.nextFloat() - 0.5f);
+			if (phase < 2000)
+				sample += std::sin(phase * 0.05f) * std::exp(-phase / 400.0f);
+			buffer.setSample(0, i, sample);
+			buffer.setSample(1, i, sample * 0.9f);
+		}
+		return buffer;
+	}
+
+	template <typename Function>
+	double measureMilliseconds(int iterations, Function&& function)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (int i = 0; i < iterations; ++i)
+		{
+			auto start = juce::Time::getMillisecondCounterHiRes();
+			function();
+			best = std::min(best, juce::Time::getMillisecondCounterHiRes() - start);
+		}
+		return best;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const double sampleRate = 44100.0;
+	const double seconds = argc > 1 ? juce::String(argv[1]).getDoubleValue() : 30.0;
+	const int iterations = argc > 2 ? juce::String(argv[2]).getIntValue() : 5;
+	auto buffer = makeClickLoop(sampleRate, seconds > 0.0 ? seconds : 30.0, 124.0);
+
+	std::vector<float> mono;
+	double downmixMs = measureMilliseconds(iterations, [&]() { AudioAnalyzer::downmixAndNormalize(buffer, mono); });
+	double onsetMs = measureMilliseconds(iterations, [&]() { AudioAnalyzer::detectBPMByOnsets(buffer, sampleRate); });
+
+	AudioAnalyzer::BPMAnalysis analysis;
+	double analyzeMs = measureMilliseconds(iterations, [&]() { analysis = AudioAnalyzer::analyzeBPM(buffer, sampleRate); });
+
+	std::cout << "Loop: " << buffer.getNumSamples() << " samples, best of " << iterations << std::endl;
+	std::cout << "downmixAndNormalize: " << downmixMs << " ms" << std::endl;
+	std::cout << "detectBPMByOnsets:   " << onsetMs << " ms" << std::endl;
+	std::cout << "analyzeBPM:          " << analyzeMs << " ms (bpm " << analysis.bpm
+		<< ", confidence " << analysis.confidence << ")" << std::endl;
+	return 0;
+}
@@ -0,0 +1,371 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "JuceHeader.h"
+#include "PluginProcessor.h"
+#include "RealtimeAllocationGuard.h"
+#include "VirtualPlayHead.h"
+
+/*
+	Drives a real DjIaVstProcessor through processBlock without a host. Every
+	combination of block size, sample rate, track count, time-stretch mode and
+	beat repeat setting plays synthetic loops triggered by the sequencers on a
+	virtual transport, and prints one JSON object per line with the per-block
+	p50/p99/max time, the DSP load against the block deadline and the heap
+	allocations made inside processBlock and its render workers. The
+	message loop runs between blocks, outside the timing, so the
+	processor's timer does its housekeeping as it would in a host.
+
+	Options, all optional ("--name=value"):
+		--block-sizes=64,128,256,512,1024
+		--sample-rates=44100,48000,96000
+		--tracks=1,4,8           (capped at the configured track capacity)
+		--stretch=none,varispeed,streaming
+		--repeat=off,repeat,retrigger
+		--seconds=5              audio measured per configuration
+		--render-threads=N       track render threads, default the processor's
+		--output=results.jsonl   default stdout
+*/
+namespace
+{
+	constexpr double loopBpm = 120.0;
+	constexpr double hostBpm = 126.0;
+	constexpr double loopSampleRate = 44100.0;
+
+	// How often the message loop is pumped, in audio time: about the
+	// processor timer's rate, so retired buffers are collected and swapped
+	// tracks synced as they would be in a host.
+	constexpr double messageLoopIntervalSeconds = 1.0 / 30.0;
+
+	void pumpMessageLoop(int milliseconds)
+	{
+		juce::MessageManager::getInstance()->runDispatchLoopUntil(milliseconds);
+	}
+
+	struct StretchSetting
+	{
+		const char* name;
+		int timeStretchMode;
+		bool streaming;
+	};
+
+	// Off, resampled to the host tempo, and SoundTouch streaming at the host tempo.
+	const StretchSetting stretchSettings[] = {
+		{ "none", 1, false },
+		{ "varispeed", 3, false },
+		{ "streaming", 3, true }
+	};
+
+	struct Configuration
+	{
+		int blockSize = 0;
+		double sampleRate = 0.0;
+		int numTracks = 0;
+		StretchSetting stretch{};
+		juce::String repeat;
+	};
+
+	struct Measurement
+	{
+		int blocks = 0;
+		double p50 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		double mean = 0.0;
+		juce::uint64 allocations = 0;
+		int blocksWithAllocations = 0;
+	};
+
+	juce::Array<int> parseIntList(const juce::ArgumentList& args, const juce::String& option, const juce::String& fallback)
+	{
+		const auto text = args.containsOption(option) ? args.getValueForOption(option) : fallback;
+		juce::Array<int> values;
+		for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+		{
+			if (token.trim().getIntValue() > 0)
+				values.add(token.trim().getIntValue());
+		}
+		return values;
+	}
+
+	juce::StringArray parseNameList(const juce::ArgumentList& args, const juce::String& option, const juce::String& fallback)
+	{
+		auto names = juce::StringArray::fromTokens(args.containsOption(option) ? args.getValueForOption(option) : fallback, ",", {});
+		names.trim();
+		names.removeEmptyStrings();
+		return names;
+	}
+
+	/** Four bars at loopBpm: a decaying click on each beat over low noise. */
+	juce::AudioBuffer<float> makeLoop(int seed)
+	{
+		const int numSamples = static_cast<int>(loopSampleRate * 4.0 * 4.0 * 60.0 / loopBpm);
+		const int period = static_cast<int>(loopSampleRate * 60.0 / loopBpm);
+		juce::AudioBuffer<float> buffer(2, numSamples);
+		juce::Random random(seed);
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const int phase = i % period;
+			float sample = 0.05f * (random.nextFloat() - 0.5f);
+			if (phase < 4000)
+				sample += 0.5f * std::sin(phase * 0.03f * static_cast<float>(seed)) * std::exp(-phase / 800.0f);
+			buffer.setSample(0, i, sample);
+			buffer.setSample(1, i, sample * 0.9f);
+		}
+		return buffer;
+	}
+
+	void setRetrigger(DjIaVstProcessor& processor, int slot, bool enabled)
+	{
+		if (auto* parameter = processor.getParameters().getParameter("slot" + juce::String(slot + 1) + "RandomRetrigger"))
+			parameter->setValueNotifyingHost(enabled ? 1.0f : 0.0f);
+	}
+
+	/** Arms the first numTracks tracks on a quarter-note pattern and parks the rest. */
+	void setUpTracks(DjIaVstProcessor& processor, const juce::StringArray& trackIds,
+		const std::vector<juce::AudioBuffer<float>>& loops, const Configuration& config)
+	{
+		for (int i = 0; i < trackIds.size(); ++i)
+		{
+			auto* track = processor.trackManager.getTrack(trackIds[i]);
+			if (track == nullptr)
+				continue;
+
+			const bool active = i < config.numTracks;
+			track->readPosition = 0.0;
+			track->isPlaying = false;
+			track->isCurrentlyPlaying = false;
+			track->isArmedToStop = false;
+			track->isArmed = active;
+			track->pendingAction = TrackData::PendingAction::None;
+			track->beatRepeatActive = false;
+			track->beatRepeatPending = active && config.repeat == "repeat";
+			track->beatRepeatStopPending = false;
+			track->beatRepeatEventSample = -1;
+			track->numScheduledEvents = 0;
+			track->timeStretchMode = config.stretch.timeStretchMode;
+			track->streamingStretch = config.stretch.streaming;
+			track->lastPpqPosition = -1.0;
+			track->customStepCounter = 0;
+
+			track->sequencerData = TrackData::SequencerData{};
+			track->sequencerData.numMeasures = 1;
+			for (int step = 0; step < 16; step += 4)
+			{
+				track->sequencerData.steps[0][step] = true;
+				track->sequencerData.velocities[0][step] = 1.0f;
+			}
+
+			if (track->slotIndex >= 0)
+				setRetrigger(processor, track->slotIndex, active && config.repeat == "retrigger");
+			if (track->audioBuffer.getNumChannels() == 0)
+			{
+				const auto& loop = loops[static_cast<size_t>(i) % loops.size()];
+				track->audioBuffer = loop;
+				track->numSamples = loop.getNumSamples();
+				track->sampleRate = loopSampleRate;
+				track->originalBpm = static_cast<float>(loopBpm);
+				track->loopStart = 0.0;
+				track->loopEnd = loop.getNumSamples() / loopSampleRate;
+			}
+		}
+	}
+
+	Measurement run(DjIaVstProcessor& processor, VirtualPlayHead& transport, const Configuration& config, double secondsToMeasure)
+	{
+		const int blocksPerPump = juce::jmax(1, static_cast<int>(config.sampleRate * messageLoopIntervalSeconds / config.blockSize));
+		const int numChannels = processor.getTotalNumOutputChannels();
+		juce::AudioBuffer<float> buffer(numChannels, config.blockSize);
+		juce::MidiBuffer midi;
+		midi.ensureSize(4096);
+
+		auto processOneBlock = [&]()
+			{
+				buffer.clear();
+				midi.clear();
+				processor.processBlock(buffer, midi);
+				transport.advance(config.blockSize);
+			};
+
+		// One stopped block resets the sequencer start, then a bar of warm-up
+		// lets the tracks start on the downbeat and the stretchers fill.
+		transport.reset(config.sampleRate, false);
+		processOneBlock();
+		transport.reset(config.sampleRate, true);
+		const int warmUpBlocks = static_cast<int>(std::ceil(config.sampleRate * 2.5 / config.blockSize));
+		for (int block = 0; block < warmUpBlocks; ++block)
+		{
+			processOneBlock();
+			if ((block + 1) % blocksPerPump == 0)
+				pumpMessageLoop(1);
+		}
+
+		const int numBlocks = juce::jmax(10, static_cast<int>(config.sampleRate * secondsToMeasure / config.blockSize));
+		std::vector<double> times;
+		times.reserve(static_cast<size_t>(numBlocks));
+		Measurement result;
+		RealtimeAllocationGuard::getAndResetAllocationCount();
+
+		for (int block = 0; block < numBlocks; ++block)
+		{
+			const auto start = juce::Time::getHighResolutionTicks();
+			processOneBlock();
+			const auto end = juce::Time::getHighResolutionTicks();
+			times.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+
+			const auto allocations = RealtimeAllocationGuard::getAndResetAllocationCount();
+			result.allocations += allocations;
+			if (allocations > 0)
+				++result.blocksWithAllocations;
+
+			// Outside the timed block and after its allocations were read.
+			if ((block + 1) % blocksPerPump == 0)
+			{
+				pumpMessageLoop(1);
+				RealtimeAllocationGuard::getAndResetAllocationCount();
+			}
+		}
+
+		std::sort(times.begin(), times.end());
+		result.blocks = numBlocks;
+		result.p50 = times[times.size() / 2];
+		result.p99 = times[juce::jmin(times.size() - 1, static_cast<size_t>(times.size() * 0.99))];
+		result.max = times.back();
+		for (double time : times)
+			result.mean += time;
+		result.mean /= static_cast<double>(times.size());
+		return result;
+	}
+
+	juce::String toJson(const Configuration& config, const Measurement& measurement, int renderThreads)
+	{
+		const double deadline = config.blockSize / config.sampleRate * 1.0e6;
+		auto* object = new juce::DynamicObject();
+		object->setProperty("blockSize", config.blockSize);
+		object->setProperty("sampleRate", config.sampleRate);
+		object->setProperty("tracks", config.numTracks);
+		object->setProperty("stretch", config.stretch.name);
+		object->setProperty("repeat", config.repeat);
+		object->setProperty("renderThreads", renderThreads);
+		object->setProperty("blocks", measurement.blocks);
+		object->setProperty("p50Us", measurement.p50);
+		object->setProperty("p99Us", measurement.p99);
+		object->setProperty("maxUs", measurement.max);
+		object->setProperty("meanUs", measurement.mean);
+		object->setProperty("deadlineUs", deadline);
+		object->setProperty("p99Load", measurement.p99 / deadline);
+		object->setProperty("allocations", static_cast<juce::int64>(measurement.allocations));
+		object->setProperty("blocksWithAllocations", measurement.blocksWithAllocations);
+		return juce::JSON::toString(juce::var(object), true);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+	const juce::ArgumentList args(argc, argv);
+
+	const auto blockSizes = parseIntList(args, "--block-sizes", "64,128,256,512,1024");
+	const auto sampleRates = parseIntList(args, "--sample-rates", "44100,48000,96000");
+	const auto trackCounts = parseIntList(args, "--tracks", "1,4,8");
+	const auto stretchNames = parseNameList(args, "--stretch", "none,varispeed,streaming");
+	const auto repeatNames = parseNameList(args, "--repeat", "off,repeat,retrigger");
+	const double seconds = args.containsOption("--seconds") ? juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue()) : 5.0;
+
+	std::unique_ptr<juce::FileOutputStream> file;
+	if (args.containsOption("--output"))
+	{
+		file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output")).createOutputStream();
+		if (file == nullptr || !file->openedOk())
+		{
+			std::cerr << "Cannot write " << args.getValueForOption("--output") << std::endl;
+			return 1;
+		}
+		file->setPosition(0);
+		file->truncate();
+	}
+
+	DjIaVstProcessor processor;
+	VirtualPlayHead transport;
+	transport.setTempo(hostBpm, 4, 4);
+	processor.setPlayHead(&transport);
+	if (args.containsOption("--render-threads"))
+		processor.setRenderThreads(juce::jmax(1, args.getValueForOption("--render-threads").getIntValue()));
+
+	int maxTracks = 0;
+	for (int count : trackCounts)
+		maxTracks = juce::jmax(maxTracks, juce::jmin(count, processor.getTrackCapacity()));
+
+	juce::StringArray trackIds;
+	for (const auto& trackId : processor.trackManager.getAllTrackIds())
+		trackIds.add(trackId);
+	while (trackIds.size() < maxTracks)
+		trackIds.add(processor.trackManager.createTrack("Bench"));
+
+	std::vector<juce::AudioBuffer<float>> loops;
+	for (int i = 0; i < juce::jmax(1, maxTracks); ++i)
+		loops.push_back(makeLoop(i + 1));
+
+	int configurations = 0;
+	for (int sampleRate : sampleRates)
+	{
+		for (int blockSize : blockSizes)
+		{
+			processor.releaseResources();
+			processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+			processor.prepareToPlay(sampleRate, blockSize);
+
+			for (int requestedTracks : trackCounts)
+			{
+				if (requestedTracks > processor.getTrackCapacity())
+				{
+					std::cerr << "Skipping " << requestedTracks << " tracks: the track capacity is "
+						<< processor.getTrackCapacity() << std::endl;
+					continue;
+				}
+
+				for (const auto& stretch : stretchSettings)
+				{
+					if (!stretchNames.contains(stretch.name))
+						continue;
+
+					for (const auto& repeat : repeatNames)
+					{
+						Configuration config;
+						config.blockSize = blockSize;
+						config.sampleRate = sampleRate;
+						config.numTracks = requestedTracks;
+						config.stretch = stretch;
+						config.repeat = repeat;
+
+						setUpTracks(processor, trackIds, loops, config);
+						// Lets the previous configuration's retired buffers
+						// and queued UI work drain before measuring.
+						pumpMessageLoop(50);
+						const auto measurement = run(processor, transport, config, seconds);
+						const auto line = toJson(config, measurement, processor.getRenderThreads());
+
+						if (file != nullptr)
+							*file << line << "\n";
+						else
+							std::cout << line << std::endl;
+						std::cerr << sampleRate << " Hz, " << blockSize << " samples, " << requestedTracks << " tracks, "
+							<< stretch.name << ", " << repeat << ": p99 " << measurement.p99 << " us" << std::endl;
+						++configurations;
+					}
+				}
+			}
+		}
+	}
+
+	processor.setPlayHead(nullptr);
+	if (file != nullptr)
+		file->flush();
+	std::cerr << configurations << " configurations measured" << std::endl;
+	return 0;
+}
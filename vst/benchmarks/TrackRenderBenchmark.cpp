@@ -0,0 +1,144 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "JuceHeader.h"
+#include "TrackManager.h"
+#include <set>
+
+/*
+	Renders blocks of looping tracks through TrackManager::renderAllTracks,
+	once with warm caches and once after streaming through a buffer larger
+	than the last-level cache before every block, the way a host running
+	other plugins leaves it. The cold/warm gap is the cost of the cache
+	misses the render loop takes on track state and sample data; the
+	footprint report lists how many cache lines of each TrackData it
+	touches, which is the part the track layout decides.
+*/
+namespace
+{
+	constexpr size_t cacheLineBytes = 64;
+
+	size_t getCacheLine(const TrackData& track, const void* field)
+	{
+		return static_cast<size_t>(static_cast<const char*>(field) - reinterpret_cast<const char*>(&track)) / cacheLineBytes;
+	}
+
+	/** Cache lines of a track holding the fields renderAllTracks reads or writes every block. */
+	std::set<size_t> getRenderedCacheLines(const TrackData& track)
+	{
+		const void* fields[] = {
+			&track.isEnabled, &track.isSolo, &track.isMuted, &track.isPlaying, &track.usePages,
+			&track.streamingStretch, &track.audioRestorePending, &track.interpolationQuality,
+			&track.timeStretchMode, &track.slotIndex, &track.volume, &track.pan,
+			&track.insertEqLow, &track.insertEqMid, &track.insertEqHigh, &track.insertFilter,
+			&track.insertCompression, &track.insertDelaySend, &track.fineOffset, &track.bpmOffset,
+			&track.readPosition, &track.beatRepeatStartPosition, &track.beatRepeatEndPosition,
+			&track.beatRepeatActive, &track.renderedPlaying, &track.numScheduledEvents,
+			&track.numSamples, &track.sampleRate, &track.loopStart, &track.loopEnd, &track.originalBpm
+		};
+
+		std::set<size_t> lines;
+		for (const void* field : fields)
+			lines.insert(getCacheLine(track, field));
+		return lines;
+	}
+
+	juce::AudioBuffer<float> makeNoiseLoop(double sampleRate, double seconds, int seed)
+	{
+		const int numSamples = static_cast<int>(sampleRate * seconds);
+		juce::AudioBuffer<float> buffer(2, numSamples);
+		juce::Random random(seed);
+		for (int channel = 0; channel < 2; ++channel)
+		{
+			auto* data = buffer.getWritePointer(channel);
+			for (int i = 0; i < numSamples; ++i)
+				data[i] = 0.25f * (random.nextFloat() - 0.5f);
+		}
+		return buffer;
+	}
+
+	struct Result
+	{
+		double medianMicroseconds = 0.0;
+		double meanMicroseconds = 0.0;
+	};
+
+	Result renderBlocks(TrackManager& manager, int numBlocks, int blockSize, std::vector<char>* evictionBuffer)
+	{
+		juce::AudioBuffer<float> output(2, blockSize);
+		std::vector<juce::AudioBuffer<float>> individualOutputs(static_cast<size_t>(manager.getSlotCapacity()));
+		std::vector<double> times;
+		times.reserve(static_cast<size_t>(numBlocks));
+		volatile char sink = 0;
+
+		for (int block = 0; block < numBlocks; ++block)
+		{
+			if (evictionBuffer != nullptr)
+			{
+				for (size_t i = 0; i < evictionBuffer->size(); i += cacheLineBytes)
+					sink = static_cast<char>(sink + ++(*evictionBuffer)[i]);
+			}
+
+			output.clear();
+			const auto start = juce::Time::getHighResolutionTicks();
+			manager.acquireAudioSnapshot();
+			manager.renderAllTracks(output, individualOutputs, 126.0);
+			const auto end = juce::Time::getHighResolutionTicks();
+			times.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+		}
+
+		Result result;
+		for (double time : times)
+			result.meanMicroseconds += time;
+		result.meanMicroseconds /= static_cast<double>(times.size());
+		std::nth_element(times.begin(), times.begin() + static_cast<long>(times.size() / 2), times.end());
+		result.medianMicroseconds = times[times.size() / 2];
+		return result;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const double sampleRate = 48000.0;
+	const int numTracks = argc > 1 ? juce::jlimit(1, 32, juce::String(argv[1]).getIntValue()) : 16;
+	const int blockSize = argc > 2 ? juce::jlimit(16, 4096, juce::String(argv[2]).getIntValue()) : 128;
+	const int numBlocks = argc > 3 ? juce::jmax(10, juce::String(argv[3]).getIntValue()) : 500;
+
+	TrackManager manager;
+	manager.setSlotCapacity(numTracks);
+	for (int i = 0; i < numTracks; ++i)
+	{
+		auto* track = manager.getTrack(manager.createTrack());
+		track->audioBuffer = makeNoiseLoop(sampleRate, 4.0, i + 1);
+		track->numSamples = track->audioBuffer.getNumSamples();
+		track->sampleRate = sampleRate;
+		track->originalBpm = 126.0f;
+		track->timeStretchMode = 1;
+		track->isPlaying = true;
+	}
+	manager.prepareToPlay(sampleRate, blockSize, numTracks);
+	manager.setRenderThreads(1);
+
+	const auto ids = manager.getAllTrackIds();
+	const auto& first = *manager.getTrack(ids.front());
+	const auto lines = getRenderedCacheLines(first);
+	std::cout << "TrackData: " << sizeof(TrackData) << " bytes, " << (sizeof(TrackData) + cacheLineBytes - 1) / cacheLineBytes
+		<< " cache lines, renderer touches " << lines.size() << " of them" << std::endl;
+
+	// Larger than the last-level cache of any machine we mix on.
+	std::vector<char> evictionBuffer(64u * 1024u * 1024u, 0);
+
+	renderBlocks(manager, 50, blockSize, nullptr);
+	const auto warm = renderBlocks(manager, numBlocks, blockSize, nullptr);
+	const auto cold = renderBlocks(manager, numBlocks, blockSize, &evictionBuffer);
+
+	std::cout << numTracks << " tracks, " << blockSize << " samples per block, " << numBlocks << " blocks" << std::endl;
+	std::cout << "Warm caches:  " << warm.medianMicroseconds << " us median, " << warm.meanMicroseconds << " us mean" << std::endl;
+	std::cout << "Cold caches:  " << cold.medianMicroseconds << " us median, " << cold.meanMicroseconds << " us mean" << std::endl;
+	std::cout << "Miss penalty: " << (cold.medianMicroseconds - warm.medianMicroseconds) / numTracks << " us per track per block" << std::endl;
+	return 0;
+}
@@ -0,0 +1,335 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "AnalysisCache.h"
+#include "SampleBank.h"
+
+namespace
+{
+	juce::String encodeFloats(const std::vector<float>& values)
+	{
+		juce::MemoryBlock block(values.data(), values.size() * sizeof(float));
+		return block.toBase64Encoding();
+	}
+
+	bool decodeFloats(const juce::var& encoded, std::vector<float>& values)
+	{
+		juce::MemoryBlock block;
+		if (!block.fromBase64Encoding(encoded.toString()))
+			return false;
+
+		values.resize(block.getSize() / sizeof(float));
+		if (!values.empty())
+			std::memcpy(values.data(), block.getData(), values.size() * sizeof(float));
+		return true;
+	}
+}
+
+AnalysisCache::AnalysisCache()
+	: AnalysisCache(SampleBank::getBankDirectory().getChildFile("AnalysisCache"))
+{
+}
+
+AnalysisCache::AnalysisCache(const juce::File& directory)
+	: cacheDirectory(directory)
+{
+}
+
+juce::String AnalysisCache::computeContentKey(const juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate)
+{
+	const juce::uint64 prime = 0x100000001b3ULL;
+	juce::uint64 hash = 0xcbf29ce484222325ULL;
+
+	auto mix = [&hash, prime](juce::uint64 value)
+		{
+			hash ^= value;
+			hash *= prime;
+		};
+
+	numSamples = juce::jlimit(0, buffer.getNumSamples(), numSamples);
+	mix(static_cast<juce::uint64>(numSamples));
+	mix(static_cast<juce::uint64>(juce::roundToInt(sampleRate)));
+
+	for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+	{
+		const auto* words = reinterpret_cast<const juce::uint32*>(buffer.getReadPointer(channel));
+		for (int i = 0; i < numSamples; ++i)
+			mix(words[i]);
+	}
+
+	return juce::String::toHexString(static_cast<juce::int64>(hash)).paddedLeft('0', 16);
+}
+
+juce::String AnalysisCache::computeFileKey(const juce::File& file)
+{
+	juce::String identity = file.getFullPathName()
+		+ "|" + juce::String(file.getSize())
+		+ "|" + juce::String(file.getLastModificationTime().toMilliseconds());
+	return "file" + juce::String::toHexString(static_cast<juce::int64>(identity.hashCode64())).paddedLeft('0', 16);
+}
+
+void AnalysisCache::computeThumbnail(const juce::AudioBuffer<float>& buffer, int numSamples, int numBuckets,
+	std::vector<float>& peaks, std::vector<float>& rms)
+{
+	numSamples = juce::jlimit(0, buffer.getNumSamples(), numSamples);
+	peaks.assign(static_cast<size_t>(numBuckets), 0.0f);
+	rms.assign(static_cast<size_t>(numBuckets), 0.0f);
+	if (numSamples == 0 || numBuckets <= 0)
+		return;
+
+	const int numChannels = std::min(2, buffer.getNumChannels());
+	for (int bucket = 0; bucket < numBuckets; ++bucket)
+	{
+		const int start = static_cast<int>(static_cast<juce::int64>(bucket) * numSamples / numBuckets);
+		const int end = static_cast<int>(static_cast<juce::int64>(bucket + 1) * numSamples / numBuckets);
+		const int count = end - start;
+		if (count <= 0)
+			continue;
+
+		float peak = 0.0f;
+		float sumSquares = 0.0f;
+		for (int channel = 0; channel < numChannels; ++channel)
+		{
+			auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(channel, start), count);
+			peak = juce::jmax(peak, std::abs(range.getStart()), std::abs(range.getEnd()));
+			float channelRms = buffer.getRMSLevel(channel, start, count);
+			sumSquares += channelRms * channelRms;
+		}
+		peaks[static_cast<size_t>(bucket)] = peak;
+		rms[static_cast<size_t>(bucket)] = std::sqrt(sumSquares / numChannels);
+	}
+}
+
+bool AnalysisCache::lookupAnalysis(const juce::String& key, Analysis& analysis)
+{
+	juce::ScopedLock lock(cacheLock);
+	auto remembered = memoryEntries.find(key);
+	if (remembered != memoryEntries.end())
+	{
+		analysis = remembered->second;
+		return true;
+	}
+
+	juce::File file = getAnalysisFile(key);
+	if (!file.existsAsFile())
+		return false;
+
+	juce::var json = juce::JSON::parse(file);
+	auto* object = json.getDynamicObject();
+	if (!object || static_cast<int>(object->getProperty("version")) != formatVersion)
+		return false;
+
+	analysis.bpm = static_cast<float>(object->getProperty("bpm"));
+	analysis.confidence = static_cast<float>(object->getProperty("confidence"));
+	analysis.sampleRate = static_cast<double>(object->getProperty("sampleRate"));
+	analysis.numSamples = static_cast<int>(object->getProperty("numSamples"));
+	analysis.onsetHopSize = static_cast<int>(object->getProperty("onsetHopSize"));
+
+	if (!decodeFloats(object->getProperty("onsetEnvelope"), analysis.onsetEnvelope) ||
+		!decodeFloats(object->getProperty("thumbnailPeaks"), analysis.thumbnailPeaks) ||
+		!decodeFloats(object->getProperty("thumbnailRms"), analysis.thumbnailRms))
+	{
+		return false;
+	}
+
+	rememberLocked(key, analysis);
+	return true;
+}
+
+void AnalysisCache::rememberLocked(const juce::String& key, const Analysis& analysis)
+{
+	if (memoryEntries.find(key) == memoryEntries.end())
+		memoryOrder.push_back(key);
+	memoryEntries[key] = analysis;
+
+	while (memoryOrder.size() > maxMemoryEntries)
+	{
+		memoryEntries.erase(memoryOrder.front());
+		memoryOrder.pop_front();
+	}
+}
+
+void AnalysisCache::storeAnalysis(const juce::String& key, const AudioAnalyzer::BPMAnalysis& bpmAnalysis,
+	const juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate)
+{
+	std::vector<float> peaks;
+	std::vector<float> rms;
+	computeThumbnail(buffer, numSamples, thumbnailSize, peaks, rms);
+
+	juce::DynamicObject::Ptr object = new juce::DynamicObject();
+	object->setProperty("version", formatVersion);
+	object->setProperty("bpm", bpmAnalysis.bpm);
+	object->setProperty("confidence", bpmAnalysis.confidence);
+	object->setProperty("sampleRate", sampleRate);
+	object->setProperty("numSamples", numSamples);
+	object->setProperty("onsetHopSize", AudioAnalyzer::onsetHopSize);
+	object->setProperty("onsetEnvelope", encodeFloats(bpmAnalysis.onsetEnvelope));
+	object->setProperty("thumbnailPeaks", encodeFloats(peaks));
+	object->setProperty("thumbnailRms", encodeFloats(rms));
+
+	Analysis analysis;
+	analysis.bpm = bpmAnalysis.bpm;
+	analysis.confidence = bpmAnalysis.confidence;
+	analysis.sampleRate = sampleRate;
+	analysis.numSamples = numSamples;
+	analysis.onsetEnvelope = bpmAnalysis.onsetEnvelope;
+	analysis.thumbnailPeaks = std::move(peaks);
+	analysis.thumbnailRms = std::move(rms);
+
+	juce::ScopedLock lock(cacheLock);
+	rememberLocked(key, analysis);
+	if (!ensureDirectoryExists())
+		return;
+
+	juce::TemporaryFile temporary(getAnalysisFile(key));
+	if (temporary.getFile().replaceWithText(juce::JSON::toString(juce::var(object.get()))))
+	{
+		temporary.overwriteTargetFileWithTemporary();
+	}
+}
+
+bool AnalysisCache::loadStretchedVariant(const juce::String& key, double stretchRatio, double sampleRate,
+	juce::AudioBuffer<float>& destination)
+{
+	juce::ScopedLock lock(cacheLock);
+	juce::File file = getVariantFile(key, stretchRatio);
+	if (!file.existsAsFile())
+		return false;
+
+	juce::WavAudioFormat wavFormat;
+	std::unique_ptr<juce::AudioFormatReader> reader(
+		wavFormat.createReaderFor(new juce::FileInputStream(file), true));
+	if (!reader || reader->lengthInSamples <= 0 || std::abs(reader->sampleRate - sampleRate) > 1.0)
+		return false;
+
+	const int numSamples = static_cast<int>(reader->lengthInSamples);
+	destination.setSize(2, numSamples, false, false, true);
+	destination.clear();
+	reader->read(&destination, 0, numSamples, 0, true, true);
+	if (reader->numChannels == 1)
+	{
+		destination.copyFrom(1, 0, destination, 0, 0, numSamples);
+	}
+
+	file.setLastModificationTime(juce::Time::getCurrentTime());
+	return true;
+}
+
+void AnalysisCache::storeStretchedVariant(const juce::String& key, double stretchRatio, double sampleRate,
+	const juce::AudioBuffer<float>& buffer)
+{
+	if (buffer.getNumSamples() == 0)
+		return;
+
+	juce::ScopedLock lock(cacheLock);
+	if (!ensureDirectoryExists())
+		return;
+
+	juce::TemporaryFile temporary(getVariantFile(key, stretchRatio));
+	{
+		auto* fileStream = new juce::FileOutputStream(temporary.getFile());
+		if (!fileStream->openedOk())
+		{
+			delete fileStream;
+			return;
+		}
+
+		juce::WavAudioFormat wavFormat;
+		std::unique_ptr<juce::AudioFormatWriter> writer(
+			wavFormat.createWriterFor(fileStream, sampleRate, static_cast<unsigned int>(buffer.getNumChannels()), 32, {}, 0));
+		if (writer == nullptr)
+		{
+			delete fileStream;
+			return;
+		}
+
+		if (!writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples()))
+			return;
+	}
+
+	temporary.overwriteTargetFileWithTemporary();
+	pruneVariants();
+}
+
+std::shared_ptr<WaveformPyramid> AnalysisCache::loadPyramid(const juce::String& key)
+{
+	juce::ScopedLock lock(cacheLock);
+	juce::File file = getPyramidFile(key);
+	if (!file.existsAsFile())
+		return nullptr;
+
+	juce::FileInputStream stream(file);
+	if (!stream.openedOk())
+		return nullptr;
+
+	return WaveformPyramid::readFrom(stream);
+}
+
+void AnalysisCache::storePyramid(const juce::String& key, const WaveformPyramid& pyramid)
+{
+	juce::ScopedLock lock(cacheLock);
+	if (!ensureDirectoryExists())
+		return;
+
+	juce::TemporaryFile temporary(getPyramidFile(key));
+	{
+		juce::FileOutputStream stream(temporary.getFile());
+		if (!stream.openedOk() || !pyramid.writeTo(stream))
+			return;
+		stream.flush();
+		if (stream.getStatus().failed())
+			return;
+	}
+	temporary.overwriteTargetFileWithTemporary();
+}
+
+juce::File AnalysisCache::getAnalysisFile(const juce::String& key) const
+{
+	return cacheDirectory.getChildFile(key + ".json");
+}
+
+juce::File AnalysisCache::getVariantFile(const juce::String& key, double stretchRatio) const
+{
+	return cacheDirectory.getChildFile(key + "_x" + juce::String(juce::roundToInt(stretchRatio * 10000.0)) + ".wav");
+}
+
+juce::File AnalysisCache::getPyramidFile(const juce::String& key) const
+{
+	return cacheDirectory.getChildFile(key + ".peaks");
+}
+
+bool AnalysisCache::ensureDirectoryExists()
+{
+	return cacheDirectory.isDirectory() || cacheDirectory.createDirectory().wasOk();
+}
+
+void AnalysisCache::pruneVariants()
+{
+	auto variants = cacheDirectory.findChildFiles(juce::File::findFiles, false, "*.wav");
+
+	juce::int64 totalBytes = 0;
+	for (const auto& variant : variants)
+		totalBytes += variant.getSize();
+
+	if (totalBytes <= maxVariantBytes)
+		return;
+
+	std::sort(variants.begin(), variants.end(), [](const juce::File& a, const juce::File& b)
+		{
+			return a.getLastModificationTime() < b.getLastModificationTime();
+		});
+
+	for (const auto& variant : variants)
+	{
+		if (totalBytes <= maxVariantBytes)
+			break;
+
+		juce::int64 size = variant.getSize();
+		if (variant.deleteFile())
+			totalBytes -= size;
+	}
+}
@@ -0,0 +1,81 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "AudioAnalyzer.h"
+#include "WaveformPyramid.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+/*
+	On-disk cache of per-sample analysis, stored next to the SampleBank index.
+	Entries are keyed by a hash of the decoded audio, so the same content hits
+	the cache whatever file it came from. Analyses read or stored recently
+	are also kept in memory, so another instance loading the same sample does
+	not parse the file again. Stretched variants are kept as WAV files per
+	stretch ratio and evicted oldest-first past maxVariantBytes.
+*/
+class AnalysisCache
+{
+public:
+	static constexpr int formatVersion = 1;
+	static constexpr int thumbnailSize = 512;
+	static constexpr juce::int64 maxVariantBytes = 512LL * 1024 * 1024;
+	static constexpr size_t maxMemoryEntries = 256;
+
+	struct Analysis
+	{
+		float bpm = 0.0f;
+		float confidence = 0.0f;
+		double sampleRate = 0.0;
+		int numSamples = 0;
+		int onsetHopSize = AudioAnalyzer::onsetHopSize;
+		std::vector<float> onsetEnvelope;
+		std::vector<float> thumbnailPeaks;
+		std::vector<float> thumbnailRms;
+	};
+
+	AnalysisCache();
+	explicit AnalysisCache(const juce::File& directory);
+
+	static juce::String computeContentKey(const juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate);
+	static juce::String computeFileKey(const juce::File& file);
+	static void computeThumbnail(const juce::AudioBuffer<float>& buffer, int numSamples, int numBuckets,
+		std::vector<float>& peaks, std::vector<float>& rms);
+
+	bool lookupAnalysis(const juce::String& key, Analysis& analysis);
+	void storeAnalysis(const juce::String& key, const AudioAnalyzer::BPMAnalysis& bpmAnalysis,
+		const juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate);
+
+	bool loadStretchedVariant(const juce::String& key, double stretchRatio, double sampleRate,
+		juce::AudioBuffer<float>& destination);
+	void storeStretchedVariant(const juce::String& key, double stretchRatio, double sampleRate,
+		const juce::AudioBuffer<float>& buffer);
+
+	std::shared_ptr<WaveformPyramid> loadPyramid(const juce::String& key);
+	void storePyramid(const juce::String& key, const WaveformPyramid& pyramid);
+
+	const juce::File& getDirectory() const { return cacheDirectory; }
+
+private:
+	juce::File cacheDirectory;
+	juce::CriticalSection cacheLock;
+	std::map<juce::String, Analysis> memoryEntries;
+	std::list<juce::String> memoryOrder;
+
+	void rememberLocked(const juce::String& key, const Analysis& analysis);
+	juce::File getAnalysisFile(const juce::String& key) const;
+	juce::File getVariantFile(const juce::String& key, double stretchRatio) const;
+	juce::File getPyramidFile(const juce::String& key) const;
+	bool ensureDirectoryExists();
+	void pruneVariants();
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisCache)
+};
@@ -9,53 +9,100 @@
 #include "JuceHeader.h"
 #include "SoundTouch.h"
 #include "BPMDetect.h"
+#include <future>
 
 class AudioAnalyzer
 {
 public:
+	struct BPMAnalysis
+	{
+		float bpm = 0.0f;
+		float confidence = 0.0f;
+		float soundTouchBpm = 0.0f;
+		float onsetBpm = 0.0f;
+		float onsetConsistency = 0.0f;
+		std::vector<float> onsetEnvelope;
+	};
+
+	static constexpr int onsetHopSize = 512;
+
 	static float detectBPM(const juce::AudioBuffer<float> &buffer, double sampleRate)
 	{
+		return analyzeBPM(buffer, sampleRate).bpm;
+	}
+
+	static BPMAnalysis analyzeBPM(const juce::AudioBuffer<float> &buffer, double sampleRate)
+	{
+		BPMAnalysis analysis;
 		if (buffer.getNumSamples() == 0)
-			return 0.0f;
+			return analysis;
 
 		try
 		{
-			soundtouch::BPMDetect bpmDetect(1, (int)sampleRate);
-
 			std::vector<float> monoData;
-			monoData.reserve(buffer.getNumSamples());
+			float normalizeGain = downmixAndNormalize(buffer, monoData);
+			if (normalizeGain <= 0.0f)
+				return analysis;
 
-			bool retFlag;
-			float retVal = normalizeAudio(buffer, monoData, retFlag);
-			if (retFlag)
-				return retVal;
+			auto onsetFuture = std::async(std::launch::async, [&monoData, sampleRate, normalizeGain, &analysis]()
+										  {
+				float consistency = 0.0f;
+				float bpm = detectBPMFromMono(monoData, sampleRate, 0.1f * normalizeGain, consistency, &analysis.onsetEnvelope);
+				return std::make_pair(bpm, consistency); });
 
+			soundtouch::BPMDetect bpmDetect(1, (int)sampleRate);
 			chunkAnalysis(monoData, bpmDetect);
+			analysis.soundTouchBpm = bpmDetect.getBpm();
 
-			float detectedBPM = bpmDetect.getBpm();
-			return returnDetectedBPMorFallback(detectedBPM, buffer, sampleRate);
+			auto onsetResult = onsetFuture.get();
+			analysis.onsetBpm = onsetResult.first;
+			analysis.onsetConsistency = onsetResult.second;
+
+			combineEstimates(analysis);
+			return analysis;
 		}
 		catch (const std::exception & /*e*/)
 		{
-			return 0.0f;
+			return analysis;
 		}
 	}
 
-	static float returnDetectedBPMorFallback(float detectedBPM, const juce::AudioSampleBuffer &buffer, double sampleRate)
+	static bool isValidBPM(float bpm)
 	{
-		if (detectedBPM >= 30.0f && detectedBPM <= 300.0f)
+		return bpm >= 30.0f && bpm <= 300.0f;
+	}
+
+	static void combineEstimates(BPMAnalysis &analysis)
+	{
+		const bool soundTouchValid = isValidBPM(analysis.soundTouchBpm);
+		const bool onsetValid = isValidBPM(analysis.onsetBpm);
+
+		if (soundTouchValid && onsetValid)
+		{
+			float ratio = analysis.soundTouchBpm / analysis.onsetBpm;
+			bool agree = false;
+			for (float multiple : {0.5f, 1.0f, 2.0f})
+			{
+				if (std::abs(ratio - multiple) <= 0.04f * multiple)
+					agree = true;
+			}
+			analysis.bpm = analysis.soundTouchBpm;
+			analysis.confidence = agree ? juce::jmin(1.0f, 0.75f + 0.25f * analysis.onsetConsistency) : 0.5f;
+		}
+		else if (soundTouchValid)
+		{
+			analysis.bpm = analysis.soundTouchBpm;
+			analysis.confidence = 0.6f;
+		}
+		else if (onsetValid)
 		{
-			return detectedBPM;
+			analysis.bpm = analysis.onsetBpm;
+			analysis.confidence = 0.4f * analysis.onsetConsistency;
 		}
 		else
 		{
-			float fallbackBPM = detectBPMByOnsets(buffer, sampleRate);
-			if (fallbackBPM >= 30.0f && fallbackBPM <= 300.0f)
-			{
-				return fallbackBPM;
-			}
-
-			return 0.0f;
+			analysis.bpm = 0.0f;
+			analysis.confidence = 0.0f;
 		}
 	}
 
@@ -70,32 +117,40 @@ public:
 		}
 	}
 
-	static float normalizeAudio(const juce::AudioSampleBuffer &buffer, std::vector<float> &monoData, bool &retFlag)
+	static float downmixAndNormalize(const juce::AudioSampleBuffer &buffer, std::vector<float> &monoData)
 	{
-		retFlag = true;
+		const int numSamples = buffer.getNumSamples();
+		const bool stereo = buffer.getNumChannels() > 1;
+		const int chunkSize = 4096;
+
+		monoData.resize((size_t)numSamples);
+		float *mono = monoData.data();
 		float maxLevel = 0.0f;
-		for (int i = 0; i < buffer.getNumSamples(); ++i)
+
+		for (int start = 0; start < numSamples; start += chunkSize)
 		{
-			float mono = buffer.getSample(0, i);
-			if (buffer.getNumChannels() > 1)
+			const int count = std::min(chunkSize, numSamples - start);
+			if (stereo)
 			{
-				mono = (buffer.getSample(0, i) + buffer.getSample(1, i)) * 0.5f;
+				juce::FloatVectorOperations::copyWithMultiply(mono + start, buffer.getReadPointer(0, start), 0.5f, count);
+				juce::FloatVectorOperations::addWithMultiply(mono + start, buffer.getReadPointer(1, start), 0.5f, count);
 			}
-
-			maxLevel = std::max(maxLevel, std::abs(mono));
-			monoData.push_back(mono);
+			else
+			{
+				juce::FloatVectorOperations::copy(mono + start, buffer.getReadPointer(0, start), count);
+			}
+			auto range = juce::FloatVectorOperations::findMinAndMax(mono + start, count);
+			maxLevel = juce::jmax(maxLevel, std::abs(range.getStart()), std::abs(range.getEnd()));
 		}
+
 		if (maxLevel < 0.001f)
 		{
 			return 0.0f;
 		}
+
 		float normalizeGain = 0.5f / maxLevel;
-		for (auto &sample : monoData)
-		{
-			sample *= normalizeGain;
-		}
-		retFlag = false;
-		return {};
+		juce::FloatVectorOperations::multiply(mono, normalizeGain, numSamples);
+		return normalizeGain;
 	}
 
 	static float detectBPMByOnsets(const juce::AudioBuffer<float> &buffer, double sampleRate)
@@ -105,101 +160,144 @@ public:
 
 		try
 		{
-			const int hopSize = 512;
-			const int windowSize = 1024;
-			std::vector<float> onsetStrength;
+			std::vector<float> monoData;
+			float normalizeGain = downmixAndNormalize(buffer, monoData);
+			if (normalizeGain <= 0.0f)
+				return 0.0f;
 
-			for (int i = 0; i < buffer.getNumSamples() - windowSize; i += hopSize)
-			{
-				float energy = 0.0f;
-				for (int j = 0; j < windowSize; ++j)
-				{
-					float sample = buffer.getSample(0, i + j);
-					if (buffer.getNumChannels() > 1)
-					{
-						sample = (sample + buffer.getSample(1, i + j)) * 0.5f;
-					}
-					energy += sample * sample;
-				}
-				onsetStrength.push_back(std::sqrt(energy / windowSize));
-			}
-			std::vector<int> onsets;
-			float threshold = 0.1f;
+			float consistency = 0.0f;
+			return detectBPMFromMono(monoData, sampleRate, 0.1f * normalizeGain, consistency);
+		}
+		catch (const std::exception & /*e*/)
+		{
+			return 0.0f;
+		}
+	}
 
-			for (int i = 1; i < onsetStrength.size() - 1; ++i)
-			{
-				if (onsetStrength[i] > threshold &&
-					onsetStrength[i] > onsetStrength[i - 1] &&
-					onsetStrength[i] > onsetStrength[i + 1])
-				{
-					onsets.push_back(i);
-				}
-			}
+	static float detectBPMFromMono(const std::vector<float> &monoData, double sampleRate,
+								   float threshold, float &consistency,
+								   std::vector<float> *envelope = nullptr)
+	{
+		consistency = 0.0f;
+		const int hopSize = onsetHopSize;
+		const int windowSize = 1024;
+		const int numSamples = (int)monoData.size();
 
-			if (onsets.size() < 4)
-			{
-				return 0.0f;
-			}
-			std::vector<float> intervals;
-			for (int i = 1; i < onsets.size(); ++i)
-			{
-				float intervalSeconds = (onsets[i] - onsets[i - 1]) * hopSize / (float)sampleRate;
-				if (intervalSeconds > 0.2f && intervalSeconds < 2.0f)
-				{
-					intervals.push_back(60.0f / intervalSeconds);
-				}
-			}
+		if (numSamples < sampleRate || numSamples <= windowSize)
+			return 0.0f;
+
+		const int numHops = numSamples / hopSize;
+		std::vector<float> hopEnergy((size_t)numHops);
+		for (int h = 0; h < numHops; ++h)
+		{
+			const float *block = monoData.data() + (size_t)h * hopSize;
+			float energy = 0.0f;
+			for (int j = 0; j < hopSize; ++j)
+				energy += block[j] * block[j];
+			hopEnergy[(size_t)h] = energy;
+		}
 
-			if (intervals.empty())
+		std::vector<float> onsetStrength;
+		onsetStrength.reserve((size_t)numHops);
+		for (int i = 0; i + windowSize < numSamples; i += hopSize)
+		{
+			const int h = i / hopSize;
+			onsetStrength.push_back(std::sqrt((hopEnergy[(size_t)h] + hopEnergy[(size_t)h + 1]) / windowSize));
+		}
+
+		if (envelope != nullptr)
+			*envelope = onsetStrength;
+
+		std::vector<int> onsets;
+		for (int i = 1; i + 1 < (int)onsetStrength.size(); ++i)
+		{
+			if (onsetStrength[i] > threshold &&
+				onsetStrength[i] > onsetStrength[i - 1] &&
+				onsetStrength[i] > onsetStrength[i + 1])
 			{
-				return 0.0f;
+				onsets.push_back(i);
 			}
+		}
 
-			std::sort(intervals.begin(), intervals.end());
-			float medianBPM = intervals[intervals.size() / 2];
+		if (onsets.size() < 4)
+		{
+			return 0.0f;
+		}
 
-			if (medianBPM >= 30.0f && medianBPM <= 300.0f)
+		std::vector<float> intervals;
+		for (size_t i = 1; i < onsets.size(); ++i)
+		{
+			float intervalSeconds = (onsets[i] - onsets[i - 1]) * hopSize / (float)sampleRate;
+			if (intervalSeconds > 0.2f && intervalSeconds < 2.0f)
 			{
-				return medianBPM;
+				intervals.push_back(60.0f / intervalSeconds);
 			}
+		}
 
+		if (intervals.empty())
+		{
 			return 0.0f;
 		}
-		catch (const std::exception & /*e*/)
+
+		std::sort(intervals.begin(), intervals.end());
+		float medianBPM = intervals[intervals.size() / 2];
+
+		int consistent = 0;
+		for (float interval : intervals)
 		{
-			return 0.0f;
+			if (std::abs(interval - medianBPM) <= medianBPM * 0.05f)
+				++consistent;
 		}
+		consistency = (float)consistent / (float)intervals.size();
+
+		return isValidBPM(medianBPM) ? medianBPM : 0.0f;
 	}
 
-	static void timeStretchBuffer(juce::AudioBuffer<float> &buffer,
-								  double ratio, double sampleRate)
+	static bool timeStretchBuffer(juce::AudioBuffer<float> &buffer,
+								  double ratio, double sampleRate,
+								  const std::function<bool()> &shouldCancel = nullptr,
+								  const std::function<void(float)> &progress = nullptr)
 	{
 		if (ratio == 1.0 || buffer.getNumSamples() == 0)
-			return;
+			return true;
 
 		try
 		{
+			const int numChannels = std::min(2, buffer.getNumChannels());
+			const int totalSamples = buffer.getNumSamples();
+			const int chunkSize = 16384;
+
 			soundtouch::SoundTouch soundTouch;
 			soundTouch.setSampleRate((int)sampleRate);
-			soundTouch.setChannels(buffer.getNumChannels());
+			soundTouch.setChannels(numChannels);
 			soundTouch.setTempoChange((ratio - 1.0) * 100.0);
 
-			if (buffer.getNumChannels() == 1)
-			{
-				soundTouch.putSamples(buffer.getReadPointer(0), buffer.getNumSamples());
-			}
-			else
+			std::vector<float> interleavedInput((size_t)chunkSize * numChannels);
+
+			for (int start = 0; start < totalSamples; start += chunkSize)
 			{
-				std::vector<float> interleavedInput;
-				interleavedInput.reserve(buffer.getNumSamples() * 2);
+				if (shouldCancel && shouldCancel())
+					return false;
 
-				for (int i = 0; i < buffer.getNumSamples(); ++i)
+				const int count = std::min(chunkSize, totalSamples - start);
+				if (numChannels == 1)
+				{
+					soundTouch.putSamples(buffer.getReadPointer(0, start), count);
+				}
+				else
 				{
-					interleavedInput.push_back(buffer.getSample(0, i));
-					interleavedInput.push_back(buffer.getSample(1, i));
+					const float *left = buffer.getReadPointer(0, start);
+					const float *right = buffer.getReadPointer(1, start);
+					for (int i = 0; i < count; ++i)
+					{
+						interleavedInput[(size_t)i * 2] = left[i];
+						interleavedInput[(size_t)i * 2 + 1] = right[i];
+					}
+					soundTouch.putSamples(interleavedInput.data(), count);
 				}
 
-				soundTouch.putSamples(interleavedInput.data(), buffer.getNumSamples());
+				if (progress)
+					progress(0.9f * (float)(start + count) / (float)totalSamples);
 			}
 
 			soundTouch.flush();
@@ -207,28 +305,38 @@ public:
 			int outputSamples = soundTouch.numSamples();
 			if (outputSamples > 0)
 			{
+				if (shouldCancel && shouldCancel())
+					return false;
+
 				buffer.setSize(buffer.getNumChannels(), outputSamples, false, false, true);
 
-				if (buffer.getNumChannels() == 1)
+				if (numChannels == 1)
 				{
 					soundTouch.receiveSamples(buffer.getWritePointer(0), outputSamples);
 				}
 				else
 				{
-					std::vector<float> interleavedOutput(outputSamples * 2);
+					std::vector<float> interleavedOutput((size_t)outputSamples * 2);
 					soundTouch.receiveSamples(interleavedOutput.data(), outputSamples);
 
+					float *left = buffer.getWritePointer(0);
+					float *right = buffer.getWritePointer(1);
 					for (int i = 0; i < outputSamples; ++i)
 					{
-						buffer.setSample(0, i, interleavedOutput[i * 2]);
-						buffer.setSample(1, i, interleavedOutput[i * 2 + 1]);
+						left[i] = interleavedOutput[(size_t)i * 2];
+						right[i] = interleavedOutput[(size_t)i * 2 + 1];
 					}
 				}
 			}
+
+			if (progress)
+				progress(1.0f);
+			return true;
 		}
 		catch (const std::exception &e)
 		{
 			std::cout << "Error: " << e.what() << std::endl;
+			return false;
 		}
 	}
 };
\ No newline at end of file
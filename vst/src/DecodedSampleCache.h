@@ -0,0 +1,144 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <list>
+#include <memory>
+
+/*
+	A sample file decoded to stereo at its own rate. Immutable once decoded,
+	so every track loading it copies from the same buffer.
+*/
+struct DecodedSample
+{
+	juce::AudioBuffer<float> audio;
+	double sampleRate = 0.0;
+
+	size_t getSizeInBytes() const
+	{
+		return sizeof(float) * static_cast<size_t>(audio.getNumChannels()) * static_cast<size_t>(audio.getNumSamples());
+	}
+};
+
+/*
+	Short-lived decodes of bank samples, so instances loading the same file
+	at about the same time decode it once. Tracks copy what they need into
+	their own staging buffers, so this saves decode time, not resident
+	memory: an entry is dropped once it has gone unused for entryLifetimeMs,
+	and the whole set stays under budgetBytes in the meantime.
+
+	Entries are keyed by path, size and modification time, so an edited file
+	is decoded again. Decoding happens outside the lock; when two loaders race
+	on the same file, the first one to finish wins and both share its buffer.
+*/
+class DecodedSampleCache
+{
+public:
+	static constexpr size_t defaultBudgetBytes = 128u * 1024u * 1024u;
+	static constexpr juce::uint32 entryLifetimeMs = 30000;
+
+	/** Returns nullptr if the file cannot be read. Job threads only; decoding can take a while. */
+	std::shared_ptr<const DecodedSample> getOrDecode(const juce::File& file)
+	{
+		const auto key = makeKey(file);
+		if (auto sample = find(key))
+			return sample;
+
+		auto decoded = decode(file);
+		if (!decoded)
+			return nullptr;
+
+		juce::ScopedLock lock(cacheLock);
+		if (auto existing = find(key))
+			return existing;
+
+		totalBytes += decoded->getSizeInBytes();
+		entries.push_front({ key, decoded, juce::Time::getMillisecondCounter() });
+
+		// Always keep the newest sample, even if it alone exceeds the budget.
+		while (totalBytes > budgetBytes && entries.size() > 1)
+		{
+			totalBytes -= entries.back().sample->getSizeInBytes();
+			entries.pop_back();
+		}
+		return decoded;
+	}
+
+	/** Any thread; cheap when nothing has expired. */
+	void releaseExpired()
+	{
+		const auto now = juce::Time::getMillisecondCounter();
+		juce::ScopedLock lock(cacheLock);
+		// Most recently used first, so expired entries are all at the back.
+		while (!entries.empty() && now - entries.back().lastUsedMs > entryLifetimeMs)
+		{
+			totalBytes -= entries.back().sample->getSizeInBytes();
+			entries.pop_back();
+		}
+	}
+
+	void clear()
+	{
+		juce::ScopedLock lock(cacheLock);
+		entries.clear();
+		totalBytes = 0;
+	}
+
+private:
+	struct Entry
+	{
+		juce::String key;
+		std::shared_ptr<const DecodedSample> sample;
+		juce::uint32 lastUsedMs = 0;
+	};
+
+	static juce::String makeKey(const juce::File& file)
+	{
+		return file.getFullPathName() + "|" + juce::String(file.getSize()) + "|"
+			+ juce::String(file.getLastModificationTime().toMilliseconds());
+	}
+
+	std::shared_ptr<const DecodedSample> find(const juce::String& key)
+	{
+		juce::ScopedLock lock(cacheLock);
+		for (auto it = entries.begin(); it != entries.end(); ++it)
+		{
+			if (it->key == key)
+			{
+				it->lastUsedMs = juce::Time::getMillisecondCounter();
+				entries.splice(entries.begin(), entries, it);
+				return entries.front().sample;
+			}
+		}
+		return nullptr;
+	}
+
+	static std::shared_ptr<const DecodedSample> decode(const juce::File& file)
+	{
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
+		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+		if (!reader || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+			return nullptr;
+
+		const int numSamples = static_cast<int>(reader->lengthInSamples);
+		auto sample = std::make_shared<DecodedSample>();
+		sample->audio.setSize(2, numSamples);
+		sample->audio.clear();
+		reader->read(&sample->audio, 0, numSamples, 0, true, true);
+		if (reader->numChannels == 1)
+			sample->audio.copyFrom(1, 0, sample->audio, 0, 0, numSamples);
+		sample->sampleRate = reader->sampleRate;
+		return sample;
+	}
+
+	juce::CriticalSection cacheLock;
+	std::list<Entry> entries;
+	size_t totalBytes = 0;
+	size_t budgetBytes = defaultBudgetBytes;
+};
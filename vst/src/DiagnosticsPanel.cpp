@@ -0,0 +1,183 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "DiagnosticsPanel.h"
+#include "PluginProcessor.h"
+#include "ColourPalette.h"
+
+DiagnosticsPanel::DiagnosticsPanel(DjIaVstProcessor& processor)
+	: audioProcessor(processor)
+{
+	addAndMakeVisible(resetButton);
+	resetButton.setButtonText("Reset");
+	resetButton.setColour(juce::TextButton::buttonColourId, ColourPalette::buttonSecondary);
+	resetButton.setColour(juce::TextButton::textColourOffId, ColourPalette::textPrimary);
+	resetButton.setTooltip("Start a new measurement window");
+	resetButton.onClick = [this]() { resetWindow(); };
+	resetWindow();
+}
+
+DiagnosticsPanel::~DiagnosticsPanel()
+{
+	stopTimer();
+}
+
+void DiagnosticsPanel::visibilityChanged()
+{
+	if (isVisible())
+	{
+		resetWindow();
+		startTimerHz(10);
+	}
+	else
+	{
+		stopTimer();
+	}
+}
+
+void DiagnosticsPanel::resetWindow()
+{
+	auto& profiler = audioProcessor.getStageProfiler();
+	for (int stage = 0; stage < StageProfiler::numStages; ++stage)
+	{
+		auto& histogram = profiler.getStage(static_cast<StageProfiler::Stage>(stage));
+		stageBaselines[static_cast<size_t>(stage)] = histogram.getSnapshot();
+		histogram.takePeak();
+	}
+	for (int slot = 0; slot < SlotParameters::maxSlots; ++slot)
+	{
+		auto& histogram = profiler.getSlot(slot);
+		slotBaselines[static_cast<size_t>(slot)] = histogram.getSnapshot();
+		histogram.takePeak();
+	}
+	stagePeaks.fill(0.0);
+	slotPeaks.fill(0.0);
+	overrunBaseline = profiler.getOverruns();
+	droppedEventsBaseline = audioProcessor.getDroppedScheduledEvents();
+	profiler.takePeakLoad();
+	peakLoad = 0.0f;
+	timerCallback();
+}
+
+DiagnosticsPanel::Row DiagnosticsPanel::makeRow(const juce::String& name, StageHistogram& histogram,
+	const StageHistogram::Snapshot& baseline, double& peak)
+{
+	const auto window = histogram.getSnapshot() - baseline;
+	peak = std::max(peak, histogram.takePeak());
+
+	Row row;
+	row.name = name;
+	row.calls = window.getTotal();
+	row.p50 = window.getPercentile(0.5);
+	row.p99 = window.getPercentile(0.99);
+	row.max = peak;
+	return row;
+}
+
+void DiagnosticsPanel::timerCallback()
+{
+	auto& profiler = audioProcessor.getStageProfiler();
+	lastLoad = profiler.getLastLoad();
+	peakLoad = std::max(peakLoad, profiler.takePeakLoad());
+	deadlineMicroseconds = profiler.getDeadlineMicroseconds();
+	droppedEvents = audioProcessor.getDroppedScheduledEvents() - droppedEventsBaseline;
+
+	rows.clear();
+	for (int stage = 0; stage < StageProfiler::numStages; ++stage)
+	{
+		rows.push_back(makeRow(StageProfiler::getStageName(stage), profiler.getStage(static_cast<StageProfiler::Stage>(stage)),
+			stageBaselines[static_cast<size_t>(stage)], stagePeaks[static_cast<size_t>(stage)]));
+	}
+
+	const auto slotNames = audioProcessor.getSlotTrackNames();
+	for (int slot = 0; slot < SlotParameters::maxSlots; ++slot)
+	{
+		auto row = makeRow("Slot " + juce::String(slot + 1), profiler.getSlot(slot),
+			slotBaselines[static_cast<size_t>(slot)], slotPeaks[static_cast<size_t>(slot)]);
+		if (row.calls == 0)
+			continue;
+		if (slot < slotNames.size() && slotNames[slot].isNotEmpty())
+			row.name << " " << slotNames[slot];
+		rows.push_back(row);
+	}
+	repaint();
+}
+
+juce::String DiagnosticsPanel::formatTime(double microseconds)
+{
+	if (microseconds >= 1000.0)
+		return juce::String(microseconds / 1000.0, 2) + " ms";
+	return juce::String(juce::roundToInt(microseconds)) + " us";
+}
+
+void DiagnosticsPanel::paint(juce::Graphics& g)
+{
+	g.fillAll(ColourPalette::backgroundDeep.withAlpha(0.95f));
+	g.setColour(ColourPalette::backgroundLight);
+	g.drawRect(getLocalBounds(), 1);
+
+	auto area = getLocalBounds().reduced(10);
+	auto header = area.removeFromTop(24);
+	g.setColour(ColourPalette::textPrimary);
+	g.setFont(juce::FontOptions(15.0f, juce::Font::bold));
+	g.drawText("DSP Diagnostics", header, juce::Justification::centredLeft);
+
+	// Load bar: the block deadline is full width, the tick marks the peak.
+	area.removeFromTop(6);
+	auto loadBar = area.removeFromTop(14).toFloat();
+	g.setColour(ColourPalette::backgroundMid);
+	g.fillRoundedRectangle(loadBar, 3.0f);
+	const auto loadColour = lastLoad > 0.9f ? ColourPalette::vuRed : lastLoad > 0.6f ? ColourPalette::vuOrange : ColourPalette::vuGreen;
+	g.setColour(loadColour);
+	g.fillRoundedRectangle(loadBar.withWidth(loadBar.getWidth() * juce::jlimit(0.0f, 1.0f, lastLoad)), 3.0f);
+	g.setColour(ColourPalette::textPrimary);
+	const float peakX = loadBar.getX() + loadBar.getWidth() * juce::jlimit(0.0f, 1.0f, peakLoad);
+	g.drawVerticalLine(juce::roundToInt(peakX), loadBar.getY(), loadBar.getBottom());
+
+	area.removeFromTop(4);
+	g.setFont(juce::FontOptions(12.0f));
+	const auto overruns = audioProcessor.getStageProfiler().getOverruns() - overrunBaseline;
+	g.drawText("Load " + juce::String(juce::roundToInt(lastLoad * 100.0f)) + "%, peak "
+		+ juce::String(juce::roundToInt(peakLoad * 100.0f)) + "% of a " + formatTime(deadlineMicroseconds) + " buffer",
+		area.removeFromTop(18), juce::Justification::centredLeft);
+	g.setColour(overruns > 0 ? ColourPalette::textDanger : ColourPalette::textSecondary);
+	g.drawText(juce::String(overruns) + (overruns == 1 ? " overrun" : " overruns") + " (blocks longer than their buffer)",
+		area.removeFromTop(18), juce::Justification::centredLeft);
+	g.setColour(droppedEvents > 0 ? ColourPalette::textWarning : ColourPalette::textSecondary);
+	g.drawText(juce::String(droppedEvents) + " transport events without their sample offset (over "
+		+ juce::String(TrackData::maxScheduledEvents) + " in one block)",
+		area.removeFromTop(18), juce::Justification::centredLeft);
+
+	area.removeFromTop(8);
+	const int nameWidth = area.getWidth() - 4 * 64;
+	auto drawRow = [&](const juce::String& name, const juce::String& p50, const juce::String& p99,
+		const juce::String& max, const juce::String& calls)
+		{
+			auto line = area.removeFromTop(17);
+			g.drawText(name, line.removeFromLeft(nameWidth), juce::Justification::centredLeft, true);
+			g.drawText(p50, line.removeFromLeft(64), juce::Justification::centredRight);
+			g.drawText(p99, line.removeFromLeft(64), juce::Justification::centredRight);
+			g.drawText(max, line.removeFromLeft(64), juce::Justification::centredRight);
+			g.drawText(calls, line.removeFromLeft(64), juce::Justification::centredRight);
+		};
+
+	g.setColour(ColourPalette::textAccent);
+	drawRow("Stage", "p50", "p99", "max", "calls");
+	for (const auto& row : rows)
+	{
+		if (area.getHeight() < 17)
+			break;
+		const bool overDeadline = deadlineMicroseconds > 0.0 && row.max > deadlineMicroseconds;
+		g.setColour(overDeadline ? ColourPalette::textWarning : ColourPalette::textPrimary);
+		drawRow(row.name, formatTime(row.p50), formatTime(row.p99), formatTime(row.max), juce::String(row.calls));
+	}
+}
+
+void DiagnosticsPanel::resized()
+{
+	resetButton.setBounds(getLocalBounds().reduced(10).removeFromTop(24).removeFromRight(70));
+}
@@ -0,0 +1,63 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "StageProfiler.h"
+#include <array>
+#include <vector>
+
+class DjIaVstProcessor;
+
+/*
+	Shows the processor's StageProfiler: DSP load against the buffer
+	deadline, the overrun and dropped-event counts and p50/p99/max per
+	stage and per slot.
+	Figures cover the window since the panel opened or Reset was pressed.
+*/
+class DiagnosticsPanel : public juce::Component, private juce::Timer
+{
+public:
+	explicit DiagnosticsPanel(DjIaVstProcessor& processor);
+	~DiagnosticsPanel() override;
+
+	void paint(juce::Graphics& g) override;
+	void resized() override;
+	void visibilityChanged() override;
+
+private:
+	struct Row
+	{
+		juce::String name;
+		double p50 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		juce::uint64 calls = 0;
+	};
+
+	void timerCallback() override;
+	void resetWindow();
+	Row makeRow(const juce::String& name, StageHistogram& histogram, const StageHistogram::Snapshot& baseline, double& peak);
+	static juce::String formatTime(double microseconds);
+
+	DjIaVstProcessor& audioProcessor;
+	juce::TextButton resetButton;
+
+	std::array<StageHistogram::Snapshot, StageProfiler::numStages> stageBaselines;
+	std::array<StageHistogram::Snapshot, SlotParameters::maxSlots> slotBaselines;
+	std::array<double, StageProfiler::numStages> stagePeaks{};
+	std::array<double, SlotParameters::maxSlots> slotPeaks{};
+	juce::uint32 overrunBaseline = 0;
+	juce::uint32 droppedEventsBaseline = 0;
+	juce::uint32 droppedEvents = 0;
+	float lastLoad = 0.0f;
+	float peakLoad = 0.0f;
+	double deadlineMicroseconds = 0.0;
+	std::vector<Row> rows;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiagnosticsPanel)
+};
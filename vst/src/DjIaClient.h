@@ -7,6 +7,10 @@
 
 #pragma once
 #include "./JuceHeader.h"
+#include "StreamingWavDecoder.h"
+#include <atomic>
+#include <functional>
+#include <memory>
 
 class DjIaClient
 {
@@ -18,6 +22,7 @@ public:
 		float bpm;
 		juce::String key;
 		std::vector<juce::String> preferredStems;
+		int seed = -1;
 
 		LoopRequest()
 			: prompt(""),
@@ -29,9 +34,35 @@ public:
 		}
 	};
 
+	struct DecodedAudio
+	{
+		juce::AudioBuffer<float> buffer;
+		double sampleRate = 0.0;
+		float detectedBpm = 0.0f;
+		bool isPreview = false;
+	};
+
+	/*
+		Decode the WAV body in memory while it downloads instead of going
+		through a temporary file. onProgress runs on the requesting thread
+		after every chunk with everything decoded so far.
+
+		progressive asks the streaming endpoint to send audio as it is
+		generated (chunked WAV with an open-ended data chunk). A server
+		that answers 404 or 405 there is remembered as not streaming, so
+		later requests go straight to the regular endpoint until the
+		base URL changes.
+	*/
+	struct StreamOptions
+	{
+		std::function<void(const juce::AudioBuffer<float> &decoded, int numFrames, double sampleRate)> onProgress;
+		bool progressive = false;
+	};
+
 	struct LoopResponse
 	{
 		juce::File audioData;
+		std::shared_ptr<DecodedAudio> decodedAudio;
 		float duration;
 		float bpm;
 		juce::String key;
@@ -41,6 +72,10 @@ public:
 		bool isUnlimitedKey = false;
 		int totalCredits = -1;
 		int usedCredits = -1;
+		juce::String audioFormat = "wav";
+		juce::int64 bytesReceived = 0;
+		double serverTimeMs = 0.0;
+		double transferTimeMs = 0.0;
 
 		LoopResponse()
 			: duration(0.0f), bpm(120.0f)
@@ -59,6 +94,19 @@ public:
 		DBG("DjIaClient: API key updated");
 	}
 
+	/*
+		Ask the server for FLAC instead of 16-bit WAV. The server encodes
+		FLAC when the request's audio_format asks for it; a server that
+		predates that field still answers with WAV, which is decoded as
+		before.
+	*/
+	void setPreferCompressedAudio(bool shouldPrefer)
+	{
+		preferCompressedAudio = shouldPrefer;
+	}
+
+	bool getPreferCompressedAudio() const { return preferCompressedAudio.load(); }
+
 	void setBaseUrl(const juce::String &newBaseUrl)
 	{
 		if (newBaseUrl.endsWith("/"))
@@ -69,10 +117,12 @@ public:
 		{
 			baseUrl = newBaseUrl + "/api/v1";
 		}
+		streamingEndpoint = EndpointSupport::unknown;
 		DBG("DjIaClient: Base URL updated to: " + baseUrl);
 	}
 
-	LoopResponse generateLoop(const LoopRequest &request, double sampleRate, int requestTimeoutMS)
+	LoopResponse generateLoop(const LoopRequest &request, double sampleRate, int requestTimeoutMS,
+							  const StreamOptions *streaming = nullptr)
 	{
 		try
 		{
@@ -87,6 +137,21 @@ public:
 			jsonRequest.getDynamicObject()->setProperty("key", request.key);
 			jsonRequest.getDynamicObject()->setProperty("sample_rate", sampleRate);
 			jsonRequest.getDynamicObject()->setProperty("generation_duration", request.generationDuration);
+			if (request.seed >= 0)
+			{
+				jsonRequest.getDynamicObject()->setProperty("seed", request.seed);
+			}
+			const bool progressive = streaming != nullptr && streaming->progressive &&
+				streamingEndpoint.load() != EndpointSupport::unavailable;
+			const bool wantsFlac = preferCompressedAudio.load() && !progressive;
+			if (progressive)
+			{
+				jsonRequest.getDynamicObject()->setProperty("stream", true);
+			}
+			if (wantsFlac)
+			{
+				jsonRequest.getDynamicObject()->setProperty("audio_format", "flac");
+			}
 
 			if (!request.preferredStems.empty())
 			{
@@ -99,6 +164,7 @@ public:
 			auto jsonString = juce::JSON::toString(jsonRequest);
 
 			juce::String headerString = "Content-Type: application/json\n";
+			headerString += wantsFlac ? "Accept: audio/flac, audio/wav;q=0.5\n" : "Accept: audio/wav\n";
 			if (apiKey.isNotEmpty())
 			{
 				headerString += "X-API-Key: " + apiKey + "\n";
@@ -116,7 +182,7 @@ public:
 			}
 			int statusCode = 0;
 			juce::StringPairArray responseHeaders;
-			auto url = juce::URL(baseUrl + "/generate")
+			auto url = juce::URL(baseUrl + (progressive ? "/generate/stream" : "/generate"))
 						   .withPOSTData(jsonString);
 			auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inPostData)
 							   .withStatusCode(&statusCode)
@@ -124,6 +190,7 @@ public:
 							   .withExtraHeaders(headerString)
 							   .withConnectionTimeoutMs(requestTimeoutMS);
 
+			const double requestStart = juce::Time::getMillisecondCounterHiRes();
 			auto response = url.createInputStream(options);
 			if (!response)
 			{
@@ -135,6 +202,15 @@ public:
 
 			DBG("HTTP Status Code: " + juce::String(statusCode));
 
+			if (progressive && (statusCode == 404 || statusCode == 405))
+			{
+				DBG("Streaming endpoint unavailable, using regular generation");
+				streamingEndpoint = EndpointSupport::unavailable;
+				StreamOptions fallback = *streaming;
+				fallback.progressive = false;
+				return generateLoop(request, sampleRate, requestTimeoutMS, &fallback);
+			}
+
 			if (statusCode == 403)
 			{
 				DBG("ERROR: HTTP 403 Forbidden");
@@ -165,6 +241,8 @@ public:
 				DBG("ERROR: HTTP " + juce::String(statusCode));
 				throw std::runtime_error("HTTP Error " + std::to_string(statusCode) + ": Request failed.");
 			}
+			if (progressive)
+				streamingEndpoint = EndpointSupport::available;
 
 			if (response->isExhausted())
 			{
@@ -173,17 +251,37 @@ public:
 			}
 
 			LoopResponse result;
-			result.audioData = juce::File::createTempFile(".wav");
-			juce::FileOutputStream stream(result.audioData);
-			if (stream.openedOk())
+			const double bodyStart = juce::Time::getMillisecondCounterHiRes();
+			result.serverTimeMs = bodyStart - requestStart;
+			result.audioFormat = responseHeaders["Content-Type"].containsIgnoreCase("flac") ? "flac" : "wav";
+
+			juce::MemoryBlock undecodedBytes;
+			if (streaming != nullptr && result.audioFormat == "flac")
 			{
-				stream.writeFromInputStream(*response, response->getTotalLength());
+				result.bytesReceived = static_cast<juce::int64>(response->readIntoMemoryBlock(undecodedBytes));
+				result.decodedAudio = decodeCompressedBody(undecodedBytes);
 			}
-			else
+			else if (streaming != nullptr)
+			{
+				result.decodedAudio = decodeResponseStream(*response, *streaming, undecodedBytes, result.bytesReceived);
+			}
+
+			if (result.decodedAudio == nullptr)
 			{
-				DBG("ERROR: Cannot create temp file");
-				throw std::runtime_error("Cannot create temporary file for audio data.");
+				result.audioData = juce::File::createTempFile("." + result.audioFormat);
+				juce::FileOutputStream stream(result.audioData);
+				if (stream.openedOk())
+				{
+					stream.write(undecodedBytes.getData(), undecodedBytes.getSize());
+					result.bytesReceived += stream.writeFromInputStream(*response, streaming != nullptr ? -1 : response->getTotalLength());
+				}
+				else
+				{
+					DBG("ERROR: Cannot create temp file");
+					throw std::runtime_error("Cannot create temporary file for audio data.");
+				}
 			}
+			result.transferTimeMs = juce::Time::getMillisecondCounterHiRes() - bodyStart;
 			result.duration = request.generationDuration;
 			result.bpm = bpm;
 			result.key = request.key;
@@ -204,8 +302,18 @@ public:
 				}
 			}
 
-			DBG("WAV file created: " + result.audioData.getFullPathName() +
-				" (" + juce::String(result.audioData.getSize()) + " bytes)");
+			DBG("Transfer: " + juce::String(result.bytesReceived) + " bytes of " + result.audioFormat +
+				" in " + juce::String(result.transferTimeMs, 1) + " ms (server " + juce::String(result.serverTimeMs, 1) + " ms)");
+
+			if (result.decodedAudio != nullptr)
+			{
+				DBG("Audio decoded in memory: " + juce::String(result.decodedAudio->buffer.getNumSamples()) + " frames");
+			}
+			else
+			{
+				DBG("WAV file created: " + result.audioData.getFullPathName() +
+					" (" + juce::String(result.audioData.getSize()) + " bytes)");
+			}
 
 			return result;
 		}
@@ -219,6 +327,90 @@ public:
 	}
 
 private:
+	static constexpr int streamChunkSize = 64 * 1024;
+
+	/*
+		Returns nullptr when the body is not a WAV this decoder handles; the
+		bytes read up to that point are left in undecodedBytes so the caller
+		can still write the complete body to a file.
+	*/
+	static std::shared_ptr<DecodedAudio> decodeResponseStream(juce::InputStream &input, const StreamOptions &options,
+															  juce::MemoryBlock &undecodedBytes, juce::int64 &bytesReceived)
+	{
+		StreamingWavDecoder decoder;
+		juce::HeapBlock<char> chunk(streamChunkSize);
+
+		for (;;)
+		{
+			const int bytesRead = input.read(chunk, streamChunkSize);
+			if (bytesRead <= 0)
+				break;
+			bytesReceived += bytesRead;
+
+			if (!decoder.hasFormat())
+				undecodedBytes.append(chunk, static_cast<size_t>(bytesRead));
+
+			if (!decoder.write(chunk, static_cast<size_t>(bytesRead)))
+			{
+				DBG("Streaming decode unavailable: " + decoder.getError());
+				return nullptr;
+			}
+
+			if (decoder.hasFormat())
+			{
+				undecodedBytes.reset();
+				if (options.onProgress)
+					options.onProgress(decoder.getBuffer(), decoder.getNumFrames(), decoder.getSampleRate());
+			}
+		}
+
+		if (decoder.getNumFrames() == 0)
+			return nullptr;
+
+		decoder.finish();
+		auto audio = std::make_shared<DecodedAudio>();
+		std::swap(audio->buffer, decoder.getBuffer());
+		audio->sampleRate = decoder.getSampleRate();
+		return audio;
+	}
+
+	/*
+		Compressed bodies cannot be decoded incrementally, so the whole body
+		is read first and decoded here on the generation worker thread.
+		Returns nullptr when the format is not available in this build.
+	*/
+	static std::shared_ptr<DecodedAudio> decodeCompressedBody(const juce::MemoryBlock &body)
+	{
+		juce::FlacAudioFormat flacFormat;
+		std::unique_ptr<juce::AudioFormatReader> reader(
+			flacFormat.createReaderFor(new juce::MemoryInputStream(body, false), true));
+		if (!reader || reader->lengthInSamples <= 0)
+		{
+			DBG("FLAC decode unavailable, falling back to file");
+			return nullptr;
+		}
+
+		auto audio = std::make_shared<DecodedAudio>();
+		const int numFrames = static_cast<int>(reader->lengthInSamples);
+		audio->buffer.setSize(2, numFrames);
+		reader->read(&audio->buffer, 0, numFrames, 0, true, true);
+		if (reader->numChannels == 1)
+		{
+			audio->buffer.copyFrom(1, 0, audio->buffer, 0, 0, numFrames);
+		}
+		audio->sampleRate = reader->sampleRate;
+		return audio;
+	}
+
 	juce::String apiKey;
 	juce::String baseUrl;
+	std::atomic<bool> preferCompressedAudio{ true };
+
+	enum class EndpointSupport
+	{
+		unknown,
+		available,
+		unavailable
+	};
+	std::atomic<EndpointSupport> streamingEndpoint{ EndpointSupport::unknown };
 };
\ No newline at end of file
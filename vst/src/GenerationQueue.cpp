@@ -0,0 +1,308 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "GenerationQueue.h"
+#include <algorithm>
+
+GenerationQueue::GenerationQueue(RunFunction runFunction)
+	: run(std::move(runFunction))
+{
+	ensureWorkers(limits[0] + limits[1]);
+}
+
+GenerationQueue::~GenerationQueue()
+{
+	stop();
+}
+
+bool GenerationQueue::submit(const juce::String& trackId, const DjIaClient::LoopRequest& loopRequest, Backend backend)
+{
+	if (stopping.load())
+		return false;
+
+	{
+		juce::ScopedLock lock(queueLock);
+		if (isActive(trackId))
+			return false;
+
+		removeQueuedSpeculative(trackId);
+
+		Request request;
+		request.trackId = trackId;
+		request.loopRequest = loopRequest;
+		request.backend = backend;
+		queuedRequests.push_back(std::move(request));
+		statuses[trackId] = Status::Queued;
+		++numActive;
+	}
+
+	DBG("Generation queued for track " << trackId);
+	notifyStatusChanged();
+	requestAvailable.signal();
+	return true;
+}
+
+bool GenerationQueue::submitSpeculative(const juce::String& trackId, const DjIaClient::LoopRequest& loopRequest, Backend backend)
+{
+	if (stopping.load())
+		return false;
+
+	juce::ScopedLock lock(queueLock);
+	if (isActive(trackId) || speculativeTrackIds.contains(trackId))
+		return false;
+
+	Request request;
+	request.trackId = trackId;
+	request.loopRequest = loopRequest;
+	request.backend = backend;
+	request.speculative = true;
+	queuedRequests.push_back(std::move(request));
+	speculativeTrackIds.add(trackId);
+	DBG("Speculative generation queued for track " << trackId);
+	requestAvailable.signal();
+	return true;
+}
+
+void GenerationQueue::cancelSpeculative()
+{
+	juce::ScopedLock lock(queueLock);
+	for (auto it = queuedRequests.begin(); it != queuedRequests.end();)
+	{
+		if (it->speculative)
+		{
+			speculativeTrackIds.removeString(it->trackId);
+			it = queuedRequests.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+int GenerationQueue::getNumSpeculative() const
+{
+	juce::ScopedLock lock(queueLock);
+	return speculativeTrackIds.size();
+}
+
+void GenerationQueue::removeQueuedSpeculative(const juce::String& trackId)
+{
+	auto it = std::find_if(queuedRequests.begin(), queuedRequests.end(),
+		[&trackId](const Request& request) { return request.speculative && request.trackId == trackId; });
+	if (it != queuedRequests.end())
+	{
+		queuedRequests.erase(it);
+		speculativeTrackIds.removeString(trackId);
+	}
+}
+
+int GenerationQueue::countQueuedRegular() const
+{
+	return static_cast<int>(std::count_if(queuedRequests.begin(), queuedRequests.end(),
+		[](const Request& request) { return !request.speculative; }));
+}
+
+void GenerationQueue::cancelQueued(const juce::String& trackId)
+{
+	{
+		juce::ScopedLock lock(queueLock);
+		auto it = std::find_if(queuedRequests.begin(), queuedRequests.end(),
+			[&trackId](const Request& request) { return !request.speculative && request.trackId == trackId; });
+		if (it == queuedRequests.end())
+			return;
+
+		queuedRequests.erase(it);
+		statuses.erase(trackId);
+		--numActive;
+	}
+	notifyStatusChanged();
+}
+
+void GenerationQueue::cancelAllQueued()
+{
+	{
+		juce::ScopedLock lock(queueLock);
+		for (const auto& request : queuedRequests)
+		{
+			if (request.speculative)
+				speculativeTrackIds.removeString(request.trackId);
+			else
+				statuses.erase(request.trackId);
+		}
+		numActive -= countQueuedRegular();
+		queuedRequests.clear();
+	}
+	notifyStatusChanged();
+}
+
+void GenerationQueue::stop()
+{
+	if (stopping.exchange(true))
+		return;
+
+	{
+		juce::ScopedLock lock(queueLock);
+		numActive -= countQueuedRegular();
+		queuedRequests.clear();
+	}
+	for (auto& worker : workers)
+	{
+		worker->signalThreadShouldExit();
+	}
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		requestAvailable.signal();
+	}
+	for (auto& worker : workers)
+	{
+		worker->stopThread(10000);
+	}
+	workers.clear();
+}
+
+GenerationQueue::Status GenerationQueue::getStatus(const juce::String& trackId) const
+{
+	juce::ScopedLock lock(queueLock);
+	auto it = statuses.find(trackId);
+	return it != statuses.end() ? it->second : Status::Idle;
+}
+
+bool GenerationQueue::isActive(const juce::String& trackId) const
+{
+	const Status status = getStatus(trackId);
+	return status == Status::Queued || status == Status::Running;
+}
+
+juce::StringArray GenerationQueue::getActiveTrackIds() const
+{
+	juce::ScopedLock lock(queueLock);
+	juce::StringArray trackIds;
+	for (const auto& entry : statuses)
+	{
+		if (entry.second == Status::Queued || entry.second == Status::Running)
+			trackIds.add(entry.first);
+	}
+	return trackIds;
+}
+
+void GenerationQueue::setMaxConcurrent(Backend backend, int maxRequests)
+{
+	{
+		juce::ScopedLock lock(queueLock);
+		limits[static_cast<size_t>(backend)] = juce::jlimit(1, maxConcurrency, maxRequests);
+		ensureWorkers(limits[0] + limits[1]);
+	}
+	DBG("Generation concurrency: server " << limits[0] << ", local " << limits[1]);
+	requestAvailable.signal();
+}
+
+int GenerationQueue::getMaxConcurrent(Backend backend) const
+{
+	juce::ScopedLock lock(queueLock);
+	return limits[static_cast<size_t>(backend)];
+}
+
+void GenerationQueue::ensureWorkers(int count)
+{
+	if (stopping.load())
+		return;
+
+	for (int i = static_cast<int>(workers.size()); i < count; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>(*this, i));
+		workers.back()->startThread(juce::Thread::Priority::low);
+	}
+}
+
+bool GenerationQueue::takeNextRequest(Request& request)
+{
+	{
+		juce::ScopedLock lock(queueLock);
+
+		// A speculative request never takes a backend's last free slot, so a
+		// request the user submits next does not wait behind it.
+		auto isRunnable = [this](const Request& queued)
+			{
+				const auto backend = static_cast<size_t>(queued.backend);
+				const int reserved = queued.speculative ? 1 : 0;
+				return runningPerBackend[backend] + reserved < limits[backend];
+			};
+
+		auto next = std::find_if(queuedRequests.begin(), queuedRequests.end(),
+			[&isRunnable](const Request& queued) { return !queued.speculative && isRunnable(queued); });
+		if (next == queuedRequests.end())
+			next = std::find_if(queuedRequests.begin(), queuedRequests.end(), isRunnable);
+
+		if (next == queuedRequests.end())
+			return false;
+
+		request = std::move(*next);
+		queuedRequests.erase(next);
+		++runningPerBackend[static_cast<size_t>(request.backend)];
+		if (request.speculative)
+			return true;
+		statuses[request.trackId] = Status::Running;
+	}
+
+	notifyStatusChanged();
+	return true;
+}
+
+void GenerationQueue::finishRequest(const Request& request, const Result& result)
+{
+	{
+		juce::ScopedLock lock(queueLock);
+		--runningPerBackend[static_cast<size_t>(request.backend)];
+		if (request.speculative)
+		{
+			speculativeTrackIds.removeString(request.trackId);
+		}
+		else
+		{
+			statuses[request.trackId] = result.success ? Status::Completed : Status::Failed;
+			--numActive;
+		}
+	}
+
+	DBG((request.speculative ? "Speculative generation " : "Generation ") << (result.success ? "completed" : "failed")
+		<< " for track " << request.trackId);
+	if (onRequestFinished)
+		onRequestFinished(request, result);
+	notifyStatusChanged();
+	requestAvailable.signal();
+}
+
+void GenerationQueue::notifyStatusChanged()
+{
+	if (onStatusChanged)
+		onStatusChanged();
+}
+
+void GenerationQueue::Worker::run()
+{
+	while (!threadShouldExit())
+	{
+		Request request;
+		if (!queue.takeNextRequest(request))
+		{
+			queue.requestAvailable.wait(200);
+			continue;
+		}
+
+		Result result;
+		try
+		{
+			result = queue.run(request);
+		}
+		catch (const std::exception& e)
+		{
+			result = Result::failure("ERROR: " + juce::String(e.what()));
+		}
+		queue.finishRequest(request, result);
+	}
+}
@@ -0,0 +1,127 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "DjIaClient.h"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+/*
+	Generation requests keyed by track. Each track holds at most one request
+	at a time; requests wait in submission order and start as soon as their
+	backend is below its concurrency limit, so loops for different tracks
+	are generated side by side and finish independently.
+
+	Speculative requests are background work: they never block or count as
+	a track's own generation, only start when no regular request is waiting
+	for the same backend and a slot would still be left free for one, and
+	are dropped when the track queues a real one.
+*/
+class GenerationQueue
+{
+public:
+	enum class Backend
+	{
+		Server = 0,
+		Local
+	};
+
+	enum class Status
+	{
+		Idle,
+		Queued,
+		Running,
+		Completed,
+		Failed
+	};
+
+	struct Request
+	{
+		juce::String trackId;
+		DjIaClient::LoopRequest loopRequest;
+		Backend backend = Backend::Server;
+		bool speculative = false;
+	};
+
+	struct Result
+	{
+		bool success = false;
+		juce::String message;
+
+		static Result failure(const juce::String& message) { return { false, message }; }
+	};
+
+	using RunFunction = std::function<Result(const Request&)>;
+
+	static constexpr int maxConcurrency = 8;
+
+	explicit GenerationQueue(RunFunction runFunction);
+	~GenerationQueue();
+
+	/** Returns false when the track already has a queued or running request. */
+	bool submit(const juce::String& trackId, const DjIaClient::LoopRequest& loopRequest, Backend backend);
+	/** Returns false when the track is busy or already has a speculative request. */
+	bool submitSpeculative(const juce::String& trackId, const DjIaClient::LoopRequest& loopRequest, Backend backend);
+	void cancelSpeculative();
+	int getNumSpeculative() const;
+	void cancelQueued(const juce::String& trackId);
+	void cancelAllQueued();
+	void stop();
+
+	Status getStatus(const juce::String& trackId) const;
+	bool isActive(const juce::String& trackId) const;
+	bool hasActiveRequests() const { return numActive.load() > 0; }
+	int getNumActive() const { return numActive.load(); }
+	juce::StringArray getActiveTrackIds() const;
+
+	void setMaxConcurrent(Backend backend, int maxRequests);
+	int getMaxConcurrent(Backend backend) const;
+
+	/** Worker thread, after the request's status has been updated. */
+	std::function<void(const Request& request, const Result& result)> onRequestFinished;
+	/** Any thread, whenever a request is queued, started or finished. */
+	std::function<void()> onStatusChanged;
+
+private:
+	class Worker : public juce::Thread
+	{
+	public:
+		Worker(GenerationQueue& owner, int index)
+			: juce::Thread("GenerationWorker" + juce::String(index)), queue(owner) {
+		}
+		void run() override;
+
+	private:
+		GenerationQueue& queue;
+	};
+
+	bool takeNextRequest(Request& request);
+	void finishRequest(const Request& request, const Result& result);
+	void ensureWorkers(int count);
+	void notifyStatusChanged();
+	void removeQueuedSpeculative(const juce::String& trackId);
+	int countQueuedRegular() const;
+
+	RunFunction run;
+	mutable juce::CriticalSection queueLock;
+	std::vector<Request> queuedRequests;
+	std::map<juce::String, Status> statuses;
+	juce::StringArray speculativeTrackIds;
+	std::array<int, 2> runningPerBackend{ { 0, 0 } };
+	std::array<int, 2> limits{ { 4, 1 } };
+	std::atomic<int> numActive{ 0 };
+	juce::WaitableEvent requestAvailable;
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<bool> stopping{ false };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GenerationQueue)
+};
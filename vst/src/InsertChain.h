@@ -0,0 +1,371 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "StereoBiquad.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+/*
+	Per-slot insert effects. Every stage exposes the same prepare / reset /
+	update / process / getTailSamples members and the chain is a tuple of
+	concrete types, so the calls are resolved at compile time and a stage
+	whose update() reports it as bypassed costs a handful of comparisons per
+	block. reset() is cheap enough for the audio thread.
+*/
+namespace InsertChain
+{
+	struct Settings
+	{
+		float eqLowDb = 0.0f;
+		float eqMidDb = 0.0f;
+		float eqHighDb = 0.0f;
+		float filter = 0.0f;
+		float compression = 0.0f;
+		float delaySend = 0.0f;
+		double hostBpm = 126.0;
+	};
+
+	class EqStage
+	{
+	public:
+		void prepare(double newSampleRate, int /*maxBlockSize*/)
+		{
+			sampleRate = newSampleRate;
+			lowDb = midDb = highDb = 0.0f;
+			updateCoefficients();
+			filters.prepare(sampleRate);
+		}
+
+		void reset()
+		{
+			filters.reset();
+		}
+
+		bool update(const Settings& settings)
+		{
+			const bool active = std::abs(settings.eqLowDb) > 0.05f || std::abs(settings.eqMidDb) > 0.05f ||
+				std::abs(settings.eqHighDb) > 0.05f;
+			if (!active)
+			{
+				wasActive = false;
+				return false;
+			}
+
+			if (std::abs(settings.eqLowDb - lowDb) > 0.05f || std::abs(settings.eqMidDb - midDb) > 0.05f ||
+				std::abs(settings.eqHighDb - highDb) > 0.05f)
+			{
+				lowDb = settings.eqLowDb;
+				midDb = settings.eqMidDb;
+				highDb = settings.eqHighDb;
+				updateCoefficients();
+			}
+			if (!wasActive)
+				reset();
+			wasActive = true;
+			return true;
+		}
+
+		void process(float* const* channels, int numChannels, int numSamples) noexcept
+		{
+			filters.process(channels[0], numChannels > 1 ? channels[1] : nullptr, numSamples);
+		}
+
+		int getTailSamples() const noexcept
+		{
+			return wasActive ? static_cast<int>(0.05 * sampleRate) : 0;
+		}
+
+	private:
+		double sampleRate = 48000.0;
+		float lowDb = 0.0f;
+		float midDb = 0.0f;
+		float highDb = 0.0f;
+		bool wasActive = false;
+		StereoBiquadCascade<3> filters;
+
+		void updateCoefficients()
+		{
+			filters.setStage(0, juce::IIRCoefficients::makeLowShelf(sampleRate, 200.0, 0.7, juce::Decibels::decibelsToGain(lowDb)));
+			filters.setStage(1, juce::IIRCoefficients::makePeakFilter(sampleRate, 1000.0, 1.0, juce::Decibels::decibelsToGain(midDb)));
+			filters.setStage(2, juce::IIRCoefficients::makeHighShelf(sampleRate, 8000.0, 0.7, juce::Decibels::decibelsToGain(highDb)));
+		}
+	};
+
+	/* DJ-style single-knob filter: below zero sweeps a low-pass down, above zero a high-pass up. */
+	class FilterStage
+	{
+	public:
+		void prepare(double newSampleRate, int /*maxBlockSize*/)
+		{
+			sampleRate = newSampleRate;
+			position = 0.0f;
+			filter.prepare(sampleRate);
+		}
+
+		void reset()
+		{
+			filter.reset();
+		}
+
+		bool update(const Settings& settings)
+		{
+			const float target = juce::jlimit(-1.0f, 1.0f, settings.filter);
+			if (std::abs(target) < 0.01f)
+			{
+				wasActive = false;
+				return false;
+			}
+
+			if (!wasActive || std::abs(target - position) > 0.001f)
+			{
+				position = target;
+				const double maxCutoff = sampleRate * 0.45;
+				const auto coefficients = position < 0.0f
+					? juce::IIRCoefficients::makeLowPass(sampleRate, juce::jmin(maxCutoff, 20000.0 * std::pow(0.001, -position)), 0.707)
+					: juce::IIRCoefficients::makeHighPass(sampleRate, juce::jmin(maxCutoff, 20.0 * std::pow(1000.0, position)), 0.707);
+				if (wasActive)
+					filter.setStage(0, coefficients);
+				else
+					filter.setStageImmediately(0, coefficients);
+			}
+			if (!wasActive)
+				reset();
+			wasActive = true;
+			return true;
+		}
+
+		void process(float* const* channels, int numChannels, int numSamples) noexcept
+		{
+			filter.process(channels[0], numChannels > 1 ? channels[1] : nullptr, numSamples);
+		}
+
+		int getTailSamples() const noexcept
+		{
+			return wasActive ? static_cast<int>(0.05 * sampleRate) : 0;
+		}
+
+	private:
+		double sampleRate = 48000.0;
+		float position = 0.0f;
+		bool wasActive = false;
+		StereoBiquadCascade<1> filter;
+	};
+
+	/*
+		Stereo-linked peak compressor; one amount knob drives threshold, ratio
+		and make-up gain. The envelope follows every sample, but the dB maths
+		runs once per control interval and the gain is ramped in between.
+	*/
+	class CompressorStage
+	{
+	public:
+		static constexpr int controlInterval = 16;
+
+		void prepare(double sampleRate, int /*maxBlockSize*/)
+		{
+			attackCoefficient = static_cast<float>(std::exp(-1.0 / (0.005 * sampleRate)));
+			releaseCoefficient = static_cast<float>(std::exp(-1.0 / (0.100 * sampleRate)));
+			reset();
+		}
+
+		void reset()
+		{
+			envelope = 0.0f;
+			gain = 1.0f;
+		}
+
+		bool update(const Settings& settings)
+		{
+			const float amount = juce::jlimit(0.0f, 1.0f, settings.compression);
+			if (amount < 0.01f)
+			{
+				reset();
+				return false;
+			}
+
+			thresholdDb = -30.0f * amount;
+			slope = 1.0f - 1.0f / (1.0f + 3.0f * amount);
+			makeupDb = -0.5f * thresholdDb * slope;
+			return true;
+		}
+
+		void process(float* const* channels, int numChannels, int numSamples) noexcept
+		{
+			for (int start = 0; start < numSamples; start += controlInterval)
+			{
+				const int count = std::min(controlInterval, numSamples - start);
+				for (int i = start; i < start + count; ++i)
+				{
+					float level = 0.0f;
+					for (int ch = 0; ch < numChannels; ++ch)
+						level = std::max(level, std::abs(channels[ch][i]));
+
+					const float coefficient = level > envelope ? attackCoefficient : releaseCoefficient;
+					envelope = level + coefficient * (envelope - level);
+				}
+
+				const float overDb = juce::Decibels::gainToDecibels(envelope, -100.0f) - thresholdDb;
+				const float gainDb = (overDb > 0.0f ? -overDb * slope : 0.0f) + makeupDb;
+				const float targetGain = juce::Decibels::decibelsToGain(gainDb);
+				const float step = (targetGain - gain) / static_cast<float>(count);
+				for (int i = start; i < start + count; ++i)
+				{
+					gain += step;
+					for (int ch = 0; ch < numChannels; ++ch)
+						channels[ch][i] *= gain;
+				}
+				gain = targetGain;
+			}
+		}
+
+		int getTailSamples() const noexcept { return 0; }
+
+	private:
+		float attackCoefficient = 0.0f;
+		float releaseCoefficient = 0.0f;
+		float envelope = 0.0f;
+		float gain = 1.0f;
+		float thresholdDb = 0.0f;
+		float slope = 0.0f;
+		float makeupDb = 0.0f;
+	};
+
+	/*
+		Dotted-eighth feedback echo mixed back into the slot at the send level.
+		The lines are only zeroed in prepare(); after a reset, reads from
+		positions not written since then count as silence, so reset() does
+		not touch two seconds of memory on the audio thread.
+	*/
+	class DelayStage
+	{
+	public:
+		static constexpr double maxDelaySeconds = 2.0;
+		static constexpr float feedback = 0.35f;
+		// Repeats until the feedback has decayed by about 64 dB.
+		static constexpr int tailRepeats = 7;
+
+		void prepare(double newSampleRate, int /*maxBlockSize*/)
+		{
+			sampleRate = newSampleRate;
+			const size_t length = static_cast<size_t>(maxDelaySeconds * sampleRate) + 1;
+			for (auto& line : lines)
+				line.assign(length, 0.0f);
+			send.reset(sampleRate, 0.05);
+			send.setCurrentAndTargetValue(0.0f);
+			reset();
+		}
+
+		void reset()
+		{
+			writeIndex = 0;
+			samplesWritten = 0;
+		}
+
+		bool update(const Settings& settings)
+		{
+			send.setTargetValue(juce::jlimit(0.0f, 1.0f, settings.delaySend));
+			if (!send.isSmoothing() && send.getTargetValue() <= 0.0f)
+			{
+				if (wasActive)
+					reset();
+				wasActive = false;
+				return false;
+			}
+
+			const double beats = 0.75;
+			const double seconds = settings.hostBpm > 0.0 ? beats * 60.0 / settings.hostBpm : 0.375;
+			delaySamples = juce::jlimit(1, static_cast<int>(lines[0].size()) - 1, static_cast<int>(seconds * sampleRate));
+			wasActive = true;
+			return true;
+		}
+
+		void process(float* const* channels, int numChannels, int numSamples) noexcept
+		{
+			const int length = static_cast<int>(lines[0].size());
+			for (int i = 0; i < numSamples; ++i)
+			{
+				const float level = send.getNextValue();
+				int readIndex = writeIndex - delaySamples;
+				if (readIndex < 0)
+					readIndex += length;
+				const bool readWritten = samplesWritten >= delaySamples;
+
+				for (int ch = 0; ch < numChannels; ++ch)
+				{
+					auto& line = lines[ch];
+					const float delayed = readWritten ? line[static_cast<size_t>(readIndex)] : 0.0f;
+					const float input = channels[ch][i];
+					line[static_cast<size_t>(writeIndex)] = input + delayed * feedback;
+					channels[ch][i] = input + delayed * level;
+				}
+
+				if (++writeIndex >= length)
+					writeIndex = 0;
+				if (samplesWritten < length)
+					++samplesWritten;
+			}
+		}
+
+		int getTailSamples() const noexcept
+		{
+			return wasActive ? delaySamples * tailRepeats : 0;
+		}
+
+	private:
+		double sampleRate = 48000.0;
+		std::vector<float> lines[2];
+		int writeIndex = 0;
+		int samplesWritten = 0;
+		int delaySamples = 1;
+		bool wasActive = false;
+		juce::SmoothedValue<float> send;
+	};
+
+	template <typename... Stages>
+	class StaticChain
+	{
+	public:
+		void prepare(double sampleRate, int maxBlockSize)
+		{
+			std::apply([&](auto&... stage) { (stage.prepare(sampleRate, maxBlockSize), ...); }, stages);
+		}
+
+		void reset()
+		{
+			std::apply([](auto&... stage) { (stage.reset(), ...); }, stages);
+		}
+
+		/** Runs every active stage in order; returns false when the whole chain was bypassed. */
+		bool process(const Settings& settings, float* const* channels, int numChannels, int numSamples) noexcept
+		{
+			bool anyActive = false;
+			std::apply([&](auto&... stage)
+				{
+					((stage.update(settings) ? (stage.process(channels, numChannels, numSamples), anyActive = true) : false), ...);
+				}, stages);
+			return anyActive;
+		}
+
+		/** How long silence fed in keeps producing output, for the longest active stage. */
+		int getTailSamples() const noexcept
+		{
+			return std::apply([](const auto&... stage) { return std::max({ 0, stage.getTailSamples()... }); }, stages);
+		}
+
+		template <size_t Index>
+		auto& get() { return std::get<Index>(stages); }
+
+	private:
+		std::tuple<Stages...> stages;
+	};
+
+	using TrackChain = StaticChain<EqStage, FilterStage, CompressorStage, DelayStage>;
+}
@@ -0,0 +1,162 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <array>
+
+struct MeterReading
+{
+	static constexpr int masterSlot = -1;
+
+	int slot = masterSlot;
+	float peak = 0.0f;
+	float rms = 0.0f;
+	float truePeak = 0.0f;
+};
+
+/*
+	Single-producer / single-consumer ring carrying meter readings from the
+	audio thread to the UI. A full ring drops the reading, so an editor that
+	is closed or stalled never blocks the render.
+*/
+class MeterFeed
+{
+public:
+	static constexpr int capacity = 512;
+
+	bool push(const MeterReading& reading) noexcept
+	{
+		const auto scope = fifo.write(1);
+		if (scope.blockSize1 + scope.blockSize2 == 0)
+			return false;
+
+		readings[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = reading;
+		return true;
+	}
+
+	template <typename Callback>
+	void drain(Callback&& callback)
+	{
+		const auto scope = fifo.read(fifo.getNumReady());
+		for (int i = 0; i < scope.blockSize1; ++i)
+			callback(readings[static_cast<size_t>(scope.startIndex1 + i)]);
+		for (int i = 0; i < scope.blockSize2; ++i)
+			callback(readings[static_cast<size_t>(scope.startIndex2 + i)]);
+	}
+
+private:
+	juce::AbstractFifo fifo{ capacity };
+	std::array<MeterReading, capacity> readings;
+};
+
+/*
+	Audio-thread accumulator for one stereo signal. Peak, RMS and a 4x
+	interpolated true-peak estimate are gathered over a window of about
+	1/60 s and pushed to a MeterFeed when the window closes.
+*/
+class LevelMeter
+{
+public:
+	void prepare(double sampleRate)
+	{
+		windowSize = std::max(256, static_cast<int>(sampleRate / 60.0));
+		history.fill({ 0.0f, 0.0f, 0.0f });
+		resetWindow();
+	}
+
+	void process(const juce::AudioBuffer<float>& buffer, int numSamples, int slot, MeterFeed* feed) noexcept
+	{
+		const int numChannels = std::min(2, buffer.getNumChannels());
+		numSamples = std::min(numSamples, buffer.getNumSamples());
+
+		for (int channel = 0; channel < numChannels; ++channel)
+		{
+			const float* data = buffer.getReadPointer(channel);
+			auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+			peak = juce::jmax(peak, std::abs(range.getStart()), std::abs(range.getEnd()));
+
+			float sumSquares = 0.0f;
+			for (int i = 0; i < numSamples; ++i)
+				sumSquares += data[i] * data[i];
+			channelSumSquares[static_cast<size_t>(channel)] += sumSquares;
+
+			accumulateTruePeak(history[static_cast<size_t>(channel)], data, numSamples);
+		}
+
+		advance(numSamples, slot, feed);
+	}
+
+	void processSilence(int numSamples, int slot, MeterFeed* feed) noexcept
+	{
+		history.fill({ 0.0f, 0.0f, 0.0f });
+		advance(numSamples, slot, feed);
+	}
+
+private:
+	int windowSize = 800;
+	int samplesInWindow = 0;
+	float peak = 0.0f;
+	float truePeak = 0.0f;
+	std::array<float, 2> channelSumSquares{ 0.0f, 0.0f };
+	std::array<std::array<float, 3>, 2> history{};
+
+	void resetWindow()
+	{
+		samplesInWindow = 0;
+		peak = 0.0f;
+		truePeak = 0.0f;
+		channelSumSquares = { 0.0f, 0.0f };
+	}
+
+	void advance(int numSamples, int slot, MeterFeed* feed) noexcept
+	{
+		samplesInWindow += numSamples;
+		if (samplesInWindow < windowSize)
+			return;
+
+		if (feed != nullptr)
+		{
+			MeterReading reading;
+			reading.slot = slot;
+			reading.peak = peak;
+			reading.rms = std::sqrt((channelSumSquares[0] + channelSumSquares[1]) / (2.0f * samplesInWindow));
+			reading.truePeak = juce::jmax(peak, truePeak);
+			feed->push(reading);
+		}
+		resetWindow();
+	}
+
+	void accumulateTruePeak(std::array<float, 3>& previous, const float* data, int numSamples) noexcept
+	{
+		float y0 = previous[0];
+		float y1 = previous[1];
+		float y2 = previous[2];
+		float maxInterpolated = truePeak;
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const float y3 = data[i];
+			const float c1 = 0.5f * (y2 - y0);
+			const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+			const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+
+			for (float t : { 0.25f, 0.5f, 0.75f })
+			{
+				const float value = ((c3 * t + c2) * t + c1) * t + y1;
+				maxInterpolated = std::max(maxInterpolated, std::abs(value));
+			}
+
+			y0 = y1;
+			y1 = y2;
+			y2 = y3;
+		}
+
+		previous = { y0, y1, y2 };
+		truePeak = maxInterpolated;
+	}
+};
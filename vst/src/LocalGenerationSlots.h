@@ -0,0 +1,83 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Process-wide limit on local generations. Each instance's queue still
+	decides what to run next, but a local job only reaches the engine once
+	it holds one of these slots, so N instances share the cores instead of
+	each starting its own fully threaded generation. Waiting for a slot
+	happens before the engine call, so it does not eat into its timeout.
+*/
+class LocalGenerationSlots
+{
+public:
+	class ScopedSlot
+	{
+	public:
+		explicit ScopedSlot(LocalGenerationSlots& owner) : slots(owner), acquired(owner.acquire()) {}
+		~ScopedSlot() { if (acquired) slots.release(); }
+		bool isAcquired() const { return acquired; }
+
+	private:
+		LocalGenerationSlots& slots;
+		const bool acquired;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedSlot)
+	};
+
+	/** The most recent setting from any instance applies to the whole process. */
+	void setLimit(int maxRunning)
+	{
+		{
+			juce::ScopedLock lock(slotLock);
+			limit = juce::jmax(1, maxRunning);
+		}
+		slotFreed.signal();
+	}
+
+	int getLimit() const
+	{
+		juce::ScopedLock lock(slotLock);
+		return limit;
+	}
+
+private:
+	/** Blocks until a slot is free; false if the calling thread was asked to exit. */
+	bool acquire()
+	{
+		while (!juce::Thread::currentThreadShouldExit())
+		{
+			{
+				juce::ScopedLock lock(slotLock);
+				if (running < limit)
+				{
+					++running;
+					return true;
+				}
+			}
+			slotFreed.wait(100);
+		}
+		return false;
+	}
+
+	void release()
+	{
+		{
+			juce::ScopedLock lock(slotLock);
+			--running;
+		}
+		slotFreed.signal();
+	}
+
+	juce::CriticalSection slotLock;
+	juce::WaitableEvent slotFreed;
+	int running = 0;
+	int limit = 1;
+};
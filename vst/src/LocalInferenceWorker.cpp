@@ -0,0 +1,230 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "LocalInferenceWorker.h"
+
+LocalInferenceWorker::LocalInferenceWorker(const juce::File& serverExecutable, const juce::String& modelsDirectory)
+	: executable(serverExecutable), modelsDir(modelsDirectory)
+{
+}
+
+LocalInferenceWorker::~LocalInferenceWorker()
+{
+	stop();
+}
+
+bool LocalInferenceWorker::isRunning() const
+{
+	juce::ScopedLock lock(workerLock);
+	return connection != nullptr && connection->isConnected();
+}
+
+void LocalInferenceWorker::stop()
+{
+	juce::ScopedLock lock(workerLock);
+	if (connection != nullptr)
+	{
+		connection->close();
+		connection.reset();
+	}
+	if (process.isRunning())
+	{
+		// The server exits on its own when the connection closes.
+		if (!process.waitForProcessToFinish(2000))
+			process.kill();
+	}
+	runningThreads = 0;
+}
+
+bool LocalInferenceWorker::ensureRunning(int numThreads)
+{
+	if (connection != nullptr && connection->isConnected() && runningThreads == numThreads)
+		return true;
+
+	stop();
+
+	juce::StreamingSocket listener;
+	if (!listener.createListener(0, "127.0.0.1"))
+	{
+		DBG("Local inference: cannot open loopback listener");
+		return false;
+	}
+
+	const juce::String token = juce::Uuid().toString() + juce::Uuid().toString();
+
+	juce::StringArray command;
+	command.add(executable.getFullPathName());
+	command.add(modelsDir);
+	command.add(juce::String(listener.getBoundPort()));
+	command.add(juce::String(numThreads));
+	command.add(token);
+
+	DBG("Starting resident inference worker: " << executable.getFullPathName());
+	if (!process.start(command, 0))
+	{
+		DBG("Local inference: failed to start " << executable.getFullPathName());
+		return false;
+	}
+
+	if (!acceptWorker(listener, token))
+	{
+		DBG("Local inference: worker did not connect in time");
+		connection.reset();
+		process.kill();
+		return false;
+	}
+
+	runningThreads = numThreads;
+	DBG("Resident inference worker ready");
+	return true;
+}
+
+bool LocalInferenceWorker::acceptWorker(juce::StreamingSocket& listener, const juce::String& token)
+{
+	// The server connects back once the models are loaded. Anything else on
+	// the loopback port that gets there first is dropped and we keep waiting.
+	const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(startupTimeoutMs);
+	const size_t tokenBytes = token.getNumBytesAsUTF8() + 1;
+
+	for (;;)
+	{
+		const auto now = juce::Time::getMillisecondCounter();
+		if (now >= deadline)
+			return false;
+		const int remainingMs = static_cast<int>(deadline - now);
+
+		if (listener.waitUntilReady(true, remainingMs) != 1)
+			return false;
+
+		connection.reset(listener.waitForNextConnection());
+		if (connection == nullptr)
+			continue;
+
+		juce::MemoryBlock received(tokenBytes);
+		if (readExactly(received.getData(), tokenBytes, juce::jmin(remainingMs, 5000))
+			&& received.toString() == token + "\n")
+			return true;
+
+		DBG("Local inference: rejected a connection without the worker token");
+		connection->close();
+		connection.reset();
+	}
+}
+
+LocalInferenceWorker::Response LocalInferenceWorker::generate(const Request& request, int timeoutMs)
+{
+	juce::ScopedLock lock(workerLock);
+	Response response;
+
+	if (!ensureRunning(request.numThreads))
+	{
+		response.errorMessage = "Failed to start resident inference worker";
+		return response;
+	}
+
+	juce::var json(new juce::DynamicObject());
+	json.getDynamicObject()->setProperty("prompt", request.prompt);
+	json.getDynamicObject()->setProperty("seed", request.seed);
+	json.getDynamicObject()->setProperty("threads", request.numThreads);
+	json.getDynamicObject()->setProperty("duration", request.duration);
+	const juce::String line = juce::JSON::toString(json, true) + "\n";
+
+	juce::int32 header[4] = {};
+	if (!writeAll(line.toRawUTF8(), line.getNumBytesAsUTF8(), timeoutMs) ||
+		!readExactly(header, sizeof(header), timeoutMs))
+	{
+		stop();
+		response.errorMessage = "Resident inference worker stopped responding";
+		return response;
+	}
+
+	const int status = juce::ByteOrder::swapIfBigEndian(header[0]);
+	const int sampleRate = juce::ByteOrder::swapIfBigEndian(header[1]);
+	const int numChannels = juce::ByteOrder::swapIfBigEndian(header[2]);
+	const int numFrames = juce::ByteOrder::swapIfBigEndian(header[3]);
+
+	if (status != 0)
+	{
+		// The length comes from the peer, so it is bounded before allocating.
+		if (numFrames < 0 || numFrames > maxErrorBytes)
+		{
+			stop();
+			response.errorMessage = "Resident inference worker sent an invalid error";
+			return response;
+		}
+		juce::MemoryBlock message(static_cast<size_t>(numFrames));
+		if (!readExactly(message.getData(), message.getSize(), timeoutMs))
+			stop();
+		response.errorMessage = message.toString();
+		return response;
+	}
+
+	if (numChannels < 1 || numChannels > 2 || numFrames <= 0 || numFrames > maxFrames
+		|| sampleRate <= 0 || sampleRate > maxSampleRate)
+	{
+		stop();
+		response.errorMessage = "Resident inference worker sent an invalid header";
+		return response;
+	}
+
+	response.audio.setSize(numChannels, numFrames);
+	for (int channel = 0; channel < numChannels; ++channel)
+	{
+		if (!readExactly(response.audio.getWritePointer(channel), sizeof(float) * static_cast<size_t>(numFrames), timeoutMs))
+		{
+			stop();
+			response.errorMessage = "Resident inference worker closed mid-transfer";
+			return response;
+		}
+#if JUCE_BIG_ENDIAN
+		auto* samples = reinterpret_cast<juce::uint32*>(response.audio.getWritePointer(channel));
+		for (int i = 0; i < numFrames; ++i)
+			samples[i] = juce::ByteOrder::swap(samples[i]);
+#endif
+	}
+
+	response.sampleRate = static_cast<double>(sampleRate);
+	response.success = true;
+	return response;
+}
+
+bool LocalInferenceWorker::readExactly(void* destination, size_t numBytes, int timeoutMs)
+{
+	auto* bytes = static_cast<char*>(destination);
+	while (numBytes > 0)
+	{
+		if (connection->waitUntilReady(true, timeoutMs) != 1)
+			return false;
+
+		const int chunk = static_cast<int>(juce::jmin(numBytes, static_cast<size_t>(1 << 20)));
+		const int bytesRead = connection->read(bytes, chunk, false);
+		if (bytesRead <= 0)
+			return false;
+
+		bytes += bytesRead;
+		numBytes -= static_cast<size_t>(bytesRead);
+	}
+	return true;
+}
+
+bool LocalInferenceWorker::writeAll(const void* source, size_t numBytes, int timeoutMs)
+{
+	auto* bytes = static_cast<const char*>(source);
+	while (numBytes > 0)
+	{
+		if (connection->waitUntilReady(false, timeoutMs) != 1)
+			return false;
+
+		const int written = connection->write(bytes, static_cast<int>(numBytes));
+		if (written <= 0)
+			return false;
+
+		bytes += written;
+		numBytes -= static_cast<size_t>(written);
+	}
+	return true;
+}
@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <memory>
+
+/*
+	Long-lived audiogen_server process that keeps the TFLite models loaded
+	between generations. It is an optional companion to the audiogen build
+	in the models directory and is not part of this repository; without it
+	StableAudioEngine launches audiogen once per request. The plugin listens
+	on a loopback port and starts
+
+		audiogen_server <modelsDir> <port> <numThreads> <token>
+
+	which connects back once its interpreters are ready and first sends the
+	token followed by a newline. Connections that do not present it are
+	dropped, so another local process cannot pose as the worker. Each request is one
+	line of JSON ({"prompt", "seed", "threads", "duration"}) and is answered
+	with four little-endian int32 values - status, sample rate, channels,
+	frames - followed by channels * frames planar float32 samples. A non-zero
+	status is followed by frames bytes of UTF-8 error text instead, at most
+	maxErrorBytes of it.
+
+	One request runs at a time; a broken connection drops the process and
+	the next request starts a fresh one.
+*/
+class LocalInferenceWorker
+{
+public:
+	struct Request
+	{
+		juce::String prompt;
+		int seed = 0;
+		int numThreads = 4;
+		float duration = 10.0f;
+	};
+
+	struct Response
+	{
+		bool success = false;
+		juce::String errorMessage;
+		juce::AudioBuffer<float> audio;
+		double sampleRate = 0.0;
+	};
+
+	LocalInferenceWorker(const juce::File& serverExecutable, const juce::String& modelsDirectory);
+	~LocalInferenceWorker();
+
+	Response generate(const Request& request, int timeoutMs);
+	bool isRunning() const;
+	void stop();
+
+private:
+	static constexpr int startupTimeoutMs = 120000;
+	static constexpr int maxErrorBytes = 4096;
+	static constexpr int maxSampleRate = 384000;
+	static constexpr int maxFrames = 48000 * 600;
+
+	bool ensureRunning(int numThreads);
+	bool acceptWorker(juce::StreamingSocket& listener, const juce::String& token);
+	bool readExactly(void* destination, size_t numBytes, int timeoutMs);
+	bool writeAll(const void* source, size_t numBytes, int timeoutMs);
+
+	juce::File executable;
+	juce::String modelsDir;
+	juce::ChildProcess process;
+	std::unique_ptr<juce::StreamingSocket> connection;
+	int runningThreads = 0;
+	mutable juce::CriticalSection workerLock;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LocalInferenceWorker)
+};
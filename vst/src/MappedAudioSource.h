@@ -0,0 +1,241 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+/*
+	Planar float audio read straight from a memory-mapped cache file. Nothing
+	is resident until it is touched, so an idle page costs only its mapping;
+	prefault() pulls the loop region in ahead of the audio thread. Files are
+	named by content key so the same audio is written once and reused, and
+	the cache is never pruned of a file a live source still maps.
+*/
+class MappedAudioSource
+{
+public:
+	static constexpr juce::uint32 fileMagic = 0x4d53424f; // "OBSM"
+	static constexpr juce::uint32 fileVersion = 1;
+	static constexpr int headerSize = 64;
+	static constexpr juce::int64 maxCacheBytes = 2048LL * 1024 * 1024;
+
+	static juce::File getCacheDirectory()
+	{
+		return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+			.getChildFile("OBSIDIAN-Neural")
+			.getChildFile("AudioCache")
+			.getChildFile("Mapped");
+	}
+
+	static juce::File getCacheFile(const juce::String& key)
+	{
+		return getCacheDirectory().getChildFile(key + ".f32");
+	}
+
+	static std::shared_ptr<MappedAudioSource> open(const juce::String& key)
+	{
+		juce::File file = getCacheFile(key);
+		if (key.isEmpty() || !file.existsAsFile())
+			return nullptr;
+
+		std::shared_ptr<MappedAudioSource> source(new MappedAudioSource(key));
+		source->mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+		if (!source->readHeader())
+			return nullptr;
+
+		file.setLastModificationTime(juce::Time::getCurrentTime());
+		return source;
+	}
+
+	static std::shared_ptr<MappedAudioSource> createFromBuffer(const juce::String& key,
+		const juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate)
+	{
+		if (auto existing = open(key))
+			return existing;
+
+		numSamples = juce::jlimit(0, buffer.getNumSamples(), numSamples);
+		const int numChannels = std::min(2, buffer.getNumChannels());
+		if (key.isEmpty() || numSamples == 0 || numChannels == 0)
+			return nullptr;
+
+		juce::File directory = getCacheDirectory();
+		if (!directory.isDirectory() && !directory.createDirectory().wasOk())
+			return nullptr;
+
+		juce::TemporaryFile temporary(getCacheFile(key));
+		{
+			juce::FileOutputStream stream(temporary.getFile());
+			if (!stream.openedOk())
+				return nullptr;
+
+			stream.writeInt(static_cast<int>(fileMagic));
+			stream.writeInt(static_cast<int>(fileVersion));
+			stream.writeInt(numChannels);
+			stream.writeInt(numSamples);
+			stream.writeDouble(sampleRate);
+			const int padding = headerSize - 24;
+			for (int i = 0; i < padding; ++i)
+				stream.writeByte(0);
+
+			for (int channel = 0; channel < numChannels; ++channel)
+			{
+				if (!stream.write(buffer.getReadPointer(channel), static_cast<size_t>(numSamples) * sizeof(float)))
+					return nullptr;
+			}
+			stream.flush();
+			if (stream.getStatus().failed())
+				return nullptr;
+		}
+
+		if (!temporary.overwriteTargetFileWithTemporary())
+			return nullptr;
+
+		pruneCache();
+		return open(key);
+	}
+
+	/** Deletes the least recently opened files over maxCacheBytes, skipping any still mapped in this process. */
+	static void pruneCache()
+	{
+		auto files = getCacheDirectory().findChildFiles(juce::File::findFiles, false, "*.f32");
+
+		juce::int64 totalBytes = 0;
+		for (const auto& file : files)
+			totalBytes += file.getSize();
+
+		if (totalBytes <= maxCacheBytes)
+			return;
+
+		std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+			{
+				return a.getLastModificationTime() < b.getLastModificationTime();
+			});
+
+		for (const auto& file : files)
+		{
+			if (totalBytes <= maxCacheBytes)
+				break;
+			// A page or project still plays from it; deleting would strand the key.
+			if (isOpen(file.getFileNameWithoutExtension()))
+				continue;
+
+			juce::int64 size = file.getSize();
+			if (file.deleteFile())
+				totalBytes -= size;
+		}
+	}
+
+	~MappedAudioSource()
+	{
+		auto& registry = getOpenKeys();
+		juce::ScopedLock lock(registry.lock);
+		auto it = registry.counts.find(key);
+		if (it != registry.counts.end() && --it->second <= 0)
+			registry.counts.erase(it);
+	}
+
+	const juce::String& getKey() const { return key; }
+	int getNumChannels() const { return numChannels; }
+	int getNumSamples() const { return numSamples; }
+	double getSampleRate() const { return sampleRate; }
+
+	const float* getReadPointer(int channel) const
+	{
+		return channels[juce::jlimit(0, 1, channel)];
+	}
+
+	void prefault(int startSample, int count) const
+	{
+		startSample = juce::jlimit(0, numSamples, startSample);
+		count = juce::jlimit(0, numSamples - startSample, count);
+		const int floatsPerPage = 4096 / static_cast<int>(sizeof(float));
+
+		float sum = 0.0f;
+		for (int channel = 0; channel < numChannels; ++channel)
+		{
+			const float* data = channels[channel] + startSample;
+			for (int i = 0; i < count; i += floatsPerPage)
+				sum += data[i];
+			if (count > 0)
+				sum += data[count - 1];
+		}
+		prefaultSink.store(sum, std::memory_order_relaxed);
+	}
+
+	/** Read-only view for code that takes an AudioBuffer; never write through it. */
+	juce::AudioBuffer<float> createView() const
+	{
+		return juce::AudioBuffer<float>(const_cast<float* const*>(channels), 2, numSamples);
+	}
+
+private:
+	// Keys with a live source in this process, across every instance.
+	struct OpenKeys
+	{
+		juce::CriticalSection lock;
+		std::map<juce::String, int> counts;
+	};
+
+	static OpenKeys& getOpenKeys()
+	{
+		static OpenKeys registry;
+		return registry;
+	}
+
+	static bool isOpen(const juce::String& cacheKey)
+	{
+		auto& registry = getOpenKeys();
+		juce::ScopedLock lock(registry.lock);
+		return registry.counts.count(cacheKey) > 0;
+	}
+
+	explicit MappedAudioSource(const juce::String& cacheKey)
+		: key(cacheKey)
+	{
+		auto& registry = getOpenKeys();
+		juce::ScopedLock lock(registry.lock);
+		++registry.counts[key];
+	}
+
+	bool readHeader()
+	{
+		if (mappedFile == nullptr || mappedFile->getData() == nullptr || mappedFile->getSize() < static_cast<size_t>(headerSize))
+			return false;
+
+		juce::MemoryInputStream header(mappedFile->getData(), static_cast<size_t>(headerSize), false);
+		if (static_cast<juce::uint32>(header.readInt()) != fileMagic ||
+			static_cast<juce::uint32>(header.readInt()) != fileVersion)
+			return false;
+
+		numChannels = header.readInt();
+		numSamples = header.readInt();
+		sampleRate = header.readDouble();
+
+		const size_t expectedSize = static_cast<size_t>(headerSize)
+			+ static_cast<size_t>(numChannels) * static_cast<size_t>(numSamples) * sizeof(float);
+		if (numChannels < 1 || numChannels > 2 || numSamples <= 0 || mappedFile->getSize() < expectedSize)
+			return false;
+
+		auto* data = reinterpret_cast<float*>(static_cast<char*>(mappedFile->getData()) + headerSize);
+		channels[0] = data;
+		channels[1] = numChannels > 1 ? data + numSamples : data;
+		return true;
+	}
+
+	juce::String key;
+	std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+	float* channels[2] = { nullptr, nullptr };
+	int numChannels = 0;
+	int numSamples = 0;
+	double sampleRate = 48000.0;
+	mutable std::atomic<float> prefaultSink{ 0.0f };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappedAudioSource)
+};
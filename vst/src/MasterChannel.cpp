@@ -343,7 +343,7 @@ void MasterChannel::drawMasterVUMeter(juce::Graphics& g, juce::Rectangle<int> bo
 		drawPeakHoldLine(numSegments, vuArea, segmentHeight, g);
 	}
 
-	if (masterPeakHold >= 0.98f)
+	if (masterPeakHold >= 1.0f)
 	{
 		drawMasterClipping(vuArea, g);
 	}
@@ -351,7 +351,7 @@ void MasterChannel::drawMasterVUMeter(juce::Graphics& g, juce::Rectangle<int> bo
 
 void MasterChannel::drawPeakHoldLine(int numSegments, juce::Rectangle<float>& vuArea, float segmentHeight, juce::Graphics& g) const
 {
-	int peakSegment = (int)(masterPeakHold * numSegments);
+	int peakSegment = (int)(juce::jmin(masterPeakHold, 1.0f) * numSegments);
 	if (peakSegment < numSegments)
 	{
 		float peakY = vuArea.getBottom() - 2 - (peakSegment + 1) * segmentHeight;
@@ -389,11 +389,16 @@ void MasterChannel::drawMasterChanelSegments(juce::Rectangle<float>& vuArea, int
 	else
 		segmentColour = ColourPalette::vuRed;
 
-	if (masterLevel >= segmentLevel)
+	if (masterRms >= segmentLevel)
 	{
 		g.setColour(segmentColour);
 		g.fillRoundedRectangle(segmentRect, 1.0f);
 	}
+	else if (masterLevel >= segmentLevel)
+	{
+		g.setColour(segmentColour.withAlpha(0.45f));
+		g.fillRoundedRectangle(segmentRect, 1.0f);
+	}
 	else
 	{
 		g.setColour(segmentColour.withAlpha(0.05f));
@@ -401,25 +406,33 @@ void MasterChannel::drawMasterChanelSegments(juce::Rectangle<float>& vuArea, int
 	}
 }
 
-void MasterChannel::setRealAudioLevel(float level)
+void MasterChannel::setRealAudioReading(const MeterReading& reading)
 {
-	realAudioLevel = juce::jlimit(0.0f, 1.0f, level);
+	realAudioLevel = juce::jlimit(0.0f, 1.0f, reading.peak);
+	realAudioRms = juce::jlimit(0.0f, 1.0f, reading.rms);
+	realAudioTruePeak = reading.truePeak;
 	hasRealAudio = true;
 }
 
 void MasterChannel::updateMasterLevels()
 {
 	float instantLevel;
+	float instantRms;
+	float instantTruePeak;
 
 	if (hasRealAudio)
 	{
 		instantLevel = realAudioLevel;
+		instantRms = realAudioRms;
+		instantTruePeak = realAudioTruePeak;
 	}
 	else
 	{
 		static float phase = 0.0f;
 		phase += 0.05f;
 		instantLevel = (std::sin(phase) * 0.3f + 0.3f) * 0.5f;
+		instantRms = instantLevel * 0.7f;
+		instantTruePeak = instantLevel;
 	}
 
 	if (instantLevel > masterLevel)
@@ -431,9 +444,13 @@ void MasterChannel::updateMasterLevels()
 		masterLevel = masterLevel * 0.95f + instantLevel * 0.05f;
 	}
 
-	if (masterLevel > masterPeakHold)
+	masterRms = masterRms * 0.7f + instantRms * 0.3f;
+
+	// The hold line and CLIP follow the true peak, which can pass 1.0
+	// between samples that the sample peak reads as just under it.
+	if (instantTruePeak > masterPeakHold)
 	{
-		masterPeakHold = masterLevel;
+		masterPeakHold = instantTruePeak;
 		masterPeakHoldTimer = 60;
 	}
 	else if (masterPeakHoldTimer > 0)
@@ -445,7 +462,7 @@ void MasterChannel::updateMasterLevels()
 		masterPeakHold *= 0.98f;
 	}
 
-	isClipping = (masterPeakHold >= 0.95f);
+	isClipping = (masterPeakHold >= 1.0f);
 
 	juce::MessageManager::callAsync([this]()
 		{ repaint(); });
@@ -19,7 +19,7 @@ public:
 	void drawPeakHoldLine(int numSegments, juce::Rectangle<float> &vuArea, float segmentHeight, juce::Graphics &g) const;
 	void drawMasterClipping(juce::Rectangle<float> &vuArea, juce::Graphics &g) const;
 	void drawMasterChanelSegments(juce::Rectangle<float> &vuArea, int i, float segmentHeight, int numSegments, juce::Graphics &g) const;
-	void setRealAudioLevel(float level);
+	void setRealAudioReading(const MeterReading& reading);
 	void updateMasterLevels();
 
 	std::function<void(float)> onMasterVolumeChanged;
@@ -36,12 +36,15 @@ private:
 	std::atomic<bool> isDestroyed{false};
 
 	float realAudioLevel = 0.0f;
+	float realAudioRms = 0.0f;
+	float realAudioTruePeak = 0.0f;
 	bool hasRealAudio = false;
 
 	juce::Label masterLabel;
 	juce::Label highLabel, midLabel, lowLabel, panLabel;
 
 	float masterLevel = 0.0f;
+	float masterRms = 0.0f;
 	float masterPeakHold = 0.0f;
 	int masterPeakHoldTimer = 0;
 	bool isClipping = false;
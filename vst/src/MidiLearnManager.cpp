@@ -13,6 +13,7 @@
 
 MidiLearnManager::MidiLearnManager()
 {
+	rebuildDispatchTable();
 }
 
 MidiLearnManager::~MidiLearnManager()
@@ -73,14 +74,14 @@ void MidiLearnManager::timerCallback()
 
 void MidiLearnManager::removeMappingsForSlot(int slotNumber)
 {
-	juce::String slotPrefix = "slot" + juce::String(slotNumber);
 	for (int i = static_cast<int>(mappings.size()) - 1; i >= 0; --i)
 	{
-		if (mappings[i].parameterName.startsWith(slotPrefix))
+		if (SlotParameters::belongsToSlot(mappings[i].parameterName, slotNumber))
 		{
 			mappings.erase(mappings.begin() + i);
 		}
 	}
+	rebuildDispatchTable();
 }
 
 void MidiLearnManager::moveMappingsFromSlotToSlot(int fromSlot, int toSlot)
@@ -100,12 +101,10 @@ void MidiLearnManager::moveMappingsFromSlotToSlot(int fromSlot, int toSlot)
 
 	for (auto it = mappings.begin(); it != mappings.end();)
 	{
-		if (it->parameterName.startsWith(fromPrefix))
+		if (SlotParameters::belongsToSlot(it->parameterName, fromSlot))
 		{
 			MidiMapping movedMapping = *it;
-
-			juce::String suffix = it->parameterName.substring(fromPrefix.length());
-			movedMapping.parameterName = toPrefix + suffix;
+			movedMapping.parameterName = toPrefix + SlotParameters::getSuffix(it->parameterName);
 
 			movedMapping.description = movedMapping.description.replace(
 				"Slot " + juce::String(fromSlot),
@@ -126,6 +125,7 @@ void MidiLearnManager::moveMappingsFromSlotToSlot(int fromSlot, int toSlot)
 	{
 		mappings.push_back(mapping);
 	}
+	rebuildDispatchTable();
 }
 bool MidiLearnManager::processMidiForLearning(const juce::MidiMessage &message)
 {
@@ -168,8 +168,6 @@ bool MidiLearnManager::processMidiForLearning(const juce::MidiMessage &message)
 		return false;
 	}
 
-	removeMapping(learningParameter);
-
 	MidiMapping mapping;
 	mapping.midiType = midiType;
 	mapping.midiNumber = midiNumber;
@@ -179,8 +177,6 @@ bool MidiLearnManager::processMidiForLearning(const juce::MidiMessage &message)
 	mapping.description = learningDescription;
 	mapping.parameterName = learningParameter;
 
-	mappings.push_back(mapping);
-
 	juce::String midiDescription;
 	switch (midiType)
 	{
@@ -197,8 +193,11 @@ bool MidiLearnManager::processMidiForLearning(const juce::MidiMessage &message)
 
 	juce::String fullMessage = "MIDI mapping created: " + midiDescription + " >> " + learningDescription;
 	DBG(fullMessage);
-	juce::MessageManager::callAsync([mapping, fullMessage]()
+	juce::MessageManager::callAsync([this, mapping, fullMessage]()
 									{
+			removeMapping(mapping.parameterName);
+			mappings.push_back(mapping);
+			rebuildDispatchTable();
 			if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor()))
 			{
 				editor->statusLabel.setText(fullMessage, juce::dontSendNotification);
@@ -214,283 +213,351 @@ bool MidiLearnManager::processMidiForLearning(const juce::MidiMessage &message)
 	return true;
 }
 
-void MidiLearnManager::processMidiMappings(const juce::MidiMessage &message)
+int MidiLearnManager::getDispatchKey(int midiType, int midiChannel, int midiNumber)
 {
-	int midiChannel = message.getChannel() - 1;
-	bool isWarning = false;
-	for (auto &mapping : mappings)
-	{
-		bool matches = false;
-		float value = 0.0f;
-		juce::String statusMessage = "";
+	if (midiType < 0 || midiType > 2 || midiChannel < 0 || midiChannel > 15 || midiNumber < 0 || midiNumber > 127)
+		return -1;
+	return (midiType * 16 + midiChannel) * 128 + midiNumber;
+}
 
-		if (mapping.midiType == 0 && message.isNoteOnOrOff() && mapping.midiChannel == midiChannel)
+void MidiLearnManager::rebuildDispatchTable()
+{
+	auto table = std::make_unique<DispatchTable>();
+	std::vector<std::pair<int, CompiledMapping>> keyed;
+	keyed.reserve(mappings.size());
+
+	for (const auto &mapping : mappings)
+	{
+		if (!mapping.processor)
+			continue;
+
+		const int midiNumber = mapping.midiType == 2 ? 0 : mapping.midiNumber;
+		const int key = getDispatchKey(mapping.midiType, mapping.midiChannel, midiNumber);
+		if (key < 0 || (mapping.midiType == 0 && midiNumber >= 60 && midiNumber <= 67))
+			continue;
+
+		const juce::String &name = mapping.parameterName;
+		CompiledMapping entry;
+		entry.processor = mapping.processor;
+		entry.midiType = mapping.midiType;
+		entry.midiNumber = midiNumber;
+		entry.isBoolean = isBooleanParameter(name);
+		statusNames.addIfNotAlreadyThere(name);
+		entry.nameIndex = statusNames.indexOf(name);
+
+		if (name == "promptPresetSelector" || name.startsWith("promptSelector_slot"))
 		{
-			int noteNumber = message.getNoteNumber();
-			bool isInSampleRange = (noteNumber >= 60 && noteNumber <= 67);
+			entry.action = CompiledMapping::Action::UICallback;
+			entry.uiCallback = mapping.uiCallback;
+		}
+		else if (name == "nextTrack")
+			entry.action = CompiledMapping::Action::NextTrack;
+		else if (name == "prevTrack")
+			entry.action = CompiledMapping::Action::PreviousTrack;
+		else if (name == "generate")
+			entry.action = CompiledMapping::Action::GlobalGenerate;
 
-			if (isInSampleRange)
-			{
-				continue;
-			}
+		entry.parameter = mapping.processor->getParameterTreeState().getParameter(name);
+		entry.isGenerateTrigger = entry.parameter != nullptr && name.contains("Generate");
 
-			if (message.getNoteNumber() == mapping.midiNumber)
+		if (name.startsWith("slot"))
+		{
+			const int slotIndex = SlotParameters::getSlotIndex(name);
+			if (slotIndex >= 0 && slotIndex < mapping.processor->getTrackCapacity())
 			{
-				matches = true;
-				statusMessage = "Note " + juce::String(mapping.midiNumber) + " >> " + mapping.parameterName;
-
-				if (message.isNoteOn() && isBooleanParameter(mapping.parameterName))
-				{
-					auto *param = mapping.processor->getParameterTreeState().getParameter(mapping.parameterName);
-					if (param)
-					{
-						if (mapping.parameterName.contains("Generate"))
-						{
-							value = 1.0f;
-							statusMessage += " (trigger)";
-							if (mapping.processor->getIsGenerating())
-							{
-								statusMessage += " (trigger) - Generation already in progress, please wait";
-								isWarning = true;
-							}
-						}
-						else
-						{
-							float currentValue = param->getValue();
-							value = (currentValue > 0.5f) ? 0.0f : 1.0f;
-							statusMessage += " (toggle: " + juce::String(value > 0.5f ? "ON" : "OFF") + ")";
-						}
-					}
-				}
-				else if (message.isNoteOn())
-				{
-					value = message.getVelocity() / 127.0f;
-					statusMessage += " (vel: " + juce::String(message.getVelocity()) + ")";
-				}
-				else
-				{
-					if (isBooleanParameter(mapping.parameterName))
-						mustCheckForMidiEvent.store(true);
-					continue;
-				}
+				entry.slotIndex = slotIndex;
+				entry.isSlotPlay = name.contains("Play");
+				entry.isSlotGenerate = name.contains("Generate");
+				entry.notifiesMidiEvent = name.contains("RandomRetrigger") || name.contains("RetriggerInterval");
 			}
 		}
-		else if (mapping.midiType == 1 && message.isController() && mapping.midiChannel == midiChannel)
+
+		if (entry.action == CompiledMapping::Action::Parameter && entry.parameter == nullptr)
+			continue;
+
+		keyed.emplace_back(key, std::move(entry));
+	}
+
+	std::stable_sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b)
+					 { return a.first < b.first; });
+
+	table->entries.reserve(keyed.size());
+	for (auto &item : keyed)
+	{
+		auto &bucket = table->buckets[static_cast<size_t>(item.first)];
+		if (bucket.count == 0)
+			bucket.first = static_cast<juce::uint16>(table->entries.size());
+		++bucket.count;
+		table->entries.push_back(std::move(item.second));
+	}
+
+	DispatchTable *newTable = table.get();
+	currentTable.store(newTable);
+	if (audioThreadTable.load() == nullptr)
+		audioThreadTable.store(newTable);
+	if (publishedTable)
+		retiredTables.push_back(std::move(publishedTable));
+	publishedTable = std::move(table);
+	reclaimRetiredTables();
+}
+
+void MidiLearnManager::reclaimRetiredTables()
+{
+	DispatchTable *inUse = audioThreadTable.load();
+	retiredTables.erase(std::remove_if(retiredTables.begin(), retiredTables.end(),
+									   [inUse](const std::unique_ptr<DispatchTable> &table)
+									   {
+										   return table.get() != inUse;
+									   }),
+						retiredTables.end());
+}
+
+const MidiLearnManager::DispatchTable &MidiLearnManager::acquireDispatchTable() noexcept
+{
+	DispatchTable *table = currentTable.load();
+	for (;;)
+	{
+		audioThreadTable.store(table);
+		DispatchTable *latest = currentTable.load();
+		if (latest == table)
+			break;
+		table = latest;
+	}
+	return *table;
+}
+
+void MidiLearnManager::processMidiMappings(const juce::MidiMessage &message)
+{
+	const auto &table = acquireDispatchTable();
+
+	int midiType = -1;
+	int midiNumber = 0;
+	if (message.isNoteOnOrOff())
+	{
+		midiType = 0;
+		midiNumber = message.getNoteNumber();
+		if (midiNumber >= 60 && midiNumber <= 67)
+			return;
+	}
+	else if (message.isController())
+	{
+		midiType = 1;
+		midiNumber = message.getControllerNumber();
+	}
+	else if (message.isPitchWheel())
+	{
+		midiType = 2;
+	}
+
+	const int key = getDispatchKey(midiType, message.getChannel() - 1, midiNumber);
+	if (key < 0)
+		return;
+
+	const auto &bucket = table.buckets[static_cast<size_t>(key)];
+	for (int i = bucket.first; i < bucket.first + bucket.count; ++i)
+	{
+		if (!dispatchMapping(table.entries[static_cast<size_t>(i)], message))
+			return;
+	}
+}
+
+bool MidiLearnManager::dispatchMapping(const CompiledMapping &entry, const juce::MidiMessage &message)
+{
+	float value = 0.0f;
+	int rawValue = 0;
+	StatusDetail detail = StatusDetail::None;
+
+	if (entry.midiType == 0)
+	{
+		if (message.isNoteOn() && entry.isBoolean)
 		{
-			if (message.getControllerNumber() == mapping.midiNumber)
+			if (entry.isGenerateTrigger)
+			{
+				value = 1.0f;
+				detail = StatusDetail::Trigger;
+			}
+			else if (entry.parameter)
 			{
-				matches = true;
-				value = message.getControllerValue() / 127.0f;
-				statusMessage = "CC" + juce::String(mapping.midiNumber) + " >> " + mapping.parameterName +
-								" (" + juce::String(message.getControllerValue()) + ")";
+				value = entry.parameter->getValue() > 0.5f ? 0.0f : 1.0f;
+				detail = value > 0.5f ? StatusDetail::ToggleOn : StatusDetail::ToggleOff;
 			}
 		}
-		else if (mapping.midiType == 2 && message.isPitchWheel() && mapping.midiChannel == midiChannel)
+		else if (message.isNoteOn())
 		{
-			matches = true;
-			value = (message.getPitchWheelValue() + 8192) / 16383.0f;
-			statusMessage = "Pitch Wheel >> " + mapping.parameterName +
-							" (" + juce::String(message.getPitchWheelValue()) + ")";
+			value = message.getVelocity() / 127.0f;
+			rawValue = message.getVelocity();
+			detail = StatusDetail::Velocity;
 		}
-
-		if (matches && mapping.processor)
+		else
 		{
-			if (mapping.parameterName == "promptPresetSelector")
-			{
-				if (mapping.uiCallback && mapping.processor->getActiveEditor())
-				{
-					mapping.uiCallback(value);
+			if (entry.isBoolean)
+				mustCheckForMidiEvent.store(true);
+			return true;
+		}
+	}
+	else if (entry.midiType == 1)
+	{
+		value = message.getControllerValue() / 127.0f;
+		rawValue = message.getControllerValue();
+	}
+	else
+	{
+		value = (message.getPitchWheelValue() + 8192) / 16383.0f;
+		rawValue = message.getPitchWheelValue();
+	}
 
-					juce::MessageManager::callAsync([mapping, statusMessage]()
-													{
-							if (mapping.processor->getActiveEditor())
-							{
-								if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor()))
-								{
-									editor->statusLabel.setText(statusMessage, juce::dontSendNotification);
-									juce::Timer::callAfterDelay(2000, [mapping]() {
-										if (mapping.processor->getActiveEditor()) {
-											if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor())) {
-												editor->statusLabel.setText("Ready", juce::dontSendNotification);
-											}
-										}
-										});
-								}
-							} });
-				}
-				continue;
-			}
-			if (mapping.parameterName.startsWith("promptSelector_slot"))
-			{
-				if (mapping.uiCallback && mapping.processor->getActiveEditor())
-				{
-					mapping.uiCallback(value);
+	switch (entry.action)
+	{
+	case CompiledMapping::Action::UICallback:
+		if (entry.uiCallback && entry.processor->getActiveEditor())
+		{
+			entry.uiCallback(value);
+			pushStatus(entry, rawValue, detail);
+		}
+		return true;
 
-					juce::MessageManager::callAsync([mapping, statusMessage]()
-						{
-							if (mapping.processor->getActiveEditor())
-							{
-								if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor()))
-								{
-									editor->statusLabel.setText(statusMessage, juce::dontSendNotification);
-									juce::Timer::callAfterDelay(2000, [mapping]() {
-										if (mapping.processor->getActiveEditor()) {
-											if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor())) {
-												editor->statusLabel.setText("Ready", juce::dontSendNotification);
-											}
-										}
-										});
-								}
-							}
-						});
-				}
-				continue;
-			}
-			if (mapping.parameterName == "nextTrack" || mapping.parameterName == "prevTrack")
+	case CompiledMapping::Action::NextTrack:
+	case CompiledMapping::Action::PreviousTrack:
+		if (message.isNoteOn() && entry.isBoolean)
+		{
+			if (entry.action == CompiledMapping::Action::NextTrack)
 			{
-				if (message.isNoteOn() && isBooleanParameter(mapping.parameterName))
-				{
-					if (mapping.parameterName == "nextTrack")
-					{
-						mapping.processor->selectNextTrack();
-						statusMessage += " (Next Track triggered)";
-					}
-					else if (mapping.parameterName == "prevTrack")
-					{
-						mapping.processor->selectPreviousTrack();
-						statusMessage += " (Previous Track triggered)";
-					}
-
-					juce::MessageManager::callAsync([mapping, statusMessage]()
-						{
-							if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor()))
-							{
-								editor->statusLabel.setText(statusMessage, juce::dontSendNotification);
-								juce::Timer::callAfterDelay(2000, [mapping]() {
-									if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor())) {
-										editor->statusLabel.setText("Ready", juce::dontSendNotification);
-									}
-									});
-							}
-						});
-				}
-				continue;
+				entry.processor->selectNextTrack();
+				pushStatus(entry, rawValue, StatusDetail::NextTrack);
 			}
-			if (mapping.parameterName == "generate")
+			else
 			{
-				if (message.isNoteOn() && isBooleanParameter(mapping.parameterName))
-				{
-					if (mapping.processor->getIsGenerating())
-					{
-						statusMessage += " (Generation already in progress)";
-						isWarning = true;
-					}
-					else
-					{
-						mapping.processor->triggerGlobalGeneration();
-						statusMessage += " (Generation triggered)";
-					}
-
-					juce::MessageManager::callAsync([mapping, statusMessage, isWarning]()
-						{
-							if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor()))
-							{
-								editor->statusLabel.setText(statusMessage, juce::dontSendNotification);
-								if (isWarning) {
-									editor->statusLabel.setColour(juce::Label::textColourId, ColourPalette::textWarning);
-								}
-								juce::Timer::callAfterDelay(2000, [mapping]() {
-									if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor())) {
-										editor->statusLabel.setText("Ready", juce::dontSendNotification);
-										editor->statusLabel.setColour(juce::Label::textColourId, ColourPalette::textSuccess);
-									}
-									});
-							}
-						});
-				}
-				continue; 
+				entry.processor->selectPreviousTrack();
+				pushStatus(entry, rawValue, StatusDetail::PreviousTrack);
 			}
-			auto *param = mapping.processor->getParameterTreeState().getParameter(mapping.parameterName);
-			if (param)
-			{
-				if (mapping.parameterName.startsWith("slot"))
-				{
-					juce::String slotPart = mapping.parameterName.substring(0, 5);
-					auto trackIds = mapping.processor->getAllTrackIds();
-					for (const auto &trackId : trackIds)
-					{
-						TrackData *track = mapping.processor->getTrack(trackId);
-						if (track)
-						{
-							juce::String expectedSlot = "slot" + juce::String(track->slotIndex + 1);
-							if (slotPart == expectedSlot)
-							{
-								break;
-							}
-						}
-					}
-				}
-				param->setValueNotifyingHost(value);
-				juce::MessageManager::callAsync([mapping, statusMessage, isWarning]()
-												{
-						if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor()))
-						{
-							editor->statusLabel.setText(statusMessage, juce::dontSendNotification);
-							if (isWarning) {
-								editor->statusLabel.setColour(juce::Label::textColourId, ColourPalette::textWarning);
-							}
-							juce::Timer::callAfterDelay(2000, [mapping]() {
-								if (auto* editor = dynamic_cast<DjIaVstEditor*>(mapping.processor->getActiveEditor())) {
-									editor->statusLabel.setText("Ready", juce::dontSendNotification);
-									editor->statusLabel.setColour(juce::Label::textColourId, ColourPalette::textSuccess);
-								}
-								});
-						} });
-
-				if (mapping.parameterName.contains("slot") && mapping.parameterName.contains("Play"))
-				{
-					juce::String slotStr = mapping.parameterName.substring(4, 5);
-					int slotNumber = slotStr.getIntValue();
-					if (slotNumber >= 1 && slotNumber <= 8)
-					{
-						changedPlaySlotIndex.store(slotNumber - 1);
-						mustCheckForMidiEvent.store(true);
-					}
-				}
-				if (mapping.parameterName.contains("slot") && mapping.parameterName.contains("Generate"))
-				{
-					if (mapping.processor->getIsGenerating())
-						return;
-					juce::String slotStr = mapping.parameterName.substring(4, 5);
-					int slotNumber = slotStr.getIntValue();
-					if (slotNumber >= 1 && slotNumber <= 8)
-					{
-						changedGenerateSlotIndex.store(slotNumber - 1);
-						mustCheckForMidiEvent.store(true);
-					}
-				}
-				if (mapping.parameterName.contains("slot") && mapping.parameterName.contains("RandomRetrigger"))
-				{
-					juce::String slotStr = mapping.parameterName.substring(4, 5);
-					int slotNumber = slotStr.getIntValue();
-					if (slotNumber >= 1 && slotNumber <= 8)
-					{
-						mustCheckForMidiEvent.store(true);
-					}
-				}
+		}
+		return true;
 
-				if (mapping.parameterName.contains("slot") && mapping.parameterName.contains("RetriggerInterval"))
-				{
-					juce::String slotStr = mapping.parameterName.substring(4, 5);
-					int slotNumber = slotStr.getIntValue();
-					if (slotNumber >= 1 && slotNumber <= 8)
-					{
-						mustCheckForMidiEvent.store(true);
-					}
-				}
-			}
+	case CompiledMapping::Action::GlobalGenerate:
+		if (message.isNoteOn() && entry.isBoolean)
+		{
+			entry.processor->triggerGlobalGeneration();
+			pushStatus(entry, rawValue, StatusDetail::GenerationTriggered);
 		}
+		return true;
+
+	case CompiledMapping::Action::Parameter:
+		break;
+	}
+
+	entry.parameter->setValueNotifyingHost(value);
+	pushStatus(entry, rawValue, detail);
+
+	if (entry.slotIndex < 0)
+		return true;
+
+	if (entry.isSlotPlay)
+	{
+		changedPlaySlotIndex.store(entry.slotIndex);
+		mustCheckForMidiEvent.store(true);
 	}
+	if (entry.isSlotGenerate)
+	{
+		changedGenerateSlotIndex.store(entry.slotIndex);
+		mustCheckForMidiEvent.store(true);
+	}
+	if (entry.notifiesMidiEvent)
+	{
+		mustCheckForMidiEvent.store(true);
+	}
+	return true;
+}
+
+void MidiLearnManager::pushStatus(const CompiledMapping &entry, int rawValue, StatusDetail detail) noexcept
+{
+	const auto scope = statusFifo.write(1);
+	if (scope.blockSize1 + scope.blockSize2 == 0)
+		return;
+
+	auto &event = statusEvents[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+	event.processor = entry.processor;
+	event.nameIndex = entry.nameIndex;
+	event.midiType = entry.midiType;
+	event.midiNumber = entry.midiNumber;
+	event.rawValue = rawValue;
+	event.detail = detail;
+}
+
+void MidiLearnManager::flushStatusMessages()
+{
+	reclaimRetiredTables();
+
+	const int numReady = statusFifo.getNumReady();
+	if (numReady == 0)
+		return;
+
+	// Only the newest reading is visible in the status bar, so a burst of
+	// controller data between two ticks formats a single string.
+	const auto scope = statusFifo.read(numReady);
+	const int lastIndex = scope.blockSize2 > 0 ? scope.startIndex2 + scope.blockSize2 - 1
+											   : scope.startIndex1 + scope.blockSize1 - 1;
+	const StatusEvent event = statusEvents[static_cast<size_t>(lastIndex)];
+
+	auto *editor = event.processor ? dynamic_cast<DjIaVstEditor *>(event.processor->getActiveEditor()) : nullptr;
+	if (!editor)
+		return;
+
+	const juce::String name = statusNames[event.nameIndex];
+	juce::String statusMessage;
+	switch (event.midiType)
+	{
+	case 0:
+		statusMessage = "Note " + juce::String(event.midiNumber) + " >> " + name;
+		break;
+	case 1:
+		statusMessage = "CC" + juce::String(event.midiNumber) + " >> " + name + " (" + juce::String(event.rawValue) + ")";
+		break;
+	default:
+		statusMessage = "Pitch Wheel >> " + name + " (" + juce::String(event.rawValue) + ")";
+		break;
+	}
+
+	switch (event.detail)
+	{
+	case StatusDetail::None:
+		break;
+	case StatusDetail::Trigger:
+		statusMessage += " (trigger)";
+		break;
+	case StatusDetail::ToggleOn:
+		statusMessage += " (toggle: ON)";
+		break;
+	case StatusDetail::ToggleOff:
+		statusMessage += " (toggle: OFF)";
+		break;
+	case StatusDetail::Velocity:
+		statusMessage += " (vel: " + juce::String(event.rawValue) + ")";
+		break;
+	case StatusDetail::NextTrack:
+		statusMessage += " (Next Track triggered)";
+		break;
+	case StatusDetail::PreviousTrack:
+		statusMessage += " (Previous Track triggered)";
+		break;
+	case StatusDetail::GenerationTriggered:
+		statusMessage += " (Generation triggered)";
+		break;
+	}
+
+	editor->statusLabel.setText(statusMessage, juce::dontSendNotification);
+	editor->statusLabel.setColour(juce::Label::textColourId, ColourPalette::textSuccess);
+
+	const juce::uint32 statusTime = juce::Time::getMillisecondCounter();
+	lastStatusTime = statusTime;
+	DjIaVstProcessor *processor = event.processor;
+	juce::Timer::callAfterDelay(2000, [this, processor, statusTime]()
+								{
+			if (statusTime != lastStatusTime)
+				return;
+			if (auto* statusEditor = dynamic_cast<DjIaVstEditor*>(processor->getActiveEditor())) {
+				statusEditor->statusLabel.setText("Ready", juce::dontSendNotification);
+				statusEditor->statusLabel.setColour(juce::Label::textColourId, ColourPalette::textSuccess);
+			} });
 }
 
 bool MidiLearnManager::isBooleanParameter(const juce::String& parameterName)
@@ -513,6 +580,7 @@ void MidiLearnManager::clearUICallbacks()
 	{
 		mapping.uiCallback = nullptr;
 	}
+	rebuildDispatchTable();
 	DBG("UI callbacks cleared");
 }
 
@@ -526,6 +594,7 @@ void MidiLearnManager::registerUICallback(const juce::String& parameterName,
 		{
 			mapping.uiCallback = callback;
 			DBG("Immediately restored callback for existing mapping: " + parameterName);
+			rebuildDispatchTable();
 			break;
 		}
 	}
@@ -541,11 +610,13 @@ void MidiLearnManager::restoreUICallbacks()
 			mapping.uiCallback = it->second;
 		}
 	}
+	rebuildDispatchTable();
 }
 
 void MidiLearnManager::addMapping(const MidiMapping &midiMapping)
 {
 	mappings.push_back(midiMapping);
+	rebuildDispatchTable();
 }
 
 void MidiLearnManager::removeMapping(juce::String parameterName)
@@ -557,11 +628,13 @@ void MidiLearnManager::removeMapping(juce::String parameterName)
 						   return mapping.parameterName == parameterName;
 					   }),
 		mappings.end());
+	rebuildDispatchTable();
 }
 
 void MidiLearnManager::clearAllMappings()
 {
 	mappings.clear();
+	rebuildDispatchTable();
 	DBG("All MIDI mappings cleared");
 }
 
@@ -582,6 +655,7 @@ bool MidiLearnManager::removeMappingForParameter(const juce::String &parameterNa
 	juce::String description = mappingIt->description;
 
 	mappings.erase(mappingIt);
+	rebuildDispatchTable();
 	juce::String statusMessage = "MIDI mapping removed: " + description;
 	DBG(statusMessage);
 	juce::MessageManager::callAsync([processor, statusMessage]()
@@ -10,6 +10,9 @@
 #include "MidiMapping.h"
 #include <vector>
 #include <functional>
+#include <array>
+#include <atomic>
+#include <memory>
 
 class DjIaVstEditor;
 class DjIaVstProcessor;
@@ -47,8 +50,87 @@ public:
 	juce::String getMappingDescription(const juce::String &parameterName) const;
 	void removeMappingsForSlot(int slotNumber);
 	void moveMappingsFromSlotToSlot(int fromSlot, int toSlot);
+	void flushStatusMessages();
 
 private:
+	/*
+		Mappings compiled for the audio thread: parameters and callbacks are
+		resolved once when the mapping list changes, and each incoming message
+		reads a single (type, channel, number) bucket instead of the whole list.
+		Tables are published and retired the same way as the track snapshots.
+	*/
+	struct CompiledMapping
+	{
+		enum class Action
+		{
+			Parameter,
+			UICallback,
+			NextTrack,
+			PreviousTrack,
+			GlobalGenerate
+		};
+
+		Action action = Action::Parameter;
+		DjIaVstProcessor *processor = nullptr;
+		juce::RangedAudioParameter *parameter = nullptr;
+		std::function<void(float)> uiCallback;
+		int midiType = 0;
+		int midiNumber = 0;
+		int nameIndex = -1;
+		int slotIndex = -1;
+		bool isBoolean = false;
+		bool isGenerateTrigger = false;
+		bool isSlotPlay = false;
+		bool isSlotGenerate = false;
+		bool notifiesMidiEvent = false;
+	};
+
+	struct DispatchTable
+	{
+		static constexpr int numKeys = 3 * 16 * 128;
+
+		struct Bucket
+		{
+			juce::uint16 first = 0;
+			juce::uint16 count = 0;
+		};
+
+		std::vector<CompiledMapping> entries;
+		std::array<Bucket, numKeys> buckets{};
+	};
+
+	enum class StatusDetail : juce::uint8
+	{
+		None,
+		Trigger,
+		ToggleOn,
+		ToggleOff,
+		Velocity,
+		NextTrack,
+		PreviousTrack,
+		GenerationTriggered
+	};
+
+	/* Plain data only; the text is built by flushStatusMessages on the message thread. */
+	struct StatusEvent
+	{
+		DjIaVstProcessor *processor = nullptr;
+		int nameIndex = -1;
+		int midiType = 0;
+		int midiNumber = 0;
+		int rawValue = 0;
+		StatusDetail detail = StatusDetail::None;
+	};
+
+	static constexpr int statusQueueSize = 64;
+
+	static int getDispatchKey(int midiType, int midiChannel, int midiNumber);
+	void rebuildDispatchTable();
+	void reclaimRetiredTables();
+	const DispatchTable &acquireDispatchTable() noexcept;
+	bool dispatchMapping(const CompiledMapping &entry, const juce::MidiMessage &message);
+	void pushStatus(const CompiledMapping &entry, int rawValue, StatusDetail detail) noexcept;
+
 	void timerCallback() override;
 	bool isLearning = false;
 	std::map<juce::String, std::function<void(float)>> registeredUICallbacks;
@@ -65,5 +147,15 @@ private:
 	MidiMapping learningMapping;
 	DjIaVstEditor *currentEditor = nullptr;
 
+	juce::StringArray statusNames;
+	std::unique_ptr<DispatchTable> publishedTable;
+	std::vector<std::unique_ptr<DispatchTable>> retiredTables;
+	std::atomic<DispatchTable *> currentTable{nullptr};
+	std::atomic<DispatchTable *> audioThreadTable{nullptr};
+
+	juce::AbstractFifo statusFifo{statusQueueSize};
+	std::array<StatusEvent, statusQueueSize> statusEvents;
+	juce::uint32 lastStatusTime = 0;
+
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiLearnManager)
 };
\ No newline at end of file
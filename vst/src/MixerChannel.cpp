@@ -659,19 +659,22 @@ void MixerChannel::drawVUMeter(juce::Graphics& g, juce::Rectangle<int> bounds)
 	if (!track)
 		return;
 
+	// Solid segments show RMS, fainter ones the sample peak above it; the
+	// hold line follows the inter-sample true peak and CLIP lights at 0 dBTP.
 	float currentLevel = getCurrentAudioLevel();
+	float currentRms = getRmsLevel();
 	float peakLevel = getPeakLevel();
 	int numSegments = 20;
 	float segmentHeight = (vuArea.getHeight() - 4) / numSegments;
 
 	for (int i = 0; i < numSegments; ++i)
 	{
-		fillMeters(vuArea, i, segmentHeight, numSegments, currentLevel, g);
+		fillMeters(vuArea, i, segmentHeight, numSegments, currentLevel, currentRms, g);
 	}
 
 	if (peakLevel > 0.0f)
 	{
-		int peakSegment = (int)(peakLevel * numSegments);
+		int peakSegment = (int)(juce::jmin(peakLevel, 1.0f) * numSegments);
 		if (peakSegment < numSegments)
 		{
 			float peakY = vuArea.getBottom() - 2 - (peakSegment + 1) * segmentHeight;
@@ -681,7 +684,7 @@ void MixerChannel::drawVUMeter(juce::Graphics& g, juce::Rectangle<int> bounds)
 			g.fillRect(peakRect);
 		}
 	}
-	if (peakLevel >= 0.95f)
+	if (peakLevel >= 1.0f)
 	{
 		auto clipRect = juce::Rectangle<float>(vuArea.getX(), vuArea.getY() - 8, vuArea.getWidth(), 4);
 		g.setColour(ColourPalette::vuClipping);
@@ -689,7 +692,7 @@ void MixerChannel::drawVUMeter(juce::Graphics& g, juce::Rectangle<int> bounds)
 	}
 }
 
-void MixerChannel::fillMeters(juce::Rectangle<float>& vuArea, int i, float segmentHeight, int numSegments, float currentLevel, juce::Graphics& g)
+void MixerChannel::fillMeters(juce::Rectangle<float>& vuArea, int i, float segmentHeight, int numSegments, float currentLevel, float currentRms, juce::Graphics& g)
 {
 	float segmentY = vuArea.getBottom() - 2 - (i + 1) * segmentHeight;
 	float segmentLevel = (float)i / numSegments;
@@ -705,11 +708,16 @@ void MixerChannel::fillMeters(juce::Rectangle<float>& vuArea, int i, float segme
 	else
 		segmentColour = ColourPalette::vuRed;
 
-	if (currentLevel >= segmentLevel)
+	if (currentRms >= segmentLevel)
 	{
 		g.setColour(segmentColour);
 		g.fillRoundedRectangle(segmentRect, 1.0f);
 	}
+	else if (currentLevel >= segmentLevel)
+	{
+		g.setColour(segmentColour.withAlpha(0.45f));
+		g.fillRoundedRectangle(segmentRect, 1.0f);
+	}
 	else
 	{
 		g.setColour(segmentColour.withAlpha(0.1f));
@@ -762,6 +770,7 @@ void MixerChannel::updateVUMeter()
 	if (!track || !track->isPlaying.load())
 	{
 		currentAudioLevel *= 0.95f;
+		rmsLevel *= 0.95f;
 		if (peakHoldTimer > 0)
 		{
 			peakHoldTimer--;
@@ -771,7 +780,11 @@ void MixerChannel::updateVUMeter()
 		return;
 	}
 
-	float instantLevel = calculateInstantLevel();
+	float instantLevel = takeMeteredLevel();
+	float instantRms = meteredRms;
+	float instantTruePeak = meteredTruePeak;
+	meteredRms = 0.0f;
+	meteredTruePeak = 0.0f;
 
 	levelHistory.push_back(instantLevel);
 	if (levelHistory.size() > 5)
@@ -791,42 +804,38 @@ void MixerChannel::updateVUMeter()
 		currentAudioLevel = currentAudioLevel * 0.85f + smoothedLevel * 0.15f;
 	}
 
-	if (currentAudioLevel > peakHold)
+	// RMS is already averaged over the meter window, so it only needs a
+	// light one-pole to steady the bar.
+	rmsLevel = rmsLevel * 0.7f + instantRms * 0.3f;
+
+	if (instantTruePeak > peakHold)
 	{
-		peakHold = currentAudioLevel;
+		peakHold = instantTruePeak;
 		peakHoldTimer = 30;
 	}
+	else if (peakHoldTimer > 0)
+	{
+		peakHoldTimer--;
+	}
+	else
+	{
+		peakHold *= 0.95f;
+	}
 }
 
-float MixerChannel::calculateInstantLevel()
+void MixerChannel::setMeterReading(const MeterReading& reading)
 {
-	if (!track || track->numSamples == 0)
-		return 0.0f;
-
-	double readPos = track->readPosition.load();
-	int sampleIndex = (int)(readPos);
-
-	if (sampleIndex >= 0 && sampleIndex < track->numSamples)
-	{
-		float level = 0.0f;
-		int samples = std::min(32, track->numSamples - sampleIndex);
-
-		for (int i = 0; i < samples; ++i)
-		{
-			for (int ch = 0; ch < track->audioBuffer.getNumChannels(); ++ch)
-			{
-				float sample = track->audioBuffer.getSample(ch, sampleIndex + i);
-				level += std::abs(sample);
-			}
-		}
-
-		level /= (samples * track->audioBuffer.getNumChannels());
-		level *= track->volume.load();
-
-		return juce::jlimit(0.0f, 1.0f, level * 3.0f);
-	}
+	meteredLevel = std::max(meteredLevel, juce::jlimit(0.0f, 1.0f, reading.peak));
+	meteredRms = std::max(meteredRms, juce::jlimit(0.0f, 1.0f, reading.rms));
+	// Not clamped: a true peak over 1.0 is what lights the clip indicator.
+	meteredTruePeak = std::max(meteredTruePeak, reading.truePeak);
+}
 
-	return 0.0f;
+float MixerChannel::takeMeteredLevel()
+{
+	float level = meteredLevel;
+	meteredLevel = 0.0f;
+	return level;
 }
 
 void MixerChannel::setSelected(bool selected)
@@ -19,7 +19,9 @@ public:
 	juce::Label trackNameLabel;
 	TrackData* track;
 	float getCurrentAudioLevel() const { return currentAudioLevel; }
+	float getRmsLevel() const { return rmsLevel; }
 	float getPeakLevel() const { return peakHold; }
+	void setMeterReading(const MeterReading& reading);
 	void setSelected(bool selected);
 	void updateFromTrackData();
 	void updateVUMeters();
@@ -46,6 +48,10 @@ private:
 	float peakHold = 0.0f;
 	int peakHoldTimer = 0;
 	std::vector<float> levelHistory;
+	float meteredLevel = 0.0f;
+	float meteredRms = 0.0f;
+	float meteredTruePeak = 0.0f;
+	float rmsLevel = 0.0f;
 
 	bool isBlinking = false;
 	bool blinkState = false;
@@ -67,10 +73,10 @@ private:
 
 	void paint(juce::Graphics& g) override;
 	void drawVUMeter(juce::Graphics& g, juce::Rectangle<int> bounds);
-	void fillMeters(juce::Rectangle<float>& vuArea, int i, float segmentHeight, int numSegments, float currentLevel, juce::Graphics& g);
+	void fillMeters(juce::Rectangle<float>& vuArea, int i, float segmentHeight, int numSegments, float currentLevel, float currentRms, juce::Graphics& g);
 	void resized() override;
 	void updateVUMeter();
-	float calculateInstantLevel();
+	float takeMeteredLevel();
 	void setCurrentLevel(float level);
 	void timerCallback() override;
 	void setupMidiLearn();
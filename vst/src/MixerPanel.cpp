@@ -41,11 +41,34 @@ void MixerPanel::updateTrackName(const juce::String& trackId, const juce::String
 
 void MixerPanel::updateAllMixerComponents()
 {
+	MeterReading master;
+	bool hasMasterReading = false;
+	audioProcessor.getMeterFeed().drain([this, &master, &hasMasterReading](const MeterReading& reading)
+		{
+			if (reading.slot == MeterReading::masterSlot)
+			{
+				master.peak = std::max(master.peak, reading.peak);
+				master.rms = std::max(master.rms, reading.rms);
+				master.truePeak = std::max(master.truePeak, reading.truePeak);
+				hasMasterReading = true;
+				return;
+			}
+			for (auto& channel : mixerChannels)
+			{
+				if (channel->track && channel->track->slotIndex == reading.slot)
+				{
+					channel->setMeterReading(reading);
+					break;
+				}
+			}
+		});
+
 	for (auto& channel : mixerChannels)
 	{
 		channel->updateVUMeters();
 	}
-	calculateMasterLevel();
+	if (hasMasterReading)
+		masterChannel->setRealAudioReading(master);
 	masterChannel->updateMasterLevels();
 }
 
@@ -59,36 +82,6 @@ float MixerPanel::getMasterPan() const
 	return masterPan;
 }
 
-void MixerPanel::calculateMasterLevel()
-{
-	float totalLevel = 0.0f;
-	float maxLevel = 0.0f;
-	int activeChannels = 0;
-
-	for (auto& channel : mixerChannels)
-	{
-		float channelLevel = channel->getCurrentAudioLevel();
-		if (channelLevel > 0.01f)
-		{
-			totalLevel += channelLevel * channelLevel;
-			maxLevel = std::max(maxLevel, channelLevel);
-			activeChannels++;
-		}
-	}
-
-	if (activeChannels > 0)
-	{
-		float rmsLevel = std::sqrt(totalLevel / activeChannels);
-		float finalLevel = (rmsLevel * 0.7f) + (maxLevel * 0.3f);
-		finalLevel *= masterVolume;
-		masterChannel->setRealAudioLevel(finalLevel);
-	}
-	else
-	{
-		masterChannel->setRealAudioLevel(0.0f);
-	}
-}
-
 void MixerPanel::refreshMixerChannels()
 {
 	for (auto& mixerChannel : mixerChannels)
@@ -126,7 +119,7 @@ void MixerPanel::refreshMixerChannels()
 	}
 	for (auto& channel : mixerChannels) {
 		juce::String trackId = channel->getTrackId();
-		if (audioProcessor.getGeneratingTrackId() == trackId && audioProcessor.getIsGenerating()) {
+		if (audioProcessor.isTrackGenerating(trackId)) {
 			channel->startGeneratingAnimation();
 		}
 	}
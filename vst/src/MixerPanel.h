@@ -24,7 +24,6 @@ public:
 	float getMasterVolume() const;
 	float getMasterPan() const;
 
-	void calculateMasterLevel();
 	void refreshMixerChannels();
 	void refreshAllChannels();
 
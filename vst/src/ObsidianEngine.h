@@ -20,23 +20,29 @@ public:
 		float bpm = 120.0f;
 		juce::String key = "C Aeolian";
 		std::vector<juce::String> preferredStems;
+		int numThreads = StableAudioEngine::getDefaultThreadCount(1);
 	};
 
 	struct LoopResponse
 	{
 		bool success = false;
 		juce::String errorMessage;
-		std::vector<float> audioData;
-		std::vector<float> leftChannel;
-		std::vector<float> rightChannel;
+		juce::AudioBuffer<float> audio;
+		double sampleRate = 0.0;
 		float actualDuration = 0.0f;
 		float bpm = 120.0f;
 		float duration = 0.0f;
 		juce::String optimizedPrompt;
 		std::vector<juce::String> stemsUsed;
+
+		LoopResponse() = default;
+		LoopResponse(LoopResponse &&) = default;
+		LoopResponse &operator=(LoopResponse &&) = default;
+		LoopResponse(const LoopResponse &) = delete;
+		LoopResponse &operator=(const LoopResponse &) = delete;
 	};
 
-	typedef std::function<void(LoopResponse)> GenerationCallback;
+	typedef std::function<void(LoopResponse &&)> GenerationCallback;
 
 private:
 	std::unique_ptr<StableAudioEngine> stableAudioEngine;
@@ -66,9 +72,9 @@ public:
 	{
 		juce::Thread::launch([this, request, callback]()
 							 {
-				auto response = generateLoop(request);
+				auto response = std::make_shared<LoopResponse>(generateLoop(request));
 				juce::MessageManager::callAsync([callback, response]() {
-					callback(response);
+					callback(std::move(*response));
 					}); });
 	}
 
@@ -84,7 +90,7 @@ private:
 			StableAudioEngine::GenerationParams audioParams;
 			audioParams.prompt = optimizedPrompt;
 			audioParams.duration = request.generationDuration;
-			audioParams.numThreads = 4;
+			audioParams.numThreads = request.numThreads;
 			audioParams.seed = -1;
 
 			auto audioResult = stableAudioEngine->generateSample(audioParams);
@@ -92,9 +98,8 @@ private:
 			if (audioResult.success)
 			{
 				response.success = true;
-				response.audioData = audioResult.audioData;
-				response.leftChannel = audioResult.leftChannel;
-				response.rightChannel = audioResult.rightChannel;
+				response.audio = std::move(audioResult.audio);
+				response.sampleRate = audioResult.sampleRate;
 				response.actualDuration = audioResult.actualDuration;
 				response.duration = audioResult.actualDuration;
 				response.bpm = request.bpm;
@@ -0,0 +1,192 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "OfflineBouncer.h"
+#include "PluginProcessor.h"
+
+OfflineBouncer::OfflineBouncer(DjIaVstProcessor& processorToUse)
+	: juce::Thread("Offline Bounce"), processor(processorToUse)
+{
+}
+
+OfflineBouncer::~OfflineBouncer()
+{
+	stopThread(10000);
+	writerThread.stopThread(10000);
+}
+
+bool OfflineBouncer::start(const Settings& settingsToUse, std::function<void(const Result&)> onFinishedCallback)
+{
+	if (isThreadRunning())
+		return false;
+
+	settings = settingsToUse;
+	onFinished = std::move(onFinishedCallback);
+	progress = 0.0f;
+	return startThread(juce::Thread::Priority::high);
+}
+
+void OfflineBouncer::cancel()
+{
+	signalThreadShouldExit();
+}
+
+void OfflineBouncer::run()
+{
+	auto result = render();
+	DBG("Offline bounce: " << result.message);
+
+	juce::MessageManager::callAsync([callback = onFinished, result]()
+		{
+			if (callback)
+				callback(result);
+		});
+}
+
+OfflineBouncer::Result OfflineBouncer::render()
+{
+	Result result;
+	const double sampleRate = processor.getSampleRate();
+	const int blockSize = juce::jlimit(64, 8192, settings.blockSize);
+	const juce::int64 totalSamples = static_cast<juce::int64>(settings.lengthSeconds * sampleRate);
+
+	if (sampleRate <= 0.0 || totalSamples <= 0)
+	{
+		result.message = "Nothing to bounce: the plugin has not been prepared by the host yet";
+		return result;
+	}
+	if (!settings.directory.createDirectory())
+	{
+		result.message = "Cannot create " + settings.directory.getFullPathName();
+		return result;
+	}
+
+	// Stems for slots holding a track; empty slots only reach the master.
+	const auto slotNames = processor.getSlotTrackNames();
+	std::vector<juce::AudioBuffer<float>> slotOutputs(static_cast<size_t>(slotNames.size()));
+	std::vector<std::unique_ptr<Writer>> stemWriters(slotOutputs.size());
+
+	writerThread.startThread(juce::Thread::Priority::normal);
+	auto masterWriter = createWriter(settings.directory.getChildFile("Master.wav"), sampleRate);
+	if (!masterWriter)
+	{
+		result.message = "Cannot write to " + settings.directory.getFullPathName();
+		writerThread.stopThread(1000);
+		return result;
+	}
+	result.files.add(settings.directory.getChildFile("Master.wav"));
+
+	for (int slot = 0; settings.writeStems && slot < slotNames.size(); ++slot)
+	{
+		if (slotNames[slot].isEmpty())
+			continue;
+
+		const auto name = juce::String(slot + 1).paddedLeft('0', 2) + " " + juce::File::createLegalFileName(slotNames[slot]);
+		const auto file = settings.directory.getChildFile(name + ".wav");
+		if (auto writer = createWriter(file, sampleRate))
+		{
+			stemWriters[static_cast<size_t>(slot)] = std::move(writer);
+			slotOutputs[static_cast<size_t>(slot)].setSize(2, blockSize);
+			result.files.add(file);
+		}
+	}
+
+	if (!processor.beginOfflineRender(blockSize))
+	{
+		result.message = "The processor could not enter offline rendering";
+		writerThread.stopThread(1000);
+		return result;
+	}
+
+	const auto startTime = juce::Time::getMillisecondCounterHiRes();
+	VirtualPlayHead transport;
+	transport.setTempo(settings.bpm, settings.timeSignatureNumerator, settings.timeSignatureDenominator);
+	transport.reset(sampleRate, true);
+	juce::AudioBuffer<float> master(2, blockSize);
+	bool writeFailed = false;
+	juce::int64 rendered = 0;
+
+	while (rendered < totalSamples && !threadShouldExit() && !writeFailed)
+	{
+		const int numSamples = static_cast<int>(std::min<juce::int64>(blockSize, totalSamples - rendered));
+		master.setSize(2, numSamples, false, false, true);
+		for (auto& output : slotOutputs)
+		{
+			if (output.getNumChannels() > 0)
+				output.setSize(2, numSamples, false, false, true);
+		}
+
+		processor.renderOfflineBlock(transport, master, slotOutputs);
+		transport.advance(numSamples);
+		rendered += numSamples;
+
+		writeFailed = !write(*masterWriter, master, numSamples);
+		for (size_t slot = 0; slot < stemWriters.size() && !writeFailed; ++slot)
+		{
+			if (stemWriters[slot])
+				writeFailed = !write(*stemWriters[slot], slotOutputs[slot], numSamples);
+		}
+		progress = static_cast<float>(static_cast<double>(rendered) / static_cast<double>(totalSamples));
+	}
+
+	processor.endOfflineRender();
+	result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+	result.audioSeconds = static_cast<double>(rendered) / sampleRate;
+
+	// Destroying a ThreadedWriter flushes what it still holds.
+	masterWriter.reset();
+	stemWriters.clear();
+	writerThread.stopThread(10000);
+
+	if (threadShouldExit())
+		result.message = "Bounce cancelled";
+	else if (writeFailed)
+		result.message = "Bounce stopped: the disk could not keep up or is full";
+	else
+	{
+		result.succeeded = true;
+		result.message = "Bounced " + juce::String(result.audioSeconds, 1) + " s to " + juce::String(result.files.size())
+			+ " files in " + juce::String(result.renderSeconds, 1) + " s";
+	}
+	progress = 1.0f;
+	return result;
+}
+
+std::unique_ptr<OfflineBouncer::Writer> OfflineBouncer::createWriter(const juce::File& file, double sampleRate)
+{
+	file.deleteFile();
+	auto* fileStream = new juce::FileOutputStream(file, fileBufferBytes);
+	if (!fileStream->openedOk())
+	{
+		delete fileStream;
+		return nullptr;
+	}
+
+	juce::WavAudioFormat wavFormat;
+	std::unique_ptr<juce::AudioFormatWriter> writer(
+		wavFormat.createWriterFor(fileStream, sampleRate, 2, settings.bitsPerSample, {}, 0));
+	if (writer == nullptr)
+	{
+		delete fileStream;
+		return nullptr;
+	}
+	return std::make_unique<Writer>(writer.release(), writerThread, writerFifoSamples);
+}
+
+bool OfflineBouncer::write(Writer& writer, const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+	// The FIFO is full only when the disk falls behind; wait for it rather than drop audio.
+	for (int attempt = 0; attempt < 10000; ++attempt)
+	{
+		if (writer.write(buffer.getArrayOfReadPointers(), numSamples))
+			return true;
+		if (threadShouldExit())
+			return false;
+		wait(1);
+	}
+	return false;
+}
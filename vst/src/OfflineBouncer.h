@@ -0,0 +1,75 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "VirtualPlayHead.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class DjIaVstProcessor;
+
+/*
+	Renders the current set faster than real time. The processor is
+	suspended for the host and driven block by block from a virtual
+	transport on this thread; slots render in parallel on the track render
+	pool. The master and one stem per track stream to WAV files through a
+	ThreadedWriter each, so disk writes never hold up the render loop.
+*/
+class OfflineBouncer : private juce::Thread
+{
+public:
+	struct Settings
+	{
+		juce::File directory;
+		double lengthSeconds = 60.0;
+		double bpm = 126.0;
+		int timeSignatureNumerator = 4;
+		int timeSignatureDenominator = 4;
+		bool writeStems = true;
+		int blockSize = 2048;
+		int bitsPerSample = 24;
+	};
+
+	struct Result
+	{
+		bool succeeded = false;
+		juce::String message;
+		juce::Array<juce::File> files;
+		double audioSeconds = 0.0;
+		double renderSeconds = 0.0;
+	};
+
+	explicit OfflineBouncer(DjIaVstProcessor& processor);
+	~OfflineBouncer() override;
+
+	/** Message thread. onFinished runs on the message thread; returns false if a bounce is already running. */
+	bool start(const Settings& settings, std::function<void(const Result&)> onFinished);
+	void cancel();
+	bool isBouncing() const { return isThreadRunning(); }
+	float getProgress() const { return progress.load(); }
+
+private:
+	using Writer = juce::AudioFormatWriter::ThreadedWriter;
+
+	void run() override;
+	Result render();
+	std::unique_ptr<Writer> createWriter(const juce::File& file, double sampleRate);
+	bool write(Writer& writer, const juce::AudioBuffer<float>& buffer, int numSamples);
+
+	// Samples each writer may queue ahead of the disk, about ten seconds.
+	static constexpr int writerFifoSamples = 1 << 19;
+	static constexpr int fileBufferBytes = 1 << 20;
+
+	DjIaVstProcessor& processor;
+	juce::TimeSliceThread writerThread{ "Bounce Writer" };
+	Settings settings;
+	std::function<void(const Result&)> onFinished;
+	std::atomic<float> progress{ 0.0f };
+};
@@ -0,0 +1,333 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OBSIDIAN_KERNEL_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OBSIDIAN_KERNEL_NEON 1
+#endif
+
+class PlaybackKernel
+{
+public:
+	enum class InterpolationQuality
+	{
+		Linear = 0,
+		Cubic,
+		Sinc
+	};
+
+	static constexpr int numInterpolationQualities = 3;
+	static constexpr double endFadeLength = 64.0;
+
+	static InterpolationQuality toInterpolationQuality(int value)
+	{
+		return static_cast<InterpolationQuality>(juce::jlimit(0, numInterpolationQualities - 1, value));
+	}
+
+	static juce::String getInterpolationQualityName(InterpolationQuality quality)
+	{
+		switch (quality)
+		{
+		case InterpolationQuality::Cubic:
+			return "CUB";
+		case InterpolationQuality::Sinc:
+			return "SNC";
+		default:
+			return "LIN";
+		}
+	}
+
+	static void prepareTables()
+	{
+		getSincTables();
+	}
+
+	static void interpolate(InterpolationQuality quality,
+		const float* source, int sourceLength,
+		double position, double ratio,
+		float* destination, int numSamples)
+	{
+		switch (quality)
+		{
+		case InterpolationQuality::Cubic:
+			interpolateCubic(source, sourceLength, position, ratio, destination, numSamples);
+			break;
+		case InterpolationQuality::Sinc:
+			interpolateSinc(source, sourceLength, position, ratio, destination, numSamples);
+			break;
+		default:
+			interpolateLinear(source, sourceLength, position, ratio, destination, numSamples);
+			break;
+		}
+	}
+
+	static int countSamplesBefore(double position, double limit, double ratio, int maxSamples)
+	{
+		if (maxSamples <= 0 || position >= limit)
+			return 0;
+		if (ratio <= 0.0)
+			return maxSamples;
+
+		double count = std::ceil((limit - position) / ratio);
+		return static_cast<int>(juce::jlimit(1.0, static_cast<double>(maxSamples), count));
+	}
+
+	static void interpolateLinear(const float* source, int sourceLength,
+		double position, double ratio,
+		float* destination, int numSamples)
+	{
+		if (numSamples <= 0 || sourceLength <= 0)
+			return;
+
+		const float lastSample = source[sourceLength - 1];
+
+		if (ratio == 1.0)
+		{
+			const int index = static_cast<int>(position);
+			const float fraction = static_cast<float>(position - index);
+			const int interpolatedCount = juce::jlimit(0, numSamples, sourceLength - 1 - index);
+
+			if (interpolatedCount > 0)
+			{
+				if (fraction == 0.0f)
+				{
+					juce::FloatVectorOperations::copy(destination, source + index, interpolatedCount);
+				}
+				else
+				{
+					juce::FloatVectorOperations::copyWithMultiply(destination, source + index, 1.0f - fraction, interpolatedCount);
+					juce::FloatVectorOperations::addWithMultiply(destination, source + index + 1, fraction, interpolatedCount);
+				}
+			}
+
+			if (interpolatedCount < numSamples)
+			{
+				juce::FloatVectorOperations::fill(destination + interpolatedCount, lastSample, numSamples - interpolatedCount);
+			}
+			return;
+		}
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const double samplePosition = position + i * ratio;
+			const int index = static_cast<int>(samplePosition);
+			if (index >= sourceLength - 1)
+			{
+				destination[i] = lastSample;
+				continue;
+			}
+
+			const float fraction = static_cast<float>(samplePosition - index);
+			const float current = source[index];
+			destination[i] = current + fraction * (source[index + 1] - current);
+		}
+	}
+
+	static void interpolateCubic(const float* source, int sourceLength,
+		double position, double ratio,
+		float* destination, int numSamples)
+	{
+		if (numSamples <= 0 || sourceLength <= 0)
+			return;
+
+		const int lastIndex = sourceLength - 1;
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const double samplePosition = position + i * ratio;
+			const int index = static_cast<int>(samplePosition);
+			if (index >= lastIndex)
+			{
+				destination[i] = source[lastIndex];
+				continue;
+			}
+
+			const float fraction = static_cast<float>(samplePosition - index);
+			const float previous = source[index > 0 ? index - 1 : 0];
+			const float current = source[index];
+			const float next = source[index + 1];
+			const float afterNext = source[std::min(index + 2, lastIndex)];
+
+			const float c1 = 0.5f * (next - previous);
+			const float c2 = previous - 2.5f * current + 2.0f * next - 0.5f * afterNext;
+			const float c3 = 0.5f * (afterNext - previous) + 1.5f * (current - next);
+			destination[i] = ((c3 * fraction + c2) * fraction + c1) * fraction + current;
+		}
+	}
+
+	static void interpolateSinc(const float* source, int sourceLength,
+		double position, double ratio,
+		float* destination, int numSamples)
+	{
+		if (numSamples <= 0 || sourceLength <= 0)
+			return;
+
+		const auto& table = getSincTables().forRatio(ratio);
+		const int lastIndex = sourceLength - 1;
+		alignas(16) float window[sincTaps];
+		alignas(16) float coefficients[sincTaps];
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const double samplePosition = position + i * ratio;
+			const int index = static_cast<int>(samplePosition);
+			if (index >= lastIndex)
+			{
+				destination[i] = source[lastIndex];
+				continue;
+			}
+
+			const float phasePosition = static_cast<float>(samplePosition - index) * sincPhases;
+			const int phase = std::min(static_cast<int>(phasePosition), sincPhases - 1);
+			const float phaseFraction = phasePosition - phase;
+			const float* lower = table.coefficients + phase * sincTaps;
+			const float* upper = lower + sincTaps;
+
+			for (int t = 0; t < sincTaps; ++t)
+			{
+				coefficients[t] = lower[t] + phaseFraction * (upper[t] - lower[t]);
+			}
+
+			const int first = index - sincHalfTaps + 1;
+			const float* taps = source + first;
+			if (first < 0 || first + sincTaps > sourceLength)
+			{
+				for (int t = 0; t < sincTaps; ++t)
+				{
+					window[t] = source[juce::jlimit(0, lastIndex, first + t)];
+				}
+				taps = window;
+			}
+
+			destination[i] = dotProduct(taps, coefficients);
+		}
+	}
+
+	static void applyEndFade(float* destination, int numSamples,
+		double position, double ratio, double endSample)
+	{
+		const double fadeStart = endSample - endFadeLength;
+		const double lastPosition = position + (numSamples - 1) * ratio;
+		if (numSamples <= 0 || lastPosition <= fadeStart)
+			return;
+
+		int firstFaded = 0;
+		if (position <= fadeStart && ratio > 0.0)
+		{
+			firstFaded = juce::jlimit(0, numSamples, static_cast<int>((fadeStart - position) / ratio));
+		}
+
+		for (int i = firstFaded; i < numSamples; ++i)
+		{
+			const double samplePosition = position + i * ratio;
+			if (samplePosition <= fadeStart)
+				continue;
+
+			float fadeGain = static_cast<float>((endSample - samplePosition) / endFadeLength);
+			destination[i] *= juce::jlimit(0.0f, 1.0f, fadeGain);
+		}
+	}
+
+private:
+	static constexpr int sincTaps = 16;
+	static constexpr int sincHalfTaps = sincTaps / 2;
+	static constexpr int sincPhases = 128;
+	static constexpr int numSincBands = 5;
+
+	struct SincTable
+	{
+		float coefficients[(sincPhases + 1) * sincTaps];
+	};
+
+	struct SincTables
+	{
+		SincTables()
+		{
+			for (int band = 0; band < numSincBands; ++band)
+			{
+				const double cutoff = 0.95 / bandMaxRatio[band];
+				for (int phase = 0; phase <= sincPhases; ++phase)
+				{
+					const double fraction = static_cast<double>(phase) / sincPhases;
+					float* row = bands[band].coefficients + phase * sincTaps;
+					double sum = 0.0;
+
+					for (int t = 0; t < sincTaps; ++t)
+					{
+						const double x = (t - sincHalfTaps + 1) - fraction;
+						const double sinc = std::abs(x) < 1.0e-9 ? 1.0
+							: std::sin(juce::MathConstants<double>::pi * cutoff * x) / (juce::MathConstants<double>::pi * cutoff * x);
+						const double windowPosition = (x + sincHalfTaps) / sincTaps;
+						const double blackman = 0.42
+							- 0.5 * std::cos(juce::MathConstants<double>::twoPi * windowPosition)
+							+ 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * windowPosition);
+						row[t] = static_cast<float>(sinc * juce::jmax(0.0, blackman));
+						sum += row[t];
+					}
+
+					if (sum > 0.0)
+					{
+						for (int t = 0; t < sincTaps; ++t)
+							row[t] = static_cast<float>(row[t] / sum);
+					}
+				}
+			}
+		}
+
+		const SincTable& forRatio(double ratio) const
+		{
+			for (int band = 0; band < numSincBands - 1; ++band)
+			{
+				if (ratio <= bandMaxRatio[band])
+					return bands[band];
+			}
+			return bands[numSincBands - 1];
+		}
+
+		static constexpr double bandMaxRatio[numSincBands] = { 1.0, 1.33, 2.0, 3.0, 4.0 };
+		SincTable bands[numSincBands];
+	};
+
+	static const SincTables& getSincTables()
+	{
+		static const SincTables tables;
+		return tables;
+	}
+
+	static float dotProduct(const float* samples, const float* coefficients)
+	{
+#if OBSIDIAN_KERNEL_SSE
+		__m128 accumulator = _mm_setzero_ps();
+		for (int t = 0; t < sincTaps; t += 4)
+		{
+			accumulator = _mm_add_ps(accumulator, _mm_mul_ps(_mm_loadu_ps(samples + t), _mm_load_ps(coefficients + t)));
+		}
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, accumulator);
+		return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif OBSIDIAN_KERNEL_NEON
+		float32x4_t accumulator = vdupq_n_f32(0.0f);
+		for (int t = 0; t < sincTaps; t += 4)
+		{
+			accumulator = vmlaq_f32(accumulator, vld1q_f32(samples + t), vld1q_f32(coefficients + t));
+		}
+		float32x2_t pair = vadd_f32(vget_low_f32(accumulator), vget_high_f32(accumulator));
+		return vget_lane_f32(vpadd_f32(pair, pair), 0);
+#else
+		float sum = 0.0f;
+		for (int t = 0; t < sincTaps; ++t)
+			sum += samples[t] * coefficients[t];
+		return sum;
+#endif
+	}
+};
@@ -55,18 +55,15 @@ DjIaVstEditor::DjIaVstEditor(DjIaVstProcessor& p)
 			}
 			if (audioProcessor.getIsGenerating())
 			{
-				generateButton.setEnabled(false);
-				setAllGenerateButtonsEnabled(false);
 				statusLabel.setText("Generation in progress...", juce::dontSendNotification);
-				juce::String generatingId = audioProcessor.getGeneratingTrackId();
 				for (auto& trackComp : trackComponents)
 				{
-					if (trackComp->getTrackId() == generatingId)
+					if (audioProcessor.isTrackGenerating(trackComp->getTrackId()))
 					{
 						trackComp->startGeneratingAnimation();
-						break;
 					}
 				}
+				refreshGenerationState();
 			} });
 }
 
@@ -108,6 +105,7 @@ void DjIaVstEditor::updateUIComponents()
 		startGenerationButtonAnimation();
 		startTimer(200);
 	}
+	refreshGenerationState();
 	for (auto& trackComp : trackComponents)
 	{
 		if (trackComp->isShowing())
@@ -218,6 +216,7 @@ void DjIaVstEditor::initUI()
 			} });
 			loadPromptPresets();
 			refreshTracks();
+			setBounceLock(audioProcessor.getOfflineBouncer().isBouncing());
 			audioProcessor.onUIUpdateNeeded = [this]()
 				{
 					juce::MessageManager::callAsync([this]()
@@ -523,7 +522,6 @@ void DjIaVstEditor::startGenerationButtonAnimation()
 	if (!isButtonBlinking)
 	{
 		originalButtonText = generateButton.getButtonText();
-		generateButton.setEnabled(false);
 		generateButton.setButtonText("Generating Track...");
 		generateButton.setColour(juce::TextButton::buttonColourId, ColourPalette::buttonWarning);
 		isButtonBlinking = true;
@@ -539,7 +537,6 @@ void DjIaVstEditor::stopGenerationButtonAnimation()
 		generateButton.setButtonText(originalButtonText);
 		generateButton.setColour(juce::TextButton::buttonColourId, ColourPalette::buttonSuccess);
 		isButtonBlinking = false;
-		generatingTrackId.clear();
 	}
 }
 
@@ -815,6 +812,9 @@ void DjIaVstEditor::setupUI()
 	addChildComponent(*sampleBankPanel);
 	sampleBankPanel->setVisible(false);
 
+	diagnosticsPanel = std::make_unique<DiagnosticsPanel>(audioProcessor);
+	addChildComponent(*diagnosticsPanel);
+
 	addAndMakeVisible(showSampleBankButton);
 	showSampleBankButton.setButtonText("Bank");
 	showSampleBankButton.setColour(juce::TextButton::buttonColourId, ColourPalette::indigo);
@@ -935,8 +935,7 @@ void DjIaVstEditor::addEventListeners()
 
 	resetUIButton.onClick = [this]()
 		{
-			audioProcessor.setIsGenerating(false);
-			audioProcessor.setGeneratingTrackId("");
+			audioProcessor.cancelQueuedGenerations();
 			generateButton.setEnabled(true);
 			setAllGenerateButtonsEnabled(true);
 			toggleWaveFormButtonOnTrack();
@@ -1354,6 +1353,10 @@ void DjIaVstEditor::resized()
 		auto bankArea = getLocalBounds().removeFromRight(400).reduced(5);
 		sampleBankPanel->setBounds(bankArea);
 	}
+	if (diagnosticsPanel && diagnosticsPanel->isVisible())
+	{
+		diagnosticsPanel->setBounds(getLocalBounds().removeFromLeft(420).reduced(5).withTrimmedTop(25));
+	}
 
 	resizing = false;
 }
@@ -1387,10 +1390,36 @@ void DjIaVstEditor::toggleSampleBank()
 	resized();
 }
 
+void DjIaVstEditor::toggleDiagnostics()
+{
+	if (!diagnosticsPanel)
+		return;
+
+	diagnosticsPanel->setVisible(!diagnosticsPanel->isVisible());
+	if (diagnosticsPanel->isVisible())
+		diagnosticsPanel->toFront(false);
+	setStatusWithTimeout(diagnosticsPanel->isVisible() ? "DSP diagnostics opened" : "DSP diagnostics closed", 2000);
+	resized();
+}
+
+void DjIaVstEditor::refreshGenerationState()
+{
+	for (auto& trackComp : trackComponents)
+	{
+		trackComp->setGenerateButtonEnabled(!audioProcessor.isTrackGenerating(trackComp->getTrackId()));
+	}
+	generateButton.setEnabled(!audioProcessor.isTrackGenerating(audioProcessor.getSelectedTrackId()));
+
+	if (isButtonBlinking)
+	{
+		const int numActive = audioProcessor.getGeneratingTrackIds().size();
+		generateButton.setButtonText(numActive > 1 ? "Generating " + juce::String(numActive) + " Tracks..." : "Generating Track...");
+	}
+}
+
 void DjIaVstEditor::startGenerationUI(const juce::String& trackId)
 {
-	generateButton.setEnabled(false);
-	setAllGenerateButtonsEnabled(false);
+	refreshGenerationState();
 	statusLabel.setText("Connecting to server...", juce::dontSendNotification);
 
 	for (auto& trackComp : trackComponents)
@@ -1412,9 +1441,6 @@ void DjIaVstEditor::startGenerationUI(const juce::String& trackId)
 
 void DjIaVstEditor::stopGenerationUI(const juce::String& trackId, bool success, const juce::String& errorMessage)
 {
-	generateButton.setEnabled(true);
-	setAllGenerateButtonsEnabled(true);
-
 	for (auto& trackComp : trackComponents)
 	{
 		if (trackComp->getTrackId() == trackId)
@@ -1432,10 +1458,14 @@ void DjIaVstEditor::stopGenerationUI(const juce::String& trackId, bool success,
 	{
 		mixerPanel->stopGeneratingAnimationForTrack(trackId);
 	}
-	isGenerating.store(false);
-	wasGenerating.store(false);
-	stopGenerationButtonAnimation();
-	stopTimer();
+	if (!audioProcessor.getIsGenerating())
+	{
+		isGenerating.store(false);
+		wasGenerating.store(false);
+		stopGenerationButtonAnimation();
+		stopTimer();
+	}
+	refreshGenerationState();
 	if (!success && !errorMessage.isEmpty())
 	{
 		statusLabel.setText("Error: " + errorMessage, juce::dontSendNotification);
@@ -1445,7 +1475,6 @@ void DjIaVstEditor::stopGenerationUI(const juce::String& trackId, bool success,
 void DjIaVstEditor::onGenerateButtonClicked()
 {
 	audioProcessor.syncSelectedTrackWithGlobalPrompt();
-	audioProcessor.setIsGenerating(true);
 	juce::String serverUrl = audioProcessor.getServerUrl();
 	juce::String apiKey = audioProcessor.getApiKey();
 	if (serverUrl.isEmpty())
@@ -1466,15 +1495,19 @@ void DjIaVstEditor::onGenerateButtonClicked()
 		return;
 	}
 
-	generatingTrackId = audioProcessor.getSelectedTrackId();
-	audioProcessor.setGeneratingTrackId(generatingTrackId);
-	TrackData* track = audioProcessor.trackManager.getTrack(generatingTrackId);
+	const juce::String trackId = audioProcessor.getSelectedTrackId();
+	TrackData* track = audioProcessor.trackManager.getTrack(trackId);
 
 	if (!track)
 	{
 		statusLabel.setText("Error: No track selected", juce::dontSendNotification);
 		return;
 	}
+	if (audioProcessor.isTrackGenerating(trackId))
+	{
+		statusLabel.setText("This track is already generating", juce::dontSendNotification);
+		return;
+	}
 
 	if (track->usePages.load()) {
 		auto& currentPage = track->getCurrentPage();
@@ -1522,31 +1555,12 @@ void DjIaVstEditor::onGenerateButtonClicked()
 			track->preferredStems.push_back("piano");
 	}
 
-	startGenerationUI(generatingTrackId);
-	juce::String selectedTrackId = generatingTrackId;
-	auto request = track->createLoopRequest();
-	juce::Thread::launch([this, selectedTrackId, request]()
-		{
-			try
-			{
-				juce::MessageManager::callAsync([this]() {
-					statusLabel.setText("Generating loop (this may take a few minutes)...",
-						juce::dontSendNotification);
-					});
-
-				audioProcessor.setServerUrl(audioProcessor.getServerUrl());
-				audioProcessor.setApiKey(audioProcessor.getApiKey());
-				juce::Thread::sleep(100);
-				audioProcessor.generateLoop(request, generatingTrackId);
-			}
-			catch (const std::exception& e)
-			{
-				juce::MessageManager::callAsync([this, selectedTrackId, error = juce::String(e.what())]() {
-					stopGenerationUI(selectedTrackId, false, error);
-					audioProcessor.setIsGenerating(false);
-					audioProcessor.setGeneratingTrackId("");
-					});
-			} });
+	if (!audioProcessor.queueGeneration(track->createLoopRequest(), trackId))
+	{
+		statusLabel.setText("This track is already generating", juce::dontSendNotification);
+		return;
+	}
+	startGenerationUI(trackId);
 }
 
 void DjIaVstEditor::loadPromptPresets()
@@ -1660,7 +1674,7 @@ bool DjIaVstEditor::keyPressed(const juce::KeyPress& key)
 				for (auto& trackComp : trackComponents) {
 					if (auto* track = trackComp->getTrack()) {
 						if (track->slotIndex == slotIndex && track->usePages.load()) {
-							if (audioProcessor.getIsGenerating() && audioProcessor.getGeneratingTrackId() == track->trackId) {
+							if (audioProcessor.isTrackGenerating(track->trackId)) {
 								setStatusWithTimeout("Cannot switch pages during generation...");
 								return false;
 							}
@@ -1921,25 +1935,24 @@ void DjIaVstEditor::refreshTrackComponents()
 
 void DjIaVstEditor::generateFromTrackComponent(const juce::String& trackId)
 {
-	audioProcessor.setIsGenerating(true);
-
 	TrackData* track = audioProcessor.getTrack(trackId);
 	if (!track)
 	{
 		statusLabel.setText("Error: Track not found", juce::dontSendNotification);
-		audioProcessor.setIsGenerating(false);
 		return;
 	}
 
 	if (track->selectedPrompt.isEmpty())
 	{
 		statusLabel.setText("Error: No prompt selected for this track", juce::dontSendNotification);
-		audioProcessor.setIsGenerating(false);
 		return;
 	}
 
-	juce::String currentGeneratingTrackId = trackId;
-	audioProcessor.setGeneratingTrackId(currentGeneratingTrackId);
+	if (audioProcessor.isTrackGenerating(trackId))
+	{
+		statusLabel.setText("This track is already generating", juce::dontSendNotification);
+		return;
+	}
 
 	if (track->usePages.load()) {
 		auto& currentPage = track->getCurrentPage();
@@ -1989,22 +2002,10 @@ void DjIaVstEditor::generateFromTrackComponent(const juce::String& trackId)
 			track->preferredStems.push_back("piano");
 	}
 
-	startGenerationUI(currentGeneratingTrackId);
-
-	juce::Thread::launch([this, currentGeneratingTrackId, track]()
-		{
-			try {
-				auto request = track->createLoopRequest();
-				audioProcessor.generateLoop(request, currentGeneratingTrackId);
-			}
-			catch (const std::exception& e) {
-				juce::MessageManager::callAsync([this, currentGeneratingTrackId, error = juce::String(e.what())]() {
-					stopGenerationUI(currentGeneratingTrackId, false, error);
-					audioProcessor.setIsGenerating(false);
-					audioProcessor.setGeneratingTrackId("");
-					});
-			}
-		});
+	if (audioProcessor.queueGeneration(track->createLoopRequest(), trackId))
+	{
+		startGenerationUI(trackId);
+	}
 }
 
 juce::StringArray DjIaVstEditor::getAllPrompts() const
@@ -2122,6 +2123,7 @@ void DjIaVstEditor::updateSelectedTrack()
 	{
 		mixerPanel->trackSelected(selectedId);
 	}
+	refreshGenerationState();
 }
 
 void DjIaVstEditor::onSaveSession()
@@ -2158,6 +2160,73 @@ void DjIaVstEditor::onSaveSession()
 		});
 }
 
+void DjIaVstEditor::startOfflineBounce(int bars)
+{
+	OfflineBouncer::Settings settings;
+	settings.bpm = audioProcessor.getHostBpm();
+	settings.timeSignatureNumerator = juce::jmax(1, audioProcessor.getTimeSignatureNumerator());
+	settings.timeSignatureDenominator = juce::jmax(1, audioProcessor.getTimeSignatureDenominator());
+	settings.lengthSeconds = bars * settings.timeSignatureNumerator * (4.0 / settings.timeSignatureDenominator) * 60.0 / settings.bpm;
+	settings.directory = getSessionsDirectory().getSiblingFile("Bounces")
+		.getChildFile("Bounce_" + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S"));
+
+	const bool started = audioProcessor.getOfflineBouncer().start(settings,
+		[safeThis = juce::Component::SafePointer<DjIaVstEditor>(this)](const OfflineBouncer::Result& result)
+		{
+			if (safeThis == nullptr)
+				return;
+			safeThis->setBounceLock(false);
+			safeThis->statusLabel.setText(result.message, juce::dontSendNotification);
+			if (result.succeeded && !result.files.isEmpty())
+				result.files.getFirst().revealToUser();
+		});
+
+	if (started)
+		setBounceLock(true);
+	statusLabel.setText(started ? "Bouncing " + juce::String(bars) + " bars offline..." : "A bounce is already running",
+		juce::dontSendNotification);
+}
+
+void DjIaVstEditor::promptBounceLength()
+{
+	auto alertWindow = std::make_unique<juce::AlertWindow>("Bounce Master and Stems",
+		"Length in bars:", juce::MessageBoxIconType::QuestionIcon);
+	alertWindow->addTextEditor("bars", "32", "Bars:");
+	alertWindow->addButton("Bounce", 1);
+	alertWindow->addButton("Cancel", 0);
+
+	auto* window = alertWindow.release();
+	window->enterModalState(true, juce::ModalCallbackFunction::create([this, window](int modalResult)
+		{
+			if (modalResult != 1)
+				return;
+			const int bars = window->getTextEditorContents("bars").getIntValue();
+			if (bars < 1 || bars > maxBounceBars)
+			{
+				statusLabel.setText("Enter a length between 1 and " + juce::String(maxBounceBars) + " bars",
+					juce::dontSendNotification);
+				return;
+			}
+			startOfflineBounce(bars);
+		}), true);
+}
+
+/*
+	The bounce drives the tracks from its own transport, so the controls
+	that start, stop or rearrange them are greyed out until it finishes.
+*/
+void DjIaVstEditor::setBounceLock(bool bouncing)
+{
+	tracksContainer.setEnabled(!bouncing);
+	if (mixerPanel)
+		mixerPanel->setEnabled(!bouncing);
+	for (juce::Component* control : std::initializer_list<juce::Component*>{ &playButton, &testMidiButton,
+		&bypassSequencerButton, &addTrackButton, &loadSessionButton, &loadSampleButton, &nextTrackButton, &prevTrackButton })
+	{
+		control->setEnabled(!bouncing);
+	}
+}
+
 void DjIaVstEditor::saveCurrentSession(const juce::String& sessionName)
 {
 	try
@@ -2295,21 +2364,95 @@ juce::PopupMenu DjIaVstEditor::getMenuForIndex(int topLevelMenuIndex, const juce
 		menu.addSeparator();
 		menu.addItem(saveSession, "Save Session", true);
 		menu.addItem(saveSessionAs, "Save Session As...", true);
-		menu.addItem(loadSessionMenu, "Load Session...", true);
+		menu.addItem(loadSessionMenu, "Load Session...", !audioProcessor.getOfflineBouncer().isBouncing());
 		menu.addSeparator();
 		menu.addItem(exportSession, "Export Session", true);
+
+		const bool bouncing = audioProcessor.getOfflineBouncer().isBouncing();
+		juce::PopupMenu bounceMenu;
+		for (int bars : { 16, 32, 64, 128, 256 })
+			bounceMenu.addItem(bounceBarsBase + bars, juce::String(bars) + " Bars", !bouncing);
+		bounceMenu.addItem(bounceCustomLength, "Custom Length...", !bouncing);
+		bounceMenu.addSeparator();
+		bounceMenu.addItem(cancelBounce, "Cancel Bounce", bouncing);
+		menu.addSubMenu("Bounce Master and Stems", bounceMenu);
 	}
 	else if (topLevelMenuIndex == 1)
 	{
-		menu.addItem(addTrack, "Add New Track", true);
+		const bool bouncing = audioProcessor.getOfflineBouncer().isBouncing();
+		menu.addItem(addTrack, "Add New Track", !bouncing);
+		menu.addSeparator();
+		menu.addItem(deleteAllTracks, "Delete All Tracks", !bouncing && audioProcessor.getAllTrackIds().size() > 1);
+		menu.addItem(resetTracks, "Reset All Tracks", !bouncing);
+		menu.addSeparator();
+		menu.addItem(memoryMappedPages, "Memory-Mapped Pages", true, audioProcessor.getMemoryMappedPages());
+		menu.addItem(directBusRendering, "Render Directly Into Output Buses", true, audioProcessor.getDirectBusRendering());
+		menu.addItem(streamGeneratedAudio, "Stream Generated Audio", true, audioProcessor.getStreamGeneratedAudio());
+		menu.addItem(progressiveGeneration, "Progressive Generation", audioProcessor.getStreamGeneratedAudio(),
+			audioProcessor.getProgressiveGeneration());
+		menu.addItem(compressedTransfer, "Compressed Transfer (FLAC)", true, audioProcessor.getCompressedTransfer());
+
+		juce::PopupMenu renderMenu;
+		for (int threads : { 1, 2, 4, 8 })
+		{
+			renderMenu.addItem(renderThreadsBase + threads, threads == 1 ? juce::String("Serial") : juce::String(threads) + " Threads",
+				true, audioProcessor.getRenderThreads() == threads);
+		}
+		menu.addSubMenu("Track Rendering", renderMenu);
+
+		juce::PopupMenu capacityMenu;
+		for (int capacity : { 8, 16, 24, 32 })
+		{
+			capacityMenu.addItem(trackCapacityBase + capacity, juce::String(capacity) + " Slots",
+				true, audioProcessor.getConfiguredTrackCapacity() == capacity);
+		}
+		menu.addSubMenu("Track Capacity", capacityMenu);
+		menu.addItem(groupExtraSlots, "Group Slots 9+ Onto Track Buses", audioProcessor.getTrackCapacity() > SlotParameters::legacySlots,
+			audioProcessor.getGroupExtraSlotsOnBuses());
+
+		juce::PopupMenu generationMenu;
+		for (int requests : { 1, 2, 4, 8 })
+		{
+			generationMenu.addItem(generationRequestsBase + requests, juce::String(requests) + (requests == 1 ? " Server Request" : " Server Requests"),
+				true, audioProcessor.getMaxConcurrentGenerations() == requests);
+		}
+		generationMenu.addSeparator();
+		for (int requests : { 1, 2 })
+		{
+			generationMenu.addItem(localGenerationRequestsBase + requests, juce::String(requests) + (requests == 1 ? " Local Generation" : " Local Generations"),
+				true, audioProcessor.getMaxConcurrentLocalGenerations() == requests);
+		}
+		menu.addSubMenu("Concurrent Generations", generationMenu);
+
 		menu.addSeparator();
-		menu.addItem(deleteAllTracks, "Delete All Tracks", audioProcessor.getAllTrackIds().size() > 1);
-		menu.addItem(resetTracks, "Reset All Tracks", true);
+		const int variationsReady = audioProcessor.getNumVariationsReady(audioProcessor.getSelectedTrackId());
+		menu.addItem(nextVariation, "Next Variation (" + juce::String(variationsReady) + " ready)", variationsReady > 0);
+		menu.addItem(speculativeVariations, "Speculative Variations", true, audioProcessor.getSpeculativeGeneration());
+		juce::PopupMenu budgetMenu;
+		for (int budget : { 4, 8, 16, 32 })
+		{
+			budgetMenu.addItem(speculativeBudgetBase + budget, juce::String(budget) + " Generations",
+				true, audioProcessor.getSpeculativeBudget() == budget);
+		}
+		menu.addSubMenu("Variation Budget (" + juce::String(audioProcessor.getSpeculativeRemaining()) + " left)", budgetMenu,
+			audioProcessor.getSpeculativeGeneration());
+
+		juce::PopupMenu localThreadsMenu;
+		localThreadsMenu.addItem(localGenerationThreadsBase, "Auto (" + juce::String(StableAudioEngine::getDefaultThreadCount(audioProcessor.getRenderThreads())) + ")",
+			true, audioProcessor.getLocalGenerationThreads() == 0);
+		for (int threads : { 2, 4, 8, 16 })
+		{
+			localThreadsMenu.addItem(localGenerationThreadsBase + threads, juce::String(threads) + " Threads",
+				true, audioProcessor.getLocalGenerationThreads() == threads);
+		}
+		menu.addSubMenu("Local Generation Threads", localThreadsMenu);
 	}
 	else if (topLevelMenuIndex == 2)
 	{
 		menu.addItem(aboutDjIa, "About OBSIDIAN-Neural", true);
 		menu.addItem(showHelp, "Show Help", true);
+		menu.addSeparator();
+		menu.addItem(showDiagnostics, "DSP Diagnostics", true, diagnosticsPanel && diagnosticsPanel->isVisible());
 	}
 
 	return menu;
@@ -2317,6 +2460,58 @@ juce::PopupMenu DjIaVstEditor::getMenuForIndex(int topLevelMenuIndex, const juce
 
 void DjIaVstEditor::menuItemSelected(int menuItemID, int /*topLevelMenuIndex*/)
 {
+	if (menuItemID > renderThreadsBase && menuItemID <= renderThreadsBase + RenderWorkerPool::maxThreads)
+	{
+		audioProcessor.setRenderThreads(menuItemID - renderThreadsBase);
+		statusLabel.setText(audioProcessor.getRenderThreads() > 1
+			? "Tracks render on " + juce::String(audioProcessor.getRenderThreads()) + " threads"
+			: "Tracks render on the audio thread", juce::dontSendNotification);
+		return;
+	}
+	if (menuItemID > generationRequestsBase && menuItemID <= generationRequestsBase + GenerationQueue::maxConcurrency)
+	{
+		audioProcessor.setMaxConcurrentGenerations(menuItemID - generationRequestsBase);
+		statusLabel.setText("Up to " + juce::String(audioProcessor.getMaxConcurrentGenerations()) + " server generations at once",
+			juce::dontSendNotification);
+		return;
+	}
+	if (menuItemID > localGenerationRequestsBase && menuItemID <= localGenerationRequestsBase + GenerationQueue::maxConcurrency)
+	{
+		audioProcessor.setMaxConcurrentLocalGenerations(menuItemID - localGenerationRequestsBase);
+		statusLabel.setText("Up to " + juce::String(audioProcessor.getMaxConcurrentLocalGenerations()) + " local generations at once",
+			juce::dontSendNotification);
+		return;
+	}
+
+	if (menuItemID > bounceBarsBase && menuItemID <= bounceBarsBase + 256)
+	{
+		startOfflineBounce(menuItemID - bounceBarsBase);
+		return;
+	}
+
+	if (menuItemID > trackCapacityBase && menuItemID <= trackCapacityBase + SlotParameters::maxSlots)
+	{
+		audioProcessor.setConfiguredTrackCapacity(menuItemID - trackCapacityBase);
+		statusLabel.setText("Track capacity " + juce::String(audioProcessor.getConfiguredTrackCapacity())
+			+ " applies the next time the plugin is loaded", juce::dontSendNotification);
+		return;
+	}
+
+	if (menuItemID > speculativeBudgetBase && menuItemID <= speculativeBudgetBase + 32)
+	{
+		audioProcessor.setSpeculativeBudget(menuItemID - speculativeBudgetBase);
+		statusLabel.setText("Up to " + juce::String(audioProcessor.getSpeculativeBudget()) + " speculative generations this session",
+			juce::dontSendNotification);
+		return;
+	}
+	if (menuItemID >= localGenerationThreadsBase && menuItemID <= localGenerationThreadsBase + 64)
+	{
+		audioProcessor.setLocalGenerationThreads(menuItemID - localGenerationThreadsBase);
+		statusLabel.setText("Local generation uses " + juce::String(audioProcessor.getEffectiveLocalGenerationThreads()) + " threads",
+			juce::dontSendNotification);
+		return;
+	}
+
 	switch (menuItemID)
 	{
 	case newSession:
@@ -2327,6 +2522,14 @@ void DjIaVstEditor::menuItemSelected(int menuItemID, int /*topLevelMenuIndex*/)
 		onSaveSession();
 		break;
 
+	case bounceCustomLength:
+		promptBounceLength();
+		break;
+	case cancelBounce:
+		audioProcessor.getOfflineBouncer().cancel();
+		statusLabel.setText("Cancelling bounce...", juce::dontSendNotification);
+		break;
+
 	case saveSessionAs:
 		onSaveSession();
 		break;
@@ -2370,6 +2573,61 @@ void DjIaVstEditor::menuItemSelected(int menuItemID, int /*topLevelMenuIndex*/)
 		statusLabel.setText("Reset tracks - Coming soon!", juce::dontSendNotification);
 		break;
 
+	case memoryMappedPages:
+		audioProcessor.setMemoryMappedPages(!audioProcessor.getMemoryMappedPages());
+		statusLabel.setText(audioProcessor.getMemoryMappedPages()
+			? "Inactive pages now play from memory-mapped cache"
+			: "Pages are decoded into memory", juce::dontSendNotification);
+		break;
+
+	case directBusRendering:
+		audioProcessor.setDirectBusRendering(!audioProcessor.getDirectBusRendering());
+		statusLabel.setText(audioProcessor.getDirectBusRendering()
+			? "Tracks render straight into their output buses"
+			: "Tracks render through intermediate buffers", juce::dontSendNotification);
+		break;
+
+	case groupExtraSlots:
+		audioProcessor.setGroupExtraSlotsOnBuses(!audioProcessor.getGroupExtraSlotsOnBuses());
+		statusLabel.setText(audioProcessor.getGroupExtraSlotsOnBuses()
+			? "Slots 9+ also play on track buses 1-8"
+			: "Slots 9+ play on the main output only", juce::dontSendNotification);
+		break;
+
+	case streamGeneratedAudio:
+		audioProcessor.setStreamGeneratedAudio(!audioProcessor.getStreamGeneratedAudio());
+		statusLabel.setText(audioProcessor.getStreamGeneratedAudio()
+			? "Generated loops are decoded while they download"
+			: "Generated loops are downloaded to a file first", juce::dontSendNotification);
+		break;
+
+	case speculativeVariations:
+		audioProcessor.setSpeculativeGeneration(!audioProcessor.getSpeculativeGeneration());
+		statusLabel.setText(audioProcessor.getSpeculativeGeneration()
+			? "Variations of the selected track are generated while idle"
+			: "Speculative variations disabled", juce::dontSendNotification);
+		break;
+
+	case nextVariation:
+		statusLabel.setText(audioProcessor.loadNextVariation(audioProcessor.getSelectedTrackId())
+			? "Loading next variation..."
+			: "No variation ready for this track", juce::dontSendNotification);
+		break;
+
+	case progressiveGeneration:
+		audioProcessor.setProgressiveGeneration(!audioProcessor.getProgressiveGeneration());
+		statusLabel.setText(audioProcessor.getProgressiveGeneration()
+			? "The first bar plays while the rest is generated"
+			: "Loops play once fully generated", juce::dontSendNotification);
+		break;
+
+	case compressedTransfer:
+		audioProcessor.setCompressedTransfer(!audioProcessor.getCompressedTransfer());
+		statusLabel.setText(audioProcessor.getCompressedTransfer()
+			? "Generated loops are requested as FLAC"
+			: "Generated loops are requested as WAV", juce::dontSendNotification);
+		break;
+
 	case aboutDjIa:
 		juce::AlertWindow::showAsync(
 			juce::MessageBoxOptions()
@@ -2384,6 +2642,10 @@ void DjIaVstEditor::menuItemSelected(int menuItemID, int /*topLevelMenuIndex*/)
 			nullptr);
 		break;
 
+	case showDiagnostics:
+		toggleDiagnostics();
+		break;
+
 	case showHelp:
 	{
 		juce::String helpText =
@@ -11,6 +11,7 @@
 #include "MixerPanel.h"
 #include "MidiLearnableComponents.h"
 #include "SampleBankPanel.h"
+#include "DiagnosticsPanel.h"
 
 class SequencerComponent;
 
@@ -48,11 +49,13 @@ public:
 	void* getSequencerForTrack(const juce::String& trackId);
 	void stopGenerationUI(const juce::String& trackId, bool success = true, const juce::String& errorMessage = "");
 	void startGenerationUI(const juce::String& trackId);
+	void refreshGenerationState();
 	juce::StringArray getBuiltInPrompts() const { return promptPresets; }
 	void restoreUICallbacks();
 	void updateSelectedTrack();
 	void onGenerateButtonClicked();
 	void toggleSampleBank();
+	void toggleDiagnostics();
 
 private:
 	DjIaVstProcessor& audioProcessor;
@@ -63,6 +66,7 @@ private:
 	std::unique_ptr<SampleBankPanel> sampleBankPanel;
 	juce::TextButton showSampleBankButton;
 	bool sampleBankVisible = false;
+	std::unique_ptr<DiagnosticsPanel> diagnosticsPanel;
 	enum KeyboardLayout { QWERTY, AZERTY, QWERTZ };
 	KeyboardLayout detectKeyboardLayout();
 	bool keyMatches(const juce::KeyPress& pressed, const juce::KeyPress& expected);
@@ -78,6 +82,10 @@ private:
 	void updateMidiIndicator(const juce::String& noteInfo);
 	void onAddTrack();
 	void onSaveSession();
+	void startOfflineBounce(int bars);
+	static constexpr int maxBounceBars = 9999;
+	void promptBounceLength();
+	void setBounceLock(bool bouncing);
 	void onLoadSession();
 	void loadSessionList();
 	void saveCurrentSession(const juce::String& sessionName);
@@ -107,7 +115,6 @@ private:
 	std::atomic<bool> isInitialized{ false };
 
 	bool isButtonBlinking = false;
-	juce::String generatingTrackId;
 	juce::String originalButtonText;
 	int blinkCounter = 0;
 
@@ -182,7 +189,25 @@ private:
 		showHelp,
 		addTrack = 200,
 		deleteAllTracks,
-		resetTracks
+		resetTracks,
+		memoryMappedPages,
+		streamGeneratedAudio,
+		compressedTransfer,
+		progressiveGeneration,
+		speculativeVariations,
+		nextVariation,
+		directBusRendering,
+		groupExtraSlots,
+		cancelBounce,
+		bounceCustomLength,
+		showDiagnostics,
+		renderThreadsBase = 300,
+		generationRequestsBase = 400,
+		localGenerationRequestsBase = 500,
+		localGenerationThreadsBase = 600,
+		speculativeBudgetBase = 700,
+		trackCapacityBase = 800,
+		bounceBarsBase = 900
 	};
 
 	JUCE_DECLARE_WEAK_REFERENCEABLE(DjIaVstEditor)
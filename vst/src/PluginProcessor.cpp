@@ -19,7 +19,7 @@ juce::AudioProcessor::BusesProperties DjIaVstProcessor::createBusLayout()
 {
 	auto layout = juce::AudioProcessor::BusesProperties();
 	layout = layout.withOutput("Main", juce::AudioChannelSet::stereo(), true);
-	for (int i = 0; i < MAX_TRACKS + 1; ++i)
+	for (int i = 0; i < NUM_TRACK_BUSES + 1; ++i)
 	{
 		layout = layout.withOutput("Track " + juce::String(i + 1),
 			juce::AudioChannelSet::stereo(), false);
@@ -29,10 +29,11 @@ juce::AudioProcessor::BusesProperties DjIaVstProcessor::createBusLayout()
 
 DjIaVstProcessor::DjIaVstProcessor()
 	: AudioProcessor(createBusLayout()), apiClient("", "http://localhost:8000"),
-	parameters(*this, nullptr, "Parameters", { std::make_unique<juce::AudioParameterBool>("generate", "Generate Loop", false), std::make_unique<juce::AudioParameterBool>("play", "Play Loop", false), std::make_unique<juce::AudioParameterFloat>("bpm", "BPM", 60.0f, 200.0f, 126.0f), std::make_unique<juce::AudioParameterFloat>("masterVolume", "Master Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("masterPan", "Master Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("masterHigh", "Master High EQ", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("masterMid", "Master Mid EQ", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("masterLow", "Master Low EQ", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot1Volume", "Slot 1 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot1Pan", "Slot 1 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot1Mute", "Slot 1 Mute", false), std::make_unique<juce::AudioParameterBool>("slot1Solo", "Slot 1 Solo", false), std::make_unique<juce::AudioParameterBool>("slot1Play", "Slot 1 Play", false), std::make_unique<juce::AudioParameterBool>("slot1Stop", "Slot 1 Stop", false), std::make_unique<juce::AudioParameterBool>("slot1Generate", "Slot 1 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot1Pitch", "Slot 1 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot1Fine", "Slot 1 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot1BpmOffset", "Slot 1 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot2Volume", "Slot 2 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot2Pan", "Slot 2 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot2Mute", "Slot 2 Mute", false), std::make_unique<juce::AudioParameterBool>("slot2Solo", "Slot 2 Solo", false), std::make_unique<juce::AudioParameterBool>("slot2Play", "Slot 2 Play", false), std::make_unique<juce::AudioParameterBool>("slot2Stop", "Slot 2 Stop", false), std::make_unique<juce::AudioParameterBool>("slot2Generate", "Slot 2 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot2Pitch", "Slot 2 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot2Fine", "Slot 2 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot2BpmOffset", "Slot 2 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot3Volume", "Slot 3 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot3Pan", "Slot 3 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot3Mute", "Slot 3 Mute", false), std::make_unique<juce::AudioParameterBool>("slot3Solo", "Slot 3 Solo", false), std::make_unique<juce::AudioParameterBool>("slot3Play", "Slot 3 Play", false), std::make_unique<juce::AudioParameterBool>("slot3Stop", "Slot 3 Stop", false), std::make_unique<juce::AudioParameterBool>("slot3Generate", "Slot 3 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot3Pitch", "Slot 3 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot3Fine", "Slot 3 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot3BpmOffset", "Slot 3 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot4Volume", "Slot 4 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot4Pan", "Slot 4 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot4Mute", "Slot 4 Mute", false), std::make_unique<juce::AudioParameterBool>("slot4Solo", "Slot 4 Solo", false), std::make_unique<juce::AudioParameterBool>("slot4Play", "Slot 4 Play", false), std::make_unique<juce::AudioParameterBool>("slot4Stop", "Slot 4 Stop", false), std::make_unique<juce::AudioParameterBool>("slot4Generate", "Slot 4 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot4Pitch", "Slot 4 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot4Fine", "Slot 4 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot4BpmOffset", "Slot 4 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot5Volume", "Slot 5 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot5Pan", "Slot 5 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot5Mute", "Slot 5 Mute", false), std::make_unique<juce::AudioParameterBool>("slot5Solo", "Slot 5 Solo", false), std::make_unique<juce::AudioParameterBool>("slot5Play", "Slot 5 Play", false), std::make_unique<juce::AudioParameterBool>("slot5Stop", "Slot 5 Stop", false), std::make_unique<juce::AudioParameterBool>("slot5Generate", "Slot 5 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot5Pitch", "Slot 5 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot5Fine", "Slot 5 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot5BpmOffset", "Slot 5 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot6Volume", "Slot 6 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot6Pan", "Slot 6 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot6Mute", "Slot 6 Mute", false), std::make_unique<juce::AudioParameterBool>("slot6Solo", "Slot 6 Solo", false), std::make_unique<juce::AudioParameterBool>("slot6Play", "Slot 6 Play", false), std::make_unique<juce::AudioParameterBool>("slot6Stop", "Slot 6 Stop", false), std::make_unique<juce::AudioParameterBool>("slot6Generate", "Slot 6 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot6Pitch", "Slot 6 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot6Fine", "Slot 6 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot6BpmOffset", "Slot 6 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot7Volume", "Slot 7 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot7Pan", "Slot 7 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot7Mute", "Slot 7 Mute", false), std::make_unique<juce::AudioParameterBool>("slot7Solo", "Slot 7 Solo", false), std::make_unique<juce::AudioParameterBool>("slot7Play", "Slot 7 Play", false), std::make_unique<juce::AudioParameterBool>("slot7Stop", "Slot 7 Stop", false), std::make_unique<juce::AudioParameterBool>("slot7Generate", "Slot 7 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot7Pitch", "Slot 7 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot7Fine", "Slot 7 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot7BpmOffset", "Slot 7 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot8Volume", "Slot 8 Volume", 0.0f, 1.0f, 0.8f), std::make_unique<juce::AudioParameterFloat>("slot8Pan", "Slot 8 Pan", -1.0f, 1.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot8Mute", "Slot 8 Mute", false), std::make_unique<juce::AudioParameterBool>("slot8Solo", "Slot 8 Solo", false), std::make_unique<juce::AudioParameterBool>("slot8Play", "Slot 8 Play", false), std::make_unique<juce::AudioParameterBool>("slot8Stop", "Slot 8 Stop", false), std::make_unique<juce::AudioParameterBool>("slot8Generate", "Slot 8 Generate", false), std::make_unique<juce::AudioParameterFloat>("slot8Pitch", "Slot 8 Pitch", -12.0f, 12.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot8Fine", "Slot 8 Fine", -50.0f, 50.0f, 0.0f), std::make_unique<juce::AudioParameterFloat>("slot8BpmOffset", "Slot 8 BPM Offset", -20.0f, 20.0f, 0.0f), std::make_unique<juce::AudioParameterBool>("slot1RandomRetrigger", "Slot 1 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot1RetriggerInterval", "Slot 1 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("slot2RandomRetrigger", "Slot 2 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot2RetriggerInterval", "Slot 2 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("slot3RandomRetrigger", "Slot 3 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot3RetriggerInterval", "Slot 3 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("slot4RandomRetrigger", "Slot 4 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot4RetriggerInterval", "Slot 4 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("slot5RandomRetrigger", "Slot 5 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot5RetriggerInterval", "Slot 5 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("slot6RandomRetrigger", "Slot 6 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot6RetriggerInterval", "Slot 6 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("slot7RandomRetrigger", "Slot 7 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot7RetriggerInterval", "Slot 7 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("slot8RandomRetrigger", "Slot 8 Random Retrigger", false), std::make_unique<juce::AudioParameterFloat>("slot8RetriggerInterval", "Slot 8 Retrigger Interval", juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f), std::make_unique<juce::AudioParameterBool>("nextTrack", "Next Track", false), std::make_unique<juce::AudioParameterBool>("prevTrack", "Previous Track", false) }
-	)
+	trackCapacity(loadTrackCapacity()),
+	parameters(*this, nullptr, "Parameters", SlotParameters::createLayout(trackCapacity))
 {
 	projectId = "legacy";
+	configuredTrackCapacity = trackCapacity;
 	loadGlobalConfig();
 	obsidianEngine = std::make_unique<ObsidianEngine>();
 	if (!obsidianEngine->initialize())
@@ -44,15 +45,41 @@ DjIaVstProcessor::DjIaVstProcessor()
 		DBG("OBSIDIAN Engine ready!");
 	}
 	sampleBankInitFuture = std::async(std::launch::async, [this]() {
-		sampleBank = std::make_unique<SampleBank>();
+		sampleBank = &sharedResources->getSampleBank();
 		sampleBankReady = true;
 		});
 	loadParameters();
+	trackManager.setSlotCapacity(trackCapacity);
 	initTracks();
 	initDummySynth();
-	trackManager.parameterUpdateCallback = [this](int slot, TrackData* track)
+	stretchJobPool.onProgress = [this](const juce::String& trackId, float progress)
 		{
-			handleSampleParams(slot, track);
+			juce::MessageManager::callAsync([this, trackId, progress]()
+				{
+					auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor());
+					TrackData* track = trackManager.getTrack(trackId);
+					if (editor && track && progress < 1.0f)
+					{
+						editor->statusLabel.setText("Processing " + track->trackName + ": " +
+							juce::String(juce::roundToInt(progress * 100.0f)) + "%", juce::dontSendNotification);
+					}
+				});
+		};
+	generationQueue.onRequestFinished = [this](const GenerationQueue::Request& request, const GenerationQueue::Result& result)
+		{
+			if (request.speculative)
+			{
+				// Only variations that were stored count against the budget.
+				if (result.success)
+					++speculativeUsed;
+				uiUpdates.raise(UIUpdateFlags::general);
+			}
+			else
+				notifyGenerationComplete(request.trackId, result.message);
+		};
+	generationQueue.onStatusChanged = [this]()
+		{
+			uiUpdates.raise(UIUpdateFlags::general);
 		};
 	startTimerHz(30);
 	autoLoadEnabled.store(true);
@@ -61,6 +88,34 @@ DjIaVstProcessor::DjIaVstProcessor()
 		{ performMigrationIfNeeded(); });
 }
 
+void DjIaVstProcessor::scheduleAudioRestore()
+{
+	// Track metadata is already live; audio decodes on the job pool, the
+	// selected track first, and each track plays as soon as its own is in.
+	for (auto& request : trackManager.takeRestoreRequests())
+	{
+		const juce::String trackId = request.track->trackId;
+		const int priority = (trackId == selectedTrackId) ? 1 : 0;
+		stretchJobPool.submit(trackId + "_restore", priority,
+			[this, trackId, request = std::move(request)](StretchJobPool::JobContext&)
+			{
+				trackManager.restoreTrackAudio(request);
+				DBG("Restored audio for track " << trackId);
+
+				juce::MessageManager::callAsync([this, trackId]()
+					{
+						TrackData* track = trackManager.getTrack(trackId);
+						if (!track)
+							return;
+						track->syncLegacyProperties();
+						updatePagePrefetch(trackId);
+						updateWaveformDisplay(trackId);
+						uiUpdates.raise(UIUpdateFlags::general);
+					});
+			});
+	}
+}
+
 void DjIaVstProcessor::performMigrationIfNeeded()
 {
 	if (migrationCompleted)
@@ -179,6 +234,29 @@ void DjIaVstProcessor::loadGlobalConfig()
 	DBG("Final customPrompts size: " + juce::String(customPrompts.size()));
 }
 
+int DjIaVstProcessor::loadTrackCapacity()
+{
+	// Read before the parameters exist, so it cannot go through loadGlobalConfig.
+	auto configFile = getGlobalConfigFile();
+	if (!configFile.existsAsFile())
+		return SlotParameters::legacySlots;
+
+	auto configJson = juce::JSON::parse(configFile);
+	if (auto* object = configJson.getDynamicObject())
+	{
+		if (object->hasProperty("trackCapacity"))
+			return juce::jlimit(SlotParameters::legacySlots, SlotParameters::maxSlots,
+				static_cast<int>(object->getProperty("trackCapacity")));
+	}
+	return SlotParameters::legacySlots;
+}
+
+void DjIaVstProcessor::setConfiguredTrackCapacity(int capacity)
+{
+	configuredTrackCapacity = juce::jlimit(SlotParameters::legacySlots, SlotParameters::maxSlots, capacity);
+	saveGlobalConfig();
+}
+
 void DjIaVstProcessor::saveGlobalConfig()
 {
 	auto configFile = getGlobalConfigFile();
@@ -190,6 +268,7 @@ void DjIaVstProcessor::saveGlobalConfig()
 	config->setProperty("requestTimeoutMS", requestTimeoutMS);
 	config->setProperty("useLocalModel", useLocalModel ? "true" : "false");
 	config->setProperty("localModelsPath", localModelsPath);
+	config->setProperty("trackCapacity", configuredTrackCapacity);
 
 	juce::Array<juce::var> promptsArray;
 	for (const auto& prompt : customPrompts)
@@ -212,11 +291,12 @@ void DjIaVstProcessor::initDummySynth()
 void DjIaVstProcessor::initTracks()
 {
 	selectedTrackId = trackManager.createTrack();
-	individualOutputBuffers.resize(MAX_TRACKS);
+	individualOutputBuffers.resize(NUM_TRACK_BUSES);
 	for (auto& buffer : individualOutputBuffers)
 	{
 		buffer.setSize(2, 512);
 	}
+	slotOutputViews.resize(static_cast<size_t>(trackCapacity));
 }
 
 void DjIaVstProcessor::loadParameters()
@@ -229,76 +309,99 @@ void DjIaVstProcessor::loadParameters()
 	masterMidParam = parameters.getRawParameterValue("masterMid");
 	masterLowParam = parameters.getRawParameterValue("masterLow");
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotVolumeParams[i] = parameters.getRawParameterValue(slotName + "Volume");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotPanParams[i] = parameters.getRawParameterValue(slotName + "Pan");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotMuteParams[i] = parameters.getRawParameterValue(slotName + "Mute");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotSoloParams[i] = parameters.getRawParameterValue(slotName + "Solo");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotPlayParams[i] = parameters.getRawParameterValue(slotName + "Play");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotStopParams[i] = parameters.getRawParameterValue(slotName + "Stop");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotGenerateParams[i] = parameters.getRawParameterValue(slotName + "Generate");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotPitchParams[i] = parameters.getRawParameterValue(slotName + "Pitch");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotFineParams[i] = parameters.getRawParameterValue(slotName + "Fine");
 	}
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotBpmOffsetParams[i] = parameters.getRawParameterValue(slotName + "BpmOffset");
 	}
-	for (int i = 1; i <= 8; ++i)
+	for (int i = 1; i <= trackCapacity; ++i)
 	{
 		parameters.addParameterListener("slot" + juce::String(i) + "Generate", this);
+		for (const char* suffix : trackParameterSuffixes)
+			parameters.addParameterListener("slot" + juce::String(i) + suffix, this);
 	}
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < trackCapacity; ++i)
 	{
 		juce::String slotName = "slot" + juce::String(i + 1);
 		slotRandomRetriggerParams[i] = parameters.getRawParameterValue(slotName + "RandomRetrigger");
 		slotRetriggerIntervalParams[i] = parameters.getRawParameterValue(slotName + "RetriggerInterval");
 	}
 
+	for (int i = 0; i < trackCapacity; ++i)
+	{
+		juce::String slotName = "slot" + juce::String(i + 1);
+		slotEqLowParams[i] = parameters.getRawParameterValue(slotName + "EqLow");
+		slotEqMidParams[i] = parameters.getRawParameterValue(slotName + "EqMid");
+		slotEqHighParams[i] = parameters.getRawParameterValue(slotName + "EqHigh");
+		slotFilterParams[i] = parameters.getRawParameterValue(slotName + "Filter");
+		slotCompParams[i] = parameters.getRawParameterValue(slotName + "Comp");
+		slotDelaySendParams[i] = parameters.getRawParameterValue(slotName + "DelaySend");
+	}
+
+	// The saved-parameter lists name the first eight slots; extend them to the capacity.
+	for (int i = SlotParameters::legacySlots + 1; i <= trackCapacity; ++i)
+	{
+		const juce::String slotName = "slot" + juce::String(i);
+		for (const char* suffix : { "Mute", "Solo", "Play", "Stop", "Generate" })
+			booleanParamIds.add(slotName + suffix);
+		for (const char* suffix : { "Volume", "Pan", "Pitch", "Fine", "BpmOffset" })
+			floatParamIds.add(slotName + suffix);
+	}
+
 	nextTrackParam = parameters.getRawParameterValue("nextTrack");
 	prevTrackParam = parameters.getRawParameterValue("prevTrack");
 
@@ -312,6 +415,7 @@ void DjIaVstProcessor::loadParameters()
 DjIaVstProcessor::~DjIaVstProcessor()
 {
 	stopTimer();
+	offlineBouncer.reset();
 	try
 	{
 		cleanProcessor();
@@ -324,13 +428,17 @@ DjIaVstProcessor::~DjIaVstProcessor()
 
 void DjIaVstProcessor::cleanProcessor()
 {
+	generationQueue.stop();
+	stretchJobPool.stop();
 	parameters.removeParameterListener("generate", this);
 	parameters.removeParameterListener("play", this);
 	parameters.removeParameterListener("nextTrack", this);
 	parameters.removeParameterListener("prevTrack", this);
-	for (int i = 1; i <= 8; ++i)
+	for (int i = 1; i <= trackCapacity; ++i)
 	{
 		parameters.removeParameterListener("slot" + juce::String(i) + "Generate", this);
+		for (const char* suffix : trackParameterSuffixes)
+			parameters.removeParameterListener("slot" + juce::String(i) + suffix, this);
 	}
 
 	isNotePlaying = false;
@@ -345,17 +453,92 @@ void DjIaVstProcessor::cleanProcessor()
 
 void DjIaVstProcessor::timerCallback()
 {
-	if (!needsUIUpdate.load())
-		return;
-	if (onUIUpdateNeeded)
+	trackManager.collectRetiredSnapshots();
+	trackManager.collectRetiredMappedAudio();
+	reclaimRetiredPreviews();
+	retiredBuffers.collect();
+	sharedResources->decodedSamples.releaseExpired();
+	releaseConsumedPendingAudio();
+	syncSwappedTracks();
+	finishAppliedPageSwitches();
+	prefaultMappedPages();
+	midiLearnManager.flushStatusMessages();
+	publishRetriggerIntervals();
+	scheduleSpeculativeGeneration();
+	dispatchUIUpdates();
+}
+
+void DjIaVstProcessor::dispatchUIUpdates()
+{
+	const juce::uint32 flags = uiUpdates.takeFlags();
+	const juce::uint64 sequencerSlots = uiUpdates.takeSequencerSlots();
+	const juce::uint64 waveformSlots = uiUpdates.takeWaveformSlots();
+	double midiBpm = 0.0;
+	const juce::uint64 midiSlots = uiUpdates.takeMidiSlots(midiBpm);
+
+	if ((flags & UIUpdateFlags::trackState) != 0)
+	{
+		for (const auto& trackId : trackManager.getAllTrackIds())
+		{
+			if (TrackData* track = trackManager.getTrack(trackId))
+				track->dispatchStateNotifications();
+		}
+	}
+
+	if ((flags & UIUpdateFlags::midiActivity) != 0 && midiIndicatorCallback)
+	{
+		updateMidiIndicatorWithActiveNotes(midiBpm, midiSlots);
+	}
+
+	if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor()))
+	{
+		if ((flags & UIUpdateFlags::loadingSample) != 0)
+		{
+			editor->statusLabel.setText("Loading sample...", juce::dontSendNotification);
+		}
+
+		if (sequencerSlots != 0 || waveformSlots != 0)
+		{
+			for (auto& trackComp : editor->getTrackComponents())
+			{
+				TrackData* track = trackComp->getTrack();
+				if (!track)
+					continue;
+
+				if (UIUpdateFlags::hasSlot(sequencerSlots, track->slotIndex))
+				{
+					if (auto* sequencer = trackComp->getSequencer())
+					{
+						sequencer->updateFromTrackData();
+					}
+				}
+				if (UIUpdateFlags::hasSlot(waveformSlots, track->slotIndex) && trackComp->isWaveformVisible())
+				{
+					trackComp->refreshWaveformDisplay();
+				}
+			}
+		}
+	}
+
+	if ((flags & UIUpdateFlags::general) != 0 && onUIUpdateNeeded)
 	{
 		onUIUpdateNeeded();
 	}
-	needsUIUpdate = false;
 }
 
 void DjIaVstProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
 {
+	// Also called from the bounce thread as it hands the processor back;
+	// the lock keeps that from overlapping the host's own call. A host call
+	// during a bounce would resize buffers the bounce is rendering into, so
+	// it waits for endOfflineRender instead.
+	const juce::ScopedLock lock(getCallbackLock());
+	if (offlineRenderActive)
+	{
+		deferredPrepareSampleRate = newSampleRate;
+		deferredPrepareBlockSize = samplesPerBlock;
+		return;
+	}
 	hostSampleRate = newSampleRate;
 	currentBlockSize = samplesPerBlock;
 	synth.setCurrentPlaybackSampleRate(newSampleRate);
@@ -364,7 +547,9 @@ void DjIaVstProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
 		buffer.setSize(2, samplesPerBlock);
 		buffer.clear();
 	}
+	trackManager.prepareToPlay(newSampleRate, samplesPerBlock, trackCapacity);
 	masterEQ.prepare(newSampleRate, samplesPerBlock);
+	masterMeter.prepare(newSampleRate);
 }
 
 void DjIaVstProcessor::releaseResources()
@@ -394,93 +579,321 @@ bool DjIaVstProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 
 void DjIaVstProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-	internalSampleCounter += buffer.getNumSamples();
-	checkAndSwapStagingBuffers();
+	RealtimeAllocationGuard::ScopedSection realtimeSection;
+	const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+#if OBSIDIAN_DETECT_RT_ALLOCATIONS
+	const auto allocationsBeforeBlock = RealtimeAllocationGuard::getAllocationCount();
+#endif
 	for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
 		buffer.clear(i, 0, buffer.getNumSamples());
 
-	bool hostIsPlaying = false;
-	auto currentPlayHead = getPlayHead();
+	const double hostBpm = advanceTracks(getPlayHead(), buffer.getNumSamples(), midiMessages, &stageProfiler);
+
+	clearOutputBuffers(buffer);
+	auto mainOutput = getBusBuffer(buffer, false, 0);
+
+	const bool renderIntoBuses = directBusRendering.load();
+	if (!renderIntoBuses)
+		resizeIndividualsBuffers(buffer);
+	pointSlotOutputs(buffer, renderIntoBuses);
+	{
+		StageProfiler::ScopedTimer timer(&stageProfiler, StageProfiler::renderTracks);
+		trackManager.renderAllTracks(mainOutput, slotOutputViews, hostBpm, &meterFeed, &stageProfiler);
+	}
+	if (!renderIntoBuses)
+		copyTracksToIndividualOutputs(buffer);
+	handlePreviewPlaying(buffer);
+
+	{
+		StageProfiler::ScopedTimer timer(&stageProfiler, StageProfiler::masterEffects);
+		applyMasterEffects(mainOutput);
+	}
+	checkIfUIUpdateNeeded(midiMessages);
+	stageProfiler.recordBlock(juce::Time::getHighResolutionTicks() - blockStartTicks, buffer.getNumSamples(), hostSampleRate);
+
+#if OBSIDIAN_DETECT_RT_ALLOCATIONS
+	jassert(RealtimeAllocationGuard::getAllocationCount() == allocationsBeforeBlock);
+#endif
+}
+
+/*
+	Everything a block does before tracks render: transport, sequencers,
+	beat repeat, MIDI, incoming loops and slot parameters. Shared by
+	processBlock and the offline bounce, which passes its own transport.
+	Returns the tempo to render at. Stages are timed into profiler when
+	there is one.
+*/
+double DjIaVstProcessor::advanceTracks(juce::AudioPlayHead* playHead, int numSamples, juce::MidiBuffer& midiMessages,
+	StageProfiler* profiler)
+{
+	trackManager.acquireAudioSnapshot();
+	internalSampleCounter += numSamples;
+	{
+		StageProfiler::ScopedTimer timer(profiler, StageProfiler::swapStagingBuffers);
+		checkAndSwapStagingBuffers();
+	}
 
+	bool hostIsPlaying = false;
 	double hostBpm = 126.0;
 	double hostPpqPosition = 0.0;
 
-	if (currentPlayHead)
+	if (playHead)
 	{
-		getDawInformations(currentPlayHead, hostIsPlaying, hostBpm, hostPpqPosition);
+		getDawInformations(playHead, hostIsPlaying, hostBpm, hostPpqPosition);
 		lastHostBpmForQuantization.store(hostBpm);
 	}
+	cachedHostIsPlaying.store(hostIsPlaying);
 	handleSequencerPlayState(hostIsPlaying);
-	updateSequencers(hostIsPlaying);
-	checkBeatRepeatWithSampleCounter();
+	{
+		StageProfiler::ScopedTimer timer(profiler, StageProfiler::sequencers);
+		updateSequencers(playHead, hostIsPlaying, numSamples, hostBpm);
+		updateBeatRepeatTimelines(numSamples);
+	}
 
 	{
 		juce::ScopedLock lock(sequencerMidiLock);
-		midiMessages.addEvents(sequencerMidiBuffer, 0, buffer.getNumSamples(), 0);
+		midiMessages.addEvents(sequencerMidiBuffer, 0, numSamples, 0);
 		sequencerMidiBuffer.clear();
 	}
 
-	processMidiMessages(midiMessages, hostIsPlaying, hostBpm);
+	{
+		StageProfiler::ScopedTimer timer(profiler, StageProfiler::midi);
+		processMidiMessages(midiMessages, hostIsPlaying, hostBpm);
+	}
 
 	if (hasPendingAudioData.load())
 	{
 		processIncomingAudio(hostIsPlaying);
 	}
 
-	resizeIndividualsBuffers(buffer);
-	clearOutputBuffers(buffer);
+	updateTimeStretchRatios(hostBpm);
+	syncTrackParameters();
+	return hostBpm;
+}
 
-	auto mainOutput = getBusBuffer(buffer, false, 0);
-	mainOutput.clear();
+juce::uint32 DjIaVstProcessor::getDroppedScheduledEvents()
+{
+	juce::uint32 dropped = 0;
+	for (const auto& trackId : trackManager.getAllTrackIds())
+	{
+		if (auto* track = trackManager.getTrack(trackId))
+			dropped += track->droppedScheduledEvents.load(std::memory_order_relaxed);
+	}
+	return dropped;
+}
 
-	updateTimeStretchRatios(hostBpm);
+juce::StringArray DjIaVstProcessor::getSlotTrackNames()
+{
+	juce::StringArray names;
+	for (int slot = 0; slot < trackCapacity; ++slot)
+		names.add({});
 
-	trackManager.renderAllTracks(mainOutput, individualOutputBuffers, hostBpm);
+	for (const auto& trackId : trackManager.getAllTrackIds())
+	{
+		if (auto* track = trackManager.getTrack(trackId))
+		{
+			if (track->slotIndex >= 0 && track->slotIndex < trackCapacity)
+				names.set(track->slotIndex, track->trackName);
+		}
+	}
+	return names;
+}
 
-	copyTracksToIndividualOutputs(buffer);
-	handlePreviewPlaying(buffer);
+/*
+	Takes the processor away from the host and starts the set from the top:
+	tracks that are playing or armed play from their first sample and the
+	sequencers restart with the virtual transport. What the bounce changes
+	is recorded so endOfflineRender can put the live set back as it was.
+*/
+bool DjIaVstProcessor::beginOfflineRender(int blockSize)
+{
+	if (hostSampleRate <= 0.0)
+		return false;
 
-	applyMasterEffects(mainOutput);
-	checkIfUIUpdateNeeded(midiMessages);
+	suspendProcessing(true);
+	liveSampleCounterBeforeBounce = internalSampleCounter.load();
+	liveSequencerPlayingBeforeBounce = sequencerWasPlaying;
+	liveRenderThreadsBeforeBounce = trackManager.getRenderThreads();
+
+	trackManager.setRenderThreads(juce::SystemStats::getNumCpus());
+	{
+		// prepareToPlay takes the same lock, so a host re-prepare from the
+		// message thread cannot interleave with this one.
+		const juce::ScopedLock lock(getCallbackLock());
+		offlineRenderActive = true;
+		deferredPrepareSampleRate = 0.0;
+		trackManager.prepareToPlay(hostSampleRate, blockSize, trackCapacity);
+		masterEQ.prepare(hostSampleRate, blockSize);
+	}
+	offlineMidi.ensureSize(4096);
+
+	livePlaybackBeforeBounce.clear();
+	const auto& snapshot = trackManager.acquireAudioSnapshot();
+	for (const auto& track : snapshot.owners)
+	{
+		LivePlayback live;
+		live.track = track;
+		live.readPosition = track->readPosition.load();
+		live.isPlaying = track->isPlaying.load();
+		live.isArmed = track->isArmed.load();
+		live.isArmedToStop = track->isArmedToStop.load();
+		live.isCurrentlyPlaying = track->isCurrentlyPlaying.load();
+		live.pendingAction = track->pendingAction;
+		live.sequencerData = track->sequencerData;
+		live.customStepCounter = track->customStepCounter;
+		live.lastPpqPosition = track->lastPpqPosition;
+		live.beatRepeatActive = track->beatRepeatActive.load();
+		live.beatRepeatStartPosition = track->beatRepeatStartPosition.load();
+		live.beatRepeatEndPosition = track->beatRepeatEndPosition.load();
+		live.originalReadPosition = track->originalReadPosition.load();
+		live.beatRepeatEventSample = track->beatRepeatEventSample;
+		live.beatRepeatTimeline = track->beatRepeatTimeline;
+		live.numScheduledEvents = track->numScheduledEvents;
+		live.scheduledEvents = track->scheduledEvents;
+		livePlaybackBeforeBounce.push_back(std::move(live));
+
+		// A live beat repeat and its pending event are timed against the
+		// live sample counter; the bounce starts clean from sample 0.
+		track->beatRepeatActive = false;
+		track->beatRepeatEventSample = -1;
+		track->beatRepeatTimeline = {};
+		track->numScheduledEvents = 0;
+
+		if (track->isPlaying.load() || track->isCurrentlyPlaying.load() || track->isArmed.load())
+		{
+			track->readPosition = 0.0;
+			track->isPlaying = true;
+			track->isCurrentlyPlaying = true;
+			track->isArmed = false;
+			track->isArmedToStop = false;
+			track->pendingAction = TrackData::PendingAction::None;
+		}
+	}
+
+	// The transport starts playing on the first block, which rewinds the sequencers.
+	sequencerWasPlaying = false;
+	internalSampleCounter = 0;
+	return true;
+}
+
+void DjIaVstProcessor::renderOfflineBlock(juce::AudioPlayHead& transport, juce::AudioBuffer<float>& master,
+	std::vector<juce::AudioBuffer<float>>& slotOutputs)
+{
+	// The audio thread is suspended, so this is uncontended; it keeps the
+	// block from overlapping anything else that takes the callback lock.
+	const juce::ScopedLock lock(getCallbackLock());
+	const int numSamples = master.getNumSamples();
+	offlineMidi.clear();
+	const double bpm = advanceTracks(&transport, numSamples, offlineMidi, nullptr);
+
+	master.clear();
+	for (auto& output : slotOutputs)
+		output.clear();
+
+	trackManager.renderAllTracks(master, slotOutputs, bpm);
+	applyMasterEffects(master);
+}
+
+void DjIaVstProcessor::endOfflineRender()
+{
+	for (auto& live : livePlaybackBeforeBounce)
+	{
+		auto& track = *live.track;
+		track.readPosition = live.readPosition;
+		track.isPlaying = live.isPlaying;
+		track.isArmed = live.isArmed;
+		track.isArmedToStop = live.isArmedToStop;
+		track.isCurrentlyPlaying = live.isCurrentlyPlaying;
+		track.pendingAction = live.pendingAction;
+		track.sequencerData = live.sequencerData;
+		track.customStepCounter = live.customStepCounter;
+		track.lastPpqPosition = live.lastPpqPosition;
+		track.beatRepeatActive = live.beatRepeatActive;
+		track.beatRepeatStartPosition = live.beatRepeatStartPosition;
+		track.beatRepeatEndPosition = live.beatRepeatEndPosition;
+		track.originalReadPosition = live.originalReadPosition;
+		track.beatRepeatEventSample = live.beatRepeatEventSample;
+		track.beatRepeatTimeline = live.beatRepeatTimeline;
+		track.numScheduledEvents = live.numScheduledEvents;
+		track.scheduledEvents = live.scheduledEvents;
+	}
+	livePlaybackBeforeBounce.clear();
+
+	internalSampleCounter = liveSampleCounterBeforeBounce;
+	sequencerWasPlaying = liveSequencerPlayingBeforeBounce;
+	trackManager.setRenderThreads(liveRenderThreadsBeforeBounce);
+	{
+		const juce::ScopedLock lock(getCallbackLock());
+		offlineRenderActive = false;
+		if (deferredPrepareSampleRate > 0.0)
+		{
+			hostSampleRate = deferredPrepareSampleRate;
+			currentBlockSize = deferredPrepareBlockSize;
+		}
+		prepareToPlay(hostSampleRate, currentBlockSize);
+	}
+	suspendProcessing(false);
+
+	uiUpdates.markAllSequencersDirty();
+	uiUpdates.raise(UIUpdateFlags::general);
 }
 
 void DjIaVstProcessor::handlePreviewPlaying(juce::AudioSampleBuffer& buffer)
 {
-	if (isPreviewPlaying.load())
+	if (!isPreviewPlaying.load())
+		return;
+
+	const PreviewClip* clip = publishedPreview.load();
+	for (;;)
 	{
-		juce::ScopedLock lock(previewLock);
-		if (previewBuffer.getNumSamples() > 0)
-		{
-			double currentPos = previewPosition.load();
-			double ratio = previewSampleRate.load() / hostSampleRate;
+		previewInUse.store(clip);
+		const PreviewClip* latest = publishedPreview.load();
+		if (latest == clip)
+			break;
+		clip = latest;
+	}
+	if (clip == nullptr || clip->audio.getNumSamples() == 0)
+		return;
 
-			const int previewBusIndex = 9;
-			auto previewOutput = getBusBuffer(buffer, false, previewBusIndex);
+	const juce::uint32 startCount = previewStartCount.load();
+	if (clip != previewClipSeen || startCount != previewStartSeen)
+	{
+		previewClipSeen = clip;
+		previewStartSeen = startCount;
+		previewPosition = 0.0;
+	}
 
-			for (int i = 0; i < buffer.getNumSamples(); ++i)
-			{
-				int sampleIndex = (int)currentPos;
-				if (sampleIndex >= previewBuffer.getNumSamples())
-				{
-					isPreviewPlaying = false;
-					break;
-				}
-				for (int ch = 0; ch < std::min(previewOutput.getNumChannels(), 2); ++ch)
-				{
-					float sample = previewBuffer.getSample(ch, sampleIndex) * 0.7f;
-					previewOutput.addSample(ch, i, sample);
-				}
-				currentPos += ratio;
-			}
-			previewPosition.store(currentPos);
+	// Clips are cached at the host rate, so this is 1 unless the rate changed since.
+	const double ratio = clip->sampleRate / hostSampleRate;
+	const int clipSamples = clip->audio.getNumSamples();
+	const float* clipData[2] = { clip->audio.getReadPointer(0), clip->audio.getReadPointer(1) };
+
+	const int previewBusIndex = 9;
+	auto previewOutput = getBusBuffer(buffer, false, previewBusIndex);
+	const int numChannels = std::min(previewOutput.getNumChannels(), 2);
+
+	double currentPos = previewPosition;
+	for (int i = 0; i < buffer.getNumSamples(); ++i)
+	{
+		int sampleIndex = (int)currentPos;
+		if (sampleIndex >= clipSamples)
+		{
+			isPreviewPlaying = false;
+			break;
+		}
+		for (int ch = 0; ch < numChannels; ++ch)
+		{
+			previewOutput.addSample(ch, i, clipData[ch][sampleIndex] * 0.7f);
 		}
+		currentPos += ratio;
 	}
+	previewPosition = currentPos;
 }
 
-void DjIaVstProcessor::addSequencerMidiMessage(const juce::MidiMessage& message)
+void DjIaVstProcessor::addSequencerMidiMessage(const juce::MidiMessage& message, int sampleOffset)
 {
 	juce::ScopedLock lock(sequencerMidiLock);
-	sequencerMidiBuffer.addEvent(message, 0);
+	sequencerMidiBuffer.addEvent(message, sampleOffset);
 }
 
 void DjIaVstProcessor::handleSequencerPlayState(bool hostIsPlaying)
@@ -489,15 +902,13 @@ void DjIaVstProcessor::handleSequencerPlayState(bool hostIsPlaying)
 	{
 		return;
 	}
-	static bool wasPlaying = false;
+	const bool wasPlaying = sequencerWasPlaying;
 
 	if (hostIsPlaying && !wasPlaying)
 	{
 		internalSampleCounter.store(0);
-		auto trackIds = trackManager.getAllTrackIds();
-		for (const auto& trackId : trackIds)
+		for (auto* track : trackManager.getAudioThreadTracks())
 		{
-			TrackData* track = trackManager.getTrack(trackId);
 			if (track)
 			{
 				track->sequencerData.isPlaying = true;
@@ -508,13 +919,12 @@ void DjIaVstProcessor::handleSequencerPlayState(bool hostIsPlaying)
 				track->lastPpqPosition = -1.0;
 			}
 		}
+		uiUpdates.markAllSequencersDirty();
 	}
 	else if (!hostIsPlaying && wasPlaying)
 	{
-		auto trackIds = trackManager.getAllTrackIds();
-		for (const auto& trackId : trackIds)
+		for (auto* track : trackManager.getAudioThreadTracks())
 		{
-			TrackData* track = trackManager.getTrack(trackId);
 			bool arm = false;
 			if (track->isCurrentlyPlaying.load())
 			{
@@ -523,7 +933,7 @@ void DjIaVstProcessor::handleSequencerPlayState(bool hostIsPlaying)
 			if (track)
 			{
 				track->sequencerData.isPlaying = false;
-				track->setStop();
+				track->setStop(uiUpdates);
 				track->isArmed = arm;
 				track->isPlaying.store(false);
 				track->isCurrentlyPlaying = false;
@@ -535,14 +945,13 @@ void DjIaVstProcessor::handleSequencerPlayState(bool hostIsPlaying)
 				track->lastPpqPosition = -1.0;
 			}
 		}
-		needsUIUpdate = true;
+		uiUpdates.markAllSequencersDirty();
+		uiUpdates.raise(UIUpdateFlags::general);
 	}
 	else if (!hostIsPlaying && !wasPlaying)
 	{
-		auto trackIds = trackManager.getAllTrackIds();
-		for (const auto& trackId : trackIds)
+		for (auto* track : trackManager.getAudioThreadTracks())
 		{
-			TrackData* track = trackManager.getTrack(trackId);
 			bool arm = false;
 			if (track->isCurrentlyPlaying.load())
 			{
@@ -559,19 +968,17 @@ void DjIaVstProcessor::handleSequencerPlayState(bool hostIsPlaying)
 				track->isPlaying.store(false);
 			}
 		}
-		needsUIUpdate = true;
+		uiUpdates.raise(UIUpdateFlags::general);
 	}
 
-	wasPlaying = hostIsPlaying;
+	sequencerWasPlaying = hostIsPlaying;
 }
 
 void DjIaVstProcessor::checkIfUIUpdateNeeded(juce::MidiBuffer& midiMessages)
 {
 	bool anyTrackPlaying = false;
-	auto trackIds = trackManager.getAllTrackIds();
-	for (const auto& trackId : trackIds)
+	for (auto* track : trackManager.getAudioThreadTracks())
 	{
-		TrackData* track = trackManager.getTrack(trackId);
 		if (track && track->isPlaying.load())
 		{
 			anyTrackPlaying = true;
@@ -581,7 +988,7 @@ void DjIaVstProcessor::checkIfUIUpdateNeeded(juce::MidiBuffer& midiMessages)
 
 	if (anyTrackPlaying || midiMessages.getNumEvents() > 0)
 	{
-		needsUIUpdate = true;
+		uiUpdates.raise(UIUpdateFlags::general);
 	}
 }
 
@@ -610,6 +1017,8 @@ void DjIaVstProcessor::applyMasterEffects(juce::AudioSampleBuffer& mainOutput)
 			mainOutput.applyGain(0, 0, mainOutput.getNumSamples(), 1.0f - smoothedMasterPan);
 		}
 	}
+
+	masterMeter.process(mainOutput, mainOutput.getNumSamples(), MeterReading::masterSlot, &meterFeed);
 }
 
 void DjIaVstProcessor::copyTracksToIndividualOutputs(juce::AudioSampleBuffer& buffer)
@@ -637,7 +1046,7 @@ void DjIaVstProcessor::clearOutputBuffers(juce::AudioSampleBuffer& buffer)
 {
 	for (int busIndex = 0; busIndex < getTotalNumOutputChannels() / 2; ++busIndex)
 	{
-		if (busIndex * 2 + 1 < getTotalNumOutputChannels() && busIndex <= MAX_TRACKS)
+		if (busIndex * 2 + 1 < getTotalNumOutputChannels() && busIndex <= NUM_TRACK_BUSES)
 		{
 			auto busBuffer = getBusBuffer(buffer, false, busIndex);
 			busBuffer.clear();
@@ -657,6 +1066,49 @@ void DjIaVstProcessor::resizeIndividualsBuffers(juce::AudioSampleBuffer& buffer)
 	}
 }
 
+void DjIaVstProcessor::pointSlotOutputs(juce::AudioSampleBuffer& buffer, bool renderIntoBuses)
+{
+	// A stereo view only uses the buffer's preallocated channel array, so
+	// re-pointing it every block does not allocate. A slot with an empty view
+	// (disabled bus, or beyond the buses without grouping) reaches the main
+	// mix only.
+	const int numSamples = buffer.getNumSamples();
+	const int numBuses = getBusCount(false);
+	const int numDirectSlots = std::min(trackCapacity, NUM_TRACK_BUSES);
+	for (int slot = 0; slot < numDirectSlots; ++slot)
+	{
+		auto& view = slotOutputViews[static_cast<size_t>(slot)];
+		if (!renderIntoBuses)
+		{
+			view.setDataToReferTo(individualOutputBuffers[static_cast<size_t>(slot)].getArrayOfWritePointers(), 2, numSamples);
+			continue;
+		}
+
+		const int busIndex = slot + 1;
+		if (busIndex < numBuses)
+		{
+			auto busBuffer = getBusBuffer(buffer, false, busIndex);
+			if (busBuffer.getNumChannels() >= 2)
+			{
+				view.setDataToReferTo(busBuffer.getArrayOfWritePointers(), 2, numSamples);
+				continue;
+			}
+		}
+		view = juce::AudioSampleBuffer();
+	}
+
+	const bool grouped = groupExtraSlotsOnBuses.load();
+	for (int slot = numDirectSlots; slot < trackCapacity; ++slot)
+	{
+		auto& view = slotOutputViews[static_cast<size_t>(slot)];
+		auto& target = slotOutputViews[static_cast<size_t>(slot % NUM_TRACK_BUSES)];
+		if (grouped && target.getNumChannels() >= 2)
+			view.setDataToReferTo(target.getArrayOfWritePointers(), 2, numSamples);
+		else
+			view = juce::AudioSampleBuffer();
+	}
+}
+
 void DjIaVstProcessor::getDawInformations(juce::AudioPlayHead* currentPlayHead, bool& hostIsPlaying, double& hostBpm, double& hostPpqPosition)
 {
 	double localSampleRate = getSampleRate();
@@ -710,9 +1162,9 @@ void DjIaVstProcessor::processMidiMessages(juce::MidiBuffer& midiMessages, bool
 	int midiEventCount = midiMessages.getNumEvents();
 	if (midiEventCount > 0)
 	{
-		needsUIUpdate = true;
+		uiUpdates.raise(UIUpdateFlags::general);
 	}
-	juce::Array<int> notesPlayedInThisBuffer;
+	juce::uint64 triggeredSlots = 0;
 	for (const auto metadata : midiMessages)
 	{
 		const auto message = metadata.getMessage();
@@ -727,20 +1179,22 @@ void DjIaVstProcessor::processMidiMessages(juce::MidiBuffer& midiMessages, bool
 		{
 			if (message.isNoteOn())
 			{
-				int noteNumber = message.getNoteNumber();
-				notesPlayedInThisBuffer.addIfNotAlreadyThere(noteNumber);
-				playTrack(message, hostBpm);
+				const int triggeredSlot = playTrack(message, hostBpm, metadata.samplePosition);
+				if (triggeredSlot >= 0 && triggeredSlot < UIUpdateFlags::maxSlots)
+				{
+					triggeredSlots |= juce::uint64(1) << triggeredSlot;
+				}
 			}
 			else if (message.isNoteOff())
 			{
 				int noteNumber = message.getNoteNumber();
-				stopNotePlaybackForTrack(noteNumber);
+				stopNotePlaybackForTrack(noteNumber, metadata.samplePosition);
 			}
 		}
 	}
-	if (midiIndicatorCallback && notesPlayedInThisBuffer.size() > 0)
+	if (triggeredSlots != 0)
 	{
-		updateMidiIndicatorWithActiveNotes(hostBpm, notesPlayedInThisBuffer);
+		uiUpdates.noteMidiTriggered(triggeredSlots, hostBpm);
 	}
 }
 
@@ -751,44 +1205,40 @@ void DjIaVstProcessor::previewTrack(const juce::String& trackId)
 	{
 		track->readPosition = 0.0;
 		track->isPlaying.store(true);
-		needsUIUpdate = true;
+		uiUpdates.raise(UIUpdateFlags::general);
 	}
 }
 
-void DjIaVstProcessor::playTrack(const juce::MidiMessage& message, double hostBpm)
+int DjIaVstProcessor::playTrack(const juce::MidiMessage& message, double hostBpm, int sampleOffset)
 {
 	int noteNumber = message.getNoteNumber();
-	juce::String noteName = juce::MidiMessage::getMidiNoteName(noteNumber, true, true, 3);
-	bool trackFound = false;
-	auto trackIds = trackManager.getAllTrackIds();
-	for (const auto& trackId : trackIds)
+	int triggeredSlot = -1;
+	for (auto* track : trackManager.getAudioThreadTracks())
 	{
-		TrackData* track = trackManager.getTrack(trackId);
 		if (track && track->midiNote == noteNumber)
 		{
-			if (trackId == trackIdWaitingForLoad)
+			if (track->waitingForMidiToLoad.load())
 			{
-				correctMidiNoteReceived = true;
+				track->correctMidiNoteReceived = true;
 			}
 			if (track->numSamples > 0)
 			{
-				startNotePlaybackForTrack(trackId, noteNumber, hostBpm);
-				trackFound = true;
+				startNotePlaybackForTrack(track->trackId, noteNumber, hostBpm, sampleOffset);
+				triggeredSlot = track->slotIndex;
 			}
 			break;
 		}
 	}
+	return triggeredSlot;
 }
 
-void DjIaVstProcessor::updateMidiIndicatorWithActiveNotes(double hostBpm, const juce::Array<int>& triggeredNotes)
+void DjIaVstProcessor::updateMidiIndicatorWithActiveNotes(double hostBpm, juce::uint64 triggeredSlots)
 {
 	juce::StringArray currentPlayingTracks;
-	auto trackIds = trackManager.getAllTrackIds();
-
-	for (const auto& trackId : trackIds)
+	for (const auto& trackId : trackManager.getAllTrackIds())
 	{
 		TrackData* track = trackManager.getTrack(trackId);
-		if (track && track->isPlaying.load() && triggeredNotes.contains(track->midiNote))
+		if (track && track->isPlaying.load() && UIUpdateFlags::hasSlot(triggeredSlots, track->slotIndex))
 		{
 			juce::String noteName = juce::MidiMessage::getMidiNoteName(track->midiNote, true, true, 3);
 			currentPlayingTracks.add(track->trackName + " (" + noteName + ")");
@@ -808,22 +1258,18 @@ void DjIaVstProcessor::updateMidiIndicatorWithActiveNotes(double hostBpm, const
 
 void DjIaVstProcessor::handleGenerate()
 {
-	if (isGenerating)
-		return;
 	int changedSlot = midiLearnManager.changedGenerateSlotIndex.load();
 	if (changedSlot >= 0)
 	{
-		auto trackIds = trackManager.getAllTrackIds();
-		for (const auto& trackId : trackIds)
+		for (auto* track : trackManager.getAudioThreadTracks())
 		{
-			TrackData* track = trackManager.getTrack(trackId);
 			if (track->slotIndex == changedSlot)
 			{
 				bool paramGenerate = slotGenerateParams[changedSlot]->load() > 0.5f;
 				if (paramGenerate)
 				{
-					generateLoopFromMidi(trackId);
-					needsUIUpdate.store(true);
+					generateLoopFromMidi(track->trackId);
+					uiUpdates.raise(UIUpdateFlags::general);
 				}
 				break;
 			}
@@ -834,96 +1280,67 @@ void DjIaVstProcessor::handleGenerate()
 
 void DjIaVstProcessor::generateLoopFromMidi(const juce::String& trackId)
 {
-	if (isGenerating)
-		return;
-
-	TrackData* track = trackManager.getTrack(trackId);
-	if (!track)
-		return;
-
-	setIsGenerating(true);
-	setGeneratingTrackId(trackId);
-
 	juce::MessageManager::callAsync([this, trackId]()
 		{
-			if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
-				editor->startGenerationUI(trackId);
-			}
-		});
-
-	juce::Thread::launch([this, trackId]()
-		{
-			try {
-				TrackData* track = trackManager.getTrack(trackId);
-				if (!track) {
-					throw std::runtime_error("Track not found");
-				}
-
-				DjIaClient::LoopRequest request;
+			TrackData* track = trackManager.getTrack(trackId);
+			if (!track || isTrackGenerating(trackId))
+				return;
 
-				if (track->usePages.load()) {
-					auto& currentPage = track->getCurrentPage();
+			DjIaClient::LoopRequest request;
 
-					if (!currentPage.selectedPrompt.isEmpty()) {
-						request.prompt = currentPage.selectedPrompt;
-						request.bpm = currentPage.generationBpm > 0 ? currentPage.generationBpm : static_cast<float>(getHostBpm());
-						request.key = !currentPage.generationKey.isEmpty() ? currentPage.generationKey : getGlobalKey();
-						request.generationDuration = currentPage.generationDuration > 0 ? static_cast<float>(currentPage.generationDuration) : static_cast<float>(getGlobalDuration());
+			if (track->usePages.load()) {
+				auto& currentPage = track->getCurrentPage();
 
-						request.preferredStems = currentPage.preferredStems;
-					}
-					else {
-						request = createGlobalLoopRequest();
-						currentPage.selectedPrompt = request.prompt;
-						currentPage.generationBpm = request.bpm;
-						currentPage.generationKey = request.key;
-						currentPage.generationDuration = static_cast<int>(request.generationDuration);
-						currentPage.preferredStems = request.preferredStems;
-					}
+				if (!currentPage.selectedPrompt.isEmpty()) {
+					request.prompt = currentPage.selectedPrompt;
+					request.bpm = currentPage.generationBpm > 0 ? currentPage.generationBpm : static_cast<float>(getHostBpm());
+					request.key = !currentPage.generationKey.isEmpty() ? currentPage.generationKey : getGlobalKey();
+					request.generationDuration = currentPage.generationDuration > 0 ? static_cast<float>(currentPage.generationDuration) : static_cast<float>(getGlobalDuration());
 
-					track->syncLegacyProperties();
-					DBG("MIDI generation for page " << (char)('A' + track->currentPageIndex));
+					request.preferredStems = currentPage.preferredStems;
 				}
 				else {
-					if (!track->selectedPrompt.isEmpty()) {
-						request.prompt = track->selectedPrompt;
-						request.bpm = static_cast<float>(getHostBpm());
-						request.key = getGlobalKey();
-						request.generationDuration = static_cast<float>(getGlobalDuration());
-
-						request.preferredStems.clear();
-						if (isGlobalStemEnabled("drums")) request.preferredStems.push_back("drums");
-						if (isGlobalStemEnabled("bass")) request.preferredStems.push_back("bass");
-						if (isGlobalStemEnabled("other")) request.preferredStems.push_back("other");
-						if (isGlobalStemEnabled("vocals")) request.preferredStems.push_back("vocals");
-						if (isGlobalStemEnabled("guitar")) request.preferredStems.push_back("guitar");
-						if (isGlobalStemEnabled("piano")) request.preferredStems.push_back("piano");
-					}
-					else {
-						request = createGlobalLoopRequest();
-					}
-					track->updateFromRequest(request);
+					request = createGlobalLoopRequest();
+					currentPage.selectedPrompt = request.prompt;
+					currentPage.generationBpm = request.bpm;
+					currentPage.generationKey = request.key;
+					currentPage.generationDuration = static_cast<int>(request.generationDuration);
+					currentPage.preferredStems = request.preferredStems;
 				}
 
-				juce::String promptSource = !request.prompt.isEmpty() ?
-					"track prompt: " + request.prompt.substring(0, 20) + "..." :
-					"global prompt";
-				juce::MessageManager::callAsync([this, promptSource]() {
-					if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
-						editor->statusLabel.setText("Generating with " + promptSource, juce::dontSendNotification);
-					}
-					});
-				generateLoop(request, trackId);
+				track->syncLegacyProperties();
+				DBG("MIDI generation for page " << (char)('A' + track->currentPageIndex));
+			}
+			else {
+				if (!track->selectedPrompt.isEmpty()) {
+					request.prompt = track->selectedPrompt;
+					request.bpm = static_cast<float>(getHostBpm());
+					request.key = getGlobalKey();
+					request.generationDuration = static_cast<float>(getGlobalDuration());
+
+					request.preferredStems.clear();
+					if (isGlobalStemEnabled("drums")) request.preferredStems.push_back("drums");
+					if (isGlobalStemEnabled("bass")) request.preferredStems.push_back("bass");
+					if (isGlobalStemEnabled("other")) request.preferredStems.push_back("other");
+					if (isGlobalStemEnabled("vocals")) request.preferredStems.push_back("vocals");
+					if (isGlobalStemEnabled("guitar")) request.preferredStems.push_back("guitar");
+					if (isGlobalStemEnabled("piano")) request.preferredStems.push_back("piano");
+				}
+				else {
+					request = createGlobalLoopRequest();
+				}
+				track->updateFromRequest(request);
 			}
-			catch (const std::exception& e) {
-				setIsGenerating(false);
-				setGeneratingTrackId("");
 
-				juce::MessageManager::callAsync([this, trackId, error = juce::String(e.what())]() {
-					if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
-						editor->stopGenerationUI(trackId, false, error);
-					}
-					});
+			if (!queueGeneration(request, trackId))
+				return;
+
+			juce::String promptSource = !request.prompt.isEmpty() ?
+				"track prompt: " + request.prompt.substring(0, 20) + "..." :
+				"global prompt";
+			if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
+				editor->startGenerationUI(trackId);
+				editor->statusLabel.setText("Generating with " + promptSource, juce::dontSendNotification);
 			}
 		});
 }
@@ -933,22 +1350,20 @@ void DjIaVstProcessor::handlePlayAndStop(bool /*hostIsPlaying*/)
 	int changedSlot = midiLearnManager.changedPlaySlotIndex.load();
 	if (changedSlot >= 0)
 	{
-		auto trackIds = trackManager.getAllTrackIds();
-		for (const auto& trackId : trackIds)
+		for (auto* track : trackManager.getAudioThreadTracks())
 		{
-			TrackData* track = trackManager.getTrack(trackId);
 			if (track->slotIndex == changedSlot)
 			{
 				bool paramPlay = slotPlayParams[changedSlot]->load() > 0.5f;
 				if (paramPlay)
 				{
-					track->setArmed(true);
+					track->setArmed(true, uiUpdates);
 				}
 				else
 				{
 					track->pendingAction = TrackData::PendingAction::StopOnNextMeasure;
-					track->setArmedToStop(true);
-					track->setArmed(false);
+					track->setArmedToStop(true, uiUpdates);
+					track->setArmed(false, uiUpdates);
 				}
 				break;
 			}
@@ -957,6 +1372,39 @@ void DjIaVstProcessor::handlePlayAndStop(bool /*hostIsPlaying*/)
 	}
 }
 
+void DjIaVstProcessor::syncTrackParameters()
+{
+	juce::uint64 dirtySlots = dirtyParameterSlots.exchange(0, std::memory_order_acquire);
+	juce::uint64 occupiedSlots = 0;
+	for (auto* track : trackManager.getAudioThreadTracks())
+	{
+		const int slot = track->slotIndex;
+		if (slot < 0 || slot >= trackCapacity)
+			continue;
+		occupiedSlots |= juce::uint64(1) << slot;
+
+		// A track that was created, restored or moved into this slot picks
+		// up the slot's parameters even if none of them changed.
+		if (syncedSlotTracks[static_cast<size_t>(slot)] != track)
+		{
+			syncedSlotTracks[static_cast<size_t>(slot)] = track;
+			dirtySlots |= juce::uint64(1) << slot;
+		}
+
+		if ((dirtySlots & (juce::uint64(1) << slot)) != 0)
+			handleSampleParams(slot, track);
+	}
+
+	// Only slots that were synced and are now empty, not every slot.
+	juce::uint64 vacatedSlots = syncedSlotMask & ~occupiedSlots;
+	for (int slot = 0; vacatedSlots != 0; ++slot, vacatedSlots >>= 1)
+	{
+		if ((vacatedSlots & 1) != 0)
+			syncedSlotTracks[static_cast<size_t>(slot)] = nullptr;
+	}
+	syncedSlotMask = occupiedSlots;
+}
+
 void DjIaVstProcessor::handleSampleParams(int slot, TrackData* track)
 {
 	float paramVolume = slotVolumeParams[slot]->load();
@@ -981,17 +1429,24 @@ void DjIaVstProcessor::handleSampleParams(int slot, TrackData* track)
 		track->pan = paramPan;
 	}
 
+	track->insertEqLow = slotEqLowParams[slot]->load();
+	track->insertEqMid = slotEqMidParams[slot]->load();
+	track->insertEqHigh = slotEqHighParams[slot]->load();
+	track->insertFilter = slotFilterParams[slot]->load();
+	track->insertCompression = slotCompParams[slot]->load();
+	track->insertDelaySend = slotDelaySendParams[slot]->load();
+
 	if (std::abs(track->bpmOffset - paramPitch) > 0.01f)
 	{
 		track->bpmOffset = paramPitch;
-		needsUIUpdate = true;
+		uiUpdates.raise(UIUpdateFlags::general);
 	}
 
 	if (std::abs(track->fineOffset - paramFine) > 0.01f)
 	{
 		track->fineOffset = paramFine * 0.05f;
 		track->bpmOffset = paramPitch + track->fineOffset;
-		needsUIUpdate = true;
+		uiUpdates.raise(UIUpdateFlags::general);
 	}
 	bool isSolo = paramSolo > 0.5f;
 	bool isMuted = paramMute > 0.5f;
@@ -1017,7 +1472,8 @@ void DjIaVstProcessor::handleSampleParams(int slot, TrackData* track)
 		}
 	}
 
-	if (track->randomRetriggerInterval.load() != retriggerInterval)
+	// A drawn interval the host has not been told about yet wins over the stale parameter.
+	if (track->randomRetriggerInterval.load() != retriggerInterval && retriggerIntervalFeedback[static_cast<size_t>(slot)].load() == 0)
 	{
 		track->randomRetriggerInterval = retriggerInterval;
 
@@ -1043,89 +1499,98 @@ void DjIaVstProcessor::handleSampleParams(int slot, TrackData* track)
 	}
 }
 
-void DjIaVstProcessor::checkBeatRepeatWithSampleCounter()
+/*
+	Turns beat-repeat requests into one quantized event per track: the next
+	half-beat boundary, computed when the request arrives and again only if
+	the tempo changes. The renderer plays the event at its exact offset.
+	Tracks with nothing requested or placed cost three loads here.
+*/
+void DjIaVstProcessor::updateBeatRepeatTimelines(int numSamples)
 {
-	auto trackIds = trackManager.getAllTrackIds();
-	for (const auto& trackId : trackIds)
+	const juce::int64 blockEnd = internalSampleCounter.load();
+	const juce::int64 blockStart = blockEnd - numSamples;
+	double hostBpm = lastHostBpmForQuantization.load();
+	if (hostBpm <= 0.0)
+		hostBpm = 120.0;
+
+	for (auto* track : trackManager.getAudioThreadTracks())
 	{
-		TrackData* track = trackManager.getTrack(trackId);
-		if (!track)
+		const bool startRequested = track->beatRepeatPending.load(std::memory_order_relaxed);
+		const bool stopRequested = track->beatRepeatStopPending.load(std::memory_order_relaxed);
+		if (!startRequested && !stopRequested && track->beatRepeatEventSample < 0)
 			continue;
 
-		if (track->beatRepeatPending.load())
+		auto& timeline = track->beatRepeatTimeline;
+		if (startRequested || stopRequested)
 		{
-			double hostBpm = lastHostBpmForQuantization.load();
-			if (hostBpm <= 0.0)
-				hostBpm = 120.0;
-
-			double halfBeatDurationSamples = (60.0 / hostBpm) * hostSampleRate * 0.5;
-			int64_t currentSample = internalSampleCounter.load();
-			int64_t currentHalfBeatNumber = currentSample / (int64_t)halfBeatDurationSamples;
+			track->beatRepeatPending = false;
+			track->beatRepeatStopPending = false;
 
-			if (track->pendingBeatNumber.load() < 0)
+			// Both in one block: the toggle's current state says which came last.
+			const bool stop = startRequested && stopRequested ? !track->randomRetriggerEnabled.load() : stopRequested;
+			if (stop && !track->beatRepeatActive.load())
 			{
-				track->pendingBeatNumber.store(currentHalfBeatNumber);
+				track->beatRepeatEventSample = -1;
+				continue;
 			}
 
-			if (currentHalfBeatNumber > track->pendingBeatNumber.load())
+			timeline.stop = stop;
+			if (!stop && track->randomRetriggerDurationEnabled.load())
 			{
-				if (track->randomRetriggerDurationEnabled.load()) {
-					int randomInterval = 1 + (rand() % 10);
-					track->randomRetriggerInterval.store(randomInterval);
-					juce::String paramName = "slot" + juce::String(track->slotIndex + 1) + "RetriggerInterval";
-					auto* param = getParameterTreeState().getParameter(paramName);
-					if (param) {
-						float normalizedValue = (randomInterval - 1.0f) / 9.0f;
-						param->setValueNotifyingHost(normalizedValue);
-					}
-				}
-
-				double currentPosition = track->readPosition.load();
-				double repeatDuration = calculateRetriggerInterval(track->randomRetriggerInterval.load(), hostBpm);
-				double repeatDurationSamples = repeatDuration * track->sampleRate;
-
-				track->originalReadPosition.store(currentPosition);
-				track->beatRepeatStartPosition.store(currentPosition);
-				track->beatRepeatEndPosition.store(currentPosition + repeatDurationSamples);
-
-				double maxSamples = track->numSamples;
-				if (track->beatRepeatEndPosition.load() > maxSamples) {
-					track->beatRepeatEndPosition.store(maxSamples);
-				}
-
-				track->beatRepeatActive.store(true);
-				track->beatRepeatPending.store(false);
-				track->pendingBeatNumber.store(-1);
-				track->readPosition.store(track->beatRepeatStartPosition.load());
+				const int randomInterval = 1 + retriggerRandom.nextInt(10);
+				track->randomRetriggerInterval = randomInterval;
+				if (track->slotIndex >= 0 && track->slotIndex < MAX_TRACKS)
+					retriggerIntervalFeedback[static_cast<size_t>(track->slotIndex)] = randomInterval;
 			}
+			placeBeatRepeatEvent(*track, blockStart, hostBpm);
 		}
+		else if (timeline.placedAtBpm != hostBpm)
+		{
+			placeBeatRepeatEvent(*track, blockStart, hostBpm);
+		}
+
+		if (track->beatRepeatEventSample >= blockEnd)
+			continue;
 
-		if (track->beatRepeatStopPending.load())
+		const int offset = static_cast<int>(juce::jlimit<juce::int64>(0, juce::jmax(0, numSamples - 1), track->beatRepeatEventSample - blockStart));
+		track->beatRepeatEventSample = -1;
+		if (timeline.stop)
 		{
-			double hostBpm = lastHostBpmForQuantization.load();
-			if (hostBpm <= 0.0)
-				hostBpm = 120.0;
+			track->scheduleEvent(TrackData::ScheduledEvent::Type::BeatRepeatStop, offset);
+			track->randomRetriggerActive = false;
+			track->lastRetriggerTime = -1.0;
+		}
+		else
+		{
+			// The renderer captures the loop start at this offset, once the
+			// samples before the half-beat boundary have played.
+			track->scheduleEvent(TrackData::ScheduledEvent::Type::BeatRepeatStart, offset, timeline.repeatSamples);
+		}
+	}
+}
 
-			double halfBeatDurationSamples = (60.0 / hostBpm) * hostSampleRate * 0.5;
-			int64_t currentSample = internalSampleCounter.load();
-			int64_t currentHalfBeatNumber = currentSample / (int64_t)halfBeatDurationSamples;
+void DjIaVstProcessor::placeBeatRepeatEvent(TrackData& track, juce::int64 fromSample, double hostBpm)
+{
+	auto& timeline = track.beatRepeatTimeline;
+	const double halfBeatSamples = juce::jmax(1.0, (60.0 / hostBpm) * hostSampleRate * 0.5);
+	track.beatRepeatEventSample = static_cast<juce::int64>(std::ceil(static_cast<double>(fromSample) / halfBeatSamples) * halfBeatSamples);
+	timeline.placedAtBpm = hostBpm;
+	timeline.repeatSamples = calculateRetriggerInterval(track.randomRetriggerInterval.load(), hostBpm) * track.sampleRate;
+}
 
-			if (track->pendingStopBeatNumber.load() < 0)
-			{
-				track->pendingStopBeatNumber.store(currentHalfBeatNumber);
-			}
+/** Message thread: tells the host about intervals the audio thread drew at random. */
+void DjIaVstProcessor::publishRetriggerIntervals()
+{
+	for (int slot = 0; slot < trackCapacity; ++slot)
+	{
+		auto& feedback = retriggerIntervalFeedback[static_cast<size_t>(slot)];
+		int interval = feedback.load();
+		if (interval == 0)
+			continue;
 
-			if (currentHalfBeatNumber > track->pendingStopBeatNumber.load())
-			{
-				track->beatRepeatActive.store(false);
-				track->beatRepeatStopPending.store(false);
-				track->randomRetriggerActive.store(false);
-				track->lastRetriggerTime.store(-1.0);
-				track->readPosition.store(track->originalReadPosition.load());
-				track->pendingStopBeatNumber.store(-1);
-				DBG("Beat repeat stopped at sample: " << currentSample);
-			}
-		}
+		if (auto* param = parameters.getParameter("slot" + juce::String(slot + 1) + "RetriggerInterval"))
+			param->setValueNotifyingHost((interval - 1.0f) / 9.0f);
+		feedback.compare_exchange_strong(interval, 0);
 	}
 }
 
@@ -1165,10 +1630,8 @@ double DjIaVstProcessor::calculateRetriggerInterval(int intervalValue, double ho
 
 void DjIaVstProcessor::updateTimeStretchRatios(double hostBpm)
 {
-	auto trackIds = trackManager.getAllTrackIds();
-	for (const auto& trackId : trackIds)
+	for (auto* track : trackManager.getAudioThreadTracks())
 	{
-		TrackData* track = trackManager.getTrack(trackId);
 		if (!track)
 			continue;
 
@@ -1197,17 +1660,15 @@ void DjIaVstProcessor::updateTimeStretchRatios(double hostBpm)
 	}
 }
 
-void DjIaVstProcessor::startNotePlaybackForTrack(const juce::String& trackId, int noteNumber, double /*hostBpm*/)
+void DjIaVstProcessor::startNotePlaybackForTrack(const juce::String& trackId, int noteNumber, double /*hostBpm*/, int sampleOffset)
 {
-	TrackData* track = trackManager.getTrack(trackId);
+	TrackData* track = trackManager.findAudioThreadTrack(trackId);
 	if (!track || track->numSamples == 0)
 		return;
 	if (getBypassSequencer())
 	{
-		if (!track->beatRepeatActive.load()) {
-			track->readPosition = 0.0;
-		}
-		track->setPlaying(true);
+		track->scheduleStart(sampleOffset);
+		track->setPlaying(true, uiUpdates);
 		track->isCurrentlyPlaying.store(true);
 		playingTracks[noteNumber] = trackId;
 		return;
@@ -1225,24 +1686,23 @@ void DjIaVstProcessor::startNotePlaybackForTrack(const juce::String& trackId, in
 		return;
 	}
 
-	if (!track->beatRepeatActive.load()) {
-		track->readPosition = 0.0;
-	}
-	track->setPlaying(true);
+	track->scheduleStart(sampleOffset);
+	track->setPlaying(true, uiUpdates);
 	track->isCurrentlyPlaying.store(true);
 	track->isArmed = false;
 	playingTracks[noteNumber] = trackId;
 }
 
-void DjIaVstProcessor::stopNotePlaybackForTrack(int noteNumber)
+void DjIaVstProcessor::stopNotePlaybackForTrack(int noteNumber, int sampleOffset)
 {
 	auto it = playingTracks.find(noteNumber);
 	if (it != playingTracks.end())
 	{
-		TrackData* track = trackManager.getTrack(it->second);
+		TrackData* track = trackManager.findAudioThreadTrack(it->second);
 		if (track)
 		{
 			track->isPlaying = false;
+			track->scheduleEvent(TrackData::ScheduledEvent::Type::Stop, sampleOffset);
 		}
 		playingTracks.erase(it);
 	}
@@ -1251,9 +1711,9 @@ void DjIaVstProcessor::stopNotePlaybackForTrack(int noteNumber)
 juce::String DjIaVstProcessor::createNewTrack(const juce::String& name)
 {
 	auto trackIds = trackManager.getAllTrackIds();
-	if (trackIds.size() >= MAX_TRACKS)
+	if (trackIds.size() >= static_cast<size_t>(trackCapacity))
 	{
-		throw std::runtime_error("Maximum number of tracks reached (" + std::to_string(MAX_TRACKS) + ")");
+		throw std::runtime_error("Maximum number of tracks reached (" + std::to_string(trackCapacity) + ")");
 	}
 
 	juce::String trackId = trackManager.createTrack(name);
@@ -1342,6 +1802,10 @@ void DjIaVstProcessor::performTrackDeletion(const juce::String& trackId)
 	}
 
 	trackManager.removeTrack(trackId);
+	{
+		const juce::ScopedLock lock(candidateLock);
+		generationCandidates.erase(trackId);
+	}
 
 	reassignTrackOutputsAndMidi();
 
@@ -1374,12 +1838,10 @@ void DjIaVstProcessor::reassignTrackOutputsAndMidi()
 
 			for (const auto& mapping : allMappings)
 			{
-				if (mapping.parameterName.startsWith("slot" + juce::String(oldSlotNumber)))
+				if (SlotParameters::belongsToSlot(mapping.parameterName, oldSlotNumber))
 				{
 					MidiMapping newMapping = mapping;
-
-					juce::String suffix = mapping.parameterName.substring(4);
-					newMapping.parameterName = "slot" + juce::String(newSlotNumber) + suffix.substring(1);
+					newMapping.parameterName = "slot" + juce::String(newSlotNumber) + SlotParameters::getSuffix(mapping.parameterName);
 
 					newMapping.description = newMapping.description.replace(
 						"Slot " + juce::String(oldSlotNumber),
@@ -1445,7 +1907,14 @@ void DjIaVstProcessor::selectTrack(const juce::String& trackId)
 	}
 }
 
-void DjIaVstProcessor::generateLoop(const DjIaClient::LoopRequest& request, const juce::String& targetTrackId)
+bool DjIaVstProcessor::queueGeneration(const DjIaClient::LoopRequest& request, const juce::String& trackId)
+{
+	const auto backend = useLocalModel ? GenerationQueue::Backend::Local : GenerationQueue::Backend::Server;
+	return generationQueue.submit(trackId, request, backend);
+}
+
+GenerationQueue::Result DjIaVstProcessor::generateLoop(const DjIaClient::LoopRequest& request, const juce::String& targetTrackId,
+	bool speculative)
 {
 	juce::String trackId = targetTrackId.isEmpty() ? selectedTrackId : targetTrackId;
 
@@ -1453,65 +1922,301 @@ void DjIaVstProcessor::generateLoop(const DjIaClient::LoopRequest& request, cons
 	{
 		if (useLocalModel)
 		{
-			generateLoopLocal(request, trackId);
-		}
-		else
-		{
-			generateLoopAPI(request, trackId);
+			return generateLoopLocal(request, trackId, speculative);
 		}
+		return generateLoopAPI(request, trackId, speculative);
 	}
 	catch (const std::exception& e)
 	{
-		hasPendingAudioData = false;
-		waitingForMidiToLoad = false;
-		trackIdWaitingForLoad.clear();
-		correctMidiNoteReceived = false;
-		setIsGenerating(false);
-		setGeneratingTrackId("");
-		notifyGenerationComplete(trackId, "Error: " + juce::String(e.what()));
+		return GenerationQueue::Result::failure("ERROR: " + juce::String(e.what()));
+	}
+}
+
+bool DjIaVstProcessor::deliverGeneratedAudio(const juce::String& trackId, const juce::File& audioFile,
+	std::shared_ptr<DjIaClient::DecodedAudio> decodedAudio, bool loadImmediately)
+{
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!track)
+		return false;
+
+	bool isPreview = false;
+	{
+		const juce::SpinLock::ScopedLockType lock(track->pendingAudioLock);
+		track->pendingAudioFile = audioFile;
+		std::swap(track->pendingDecodedAudio, decodedAudio);
+		track->pendingAudioConsumed = false;
+		isPreview = track->pendingDecodedAudio != nullptr && track->pendingDecodedAudio->isPreview;
+	}
+	const bool replacesPreview = track->previewDelivered.exchange(isPreview) && !isPreview;
+	track->pendingLoadsImmediately = replacesPreview || loadImmediately;
+	track->correctMidiNoteReceived = false;
+	track->waitingForMidiToLoad = !track->pendingLoadsImmediately.load();
+	track->hasPendingAudio = true;
+	hasPendingAudioData = true;
+	return true;
+}
+
+bool DjIaVstProcessor::candidateMatches(const DjIaClient::LoopRequest& candidate, const DjIaClient::LoopRequest& current)
+{
+	return candidate.prompt == current.prompt && candidate.key == current.key &&
+		std::abs(candidate.bpm - current.bpm) < 0.01f &&
+		std::abs(candidate.generationDuration - current.generationDuration) < 0.01f;
+}
+
+bool DjIaVstProcessor::storeGenerationCandidate(const juce::String& trackId, const DjIaClient::LoopRequest& request,
+	const juce::File& audioFile, std::shared_ptr<DjIaClient::DecodedAudio> decodedAudio)
+{
+	// Decoded and analysed now so that taking the variation later only
+	// leaves the stretch to do.
+	if (decodedAudio == nullptr)
+	{
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
+		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
+		if (!reader || reader->lengthInSamples <= 0)
+			return false;
+
+		decodedAudio = std::make_shared<DjIaClient::DecodedAudio>();
+		const int numFrames = static_cast<int>(reader->lengthInSamples);
+		decodedAudio->buffer.setSize(2, numFrames);
+		reader->read(&decodedAudio->buffer, 0, numFrames, 0, true, true);
+		if (reader->numChannels == 1)
+			decodedAudio->buffer.copyFrom(1, 0, decodedAudio->buffer, 0, 0, numFrames);
+		decodedAudio->sampleRate = reader->sampleRate;
+		reader.reset();
+		audioFile.deleteFile();
+	}
+	if (decodedAudio->detectedBpm <= 0.0f)
+	{
+		decodedAudio->detectedBpm = AudioAnalyzer::analyzeBPM(decodedAudio->buffer, decodedAudio->sampleRate).bpm;
+	}
+
+	if (trackManager.getTrack(trackId) == nullptr)
+		return false;
+
+	const juce::ScopedLock lock(candidateLock);
+	auto& candidates = generationCandidates[trackId];
+	if (static_cast<int>(candidates.size()) >= candidatesPerTrack)
+		candidates.erase(candidates.begin());
+	candidates.push_back({ request, std::move(decodedAudio) });
+	DBG("Variation ready for track " << trackId << " (" << candidates.size() << " waiting)");
+	return true;
+}
+
+void DjIaVstProcessor::scheduleSpeculativeGeneration()
+{
+	if (!speculativeGeneration.load() || getSpeculativeRemaining() <= 0 ||
+		generationQueue.hasActiveRequests() || generationQueue.getNumSpeculative() > 0)
+		return;
+
+	TrackData* track = trackManager.getTrack(selectedTrackId);
+	if (!track || track->numSamples <= 0)
+		return;
+
+	auto request = track->createLoopRequest();
+	if (request.prompt.isEmpty())
+		return;
+
+	{
+		const juce::ScopedLock lock(candidateLock);
+		auto& candidates = generationCandidates[track->trackId];
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+			[&request](const GenerationCandidate& candidate) { return !candidateMatches(candidate.request, request); }),
+			candidates.end());
+		if (static_cast<int>(candidates.size()) >= candidatesPerTrack)
+			return;
 	}
+
+	// With a single slot (the local engine's default) a variation would hold
+	// up the user's next generation, so nothing is speculated there.
+	const auto backend = useLocalModel ? GenerationQueue::Backend::Local : GenerationQueue::Backend::Server;
+	if (generationQueue.getMaxConcurrent(backend) < 2)
+		return;
+
+	request.seed = juce::Random().nextInt(1000000);
+	generationQueue.submitSpeculative(track->trackId, request, backend);
+}
+
+void DjIaVstProcessor::setSpeculativeGeneration(bool enabled)
+{
+	speculativeGeneration = enabled;
+	if (!enabled)
+		generationQueue.cancelSpeculative();
+}
+
+void DjIaVstProcessor::setSpeculativeBudget(int maxGenerations)
+{
+	speculativeBudget = juce::jmax(0, maxGenerations);
+	speculativeUsed = 0;
 }
 
-void DjIaVstProcessor::generateLoopAPI(const DjIaClient::LoopRequest& request, const juce::String& trackId)
+int DjIaVstProcessor::getNumVariationsReady(const juce::String& trackId)
 {
-	auto response = apiClient.generateLoop(request, hostSampleRate, requestTimeoutMS);
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!track)
+		return 0;
+
+	const auto current = track->createLoopRequest();
+	const juce::ScopedLock lock(candidateLock);
+	auto it = generationCandidates.find(trackId);
+	if (it == generationCandidates.end())
+		return 0;
+	return static_cast<int>(std::count_if(it->second.begin(), it->second.end(),
+		[&current](const GenerationCandidate& candidate) { return candidateMatches(candidate.request, current); }));
+}
+
+bool DjIaVstProcessor::loadNextVariation(const juce::String& trackId)
+{
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!track)
+		return false;
+
+	const auto current = track->createLoopRequest();
+	GenerationCandidate candidate;
+	{
+		const juce::ScopedLock lock(candidateLock);
+		auto it = generationCandidates.find(trackId);
+		if (it == generationCandidates.end())
+			return false;
+
+		auto& candidates = it->second;
+		auto match = std::find_if(candidates.begin(), candidates.end(),
+			[&current](const GenerationCandidate& entry) { return candidateMatches(entry.request, current); });
+		if (match == candidates.end())
+			return false;
+
+		candidate = std::move(*match);
+		candidates.erase(match);
+	}
+
+	if (!deliverGeneratedAudio(trackId, {}, candidate.audio, true))
+		return false;
+
+	track->prompt = candidate.request.prompt;
+	track->bpm = candidate.request.bpm;
+	uiUpdates.raise(UIUpdateFlags::general);
+	return true;
+}
+
+void DjIaVstProcessor::restoreAudioBeforePreview(const juce::String& trackId)
+{
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!track)
+		return;
+
+	const juce::File previousFile = track->usePages.load()
+		? getTrackPageAudioFile(trackId, track->currentPageIndex)
+		: getTrackAudioFile(trackId);
+	if (previousFile.existsAsFile())
+	{
+		DBG("Progressive generation failed, restoring previous loop for track " << trackId);
+		deliverGeneratedAudio(trackId, previousFile, nullptr, true);
+		return;
+	}
+
+	// Nothing was loaded before the preview; stop the track rather than
+	// leave it looping a single bar of an abandoned generation.
+	DBG("Progressive generation failed, stopping preview on track " << trackId);
+	track->previewDelivered = false;
+	track->isPlaying = false;
+	track->isCurrentlyPlaying = false;
+	uiUpdates.raise(UIUpdateFlags::general);
+}
+
+GenerationQueue::Result DjIaVstProcessor::generateLoopAPI(const DjIaClient::LoopRequest& request, const juce::String& trackId,
+	bool speculative)
+{
+	// In streaming mode the loop is decoded while it downloads, and BPM
+	// detection starts on the first seconds before the body has finished.
+	// With progressive generation the first bar is also handed to the track
+	// as a preview loop so it can play while the rest is still generated.
+	TrackData* generatingTrack = speculative ? nullptr : trackManager.getTrack(trackId);
+	if (generatingTrack != nullptr)
+		generatingTrack->previewDelivered = false;
+
+	std::future<float> earlyBpm;
+	bool previewDelivered = false;
+	const float previewBpm = request.bpm > 0.0f ? request.bpm : 110.0f;
+	DjIaClient::StreamOptions streamOptions;
+	streamOptions.progressive = progressiveGeneration.load() && !speculative;
+	streamOptions.onProgress = [this, &earlyBpm, &previewDelivered, &trackId, previewBpm, progressive = streamOptions.progressive](
+		const juce::AudioBuffer<float>& decoded, int numFrames, double sampleRate)
+		{
+			const int barFrames = static_cast<int>(sampleRate * 240.0 / previewBpm);
+			if (progressive && !previewDelivered && numFrames >= barFrames)
+			{
+				auto preview = std::make_shared<DjIaClient::DecodedAudio>();
+				preview->buffer.setSize(decoded.getNumChannels(), barFrames);
+				for (int channel = 0; channel < decoded.getNumChannels(); ++channel)
+					preview->buffer.copyFrom(channel, 0, decoded, channel, 0, barFrames);
+				preview->sampleRate = sampleRate;
+				preview->detectedBpm = previewBpm;
+				preview->isPreview = true;
+				previewDelivered = deliverGeneratedAudio(trackId, {}, preview);
+			}
+
+			if (earlyBpm.valid() || numFrames < static_cast<int>(sampleRate * earlyAnalysisSeconds))
+				return;
+
+			auto prefix = std::make_shared<juce::AudioBuffer<float>>(decoded.getNumChannels(), numFrames);
+			for (int channel = 0; channel < decoded.getNumChannels(); ++channel)
+				prefix->copyFrom(channel, 0, decoded, channel, 0, numFrames);
+
+			earlyBpm = std::async(std::launch::async, [prefix, sampleRate]()
+				{ return AudioAnalyzer::analyzeBPM(*prefix, sampleRate).bpm; });
+		};
+
+	auto response = apiClient.generateLoop(request, hostSampleRate, requestTimeoutMS,
+		streamGeneratedAudio.load() ? &streamOptions : nullptr);
+
+	// A stream that fails after its first bar was installed must not leave
+	// the track looping that bar: the previous loop is loaded back from its
+	// cache file, which a preview never overwrites.
+	auto failAfterPreview = [this, &trackId, &previewDelivered](const juce::String& message)
+		{
+			if (previewDelivered)
+				restoreAudioBeforePreview(trackId);
+			return GenerationQueue::Result::failure(message);
+		};
 
 	try
 	{
 		if (!response.errorMessage.isEmpty())
 		{
-			setIsGenerating(false);
-			setGeneratingTrackId("");
-			notifyGenerationComplete(trackId, "ERROR: " + response.errorMessage);
-			return;
+			return failAfterPreview("ERROR: " + response.errorMessage);
 		}
 
-		if (response.audioData.getFullPathName().isEmpty() ||
+		if (response.decodedAudio == nullptr &&
+			(response.audioData.getFullPathName().isEmpty() ||
 			!response.audioData.exists() ||
-			response.audioData.getSize() == 0)
+			response.audioData.getSize() == 0))
 		{
-			setIsGenerating(false);
-			setGeneratingTrackId("");
-			notifyGenerationComplete(trackId, "Invalid response from API");
-			return;
+			return failAfterPreview("ERROR: Invalid response from API");
 		}
 	}
 	catch (const std::exception& /*e*/)
 	{
-		setIsGenerating(false);
-		setGeneratingTrackId("");
-		notifyGenerationComplete(trackId, "Response validation failed");
-		return;
+		return failAfterPreview("ERROR: Response validation failed");
+	}
+
+	lastTransferBytes = response.bytesReceived;
+	lastTransferMs = response.transferTimeMs;
+	DBG("Generation transfer for " << trackId << ": " << response.bytesReceived << " bytes (" << response.audioFormat
+		<< ") in " << response.transferTimeMs << " ms after " << response.serverTimeMs << " ms server time");
+
+	if (response.decodedAudio != nullptr && earlyBpm.valid())
+	{
+		response.decodedAudio->detectedBpm = earlyBpm.get();
 	}
 
+	if (speculative)
 	{
-		const juce::ScopedLock lock(apiLock);
-		pendingTrackId = trackId;
-		pendingAudioFile = response.audioData;
-		hasPendingAudioData = true;
-		waitingForMidiToLoad = true;
-		trackIdWaitingForLoad = trackId;
-		correctMidiNoteReceived = false;
+		return { storeGenerationCandidate(trackId, request, response.audioData, response.decodedAudio), {} };
+	}
+
+	if (!deliverGeneratedAudio(trackId, response.audioData, response.decodedAudio))
+	{
+		return GenerationQueue::Result::failure("ERROR: Track was removed during generation");
 	}
 
 	if (TrackData* track = trackManager.getTrack(trackId))
@@ -1529,9 +2234,6 @@ void DjIaVstProcessor::generateLoopAPI(const DjIaClient::LoopRequest& request, c
 		track->stems = stems;
 	}
 
-	setIsGenerating(false);
-	setGeneratingTrackId("");
-
 	juce::String successMessage = "Loop generated successfully! Press Play to listen.";
 	if (response.isUnlimitedKey)
 	{
@@ -1542,7 +2244,7 @@ void DjIaVstProcessor::generateLoopAPI(const DjIaClient::LoopRequest& request, c
 		successMessage += " - " + juce::String(response.creditsRemaining) + " credits remaining";
 	}
 
-	notifyGenerationComplete(trackId, successMessage);
+	return { true, successMessage };
 }
 
 void DjIaVstProcessor::loadSampleFromBank(const juce::String& sampleId, const juce::String& trackId)
@@ -1576,16 +2278,16 @@ void DjIaVstProcessor::loadSampleFromBank(const juce::String& sampleId, const ju
 		track->currentSampleId = sampleId;
 	}
 
-	juce::Thread::launch([this, trackId, sampleFile, sampleId]()
+	submitStretchJob(trackId, [this, trackId, sampleFile, sampleId](StretchJobPool::JobContext& job)
 		{
 			TrackData* track = trackManager.getTrack(trackId);
 			if (!track) return;
 
 			if (track->usePages.load()) {
-				loadSampleToBankPage(trackId, track->currentPageIndex, sampleFile, sampleId);
+				loadSampleToBankPage(trackId, track->currentPageIndex, sampleFile, sampleId, &job);
 			}
 			else {
-				loadAudioFileAsync(trackId, sampleFile);
+				loadAudioFileAsync(trackId, sampleFile, &job, true);
 			}
 
 			juce::Timer::callAfterDelay(2000, [this]()
@@ -1596,52 +2298,61 @@ void DjIaVstProcessor::loadSampleFromBank(const juce::String& sampleId, const ju
 		});
 }
 
-void DjIaVstProcessor::generateLoopLocal(const DjIaClient::LoopRequest& request, const juce::String& trackId)
+GenerationQueue::Result DjIaVstProcessor::generateLoopLocal(const DjIaClient::LoopRequest& request, const juce::String& trackId,
+	bool speculative)
 {
-	auto appDataDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-		.getChildFile("OBSIDIAN-Neural");
-	auto stableAudioDir = appDataDir.getChildFile("stable-audio");
+	{
+		const juce::ScopedLock lock(sharedResources->localEngineLock);
+		if (!sharedResources->localEngine.isReady())
+		{
+			auto appDataDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+				.getChildFile("OBSIDIAN-Neural");
+			auto stableAudioDir = appDataDir.getChildFile("stable-audio");
+
+			if (!sharedResources->localEngine.initialize(stableAudioDir.getFullPathName()))
+			{
+				return GenerationQueue::Result::failure("ERROR: Local models not found. Please check setup instructions.");
+			}
+		}
+	}
 
-	StableAudioEngine localEngine;
-	if (!localEngine.initialize(stableAudioDir.getFullPathName()))
+	// Other instances in the process may be generating locally too; the
+	// shared slot keeps the total within the limit.
+	LocalGenerationSlots::ScopedSlot slot(sharedResources->localGenerations);
+	if (!slot.isAcquired())
 	{
-		setIsGenerating(false);
-		setGeneratingTrackId("");
-		notifyGenerationComplete(trackId, "ERROR: Local models not found. Please check setup instructions.");
-		return;
+		return GenerationQueue::Result::failure("ERROR: Local generation cancelled");
 	}
 
 	StableAudioEngine::GenerationParams params(request.prompt, 6.0f);
 	params.sampleRate = static_cast<int>(hostSampleRate);
-	params.numThreads = 4;
+	// The thread budget covers every local generation the process allows
+	// at once, so concurrent jobs share the cores instead of oversubscribing.
+	const int concurrentJobs = sharedResources->localGenerations.getLimit();
+	params.numThreads = juce::jmax(1, getEffectiveLocalGenerationThreads() / concurrentJobs);
+	params.seed = request.seed;
 
-	auto result = localEngine.generateSample(params);
+	auto result = sharedResources->localEngine.generateSample(params);
 
-	if (!result.success || result.audioData.empty())
+	if (!result.isValid())
 	{
-		setIsGenerating(false);
-		setGeneratingTrackId("");
-		notifyGenerationComplete(trackId, "ERROR: Local generation failed - " + result.errorMessage);
-		return;
+		return GenerationQueue::Result::failure("ERROR: Local generation failed - " + result.errorMessage);
 	}
 
-	juce::File tempFile = createTempAudioFile(result.audioData, result.actualDuration);
-	if (!tempFile.exists() || tempFile.getSize() == 0)
+	// The engine's buffer is moved into the staging handoff; the bank copy
+	// is written after the swap by loadDecodedAudioAsync.
+	auto decodedAudio = std::make_shared<DjIaClient::DecodedAudio>();
+	decodedAudio->buffer = std::move(result.audio);
+	decodedAudio->sampleRate = result.sampleRate;
+
+	if (speculative)
 	{
-		setIsGenerating(false);
-		setGeneratingTrackId("");
-		notifyGenerationComplete(trackId, "ERROR: Failed to create audio file");
-		return;
+		return { storeGenerationCandidate(trackId, request, {}, std::move(decodedAudio)), {} };
 	}
 
+	if (!deliverGeneratedAudio(trackId, {}, std::move(decodedAudio)))
 	{
-		const juce::ScopedLock lock(apiLock);
-		pendingTrackId = trackId;
-		pendingAudioFile = tempFile;
-		hasPendingAudioData = true;
-		waitingForMidiToLoad = true;
-		trackIdWaitingForLoad = trackId;
-		correctMidiNoteReceived = false;
+		return GenerationQueue::Result::failure("ERROR: Track was removed during generation");
 	}
 
 	if (TrackData* track = trackManager.getTrack(trackId))
@@ -1651,14 +2362,11 @@ void DjIaVstProcessor::generateLoopLocal(const DjIaClient::LoopRequest& request,
 		track->stems = "";
 	}
 
-	setIsGenerating(false);
-	setGeneratingTrackId("");
-
 	juce::String successMessage = juce::String::formatted(
 		"Loop generated locally! (%.1fs) Press Play to listen.",
 		result.actualDuration);
 
-	notifyGenerationComplete(trackId, successMessage);
+	return { true, successMessage };
 }
 
 juce::StringArray DjIaVstProcessor::getBuiltInPrompts() const
@@ -1684,36 +2392,25 @@ juce::StringArray DjIaVstProcessor::getBuiltInPrompts() const
 
 void DjIaVstProcessor::handleGenerationComplete(const juce::String& trackId,
 	const DjIaClient::LoopRequest& /*originalRequest*/,
-	const ObsidianEngine::LoopResponse& response)
+	ObsidianEngine::LoopResponse&& response)
 {
 	try
 	{
-		if (!response.success || response.audioData.empty())
+		if (!response.success || response.audio.getNumSamples() == 0)
 		{
-			setIsGenerating(false);
-			setGeneratingTrackId("");
 			juce::String errorMsg = response.errorMessage.isEmpty() ? "Unknown generation error" : response.errorMessage;
 			notifyGenerationComplete(trackId, "ERROR: " + errorMsg);
 			return;
 		}
 
-		juce::File tempFile = createTempAudioFile(response.audioData, response.actualDuration);
-		if (!tempFile.exists() || tempFile.getSize() == 0)
-		{
-			setIsGenerating(false);
-			setGeneratingTrackId("");
-			notifyGenerationComplete(trackId, "ERROR: Failed to create audio file");
-			return;
-		}
+		auto decodedAudio = std::make_shared<DjIaClient::DecodedAudio>();
+		decodedAudio->buffer = std::move(response.audio);
+		decodedAudio->sampleRate = response.sampleRate;
 
+		if (!deliverGeneratedAudio(trackId, {}, std::move(decodedAudio)))
 		{
-			const juce::ScopedLock lock(apiLock);
-			pendingTrackId = trackId;
-			pendingAudioFile = tempFile;
-			hasPendingAudioData = true;
-			waitingForMidiToLoad = true;
-			trackIdWaitingForLoad = trackId;
-			correctMidiNoteReceived = false;
+			notifyGenerationComplete(trackId, "ERROR: Track was removed during generation");
+			return;
 		}
 
 		if (TrackData* track = trackManager.getTrack(trackId))
@@ -1734,9 +2431,6 @@ void DjIaVstProcessor::handleGenerationComplete(const juce::String& trackId,
 			}
 		}
 
-		setIsGenerating(false);
-		setGeneratingTrackId("");
-
 		juce::String successMessage = juce::String::formatted(
 			"Loop generated successfully! (%.1fs, %.0f BPM) Press Play to listen.",
 			response.duration,
@@ -1756,145 +2450,109 @@ void DjIaVstProcessor::handleGenerationComplete(const juce::String& trackId,
 	}
 	catch (const std::exception& e)
 	{
-		hasPendingAudioData = false;
-		waitingForMidiToLoad = false;
-		trackIdWaitingForLoad.clear();
-		correctMidiNoteReceived = false;
-		setIsGenerating(false);
-		setGeneratingTrackId("");
 		notifyGenerationComplete(trackId, "Error processing generated audio: " + juce::String(e.what()));
 	}
 }
 
-juce::File DjIaVstProcessor::createTempAudioFile(const std::vector<float>& audioData, float /*duration*/)
+void DjIaVstProcessor::notifyGenerationComplete(const juce::String& trackId, const juce::String& message)
 {
-	try
 	{
-		juce::File tempFile = juce::File::createTempFile(".wav");
-		int numSamples = static_cast<int>(audioData.size());
-		juce::AudioBuffer<float> buffer(1, numSamples);
-		if (audioData.size() > 0)
-		{
-			buffer.copyFrom(0, 0, audioData.data(), numSamples);
-		}
-		juce::WavAudioFormat wavFormat;
-		juce::FileOutputStream* outputStream = new juce::FileOutputStream(tempFile);
-		if (!outputStream->openedOk())
-		{
-			delete outputStream;
-			return juce::File{};
-		}
-
-		std::unique_ptr<juce::AudioFormatWriter> writer(
-			wavFormat.createWriterFor(
-				outputStream,
-				hostSampleRate,
-				1,
-				16,
-				{},
-				0));
-
-		if (!writer)
-		{
-			return juce::File{};
-		}
-
-		if (!writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples()))
-		{
-			return juce::File{};
-		}
-
-		writer.reset();
-
-		return tempFile;
-	}
-	catch (const std::exception& /*e*/)
-	{
-		return juce::File{};
+		const juce::ScopedLock lock(notificationLock);
+		pendingNotifications.push_back({ trackId, message });
 	}
-}
-
-void DjIaVstProcessor::notifyGenerationComplete(const juce::String& trackId, const juce::String& message)
-{
-	lastGeneratedTrackId = trackId;
-	pendingMessage = message;
-	hasPendingNotification = true;
 	triggerAsyncUpdate();
 }
 
 void DjIaVstProcessor::handleAsyncUpdate()
 {
-	if (!hasPendingNotification)
-		return;
+	std::vector<GenerationNotification> notifications;
+	{
+		const juce::ScopedLock lock(notificationLock);
+		notifications.swap(pendingNotifications);
+	}
 
-	hasPendingNotification = false;
+	if (notifications.empty() || !dynamic_cast<DjIaVstEditor*>(getActiveEditor()) || !generationListener)
+		return;
 
-	juce::MessageManager::callAsync([this]()
-		{
-			if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
-				if (generationListener) {
-					generationListener->onGenerationComplete(lastGeneratedTrackId, pendingMessage);
-				}
-			} });
+	for (const auto& notification : notifications)
+	{
+		generationListener->onGenerationComplete(notification.trackId, notification.message);
+	}
 }
 
 void DjIaVstProcessor::processIncomingAudio(bool hostIsPlaying)
 {
-	if (!hasPendingAudioData.load())
-	{
-		return;
-	}
-	if (pendingTrackId.isEmpty())
-	{
-		return;
-	}
+	// Each track owns its pending slot, so loops that finish together are
+	// picked up in the same pass and one deferred track does not hold back
+	// the others. The flag is cleared first so a delivery racing this pass
+	// is seen on the next block.
+	hasPendingAudioData = false;
 
-	TrackData* track = trackManager.getTrack(pendingTrackId);
-	if (!track)
-	{
-		return;
-	}
-	if (waitingForMidiToLoad.load() && !correctMidiNoteReceived.load() && hostIsPlaying && track->isPlaying.load())
-	{
-		return;
-	}
-	if (!canLoad.load() && !autoLoadEnabled.load())
+	const bool loadRequested = canLoad.load();
+	bool stillPending = false;
+	bool waitingForLoad = false;
+	bool loadedAny = false;
+
+	for (auto* track : trackManager.getAudioThreadTracks())
 	{
-		hasUnloadedSample = true;
-		return;
-	}
+		if (!track || !track->hasPendingAudio.load())
+			continue;
 
-	juce::MessageManager::callAsync([this]()
+		if (track->waitingForMidiToLoad.load() && !track->correctMidiNoteReceived.load() && hostIsPlaying && track->isPlaying.load())
 		{
-			if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
-				editor->statusLabel.setText("Loading sample...", juce::dontSendNotification);
-			} });
+			stillPending = true;
+			continue;
+		}
+		if (!loadRequested && !autoLoadEnabled.load() && !track->pendingLoadsImmediately.load())
+		{
+			waitingForLoad = true;
+			stillPending = true;
+			continue;
+		}
+
+		const juce::SpinLock::ScopedTryLockType lock(track->pendingAudioLock);
+		if (!lock.isLocked())
+		{
+			stillPending = true;
+			continue;
+		}
+
+		uiUpdates.raise(UIUpdateFlags::loadingSample);
+		submitStretchJob(track->trackId, [this, trackId = track->trackId, audioFile = track->pendingAudioFile,
+			decodedAudio = track->pendingDecodedAudio](StretchJobPool::JobContext& job)
+			{
+				if (decodedAudio != nullptr)
+					loadDecodedAudioAsync(trackId, decodedAudio, &job);
+				else
+					loadAudioFileAsync(trackId, audioFile, &job);
+			});
 
-			juce::Thread::launch([this, trackId = pendingTrackId, audioFile = pendingAudioFile]()
-				{ loadAudioFileAsync(trackId, audioFile); });
+		track->pendingAudioConsumed = true;
+		track->hasPendingAudio = false;
+		track->waitingForMidiToLoad = false;
+		track->correctMidiNoteReceived = false;
+		track->pendingLoadsImmediately = false;
+		loadedAny = true;
+	}
 
-			clearPendingAudio();
-			hasUnloadedSample = false;
-			waitingForMidiToLoad = false;
-			correctMidiNoteReceived = false;
-			canLoad = false;
-			trackIdWaitingForLoad.clear();
+	hasUnloadedSample = waitingForLoad;
+	if (loadedAny && !stillPending)
+		canLoad = false;
+	if (stillPending)
+		hasPendingAudioData = true;
 }
 
 void DjIaVstProcessor::checkAndSwapStagingBuffers()
 {
-	auto trackIds = trackManager.getAllTrackIds();
-
-	for (const auto& trackId : trackIds)
+	for (auto* track : trackManager.getAudioThreadTracks())
 	{
-		TrackData* track = trackManager.getTrack(trackId);
 		if (!track)
 			continue;
 		if (track->swapRequested.exchange(false))
 		{
 			if (track->hasStagingData.load())
 			{
-				performAtomicSwap(track, trackId);
+				performAtomicSwap(track, track->trackId);
 			}
 		}
 	}
@@ -1908,6 +2566,8 @@ void DjIaVstProcessor::performAtomicSwap(TrackData* track, const juce::String& t
 		auto& currentPage = track->getCurrentPage();
 		bool preservedHasOriginal = currentPage.hasOriginalVersion.load();
 		std::swap(currentPage.audioBuffer, track->stagingBuffer);
+		retireBuffer(track->stagingBuffer);
+		currentPage.mappedAudioView = nullptr;
 		currentPage.numSamples = track->stagingNumSamples.load();
 		currentPage.sampleRate = track->stagingSampleRate.load();
 		currentPage.originalBpm = track->stagingOriginalBpm;
@@ -1938,7 +2598,8 @@ void DjIaVstProcessor::performAtomicSwap(TrackData* track, const juce::String& t
 				currentPage.loopEnd = std::min(fourBars, sampleDuration);
 			}
 		}
-		track->syncLegacyProperties();
+		track->syncLegacyPlaybackProperties();
+		track->legacySyncPending = true;
 	}
 	else {
 		std::swap(track->audioBuffer, track->stagingBuffer);
@@ -1977,11 +2638,53 @@ void DjIaVstProcessor::performAtomicSwap(TrackData* track, const juce::String& t
 
 		track->readPosition = 0.0;
 		track->hasStagingData = false;
-		track->stagingBuffer.setSize(0, 0);
+		retireBuffer(track->stagingBuffer);
 	}
 
-	juce::MessageManager::callAsync([this, trackId]()
-		{ updateWaveformDisplay(trackId); });
+	uiUpdates.markWaveformDirty(track->slotIndex);
+}
+
+void DjIaVstProcessor::retireBuffer(juce::AudioBuffer<float>& buffer) noexcept
+{
+	// With the ring full (timer stalled) the buffer simply stays in the staging
+	// slot, where the next load overwrites it on a worker thread.
+	if (!retiredBuffers.retire(buffer))
+		DBG("Retired buffer queue full, keeping buffer in staging");
+}
+
+/*
+	The stretch job holds its own reference to a picked-up loop; dropping the
+	track's one here, on the message thread, lets the buffer go as soon as the
+	job is done with it instead of living until the next generation.
+*/
+void DjIaVstProcessor::releaseConsumedPendingAudio()
+{
+	for (const auto& trackId : trackManager.getAllTrackIds())
+	{
+		TrackData* track = trackManager.getTrack(trackId);
+		if (!track)
+			continue;
+
+		std::shared_ptr<DjIaClient::DecodedAudio> consumed;
+		{
+			const juce::SpinLock::ScopedLockType lock(track->pendingAudioLock);
+			if (!track->pendingAudioConsumed)
+				continue;
+			std::swap(consumed, track->pendingDecodedAudio);
+			track->pendingAudioFile = juce::File();
+			track->pendingAudioConsumed = false;
+		}
+	}
+}
+
+void DjIaVstProcessor::syncSwappedTracks()
+{
+	for (const auto& trackId : trackManager.getAllTrackIds())
+	{
+		TrackData* track = trackManager.getTrack(trackId);
+		if (track && track->legacySyncPending.exchange(false))
+			track->syncLegacyProperties();
+	}
 }
 
 void DjIaVstProcessor::updateWaveformDisplay(const juce::String& trackId)
@@ -2002,7 +2705,14 @@ void DjIaVstProcessor::updateWaveformDisplay(const juce::String& trackId)
 	}
 }
 
-void DjIaVstProcessor::loadAudioFileAsync(const juce::String& trackId, const juce::File& audioFile)
+void DjIaVstProcessor::submitStretchJob(const juce::String& trackId, StretchJobPool::JobFunction job)
+{
+	int priority = (trackId == selectedTrackId) ? 1 : 0;
+	stretchJobPool.submit(trackId, priority, std::move(job));
+}
+
+void DjIaVstProcessor::loadAudioFileAsync(const juce::String& trackId, const juce::File& audioFile, StretchJobPool::JobContext* job,
+	bool fromSampleBank)
 {
 	TrackData* track = trackManager.getTrack(trackId);
 	if (!track)
@@ -2012,19 +2722,31 @@ void DjIaVstProcessor::loadAudioFileAsync(const juce::String& trackId, const juc
 
 	try
 	{
-		juce::AudioFormatManager formatManager;
-		formatManager.registerBasicFormats();
+		if (fromSampleBank)
+		{
+			if (!loadSharedSampleToStagingBuffer(audioFile, track))
+				return;
+		}
+		else
+		{
+			juce::AudioFormatManager formatManager;
+			formatManager.registerBasicFormats();
 
-		std::unique_ptr<juce::AudioFormatReader> reader(
-			formatManager.createReaderFor(audioFile));
+			std::unique_ptr<juce::AudioFormatReader> reader(
+				formatManager.createReaderFor(audioFile));
 
-		if (!reader)
+			if (!reader)
+			{
+				return;
+			}
+
+			loadAudioToStagingBuffer(reader, track);
+		}
+		if (!processAudioBPMAndSync(track, job))
 		{
+			DBG("Stretch cancelled for track: " << trackId);
 			return;
 		}
-
-		loadAudioToStagingBuffer(reader, track);
-		processAudioBPMAndSync(track);
 		juce::File permanentFile;
 		if (track->usePages.load()) {
 			permanentFile = getTrackPageAudioFile(trackId, track->currentPageIndex);
@@ -2038,6 +2760,7 @@ void DjIaVstProcessor::loadAudioFileAsync(const juce::String& trackId, const juc
 		if (track->nextHasOriginalVersion.load())
 		{
 			saveOriginalAndStretchedBuffers(track->originalStagingBuffer, track->stagingBuffer, trackId, track->stagingSampleRate);
+			track->originalStagingBuffer.setSize(0, 0);
 			DBG("Both files saved for track: " << trackId);
 		}
 		else
@@ -2074,6 +2797,85 @@ void DjIaVstProcessor::loadAudioFileAsync(const juce::String& trackId, const juc
 	}
 }
 
+void DjIaVstProcessor::loadDecodedAudioAsync(const juce::String& trackId, std::shared_ptr<DjIaClient::DecodedAudio> audio, StretchJobPool::JobContext* job)
+{
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!track || audio == nullptr)
+	{
+		return;
+	}
+
+	std::swap(track->stagingBuffer, audio->buffer);
+	track->stagingNumSamples = track->stagingBuffer.getNumSamples();
+	track->stagingSampleRate = audio->sampleRate;
+	if (!processAudioBPMAndSync(track, job, audio->detectedBpm))
+	{
+		DBG("Stretch cancelled for track: " << trackId);
+		return;
+	}
+
+	if (audio->isPreview)
+	{
+		// Played from memory until the complete loop replaces it; nothing is saved.
+		track->originalStagingBuffer.setSize(0, 0);
+		track->nextHasOriginalVersion = false;
+		track->hasStagingData = true;
+		track->swapRequested = true;
+		juce::MessageManager::callAsync([this]()
+			{
+				if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor()))
+					editor->statusLabel.setText("First bar loaded, receiving the rest...", juce::dontSendNotification);
+			});
+		return;
+	}
+
+	juce::File permanentFile = track->usePages.load()
+		? getTrackPageAudioFile(trackId, track->currentPageIndex)
+		: getTrackAudioFile(trackId);
+	permanentFile.getParentDirectory().createDirectory();
+
+	// The loop becomes playable from memory right away; writing the cache
+	// file and registering it in the bank runs afterwards on its own job.
+	const bool hasOriginal = track->nextHasOriginalVersion.load();
+	const double sampleRate = track->stagingSampleRate.load();
+	auto stretched = std::make_shared<juce::AudioBuffer<float>>(track->stagingBuffer);
+	auto original = std::make_shared<juce::AudioBuffer<float>>();
+	if (hasOriginal)
+	{
+		std::swap(*original, track->originalStagingBuffer);
+	}
+
+	if (track->usePages.load()) {
+		track->getCurrentPage().audioFilePath = permanentFile.getFullPathName();
+	}
+	else {
+		track->audioFilePath = permanentFile.getFullPathName();
+	}
+	track->hasStagingData = true;
+	track->swapRequested = true;
+
+	stretchJobPool.submit(trackId + "_persist", 0,
+		[this, trackId, permanentFile, stretched, original, hasOriginal, sampleRate](StretchJobPool::JobContext&)
+		{
+			if (hasOriginal)
+				saveOriginalAndStretchedBuffers(*original, *stretched, trackId, sampleRate);
+			else
+				saveBufferToFile(*stretched, permanentFile, sampleRate);
+			DBG("Streamed loop persisted for track: " << trackId);
+		});
+
+	juce::MessageManager::callAsync([this]()
+		{
+			if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
+				editor->statusLabel.setText("Sample loaded! Ready to play.", juce::dontSendNotification);
+				juce::Timer::callAfterDelay(2000, [this]() {
+					if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor())) {
+						editor->statusLabel.setText("Ready", juce::dontSendNotification);
+					}
+					});
+			} });
+}
+
 void DjIaVstProcessor::reloadTrackWithVersion(const juce::String& trackId, bool useOriginal)
 {
 	TrackData* track = trackManager.getTrack(trackId);
@@ -2133,20 +2935,23 @@ void DjIaVstProcessor::reloadTrackWithVersion(const juce::String& trackId, bool
 		if (!fileToLoad.existsAsFile()) return;
 	}
 
+	// Keyed by track like every other staging writer, so a version switch
+	// never fills stagingBuffer while a stretch job is writing it.
 	if (track->usePages.load()) {
 		int currentPageIndex = track->currentPageIndex;
-		juce::Thread::launch([this, trackId, currentPageIndex, fileToLoad]() {
-			loadAudioFileForPageSwitch(trackId, currentPageIndex, fileToLoad);
+		submitStretchJob(trackId, [this, trackId, currentPageIndex, fileToLoad](StretchJobPool::JobContext& job) {
+			loadAudioFileForPageSwitch(trackId, currentPageIndex, fileToLoad, &job);
 			});
 	}
 	else {
-		juce::Thread::launch([this, trackId, fileToLoad]() {
-			loadAudioFileForSwitch(trackId, fileToLoad);
+		submitStretchJob(trackId, [this, trackId, fileToLoad](StretchJobPool::JobContext& job) {
+			loadAudioFileForSwitch(trackId, fileToLoad, &job);
 			});
 	}
 }
 
-void DjIaVstProcessor::loadAudioFileForPageSwitch(const juce::String& trackId, int pageIndex, const juce::File& audioFile)
+void DjIaVstProcessor::loadAudioFileForPageSwitch(const juce::String& trackId, int pageIndex, const juce::File& audioFile,
+	StretchJobPool::JobContext* job)
 {
 	TrackData* track = trackManager.getTrack(trackId);
 	if (!track || pageIndex < 0 || pageIndex >= 4) return;
@@ -2174,6 +2979,8 @@ void DjIaVstProcessor::loadAudioFileForPageSwitch(const juce::String& trackId, i
 
 		track->stagingNumSamples = numSamples;
 		track->stagingSampleRate = reader->sampleRate;
+		if (job != nullptr && job->isCancelled())
+			return;
 
 		track->isVersionSwitch = true;
 		track->preservedLoopStart = preservedLoopStart;
@@ -2185,7 +2992,17 @@ void DjIaVstProcessor::loadAudioFileForPageSwitch(const juce::String& trackId, i
 			track->swapRequested = true;
 		}
 		else {
-			page.audioBuffer.makeCopyOf(track->stagingBuffer);
+			auto mapped = trackManager.getMemoryMappedPages()
+				? TrackManager::createMappedAudio(track->stagingBuffer, numSamples, reader->sampleRate)
+				: nullptr;
+			if (mapped) {
+				page.setMappedAudio(std::move(mapped));
+				page.audioBuffer.setSize(0, 0);
+			}
+			else {
+				page.setMappedAudio(nullptr);
+				page.audioBuffer.makeCopyOf(track->stagingBuffer);
+			}
 			page.numSamples = numSamples;
 			page.sampleRate = reader->sampleRate;
 			page.isLoaded = true;
@@ -2203,7 +3020,8 @@ void DjIaVstProcessor::loadAudioFileForPageSwitch(const juce::String& trackId, i
 	}
 }
 
-void DjIaVstProcessor::loadAudioFileForSwitch(const juce::String& trackId, const juce::File& audioFile)
+void DjIaVstProcessor::loadAudioFileForSwitch(const juce::String& trackId, const juce::File& audioFile,
+	StretchJobPool::JobContext* job)
 {
 	TrackData* track = trackManager.getTrack(trackId);
 	if (!track)
@@ -2223,6 +3041,8 @@ void DjIaVstProcessor::loadAudioFileForSwitch(const juce::String& trackId, const
 		if (!reader)
 			return;
 		loadAudioToStagingBuffer(reader, track);
+		if (job != nullptr && job->isCancelled())
+			return;
 		track->isVersionSwitch = true;
 		track->preservedLoopStart = preservedLoopStart;
 		track->preservedLoopEnd = preservedLoopEnd;
@@ -2374,10 +3194,32 @@ juce::File DjIaVstProcessor::getTrackAudioFile(const juce::String& trackId)
 	return audioDir.getChildFile(trackId + ".wav");
 }
 
-void DjIaVstProcessor::processAudioBPMAndSync(TrackData* track)
+bool DjIaVstProcessor::processAudioBPMAndSync(TrackData* track, StretchJobPool::JobContext* job, float knownBpm)
 {
 	track->nextHasOriginalVersion.store(false);
-	float detectedBPM = AudioAnalyzer::detectBPM(track->stagingBuffer, track->stagingSampleRate);
+	const int stagingSamples = track->stagingNumSamples.load();
+	const juce::String cacheKey = AnalysisCache::computeContentKey(track->stagingBuffer, stagingSamples, track->stagingSampleRate);
+
+	float detectedBPM = 0.0f;
+	AnalysisCache::Analysis cachedAnalysis;
+	if (sharedResources->analysis.lookupAnalysis(cacheKey, cachedAnalysis))
+	{
+		detectedBPM = cachedAnalysis.bpm;
+		DBG("Analysis cache hit: " << cacheKey << " (" << detectedBPM << " BPM)");
+	}
+	else if (knownBpm > 0.0f)
+	{
+		detectedBPM = knownBpm;
+		DBG("Using BPM detected while streaming: " << detectedBPM);
+	}
+	else
+	{
+		auto analysis = AudioAnalyzer::analyzeBPM(track->stagingBuffer, track->stagingSampleRate);
+		detectedBPM = analysis.bpm;
+		sharedResources->analysis.storeAnalysis(cacheKey, analysis, track->stagingBuffer, stagingSamples, track->stagingSampleRate);
+	}
+	if (job != nullptr && job->isCancelled())
+		return false;
 
 	double hostBpm = cachedHostBpm.load();
 
@@ -2393,89 +3235,322 @@ void DjIaVstProcessor::processAudioBPMAndSync(TrackData* track)
 		if (detectedBPM >= (expectedDoubleTempo - tolerance) &&
 			detectedBPM <= (expectedDoubleTempo + tolerance))
 		{
-			isDoubleTempo = true;
+			isDoubleTempo = true;
+		}
+		if (detectedBPM >= (expectedHalfTempo - tolerance) &&
+			detectedBPM <= (expectedHalfTempo + tolerance))
+		{
+			isHalfTempo = true;
+		}
+	}
+
+	bool isTempoBypass = isDoubleTempo || isHalfTempo;
+	bool bpmValid = (detectedBPM > 60.0f && detectedBPM < 200.0f) && !isTempoBypass;
+
+	if (isTempoBypass)
+	{
+		track->stagingOriginalBpm = track->bpm;
+	}
+	else
+	{
+		track->stagingOriginalBpm = bpmValid ? detectedBPM : track->bpm;
+	}
+
+	double bpmDifference = std::abs(hostBpm - track->stagingOriginalBpm);
+	bool hostBpmValid = (hostBpm > 0.0);
+	bool originalBpmValid = (track->stagingOriginalBpm > 0.0f);
+	bool bpmDifferenceSignificant = (bpmDifference > 1.0);
+
+	if (hostBpmValid && originalBpmValid && bpmDifferenceSignificant && !isTempoBypass && !track->streamingStretch.load())
+	{
+		track->originalStagingBuffer.makeCopyOf(track->stagingBuffer);
+		double stretchRatio = hostBpm / static_cast<double>(track->stagingOriginalBpm);
+		if (!sharedResources->analysis.loadStretchedVariant(cacheKey, stretchRatio, track->stagingSampleRate, track->stagingBuffer))
+		{
+			bool completed = AudioAnalyzer::timeStretchBuffer(track->stagingBuffer, stretchRatio, track->stagingSampleRate,
+				[job]() { return job != nullptr && job->isCancelled(); },
+				[job](float progress) { if (job) job->setProgress(progress); });
+			if (!completed)
+			{
+				track->nextHasOriginalVersion.store(false);
+				return false;
+			}
+			sharedResources->analysis.storeStretchedVariant(cacheKey, stretchRatio, track->stagingSampleRate, track->stagingBuffer);
+		}
+		track->stagingNumSamples.store(track->stagingBuffer.getNumSamples());
+		track->stagingOriginalBpm = static_cast<float>(hostBpm);
+		track->nextHasOriginalVersion.store(true);
+	}
+	else
+	{
+		track->stagingNumSamples.store(track->stagingBuffer.getNumSamples());
+		track->nextHasOriginalVersion.store(false);
+	}
+	return true;
+}
+
+void DjIaVstProcessor::loadAudioToStagingBuffer(std::unique_ptr<juce::AudioFormatReader>& reader, TrackData* track)
+{
+	int numChannels = reader->numChannels;
+	int numSamples = static_cast<int>(reader->lengthInSamples);
+	double sampleRate = reader->sampleRate;
+
+	track->stagingBuffer.setSize(2, numSamples, false, false, true);
+	track->stagingBuffer.clear();
+
+	reader->read(&track->stagingBuffer, 0, numSamples, 0, true, true);
+
+	if (numChannels == 1)
+	{
+		track->stagingBuffer.copyFrom(1, 0, track->stagingBuffer, 0, 0, numSamples);
+	}
+
+	track->stagingNumSamples = numSamples;
+	track->stagingSampleRate = sampleRate;
+}
+
+/*
+	Instances loading the same bank file at about the same time (a project
+	reopening, a kit loaded into several instances) share one decode. The
+	track still gets its own staging copy, since it is stretched to this
+	instance's tempo; the shared decode is dropped shortly after its last use.
+*/
+bool DjIaVstProcessor::loadSharedSampleToStagingBuffer(const juce::File& sampleFile, TrackData* track)
+{
+	auto sample = sharedResources->decodedSamples.getOrDecode(sampleFile);
+	if (!sample)
+		return false;
+
+	const int numSamples = sample->audio.getNumSamples();
+	track->stagingBuffer.setSize(2, numSamples, false, false, true);
+	for (int channel = 0; channel < 2; ++channel)
+		track->stagingBuffer.copyFrom(channel, 0, sample->audio, channel, 0, numSamples);
+
+	track->stagingNumSamples = numSamples;
+	track->stagingSampleRate = sample->sampleRate;
+	return true;
+}
+
+void DjIaVstProcessor::loadPendingSample()
+{
+	if (!hasUnloadedSample.load())
+		return;
+
+	for (const auto& trackId : trackManager.getAllTrackIds())
+	{
+		if (TrackData* track = trackManager.getTrack(trackId))
+		{
+			if (track->hasPendingAudio.load())
+				track->waitingForMidiToLoad = true;
+		}
+	}
+	canLoad = true;
+}
+
+void DjIaVstProcessor::setAutoLoadEnabled(bool enabled)
+{
+	autoLoadEnabled = enabled;
+}
+
+void DjIaVstProcessor::setMemoryMappedPages(bool enabled)
+{
+	trackManager.setMemoryMappedPages(enabled);
+	if (!enabled)
+		return;
+
+	for (const auto& trackId : trackManager.getAllTrackIds())
+	{
+		updatePagePrefetch(trackId);
+	}
+}
+
+bool DjIaVstProcessor::queuePageSwitch(const juce::String& trackId, int pageIndex)
+{
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!track || pageIndex < 0 || pageIndex >= 4)
+		return false;
+	if (getBypassSequencer() || !cachedHostIsPlaying.load() || !track->isPlaying.load())
+		return false;
+	// A page that still has to load switches immediately instead, so the
+	// bar line never lands on silence.
+	if (pageIndex == track->currentPageIndex.load() || !track->pages[pageIndex].isReadyToPlay())
+		return false;
+
+	track->pendingPageIndex = pageIndex;
+	return true;
+}
+
+void DjIaVstProcessor::applyPendingPageSwitch(TrackData* track)
+{
+	// The message thread is releasing a page; keep the switch queued.
+	const juce::SpinLock::ScopedTryLockType lock(track->pageSwitchLock);
+	if (!lock.isLocked())
+		return;
+
+	const int pageIndex = track->pendingPageIndex.exchange(-1);
+	if (pageIndex < 0 || pageIndex >= 4 || pageIndex == track->currentPageIndex.load())
+		return;
+	if (!track->pages[pageIndex].hasAudioData())
+		return;
+
+	// The previous page is no longer read, so its mapped source may go.
+	track->getCurrentPage().releaseMappedAudio();
+	track->currentPageIndex = pageIndex;
+	track->pageSwitchApplied = true;
+}
+
+void DjIaVstProcessor::finishAppliedPageSwitches()
+{
+	for (const auto& trackId : trackManager.getAllTrackIds())
+	{
+		TrackData* track = trackManager.getTrack(trackId);
+		if (!track || !track->pageSwitchApplied.exchange(false))
+			continue;
+
+		track->syncLegacyProperties();
+		updatePagePrefetch(trackId);
+
+		if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor()))
+		{
+			for (auto& trackComp : editor->getTrackComponents())
+			{
+				if (trackComp->getTrackId() == trackId)
+				{
+					trackComp->onPageSwitched(track->currentPageIndex, track->readPosition.load());
+					break;
+				}
+			}
+		}
+	}
+}
+
+void DjIaVstProcessor::updatePagePrefetch(const juce::String& trackId)
+{
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!track || !track->usePages.load())
+		return;
+
+	const int currentPageIndex = track->currentPageIndex;
+	for (int pageIndex = 0; pageIndex < 4; ++pageIndex)
+	{
+		if (pageIndex == currentPageIndex)
+			continue;
+
+		if (std::abs(pageIndex - currentPageIndex) != 1)
+		{
+			releaseInactivePageAudio(trackId, pageIndex);
+			continue;
 		}
-		if (detectedBPM >= (expectedHalfTempo - tolerance) &&
-			detectedBPM <= (expectedHalfTempo + tolerance))
+
+		auto& page = track->pages[pageIndex];
+		if (page.getMappedAudio() != nullptr && page.audioBuffer.getNumSamples() == 0)
 		{
-			isHalfTempo = true;
+			prefaultPageLoop(trackId, page);
+			continue;
 		}
-	}
-
-	bool isTempoBypass = isDoubleTempo || isHalfTempo;
-	bool bpmValid = (detectedBPM > 60.0f && detectedBPM < 200.0f) && !isTempoBypass;
+		if (page.isLoaded.load() || page.isLoading.load() || page.audioFilePath.isEmpty())
+			continue;
 
-	if (isTempoBypass)
-	{
-		track->stagingOriginalBpm = track->bpm;
-	}
-	else
-	{
-		track->stagingOriginalBpm = bpmValid ? detectedBPM : track->bpm;
-	}
+		juce::File audioFile(page.audioFilePath);
+		if (!audioFile.existsAsFile())
+			continue;
 
-	double bpmDifference = std::abs(hostBpm - track->stagingOriginalBpm);
-	bool hostBpmValid = (hostBpm > 0.0);
-	bool originalBpmValid = (track->stagingOriginalBpm > 0.0f);
-	bool bpmDifferenceSignificant = (bpmDifference > 1.0);
+		page.isLoading = true;
+		stretchJobPool.submit(trackId + "_prefetch" + juce::String(pageIndex), 0,
+			[this, trackId, pageIndex, audioFile](StretchJobPool::JobContext&)
+			{
+				TrackData* track = trackManager.getTrack(trackId);
+				if (!track)
+					return;
 
-	if (hostBpmValid && originalBpmValid && bpmDifferenceSignificant && !isTempoBypass)
-	{
-		track->originalStagingBuffer.makeCopyOf(track->stagingBuffer);
-		double stretchRatio = hostBpm / static_cast<double>(track->stagingOriginalBpm);
-		AudioAnalyzer::timeStretchBuffer(track->stagingBuffer, stretchRatio, track->stagingSampleRate);
-		track->stagingNumSamples.store(track->stagingBuffer.getNumSamples());
-		track->stagingOriginalBpm = static_cast<float>(hostBpm);
-		track->nextHasOriginalVersion.store(true);
-	}
-	else
-	{
-		track->stagingNumSamples.store(track->stagingBuffer.getNumSamples());
-		track->nextHasOriginalVersion.store(false);
+				trackManager.loadAudioFileForPage(track, pageIndex, audioFile);
+				track->pages[pageIndex].isLoading = false;
+				DBG("Prefetched page " << (char)('A' + pageIndex) << " for track " << trackId);
+				uiUpdates.raise(UIUpdateFlags::general);
+			});
 	}
 }
 
-void DjIaVstProcessor::loadAudioToStagingBuffer(std::unique_ptr<juce::AudioFormatReader>& reader, TrackData* track)
+void DjIaVstProcessor::releaseInactivePageAudio(const juce::String& trackId, int pageIndex)
 {
-	int numChannels = reader->numChannels;
-	int numSamples = static_cast<int>(reader->lengthInSamples);
-	double sampleRate = reader->sampleRate;
+	TrackData* track = trackManager.getTrack(trackId);
+	if (!trackManager.getMemoryMappedPages() || !track || pageIndex < 0 || pageIndex >= 4)
+		return;
 
-	track->stagingBuffer.setSize(2, numSamples, false, false, true);
-	track->stagingBuffer.clear();
+	const auto& page = track->pages[pageIndex];
+	if (page.audioBuffer.getNumSamples() == 0 || page.isLoading.load())
+		return;
 
-	reader->read(&track->stagingBuffer, 0, numSamples, 0, true, true);
+	stretchJobPool.submit(trackId + "_map" + juce::String(pageIndex), 0,
+		[this, trackId, pageIndex](StretchJobPool::JobContext& job)
+		{
+			TrackData* track = trackManager.getTrack(trackId);
+			if (!track)
+				return;
 
-	if (numChannels == 1)
-	{
-		track->stagingBuffer.copyFrom(1, 0, track->stagingBuffer, 0, 0, numSamples);
-	}
+			const auto& page = track->pages[pageIndex];
+			const int numSamples = page.numSamples;
+			auto source = TrackManager::createMappedAudio(page.audioBuffer, numSamples, page.sampleRate);
+			if (!source || job.isCancelled())
+				return;
 
-	track->stagingNumSamples = numSamples;
-	track->stagingSampleRate = sampleRate;
+			juce::MessageManager::callAsync([this, trackId, pageIndex, numSamples, source]()
+				{
+					TrackData* track = trackManager.getTrack(trackId);
+					if (!track)
+						return;
+
+					// Checked again under the switch lock: the audio thread may
+					// have made this page current since the job was submitted.
+					// The buffer is freed once the lock is released.
+					juce::AudioBuffer<float> released;
+					{
+						const juce::SpinLock::ScopedLockType lock(track->pageSwitchLock);
+						if (track->currentPageIndex.load() == pageIndex || track->pendingPageIndex.load() == pageIndex)
+							return;
+
+						auto& page = track->pages[pageIndex];
+						if (page.numSamples != numSamples || page.audioBuffer.getNumSamples() == 0)
+							return;
+
+						page.setMappedAudio(source);
+						released = std::move(page.audioBuffer);
+					}
+					DBG("Page " << (char)('A' + pageIndex) << " of track " << trackId << " released to mapped cache");
+				});
+		});
 }
 
-void DjIaVstProcessor::loadPendingSample()
+void DjIaVstProcessor::prefaultMappedPages()
 {
-	if (hasUnloadedSample.load() && !pendingTrackId.isEmpty())
+	for (const auto& trackId : trackManager.getAllTrackIds())
 	{
-		waitingForMidiToLoad = true;
-		canLoad = true;
-		trackIdWaitingForLoad = pendingTrackId;
+		TrackData* track = trackManager.getTrack(trackId);
+		if (!track || !track->usePages.load())
+			continue;
+
+		prefaultPageLoop(trackId, track->getCurrentPage());
 	}
 }
 
-void DjIaVstProcessor::clearPendingAudio()
+void DjIaVstProcessor::prefaultPageLoop(const juce::String& trackId, TrackPage& page)
 {
-	const juce::ScopedLock lock(apiLock);
-	pendingAudioFile = juce::File();
-	pendingTrackId.clear();
-	hasPendingAudioData = false;
-}
+	if (page.getMappedAudio() == nullptr || !page.mappedAudio)
+		return;
+	if (page.prefaultedLoopStart == page.loopStart && page.prefaultedLoopEnd == page.loopEnd)
+		return;
 
-void DjIaVstProcessor::setAutoLoadEnabled(bool enabled)
-{
-	autoLoadEnabled = enabled;
+	page.prefaultedLoopStart = page.loopStart;
+	page.prefaultedLoopEnd = page.loopEnd;
+
+	auto source = page.mappedAudio;
+	const int startSample = static_cast<int>(page.loopStart * page.sampleRate);
+	const int numSamples = static_cast<int>((page.loopEnd - page.loopStart) * page.sampleRate) + 1;
+	stretchJobPool.submit(trackId + "_prefault" + source->getKey(), 0,
+		[source, startSample, numSamples](StretchJobPool::JobContext&)
+		{
+			source->prefault(startSample, numSamples);
+		});
 }
 
 void DjIaVstProcessor::setApiKey(const juce::String& key)
@@ -2540,9 +3615,9 @@ void DjIaVstProcessor::clearCustomPrompts()
 	customPrompts.clear();
 }
 
-void DjIaVstProcessor::getStateInformation(juce::MemoryBlock& destData)
+juce::ValueTree DjIaVstProcessor::createSettingsState()
 {
-	juce::ValueTree state("DjIaVstState");
+	juce::ValueTree state("Settings");
 
 	state.setProperty("projectId", projectId, nullptr);
 	state.setProperty("lastPrompt", juce::var(lastPrompt), nullptr);
@@ -2559,11 +3634,25 @@ void DjIaVstProcessor::getStateInformation(juce::MemoryBlock& destData)
 	state.setProperty("guitarEnabled", juce::var(guitarEnabled), nullptr);
 	state.setProperty("pianoEnabled", juce::var(pianoEnabled), nullptr);
 	state.setProperty("lastKeyIndex", juce::var(lastKeyIndex), nullptr);
-	state.setProperty("isGenerating", juce::var(isGenerating), nullptr);
 	state.setProperty("autoLoadEnabled", juce::var(autoLoadEnabled.load()), nullptr);
-	state.setProperty("generatingTrackId", juce::var(generatingTrackId), nullptr);
+	state.setProperty("memoryMappedPages", juce::var(trackManager.getMemoryMappedPages()), nullptr);
+	state.setProperty("renderThreads", juce::var(trackManager.getRenderThreads()), nullptr);
+	state.setProperty("streamGeneratedAudio", juce::var(streamGeneratedAudio.load()), nullptr);
+	state.setProperty("directBusRendering", juce::var(directBusRendering.load()), nullptr);
+	state.setProperty("groupExtraSlotsOnBuses", juce::var(groupExtraSlotsOnBuses.load()), nullptr);
+	state.setProperty("speculativeGeneration", juce::var(speculativeGeneration.load()), nullptr);
+	state.setProperty("speculativeBudget", juce::var(speculativeBudget.load()), nullptr);
+	state.setProperty("localGenerationThreads", juce::var(localGenerationThreads.load()), nullptr);
+	state.setProperty("progressiveGeneration", juce::var(progressiveGeneration.load()), nullptr);
+	state.setProperty("compressedTransfer", juce::var(apiClient.getPreferCompressedAudio()), nullptr);
+	state.setProperty("maxConcurrentGenerations", juce::var(getMaxConcurrentGenerations()), nullptr);
+	state.setProperty("maxConcurrentLocalGenerations", juce::var(getMaxConcurrentLocalGenerations()), nullptr);
 	state.setProperty("bypassSequencer", juce::var(getBypassSequencer()), nullptr);
+	return state;
+}
 
+juce::ValueTree DjIaVstProcessor::createMidiMappingsState()
+{
 	juce::ValueTree midiMappingsState("MidiMappings");
 	auto mappings = midiLearnManager.getAllMappings();
 	for (int i = 0; i < mappings.size(); ++i)
@@ -2577,11 +3666,11 @@ void DjIaVstProcessor::getStateInformation(juce::MemoryBlock& destData)
 		mappingState.setProperty("description", mapping.description, nullptr);
 		midiMappingsState.appendChild(mappingState, nullptr);
 	}
-	state.appendChild(midiMappingsState, nullptr);
-
-	auto tracksState = trackManager.saveState();
-	state.appendChild(tracksState, nullptr);
+	return midiMappingsState;
+}
 
+juce::ValueTree DjIaVstProcessor::createParametersState()
+{
 	juce::ValueTree parametersState("Parameters");
 
 	auto& params = getParameterTreeState();
@@ -2601,8 +3690,11 @@ void DjIaVstProcessor::getStateInformation(juce::MemoryBlock& destData)
 			parametersState.setProperty(paramId, param->getValue(), nullptr);
 		}
 	}
-	state.appendChild(parametersState, nullptr);
+	return parametersState;
+}
 
+juce::ValueTree DjIaVstProcessor::createGlobalGenerationState()
+{
 	auto globalGenState = juce::ValueTree("GlobalGeneration");
 	globalGenState.setProperty("prompt", globalPrompt, nullptr);
 	globalGenState.setProperty("bpm", globalBpm, nullptr);
@@ -2616,21 +3708,118 @@ void DjIaVstProcessor::getStateInformation(juce::MemoryBlock& destData)
 		stemsString += globalStems[i];
 	}
 	globalGenState.setProperty("stems", stemsString, nullptr);
-	state.appendChild(globalGenState, nullptr);
+	return globalGenState;
+}
+
+juce::StringArray DjIaVstProcessor::encodeStateSections()
+{
+	// Caller holds stateCodecLock. One section per track so editing one track
+	// only re-encodes that track.
+	juce::StringArray sectionNames;
+	auto encode = [this, &sectionNames](const juce::String& name, const juce::ValueTree& tree)
+		{
+			stateCodec.encodeSection(name, tree);
+			sectionNames.add(name);
+		};
+
+	encode("Settings", createSettingsState());
+	encode("MidiMappings", createMidiMappingsState());
+	auto tracksState = trackManager.saveState();
+	for (int i = 0; i < tracksState.getNumChildren(); ++i)
+	{
+		auto trackState = tracksState.getChild(i);
+		encode("Track:" + trackState.getProperty("id").toString(), trackState);
+	}
+	encode("Parameters", createParametersState());
+	encode("GlobalGeneration", createGlobalGenerationState());
+	return sectionNames;
+}
 
-	std::unique_ptr<juce::XmlElement> xml(state.createXml());
-	copyXmlToBinary(*xml, destData);
+void DjIaVstProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+	juce::ScopedLock lock(stateCodecLock);
+	stateCodec.writeState(destData, encodeStateSections());
 }
 
 void DjIaVstProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+	if (PluginStateCodec::isBinaryState(data, sizeInBytes))
+	{
+		std::vector<PluginStateCodec::Section> sections;
+		if (PluginStateCodec::readState(data, sizeInBytes, sections))
+		{
+			applyState(composeBinaryState(sections));
+		}
+		return;
+	}
+
 	std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
 	if (!xml || !xml->hasTagName("DjIaVstState"))
 	{
 		return;
 	}
-	juce::ValueTree state = juce::ValueTree::fromXml(*xml);
+	applyState(juce::ValueTree::fromXml(*xml));
+}
+
+juce::ValueTree DjIaVstProcessor::composeBinaryState(const std::vector<PluginStateCodec::Section>& sections)
+{
+	// Sections matching what the plugin would save right now are left out, so
+	// applyState keeps the live mappings, parameters and tracks (and their
+	// loaded audio) instead of rebuilding them. Settings are always applied.
+	juce::ScopedLock lock(stateCodecLock);
+	const auto currentSections = encodeStateSections();
+	auto isUnchanged = [this](const PluginStateCodec::Section& section)
+		{
+			auto* current = stateCodec.getSection(section.name);
+			return current != nullptr && current->hash == section.hash;
+		};
+
+	int numTrackSections = 0;
+	bool tracksChanged = false;
+	for (const auto& section : sections)
+	{
+		if (section.name.startsWith("Track:"))
+		{
+			++numTrackSections;
+			tracksChanged = tracksChanged || !isUnchanged(section);
+		}
+	}
+	int numCurrentTracks = 0;
+	for (const auto& name : currentSections)
+	{
+		if (name.startsWith("Track:"))
+			++numCurrentTracks;
+	}
+	tracksChanged = tracksChanged || numTrackSections != numCurrentTracks;
+
+	juce::ValueTree state("DjIaVstState");
+	juce::ValueTree tracksState("TrackManager");
+	for (const auto& section : sections)
+	{
+		if (section.name == "Settings")
+		{
+			state.copyPropertiesFrom(PluginStateCodec::decodeSection(section), nullptr);
+		}
+		else if (section.name.startsWith("Track:"))
+		{
+			if (tracksChanged)
+				tracksState.appendChild(PluginStateCodec::decodeSection(section), nullptr);
+		}
+		else if (!isUnchanged(section))
+		{
+			state.appendChild(PluginStateCodec::decodeSection(section), nullptr);
+		}
+	}
+
+	if (tracksChanged)
+		state.appendChild(tracksState, nullptr);
+	else
+		DBG("Track state unchanged, keeping loaded tracks");
+	return state;
+}
 
+void DjIaVstProcessor::applyState(const juce::ValueTree& state)
+{
 	projectId = state.getProperty("projectId", "legacy").toString();
 	lastPrompt = state.getProperty("lastPrompt", "").toString();
 	lastKey = state.getProperty("lastKey", "C minor").toString();
@@ -2645,14 +3834,29 @@ void DjIaVstProcessor::setStateInformation(const void* data, int sizeInBytes)
 	guitarEnabled = state.getProperty("guitarEnabled", false);
 	pianoEnabled = state.getProperty("pianoEnabled", false);
 	lastKeyIndex = state.getProperty("lastKeyIndex", 1);
-	isGenerating = state.getProperty("isGenerating", false);
-	generatingTrackId = state.getProperty("generatingTrackId", "").toString();
 	autoLoadEnabled.store(state.getProperty("autoLoadEnabled", true));
+	trackManager.setMemoryMappedPages(state.getProperty("memoryMappedPages", false));
+	trackManager.setRenderThreads(state.getProperty("renderThreads", 1));
+	streamGeneratedAudio.store(state.getProperty("streamGeneratedAudio", true));
+	directBusRendering.store(state.getProperty("directBusRendering", true));
+	groupExtraSlotsOnBuses.store(state.getProperty("groupExtraSlotsOnBuses", false));
+	apiClient.setPreferCompressedAudio(state.getProperty("compressedTransfer", true));
+	progressiveGeneration.store(state.getProperty("progressiveGeneration", false));
+	setLocalGenerationThreads(state.getProperty("localGenerationThreads", 0));
+	setSpeculativeBudget(state.getProperty("speculativeBudget", 8));
+	setSpeculativeGeneration(state.getProperty("speculativeGeneration", false));
+	setMaxConcurrentGenerations(state.getProperty("maxConcurrentGenerations", 4));
+	setMaxConcurrentLocalGenerations(state.getProperty("maxConcurrentLocalGenerations", 1));
 	bool bypassValue = state.getProperty("bypassSequencer", false);
 	setBypassSequencer(bypassValue);
 	auto tracksState = state.getChildWithName("TrackManager");
 	if (tracksState.isValid())
 	{
+		generationQueue.cancelSpeculative();
+		{
+			const juce::ScopedLock lock(candidateLock);
+			generationCandidates.clear();
+		}
 		trackManager.loadState(tracksState);
 	}
 
@@ -2670,6 +3874,7 @@ void DjIaVstProcessor::setStateInformation(const void* data, int sizeInBytes)
 			selectedTrackId = trackManager.createTrack("Main");
 		}
 	}
+	scheduleAudioRestore();
 	juce::ValueTree midiMappingsState = state.getChildWithName("MidiMappings");
 	if (midiMappingsState.isValid())
 	{
@@ -2870,6 +4075,14 @@ void DjIaVstProcessor::updateAllWaveformsAfterLoad()
 
 void DjIaVstProcessor::parameterChanged(const juce::String& parameterID, float newValue)
 {
+	if (parameterID.startsWith("slot"))
+	{
+		const int slot = SlotParameters::getSlotIndex(parameterID);
+		if (slot >= 0 && slot < trackCapacity)
+			dirtyParameterSlots.fetch_or(juce::uint64(1) << slot, std::memory_order_release);
+		return;
+	}
+
 	if (parameterID == "generate" && newValue > 0.5f)
 	{
 		juce::MessageManager::callAsync([this]()
@@ -2962,18 +4175,6 @@ void DjIaVstProcessor::selectPreviousTrack()
 
 void DjIaVstProcessor::triggerGlobalGeneration()
 {
-	if (isGenerating)
-	{
-		juce::MessageManager::callAsync([this]()
-			{
-				if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor()))
-				{
-					editor->setStatusWithTimeout("Generation already in progress, please wait", 3000);
-				}
-			});
-		return;
-	}
-
 	if (selectedTrackId.isEmpty())
 	{
 		juce::MessageManager::callAsync([this]()
@@ -2986,11 +4187,19 @@ void DjIaVstProcessor::triggerGlobalGeneration()
 		return;
 	}
 
-	syncSelectedTrackWithGlobalPrompt();
-
 	juce::MessageManager::callAsync([this]()
 		{
-			if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor()))
+			auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor());
+			if (isTrackGenerating(selectedTrackId))
+			{
+				if (editor)
+				{
+					editor->setStatusWithTimeout("Selected track is already generating, please wait", 3000);
+				}
+				return;
+			}
+
+			if (editor)
 			{
 				editor->onGenerateButtonClicked();
 			}
@@ -3031,52 +4240,32 @@ void DjIaVstProcessor::syncSelectedTrackWithGlobalPrompt()
 
 void DjIaVstProcessor::generateLoopFromGlobalSettings()
 {
-	if (isGenerating)
-		return;
-
 	TrackData* track = trackManager.getTrack(selectedTrackId);
-	if (!track)
+	if (!track || isTrackGenerating(selectedTrackId))
 		return;
 
 	syncSelectedTrackWithGlobalPrompt();
-	setIsGenerating(true);
-	setGeneratingTrackId(selectedTrackId);
-
-	juce::Thread::launch([this]()
-		{
-			try
-			{
-				TrackData* track = trackManager.getTrack(selectedTrackId);
-				if (!track) return;
 
-				if (track->usePages.load()) {
-					auto& currentPage = track->getCurrentPage();
+	if (track->usePages.load()) {
+		auto& currentPage = track->getCurrentPage();
 
-					currentPage.selectedPrompt = getGlobalPrompt();
-					currentPage.generationBpm = getGlobalBpm();
-					currentPage.generationKey = getGlobalKey();
-					currentPage.generationDuration = getGlobalDuration();
+		currentPage.selectedPrompt = getGlobalPrompt();
+		currentPage.generationBpm = getGlobalBpm();
+		currentPage.generationKey = getGlobalKey();
+		currentPage.generationDuration = getGlobalDuration();
 
-					currentPage.preferredStems.clear();
-					if (isGlobalStemEnabled("drums")) currentPage.preferredStems.push_back("drums");
-					if (isGlobalStemEnabled("bass")) currentPage.preferredStems.push_back("bass");
-					if (isGlobalStemEnabled("other")) currentPage.preferredStems.push_back("other");
-					if (isGlobalStemEnabled("vocals")) currentPage.preferredStems.push_back("vocals");
-					if (isGlobalStemEnabled("guitar")) currentPage.preferredStems.push_back("guitar");
-					if (isGlobalStemEnabled("piano")) currentPage.preferredStems.push_back("piano");
+		currentPage.preferredStems.clear();
+		if (isGlobalStemEnabled("drums")) currentPage.preferredStems.push_back("drums");
+		if (isGlobalStemEnabled("bass")) currentPage.preferredStems.push_back("bass");
+		if (isGlobalStemEnabled("other")) currentPage.preferredStems.push_back("other");
+		if (isGlobalStemEnabled("vocals")) currentPage.preferredStems.push_back("vocals");
+		if (isGlobalStemEnabled("guitar")) currentPage.preferredStems.push_back("guitar");
+		if (isGlobalStemEnabled("piano")) currentPage.preferredStems.push_back("piano");
 
-					track->syncLegacyProperties();
-				}
+		track->syncLegacyProperties();
+	}
 
-				auto request = createGlobalLoopRequest();
-				generateLoop(request, selectedTrackId);
-			}
-			catch (const std::exception& /*e*/)
-			{
-				setIsGenerating(false);
-				setGeneratingTrackId("");
-			}
-		});
+	queueGeneration(createGlobalLoopRequest(), selectedTrackId);
 }
 
 void DjIaVstProcessor::removeCustomPrompt(const juce::String& prompt)
@@ -3095,7 +4284,7 @@ void DjIaVstProcessor::editCustomPrompt(const juce::String& oldPrompt, const juc
 	}
 }
 
-void DjIaVstProcessor::executePendingAction(TrackData* track) const
+void DjIaVstProcessor::executePendingAction(TrackData* track, int sampleOffset)
 {
 	switch (track->pendingAction)
 	{
@@ -3115,10 +4304,10 @@ void DjIaVstProcessor::executePendingAction(TrackData* track) const
 
 	case TrackData::PendingAction::StopOnNextMeasure:
 		track->isPlaying = false;
+		track->scheduleEvent(TrackData::ScheduledEvent::Type::Stop, sampleOffset);
 		track->isArmedToStop = false;
 		track->isCurrentlyPlaying = false;
-		if (onUIUpdateNeeded)
-			onUIUpdateNeeded();
+		uiUpdates.raise(UIUpdateFlags::general);
 		break;
 
 	default:
@@ -3128,71 +4317,93 @@ void DjIaVstProcessor::executePendingAction(TrackData* track) const
 	track->pendingAction = TrackData::PendingAction::None;
 }
 
-void DjIaVstProcessor::updateSequencers(bool hostIsPlaying)
+void DjIaVstProcessor::updateSequencers(juce::AudioPlayHead* playHead, bool hostIsPlaying, int numSamples, double hostBpm)
 {
 	if (getBypassSequencer())
 	{
 		return;
 	}
-	auto currentPlayHead = getPlayHead();
-	if (!currentPlayHead)
+
+	// Without a musical position there is no bar line to wait for, so a
+	// queued page switch lands on the next block instead.
+	auto applyQueuedPageSwitches = [this]()
+		{
+			for (auto* track : trackManager.getAudioThreadTracks())
+			{
+				if (track)
+					applyPendingPageSwitch(track);
+			}
+		};
+
+	if (!playHead)
+	{
+		applyQueuedPageSwitches();
 		return;
-	auto positionInfo = currentPlayHead->getPosition();
+	}
+	auto positionInfo = playHead->getPosition();
 	if (!positionInfo)
+	{
+		applyQueuedPageSwitches();
 		return;
+	}
 	auto ppqPosition = positionInfo->getPpqPosition();
 	if (!ppqPosition.hasValue())
+	{
+		applyQueuedPageSwitches();
 		return;
+	}
 
 	double currentPpq = *ppqPosition;
 	double stepInPpq = 0.25;
+	const double ppqPerSample = hostBpm > 0.0 && hostSampleRate > 0.0 ? hostBpm / (60.0 * hostSampleRate) : 0.0;
+	const double blockEndPpq = currentPpq + numSamples * ppqPerSample;
 
-	auto trackIds = trackManager.getAllTrackIds();
-	for (const auto& trackId : trackIds)
+	auto offsetForPpq = [currentPpq, ppqPerSample, numSamples](double ppq)
+		{
+			if (ppqPerSample <= 0.0 || ppq <= currentPpq)
+				return 0;
+			return juce::jlimit(0, juce::jmax(0, numSamples - 1), static_cast<int>((ppq - currentPpq) / ppqPerSample));
+		};
+
+	for (auto* track : trackManager.getAudioThreadTracks())
 	{
-		TrackData* track = trackManager.getTrack(trackId);
 		if (track)
 		{
-			double expectedPpqForNextStep = track->lastPpqPosition + stepInPpq;
-
-			bool shouldAdvanceStep = false;
 			if (track->lastPpqPosition < 0)
 			{
 				double totalStepsFromStart = currentPpq / stepInPpq;
 				track->customStepCounter = static_cast<int>(totalStepsFromStart);
 				track->lastPpqPosition = track->customStepCounter * stepInPpq;
-				shouldAdvanceStep = true;
-			}
-			else if (currentPpq >= expectedPpqForNextStep)
-			{
-				track->customStepCounter++;
-				track->lastPpqPosition = expectedPpqForNextStep;
-				shouldAdvanceStep = true;
+				handleAdvanceStep(track, hostIsPlaying, 0);
+				uiUpdates.markSequencerDirty(track->slotIndex);
 			}
 
-			if (shouldAdvanceStep)
+			// After a transport jump or a stalled host the track can be many
+			// steps behind. Only the latest missed step still fires, late at
+			// the block start; replaying the rest would burst their notes.
+			const double missedSteps = std::floor((currentPpq - track->lastPpqPosition) / stepInPpq);
+			if (missedSteps > 1.0)
 			{
-				handleAdvanceStep(track, hostIsPlaying);
+				track->customStepCounter += static_cast<int>(missedSteps) - 1;
+				track->lastPpqPosition += (missedSteps - 1.0) * stepInPpq;
 			}
 
-			if (auto* editor = dynamic_cast<DjIaVstEditor*>(getActiveEditor()))
+			for (int stepsThisBlock = 0; stepsThisBlock < maxStepsPerBlock; ++stepsThisBlock)
 			{
-				juce::Component::SafePointer<DjIaVstEditor> safeEditor(editor);
-				juce::MessageManager::callAsync([safeEditor, trackId]()
-					{
-						if (safeEditor.getComponent() != nullptr)
-						{
-							if (auto* sequencer = static_cast<SequencerComponent*>(safeEditor->getSequencerForTrack(trackId)))
-							{
-								sequencer->updateFromTrackData();
-							}
-						} });
+				double expectedPpqForNextStep = track->lastPpqPosition + stepInPpq;
+				if (expectedPpqForNextStep >= blockEndPpq && currentPpq < expectedPpqForNextStep)
+					break;
+
+				track->customStepCounter++;
+				track->lastPpqPosition = expectedPpqForNextStep;
+				handleAdvanceStep(track, hostIsPlaying, offsetForPpq(expectedPpqForNextStep));
+				uiUpdates.markSequencerDirty(track->slotIndex);
 			}
 		}
 	}
 }
 
-void DjIaVstProcessor::handleAdvanceStep(TrackData* track, bool hostIsPlaying)
+void DjIaVstProcessor::handleAdvanceStep(TrackData* track, bool hostIsPlaying, int sampleOffset)
 {
 	int numerator = getTimeSignatureNumerator();
 	int denominator = getTimeSignatureDenominator();
@@ -3231,7 +4442,12 @@ void DjIaVstProcessor::handleAdvanceStep(TrackData* track, bool hostIsPlaying)
 
 	if ((newMeasure == 0 && newStep == 0) && track->pendingAction != TrackData::PendingAction::None)
 	{
-		executePendingAction(track);
+		executePendingAction(track, sampleOffset);
+	}
+
+	if (newStep == 0)
+	{
+		applyPendingPageSwitch(track);
 	}
 
 	track->sequencerData.currentStep = newStep;
@@ -3240,13 +4456,9 @@ void DjIaVstProcessor::handleAdvanceStep(TrackData* track, bool hostIsPlaying)
 	if (currentStepIsActive &&
 		track->isCurrentlyPlaying.load() && hostIsPlaying)
 	{
-
-		if (!track->beatRepeatActive.load())
-		{
-			track->readPosition = 0.0;
-		}
-		track->setPlaying(true);
-		triggerSequencerStep(track);
+		track->scheduleStart(sampleOffset);
+		track->setPlaying(true, uiUpdates);
+		triggerSequencerStep(track, sampleOffset);
 	}
 }
 
@@ -3256,41 +4468,48 @@ bool DjIaVstProcessor::previewSampleFromBank(const juce::String& sampleId)
 	auto* entry = sampleBank->getSample(sampleId);
 	if (!entry) return false;
 
-	juce::File sampleFile(entry->filePath);
-	if (!sampleFile.exists()) return false;
-
-	juce::AudioFormatManager formatManager;
-	formatManager.registerBasicFormats();
-	std::unique_ptr<juce::AudioFormatReader> testReader(formatManager.createReaderFor(sampleFile));
-	if (!testReader) {
-		DBG("Cannot read audio file: " + sampleFile.getFullPathName());
-		return false;
+	const double targetSampleRate = hostSampleRate;
+	if (auto clip = sharedResources->previews.find(sampleId, targetSampleRate))
+	{
+		juce::ScopedLock lock(previewLock);
+		++previewRequestId;
+		startPreview(std::move(clip));
+		return true;
 	}
 
-	stopSamplePreview();
+	juce::File sampleFile(entry->filePath);
+	if (!sampleFile.existsAsFile()) return false;
 
-	juce::Thread::launch([this, sampleFile]()
+	stopSamplePreview();
+	const juce::uint32 requestId = ++previewRequestId;
+	isPreviewDecoding = true;
+
+	// On the job pool rather than a detached thread: cleanProcessor stops the
+	// pool, so the decode never outlives the processor it reports back to.
+	// A newer preview replaces this one under the same key.
+	stretchJobPool.submit("_preview", 1,
+		[this, sampleId, sampleFile, targetSampleRate, requestId](StretchJobPool::JobContext& job)
 		{
-			juce::AudioFormatManager formatManager;
-			formatManager.registerBasicFormats();
-			std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(sampleFile));
-			if (!reader) {
-				juce::ScopedLock lock(previewLock);
-				isPreviewPlaying = false;
+			auto clip = PreviewClip::decode(sampleId, sampleFile, targetSampleRate);
+			if (!clip)
+			{
+				DBG("Cannot read audio file: " + sampleFile.getFullPathName());
+				if (previewRequestId.load() == requestId)
+					isPreviewDecoding = false;
 				return;
 			}
 
+			sharedResources->previews.insert(clip);
+			if (job.isCancelled())
+				return;
+			// A later click or stop supersedes this request; the clip stays
+			// cached. Both bump the id under previewLock, so holding it here
+			// keeps a stop from landing between the check and the start.
+			juce::ScopedLock lock(previewLock);
+			if (previewRequestId.load() == requestId)
 			{
-				juce::ScopedLock lock(previewLock);
-				previewBuffer.setSize(2, (int)reader->lengthInSamples);
-				reader->read(&previewBuffer, 0, (int)reader->lengthInSamples, 0, true, true);
-				if (reader->numChannels == 1)
-				{
-					previewBuffer.copyFrom(1, 0, previewBuffer, 0, 0, previewBuffer.getNumSamples());
-				}
-				previewSampleRate = reader->sampleRate;
-				previewPosition = 0.0;
-				isPreviewPlaying = true;
+				startPreview(std::move(clip));
+				isPreviewDecoding = false;
 			}
 			DBG("Preview loaded: " + sampleFile.getFileName());
 		});
@@ -3298,7 +4517,31 @@ bool DjIaVstProcessor::previewSampleFromBank(const juce::String& sampleId)
 	return true;
 }
 
-void DjIaVstProcessor::triggerSequencerStep(TrackData* track)
+void DjIaVstProcessor::startPreview(std::shared_ptr<const PreviewClip> clip)
+{
+	juce::ScopedLock lock(previewLock);
+	++previewStartCount;
+	publishedPreview.store(clip.get());
+	if (activePreview)
+		retiredPreviews.push_back(std::move(activePreview));
+	activePreview = std::move(clip);
+	isPreviewPlaying = true;
+	reclaimRetiredPreviews();
+}
+
+void DjIaVstProcessor::reclaimRetiredPreviews()
+{
+	juce::ScopedLock lock(previewLock);
+	const PreviewClip* inUse = previewInUse.load();
+	retiredPreviews.erase(std::remove_if(retiredPreviews.begin(), retiredPreviews.end(),
+		[inUse](const std::shared_ptr<const PreviewClip>& clip)
+		{
+			return clip.get() != inUse;
+		}),
+		retiredPreviews.end());
+}
+
+void DjIaVstProcessor::triggerSequencerStep(TrackData* track, int sampleOffset)
 {
 	if (getBypassSequencer())
 	{
@@ -3309,21 +4552,19 @@ void DjIaVstProcessor::triggerSequencerStep(TrackData* track)
 	track->isArmed = false;
 	if (track->sequencerData.steps[measure][step])
 	{
-		if (!track->beatRepeatActive.load())
-		{
-			track->readPosition = 0.0;
-		}
 		playingTracks[track->midiNote] = track->trackId;
 		juce::MidiMessage noteOn = juce::MidiMessage::noteOn(1, track->midiNote,
 			(juce::uint8)(track->sequencerData.velocities[measure][step] * 127));
-		addSequencerMidiMessage(noteOn);
+		addSequencerMidiMessage(noteOn, sampleOffset);
 	}
 }
 
 void DjIaVstProcessor::stopSamplePreview()
 {
+	juce::ScopedLock lock(previewLock);
+	++previewRequestId;
+	isPreviewDecoding = false;
 	isPreviewPlaying = false;
-	previewPosition = 0.0;
 }
 
 juce::File DjIaVstProcessor::getTrackPageAudioFile(const juce::String& trackId, int pageIndex)
@@ -3341,7 +4582,7 @@ juce::File DjIaVstProcessor::getTrackPageAudioFile(const juce::String& trackId,
 	return audioDir.getChildFile(filename);
 }
 
-void DjIaVstProcessor::loadSampleToBankPage(const juce::String& trackId, int pageIndex, const juce::File& sampleFile, const juce::String& sampleId)
+void DjIaVstProcessor::loadSampleToBankPage(const juce::String& trackId, int pageIndex, const juce::File& sampleFile, const juce::String& sampleId, StretchJobPool::JobContext* job)
 {
 	TrackData* track = trackManager.getTrack(trackId);
 	if (!track || pageIndex < 0 || pageIndex >= 4) return;
@@ -3349,27 +4590,14 @@ void DjIaVstProcessor::loadSampleToBankPage(const juce::String& trackId, int pag
 	auto& page = track->pages[pageIndex];
 
 	try {
-		juce::AudioFormatManager formatManager;
-		formatManager.registerBasicFormats();
-
-		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(sampleFile));
-		if (!reader) return;
-
-		int numChannels = reader->numChannels;
-		int numSamples = static_cast<int>(reader->lengthInSamples);
-
-		track->stagingBuffer.setSize(2, numSamples);
-		reader->read(&track->stagingBuffer, 0, numSamples, 0, true, true);
-
-		if (numChannels == 1) {
-			track->stagingBuffer.copyFrom(1, 0, track->stagingBuffer, 0, 0, numSamples);
-		}
-
-		track->stagingNumSamples = numSamples;
-		track->stagingSampleRate = reader->sampleRate;
+		if (!loadSharedSampleToStagingBuffer(sampleFile, track)) return;
 		track->stagingOriginalBpm = 126.0f;
 
-		processAudioBPMAndSync(track);
+		if (!processAudioBPMAndSync(track, job))
+		{
+			page.isLoading = false;
+			return;
+		}
 
 		auto permanentFile = getTrackPageAudioFile(trackId, pageIndex);
 		permanentFile.getParentDirectory().createDirectory();
@@ -3381,6 +4609,7 @@ void DjIaVstProcessor::loadSampleToBankPage(const juce::String& trackId, int pag
 			auto stretchedFile = getTrackPageAudioFile(trackId, pageIndex);
 			saveBufferToFile(track->originalStagingBuffer, originalFile, track->stagingSampleRate);
 			saveBufferToFile(track->stagingBuffer, stretchedFile, track->stagingSampleRate);
+			track->originalStagingBuffer.setSize(0, 0);
 		}
 		else {
 			saveBufferToFile(track->stagingBuffer, permanentFile, track->stagingSampleRate);
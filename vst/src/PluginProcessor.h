@@ -13,10 +13,21 @@
 #include "ObsidianEngine.h"
 #include "SimpleEQ.h"
 #include "SampleBank.h"
+#include "StretchJobPool.h"
+#include "GenerationQueue.h"
+#include "SharedResources.h"
+#include "LevelMeter.h"
+#include "PluginStateCodec.h"
+#include "RetiredBufferQueue.h"
+#include "OfflineBouncer.h"
+#include "SlotParameters.h"
+#include "UIUpdateFlags.h"
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 #include <atomic>
+#include <array>
 
 class DjIaVstEditor;
 class TrackComponent;
@@ -43,7 +54,10 @@ public:
 	TrackManager trackManager;
 	juce::ValueTree pendingMidiMappings;
 	juce::AudioProcessorValueTreeState& getParameterTreeState() { return parameters; }
-	std::atomic<bool> needsUIUpdate{ false };
+	UIUpdateFlags uiUpdates;
+	MeterFeed& getMeterFeed() { return meterFeed; }
+	StageProfiler& getStageProfiler() { return stageProfiler; }
+	AnalysisCache& getAnalysisCache() { return sharedResources->analysis; }
 	void initDummySynth();
 	void initTracks();
 	void loadParameters();
@@ -57,6 +71,7 @@ public:
 	void copyTracksToIndividualOutputs(juce::AudioSampleBuffer& buffer);
 	void clearOutputBuffers(juce::AudioSampleBuffer& buffer);
 	void resizeIndividualsBuffers(juce::AudioSampleBuffer& buffer);
+	void pointSlotOutputs(juce::AudioSampleBuffer& buffer, bool renderIntoBuses);
 	void getDawInformations(juce::AudioPlayHead* currentPlayHead, bool& hostIsPlaying, double& hostBpm, double& hostPpqPosition);
 	bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 	bool getDrumsEnabled() const { return drumsEnabled; }
@@ -114,8 +129,9 @@ public:
 	std::vector<juce::String> getAllTrackIds() const { return trackManager.getAllTrackIds(); }
 	TrackData* getCurrentTrack() { return trackManager.getTrack(selectedTrackId); }
 	TrackData* getTrack(const juce::String& trackId) { return trackManager.getTrack(trackId); }
-	void generateLoop(const DjIaClient::LoopRequest& request, const juce::String& targetTrackId = "");
-	void startNotePlaybackForTrack(const juce::String& trackId, int noteNumber, double hostBpm = 126.0);
+	GenerationQueue::Result generateLoop(const DjIaClient::LoopRequest& request, const juce::String& targetTrackId = "",
+		bool speculative = false);
+	void startNotePlaybackForTrack(const juce::String& trackId, int noteNumber, double hostBpm = 126.0, int sampleOffset = 0);
 	void setApiKey(const juce::String& key);
 	void setServerUrl(const juce::String& url);
 	double getHostBpm() const;
@@ -131,6 +147,50 @@ public:
 	void updateAllWaveformsAfterLoad();
 	void setAutoLoadEnabled(bool enabled);
 	bool getAutoLoadEnabled() const { return autoLoadEnabled.load(); }
+	void setMemoryMappedPages(bool enabled);
+	bool getMemoryMappedPages() const { return trackManager.getMemoryMappedPages(); }
+	void setStreamGeneratedAudio(bool enabled) { streamGeneratedAudio = enabled; }
+	bool getStreamGeneratedAudio() const { return streamGeneratedAudio.load(); }
+	/** Tracks render straight into their host output buses instead of intermediate buffers. */
+	void setDirectBusRendering(bool enabled) { directBusRendering = enabled; }
+	bool getDirectBusRendering() const { return directBusRendering.load(); }
+	/** Slots beyond the individual outputs share bus (slot % 8) + 1 instead of only reaching the main mix. */
+	void setGroupExtraSlotsOnBuses(bool enabled) { groupExtraSlotsOnBuses = enabled; }
+	bool getGroupExtraSlotsOnBuses() const { return groupExtraSlotsOnBuses.load(); }
+	int getTrackCapacity() const { return trackCapacity; }
+	/** Saved to the global config; used by the next plugin instance. */
+	void setConfiguredTrackCapacity(int capacity);
+	int getConfiguredTrackCapacity() const { return configuredTrackCapacity; }
+	/** 0 picks every core not reserved for the audio and render threads. */
+	void setLocalGenerationThreads(int numThreads) { localGenerationThreads = juce::jmax(0, numThreads); }
+	int getLocalGenerationThreads() const { return localGenerationThreads.load(); }
+	int getEffectiveLocalGenerationThreads() const
+	{
+		const int configured = localGenerationThreads.load();
+		return configured > 0 ? configured : StableAudioEngine::getDefaultThreadCount(getRenderThreads());
+	}
+	void setProgressiveGeneration(bool enabled) { progressiveGeneration = enabled; }
+	bool getProgressiveGeneration() const { return progressiveGeneration.load(); }
+	void setCompressedTransfer(bool enabled) { apiClient.setPreferCompressedAudio(enabled); }
+	bool getCompressedTransfer() const { return apiClient.getPreferCompressedAudio(); }
+	juce::int64 getLastTransferBytes() const { return lastTransferBytes.load(); }
+	double getLastTransferMs() const { return lastTransferMs.load(); }
+	void setRenderThreads(int numThreads) { trackManager.setRenderThreads(numThreads); }
+	int getRenderThreads() const { return trackManager.getRenderThreads(); }
+
+	OfflineBouncer& getOfflineBouncer() { return *offlineBouncer; }
+	/** Name of the track in each slot, empty for free slots. */
+	juce::StringArray getSlotTrackNames();
+	/** Message thread. Transport events that overflowed a track's per-block list, summed over tracks. */
+	juce::uint32 getDroppedScheduledEvents();
+	// Offline bounce thread only, between begin and end; the host gets silence meanwhile.
+	bool beginOfflineRender(int blockSize);
+	void renderOfflineBlock(juce::AudioPlayHead& transport, juce::AudioBuffer<float>& master,
+		std::vector<juce::AudioBuffer<float>>& slotOutputs);
+	void endOfflineRender();
+	void releaseInactivePageAudio(const juce::String& trackId, int pageIndex);
+	bool queuePageSwitch(const juce::String& trackId, int pageIndex);
+	void updatePagePrefetch(const juce::String& trackId);
 	void loadPendingSample();
 	bool hasSampleWaiting() const { return hasUnloadedSample.load(); }
 	void setMidiIndicatorCallback(std::function<void(const juce::String&)> callback)
@@ -142,12 +202,41 @@ public:
 	void addCustomPrompt(const juce::String& prompt);
 	juce::StringArray getCustomPrompts() const;
 	void clearCustomPrompts();
-	bool getIsGenerating() const { return isGenerating; }
-	void setIsGenerating(bool generating) { isGenerating = generating; }
-	juce::String getGeneratingTrackId() const { return generatingTrackId; }
-	void setGeneratingTrackId(const juce::String& trackId) { generatingTrackId = trackId; }
+	bool getIsGenerating() const { return generationQueue.hasActiveRequests(); }
+	bool isTrackGenerating(const juce::String& trackId) const { return generationQueue.isActive(trackId); }
+	GenerationQueue::Status getGenerationStatus(const juce::String& trackId) const { return generationQueue.getStatus(trackId); }
+	juce::StringArray getGeneratingTrackIds() const { return generationQueue.getActiveTrackIds(); }
+	bool queueGeneration(const DjIaClient::LoopRequest& request, const juce::String& trackId);
+	void cancelQueuedGenerations() { generationQueue.cancelAllQueued(); }
+
+	/*
+		Speculative variations: while no generation is running, the selected
+		track's current prompt is generated again with fresh seeds in the
+		background, up to candidatesPerTrack ready variations and within the
+		session budget. Only backends allowed two or more concurrent requests
+		speculate, and only successful variations use up the budget.
+		loadNextVariation then swaps one in without waiting.
+	*/
+	static constexpr int candidatesPerTrack = 2;
+	void setSpeculativeGeneration(bool enabled);
+	bool getSpeculativeGeneration() const { return speculativeGeneration.load(); }
+	void setSpeculativeBudget(int maxGenerations);
+	int getSpeculativeBudget() const { return speculativeBudget.load(); }
+	int getSpeculativeRemaining() const { return juce::jmax(0, speculativeBudget.load() - speculativeUsed.load()); }
+	int getNumVariationsReady(const juce::String& trackId);
+	bool loadNextVariation(const juce::String& trackId);
+	void setMaxConcurrentGenerations(int maxRequests) { generationQueue.setMaxConcurrent(GenerationQueue::Backend::Server, maxRequests); }
+	int getMaxConcurrentGenerations() const { return generationQueue.getMaxConcurrent(GenerationQueue::Backend::Server); }
+	/** Also sets the process-wide limit shared with every other instance. */
+	void setMaxConcurrentLocalGenerations(int maxRequests)
+	{
+		generationQueue.setMaxConcurrent(GenerationQueue::Backend::Local, maxRequests);
+		sharedResources->localGenerations.setLimit(generationQueue.getMaxConcurrent(GenerationQueue::Backend::Local));
+	}
+	int getMaxConcurrentLocalGenerations() const { return generationQueue.getMaxConcurrent(GenerationQueue::Backend::Local); }
 	bool isStateReady() const { return stateLoaded; }
 	MidiLearnManager& getMidiLearnManager() { return midiLearnManager; }
+	void syncTrackParameters();
 	void handleSampleParams(int slot, TrackData* track);
 	void loadGlobalConfig();
 	void saveGlobalConfig();
@@ -156,7 +245,7 @@ public:
 	int getSamplesPerBlock() const { return currentBlockSize; };
 	int getRequestTimeout() const { return requestTimeoutMS; };
 	void handleSequencerPlayState(bool hostIsPlaying);
-	void addSequencerMidiMessage(const juce::MidiMessage& message);
+	void addSequencerMidiMessage(const juce::MidiMessage& message, int sampleOffset = 0);
 	void setRequestTimeout(int requestTimeoutMS);
 	void prepareToPlay(double newSampleRate, int samplesPerBlock);
 	std::function<void(double)> onHostBpmChanged = nullptr;
@@ -231,34 +320,70 @@ public:
 	void selectPreviousTrack();
 	void triggerGlobalGeneration();
 	void syncSelectedTrackWithGlobalPrompt();
-	SampleBank* getSampleBank() { return sampleBank.get(); }
+	SampleBank* getSampleBank() { return sampleBank; }
 	void loadSampleFromBank(const juce::String& sampleId, const juce::String& trackId);
-	void loadAudioFileAsync(const juce::String& trackId, const juce::File& audioData);
+	void loadAudioFileAsync(const juce::String& trackId, const juce::File& audioData, StretchJobPool::JobContext* job = nullptr,
+		bool fromSampleBank = false);
+	void submitStretchJob(const juce::String& trackId, StretchJobPool::JobFunction job);
 	bool previewSampleFromBank(const juce::String& sampleId);
 	void stopSamplePreview();
-	bool isSamplePreviewing() const { return isPreviewPlaying.load(); }
+	bool isSamplePreviewing() const { return isPreviewPlaying.load() || isPreviewDecoding.load(); }
 
 private:
 	DjIaVstEditor* currentEditor = nullptr;
 	SimpleEQ masterEQ;
+	MeterFeed meterFeed;
+	StageProfiler stageProfiler;
+	LevelMeter masterMeter;
 	MidiLearnManager midiLearnManager;
 	DjIaClient apiClient;
+	juce::SharedResourcePointer<SharedResources> sharedResources;
+	StretchJobPool stretchJobPool{ 2 };
+	GenerationQueue generationQueue{ [this](const GenerationQueue::Request& request)
+		{ return generateLoop(request.loopRequest, request.trackId, request.speculative); } };
 	GenerationListener* generationListener = nullptr;
 	juce::String projectId;
 	bool migrationCompleted = false;
-	std::unique_ptr<SampleBank> sampleBank;
+	SampleBank* sampleBank = nullptr;
 
 	std::atomic<float>* nextTrackParam = nullptr;
 	std::atomic<float>* prevTrackParam = nullptr;
 	std::atomic<int64_t> internalSampleCounter{ 0 };
 	std::atomic<double> lastHostBpmForQuantization{ 120.0 };
 
+	/*
+		Sample bank audition. The message side publishes a cached clip and
+		bumps previewStartCount; the audio thread never locks, acknowledges
+		the clip it reads in previewInUse and restarts when the clip or the
+		count changes. Replaced clips are released only once it moved on.
+	*/
 	std::atomic<bool> isPreviewPlaying{ false };
-	juce::AudioBuffer<float> previewBuffer;
-	std::atomic<double> previewPosition{ 0.0 };
-	std::atomic<double> previewSampleRate{ 44100.0 };
+	std::atomic<bool> isPreviewDecoding{ false };
+	std::atomic<const PreviewClip*> publishedPreview{ nullptr };
+	std::atomic<const PreviewClip*> previewInUse{ nullptr };
+	std::atomic<juce::uint32> previewStartCount{ 0 };
+	std::atomic<juce::uint32> previewRequestId{ 0 };
+	const PreviewClip* previewClipSeen = nullptr;
+	juce::uint32 previewStartSeen = 0;
+	double previewPosition = 0.0;
+	std::shared_ptr<const PreviewClip> activePreview;
+	std::vector<std::shared_ptr<const PreviewClip>> retiredPreviews;
 	juce::CriticalSection previewLock;
 
+	void startPreview(std::shared_ptr<const PreviewClip> clip);
+	void reclaimRetiredPreviews();
+
+	PluginStateCodec stateCodec;
+	juce::CriticalSection stateCodecLock;
+
+	juce::ValueTree createSettingsState();
+	juce::ValueTree createMidiMappingsState();
+	juce::ValueTree createParametersState();
+	juce::ValueTree createGlobalGenerationState();
+	juce::StringArray encodeStateSections();
+	juce::ValueTree composeBinaryState(const std::vector<PluginStateCodec::Section>& sections);
+	void applyState(const juce::ValueTree& state);
+
 	std::atomic<bool> isLoadingFromBank{ false };
 	juce::String currentBankLoadTrackId;
 
@@ -271,7 +396,11 @@ private:
 	juce::Synthesiser synth;
 
 	static juce::AudioProcessor::BusesProperties createBusLayout();
-	static const int MAX_TRACKS = 8;
+	/** Upper bound of the configurable capacity; arrays indexed by slot use it. */
+	static const int MAX_TRACKS = SlotParameters::maxSlots;
+	/** Individual stereo outputs; the bus layout does not change with capacity. */
+	static const int NUM_TRACK_BUSES = 8;
+	static int loadTrackCapacity();
 
 	juce::StringArray customPrompts;
 
@@ -289,7 +418,6 @@ private:
 	bool vocalsEnabled = false;
 	bool guitarEnabled = false;
 	bool pianoEnabled = false;
-	bool isGenerating = false;
 
 	int lastKeyIndex = 1;
 	int lastPresetIndex = -1;
@@ -304,8 +432,14 @@ private:
 	int globalDuration = 6;
 	std::vector<juce::String> globalStems = {};
 
-	juce::String pendingMessage;
-	bool hasPendingNotification = false;
+	struct GenerationNotification
+	{
+		juce::String trackId;
+		juce::String message;
+	};
+
+	juce::CriticalSection notificationLock;
+	std::vector<GenerationNotification> pendingNotifications;
 
 	void handleAsyncUpdate() override;
 
@@ -324,20 +458,17 @@ private:
 	juce::CriticalSection apiLock;
 	juce::CriticalSection sequencerMidiLock;
 
-	juce::File pendingAudioFile;
-
 	juce::MidiBuffer sequencerMidiBuffer;
 
+	// Fixed for the lifetime of the instance: hosts expect a constant parameter list.
+	const int trackCapacity;
+	int configuredTrackCapacity = SlotParameters::legacySlots;
 	juce::AudioProcessorValueTreeState parameters;
 	juce::String serverUrl = "";
 	juce::String apiKey;
 	juce::String lastPrompt = "";
 	juce::String lastKey = "C Aeolian";
-	juce::String trackIdWaitingForLoad;
-	juce::String pendingTrackId;
-	juce::String lastGeneratedTrackId;
 	juce::String selectedTrackId;
-	juce::String generatingTrackId = "";
 
 	juce::StringArray booleanParamIds = {
 		"generate", "play",
@@ -367,8 +498,12 @@ private:
 	std::function<void(const juce::String&)> midiIndicatorCallback;
 
 	std::atomic<double> cachedHostBpm{ 126.0 };
+	std::atomic<bool> cachedHostIsPlaying{ false };
 
 	std::vector<juce::AudioBuffer<float>> individualOutputBuffers;
+	// Per-slot render targets, re-pointed each block at a host bus, at
+	// individualOutputBuffers or, for grouped slots, at a shared bus.
+	std::vector<juce::AudioBuffer<float>> slotOutputViews;
 
 	std::unordered_map<int, juce::String> playingTracks;
 
@@ -377,12 +512,29 @@ private:
 	std::atomic<bool> hasPendingAudioData{ false };
 	std::atomic<bool> autoLoadEnabled;
 	std::atomic<bool> hasUnloadedSample{ false };
-	std::atomic<bool> waitingForMidiToLoad{ false };
 	std::atomic<bool> isNotePlaying{ false };
-	std::atomic<bool> correctMidiNoteReceived{ false };
 	std::atomic<bool> stateLoaded{ false };
 	std::atomic<bool> canLoad{ false };
 	std::atomic<bool> bypassSequencer{ false };
+	std::atomic<bool> streamGeneratedAudio{ true };
+	std::atomic<bool> directBusRendering{ true };
+	std::atomic<bool> groupExtraSlotsOnBuses{ false };
+	std::atomic<bool> progressiveGeneration{ false };
+	std::atomic<int> localGenerationThreads{ 0 };
+	std::atomic<bool> speculativeGeneration{ false };
+	std::atomic<int> speculativeBudget{ 8 };
+	std::atomic<int> speculativeUsed{ 0 };
+
+	struct GenerationCandidate
+	{
+		DjIaClient::LoopRequest request;
+		std::shared_ptr<DjIaClient::DecodedAudio> audio;
+	};
+	std::map<juce::String, std::vector<GenerationCandidate>> generationCandidates;
+	juce::CriticalSection candidateLock;
+	std::atomic<juce::int64> lastTransferBytes{ 0 };
+	std::atomic<double> lastTransferMs{ 0.0 };
+	static constexpr double earlyAnalysisSeconds = 8.0;
 
 
 	std::atomic<float>* generateParam = nullptr;
@@ -397,18 +549,30 @@ private:
 	std::atomic<float>* masterHighParam = nullptr;
 	std::atomic<float>* masterMidParam = nullptr;
 	std::atomic<float>* masterLowParam = nullptr;
-	std::atomic<float>* slotVolumeParams[8] = { nullptr };
-	std::atomic<float>* slotPanParams[8] = { nullptr };
-	std::atomic<float>* slotMuteParams[8] = { nullptr };
-	std::atomic<float>* slotSoloParams[8] = { nullptr };
-	std::atomic<float>* slotPlayParams[8] = { nullptr };
-	std::atomic<float>* slotStopParams[8] = { nullptr };
-	std::atomic<float>* slotGenerateParams[8] = { nullptr };
-	std::atomic<float>* slotPitchParams[8] = { nullptr };
-	std::atomic<float>* slotFineParams[8] = { nullptr };
-	std::atomic<float>* slotBpmOffsetParams[8] = { nullptr };
-	std::atomic<float>* slotRandomRetriggerParams[8];
-	std::atomic<float>* slotRetriggerIntervalParams[8];
+	std::atomic<float>* slotVolumeParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotPanParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotMuteParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotSoloParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotPlayParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotStopParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotGenerateParams[MAX_TRACKS] = { nullptr };
+
+	static constexpr const char* trackParameterSuffixes[] = { "Volume", "Pan", "Pitch", "Fine", "Solo", "Mute",
+		"RandomRetrigger", "RetriggerInterval", "EqLow", "EqMid", "EqHigh", "Filter", "Comp", "DelaySend" };
+	std::atomic<juce::uint64> dirtyParameterSlots{ ~juce::uint64(0) };
+	std::array<TrackData*, MAX_TRACKS> syncedSlotTracks{};
+	juce::uint64 syncedSlotMask = 0;
+	std::atomic<float>* slotPitchParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotFineParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotBpmOffsetParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotRandomRetriggerParams[MAX_TRACKS];
+	std::atomic<float>* slotRetriggerIntervalParams[MAX_TRACKS];
+	std::atomic<float>* slotEqLowParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotEqMidParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotEqHighParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotFilterParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotCompParams[MAX_TRACKS] = { nullptr };
+	std::atomic<float>* slotDelaySendParams[MAX_TRACKS] = { nullptr };
 
 
 	static juce::File getGlobalConfigFile()
@@ -419,40 +583,59 @@ private:
 	}
 
 	void processIncomingAudio(bool hostIsPlaying);
-	void clearPendingAudio();
+	bool deliverGeneratedAudio(const juce::String& trackId, const juce::File& audioFile,
+		std::shared_ptr<DjIaClient::DecodedAudio> decodedAudio = nullptr, bool loadImmediately = false);
+	bool storeGenerationCandidate(const juce::String& trackId, const DjIaClient::LoopRequest& request,
+		const juce::File& audioFile, std::shared_ptr<DjIaClient::DecodedAudio> decodedAudio);
+	void scheduleSpeculativeGeneration();
+	static bool candidateMatches(const DjIaClient::LoopRequest& candidate, const DjIaClient::LoopRequest& current);
+	void loadDecodedAudioAsync(const juce::String& trackId, std::shared_ptr<DjIaClient::DecodedAudio> audio, StretchJobPool::JobContext* job);
 	void processMidiMessages(juce::MidiBuffer& midiMessages, bool hostIsPlaying, double hostBpm);
-	void playTrack(const juce::MidiMessage& message, double hostBpm);
+	int playTrack(const juce::MidiMessage& message, double hostBpm, int sampleOffset);
 	void handlePlayAndStop(bool hostIsPlaying);
 	void updateTimeStretchRatios(double hostBpm);
 	void updateMasterEQ();
-	void processAudioBPMAndSync(TrackData* track);
+	bool processAudioBPMAndSync(TrackData* track, StretchJobPool::JobContext* job = nullptr, float knownBpm = 0.0f);
+	void prefaultMappedPages();
+	void prefaultPageLoop(const juce::String& trackId, TrackPage& page);
+	void applyPendingPageSwitch(TrackData* track);
+	void finishAppliedPageSwitches();
 	void loadAudioToStagingBuffer(std::unique_ptr<juce::AudioFormatReader>& reader, TrackData* track);
+	bool loadSharedSampleToStagingBuffer(const juce::File& sampleFile, TrackData* track);
 	void checkAndSwapStagingBuffers();
 	void performAtomicSwap(TrackData* track, const juce::String& trackId);
+	void retireBuffer(juce::AudioBuffer<float>& buffer) noexcept;
+	void syncSwappedTracks();
+	void releaseConsumedPendingAudio();
+	RetiredBufferQueue retiredBuffers;
 	void updateWaveformDisplay(const juce::String& trackId);
 	void performTrackDeletion(const juce::String& trackId);
 	void reassignTrackOutputsAndMidi();
-	void stopNotePlaybackForTrack(int noteNumber);
-	void updateSequencers(bool hostIsPlaying);
-	void handleAdvanceStep(TrackData* track, bool hostIsPlaying);
-	void triggerSequencerStep(TrackData* track);
+	void stopNotePlaybackForTrack(int noteNumber, int sampleOffset);
+	static constexpr int maxStepsPerBlock = 64;
+	void updateSequencers(juce::AudioPlayHead* playHead, bool hostIsPlaying, int numSamples, double hostBpm);
+	void handleAdvanceStep(TrackData* track, bool hostIsPlaying, int sampleOffset);
+	void triggerSequencerStep(TrackData* track, int sampleOffset);
 	void saveBufferToFile(const juce::AudioBuffer<float>& buffer,
 		const juce::File& outputFile,
 		double sampleRate);
-	void executePendingAction(TrackData* track) const;
+	void executePendingAction(TrackData* track, int sampleOffset);
 	void handleGenerate();
 	void notifyGenerationComplete(const juce::String& trackId, const juce::String& message);
 	void generateLoopFromMidi(const juce::String& trackId);
-	void updateMidiIndicatorWithActiveNotes(double hostBpm, const juce::Array<int>& triggeredNotes);
-	void generateLoopAPI(const DjIaClient::LoopRequest& request, const juce::String& trackId);
-	void generateLoopLocal(const DjIaClient::LoopRequest& request, const juce::String& trackId);
+	void updateMidiIndicatorWithActiveNotes(double hostBpm, juce::uint64 triggeredSlots);
+	void dispatchUIUpdates();
+	/** Undoes a progressive preview after its generation failed. */
+	void restoreAudioBeforePreview(const juce::String& trackId);
+	GenerationQueue::Result generateLoopAPI(const DjIaClient::LoopRequest& request, const juce::String& trackId, bool speculative);
+	GenerationQueue::Result generateLoopLocal(const DjIaClient::LoopRequest& request, const juce::String& trackId, bool speculative);
 	void saveOriginalAndStretchedBuffers(const juce::AudioBuffer<float>& originalBuffer,
 		const juce::AudioBuffer<float>& stretchedBuffer,
 		const juce::String& trackId,
 		double sampleRate);
-	void loadAudioFileForSwitch(const juce::String& trackId, const juce::File& audioFile);
-	void loadSampleToBankPage(const juce::String& trackId, int pageIndex, const juce::File& sampleFile, const juce::String& sampleId);
-	void loadAudioFileForPageSwitch(const juce::String& trackId, int pageIndex, const juce::File& audioFile);
+	void loadAudioFileForSwitch(const juce::String& trackId, const juce::File& audioFile, StretchJobPool::JobContext* job = nullptr);
+	void loadSampleToBankPage(const juce::String& trackId, int pageIndex, const juce::File& sampleFile, const juce::String& sampleId, StretchJobPool::JobContext* job = nullptr);
+	void loadAudioFileForPageSwitch(const juce::String& trackId, int pageIndex, const juce::File& audioFile, StretchJobPool::JobContext* job = nullptr);
 
 	juce::File getTrackPageAudioFile(const juce::String& trackId, int pageIndex);
 
@@ -466,13 +649,55 @@ private:
 
 	void handleGenerationComplete(const juce::String& trackId,
 		const DjIaClient::LoopRequest& originalRequest,
-		const ObsidianEngine::LoopResponse& response);
+		ObsidianEngine::LoopResponse&& response);
 
-	juce::File createTempAudioFile(const std::vector<float>& audioData, float duration);
 	void performMigrationIfNeeded();
+	void scheduleAudioRestore();
 	void updateTrackPathsAfterMigration();
-	void checkBeatRepeatWithSampleCounter();
+	double advanceTracks(juce::AudioPlayHead* playHead, int numSamples, juce::MidiBuffer& midiMessages, StageProfiler* profiler);
+	bool sequencerWasPlaying = false;
+	void updateBeatRepeatTimelines(int numSamples);
+	void placeBeatRepeatEvent(TrackData& track, juce::int64 fromSample, double hostBpm);
+	void publishRetriggerIntervals();
+	juce::Random retriggerRandom;
+	// Intervals drawn on the audio thread for "RetriggerInterval", 0 when
+	// none; the timer forwards them to the host.
+	std::array<std::atomic<int>, MAX_TRACKS> retriggerIntervalFeedback{};
 	void generateLoopFromGlobalSettings();
 
+	// Live transport state a bounce overwrites, put back when it ends.
+	struct LivePlayback
+	{
+		std::shared_ptr<TrackData> track;
+		double readPosition = 0.0;
+		bool isPlaying = false;
+		bool isArmed = false;
+		bool isArmedToStop = false;
+		bool isCurrentlyPlaying = false;
+		TrackData::PendingAction pendingAction = TrackData::PendingAction::None;
+		TrackData::SequencerData sequencerData;
+		int customStepCounter = 0;
+		double lastPpqPosition = -1.0;
+		bool beatRepeatActive = false;
+		double beatRepeatStartPosition = 0.0;
+		double beatRepeatEndPosition = 0.0;
+		double originalReadPosition = 0.0;
+		juce::int64 beatRepeatEventSample = -1;
+		TrackData::BeatRepeatTimeline beatRepeatTimeline;
+		int numScheduledEvents = 0;
+		std::array<TrackData::ScheduledEvent, TrackData::maxScheduledEvents> scheduledEvents{};
+	};
+	std::vector<LivePlayback> livePlaybackBeforeBounce;
+	juce::int64 liveSampleCounterBeforeBounce = 0;
+	bool liveSequencerPlayingBeforeBounce = false;
+	int liveRenderThreadsBeforeBounce = 1;
+	// Set between begin and endOfflineRender, under the callback lock. A host
+	// prepareToPlay in that window is recorded here and applied at the end.
+	bool offlineRenderActive = false;
+	double deferredPrepareSampleRate = 0.0;
+	int deferredPrepareBlockSize = 0;
+	juce::MidiBuffer offlineMidi;
+	std::unique_ptr<OfflineBouncer> offlineBouncer = std::make_unique<OfflineBouncer>(*this);
+
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DjIaVstProcessor);
 };
\ No newline at end of file
@@ -0,0 +1,157 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <map>
+#include <vector>
+
+/*
+	Binary plugin state: a magic word and version followed by independent
+	sections, each a ValueTree written with writeToStream and tagged with a
+	hash of its bytes. A section whose tree is unchanged since the last save
+	reuses its cached bytes, and a reader can compare hashes to skip sections
+	it already holds without parsing them.
+
+	Layout: magic, version, section count, then per section its name, hash,
+	byte size and bytes. States saved as XML by older versions are not
+	handled here; the processor still reads them through getXmlFromBinary.
+*/
+class PluginStateCodec
+{
+public:
+	static constexpr juce::uint32 magic = 0x5453424f; // "OBST"
+	static constexpr int version = 1;
+
+	struct Section
+	{
+		juce::String name;
+		juce::int64 hash = 0;
+		juce::MemoryBlock data;
+	};
+
+	static bool isBinaryState(const void* data, int sizeInBytes)
+	{
+		if (data == nullptr || sizeInBytes < 8)
+			return false;
+		juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+		return static_cast<juce::uint32>(stream.readInt()) == magic;
+	}
+
+	/** Encodes a section, reusing the previous bytes when the tree is equivalent to the last one seen under that name. */
+	const Section& encodeSection(const juce::String& name, const juce::ValueTree& tree)
+	{
+		auto& cached = cache[name];
+		if (!cached.tree.isValid() || !cached.tree.isEquivalentTo(tree))
+		{
+			juce::MemoryOutputStream stream;
+			tree.writeToStream(stream);
+			cached.section.data = stream.getMemoryBlock();
+			cached.section.name = name;
+			cached.section.hash = hashBytes(cached.section.data);
+			cached.tree = tree.createCopy();
+		}
+		cached.lastUsed = encodePass;
+		return cached.section;
+	}
+
+	const Section* getSection(const juce::String& name) const
+	{
+		auto it = cache.find(name);
+		return it != cache.end() ? &it->second.section : nullptr;
+	}
+
+	/** Writes the sections encoded since the previous call and forgets those that were not, e.g. deleted tracks. */
+	void writeState(juce::MemoryBlock& destData, const juce::StringArray& sectionNames)
+	{
+		juce::MemoryOutputStream stream(destData, false);
+		stream.writeInt(static_cast<int>(magic));
+		stream.writeInt(version);
+		stream.writeInt(sectionNames.size());
+		for (const auto& name : sectionNames)
+		{
+			const auto& section = cache[name].section;
+			stream.writeString(section.name);
+			stream.writeInt64(section.hash);
+			stream.writeInt(static_cast<int>(section.data.getSize()));
+			stream.write(section.data.getData(), section.data.getSize());
+		}
+		stream.flush();
+
+		for (auto it = cache.begin(); it != cache.end();)
+		{
+			if (it->second.lastUsed != encodePass)
+				it = cache.erase(it);
+			else
+				++it;
+		}
+		++encodePass;
+	}
+
+	/** Returns false on a foreign, newer or truncated state. */
+	static bool readState(const void* data, int sizeInBytes, std::vector<Section>& sections)
+	{
+		if (!isBinaryState(data, sizeInBytes))
+			return false;
+
+		juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+		stream.readInt();
+		const int stateVersion = stream.readInt();
+		if (stateVersion > version)
+		{
+			DBG("Plugin state version " << stateVersion << " is newer than supported");
+			return false;
+		}
+
+		const int numSections = stream.readInt();
+		sections.clear();
+		for (int i = 0; i < numSections; ++i)
+		{
+			Section section;
+			section.name = stream.readString();
+			section.hash = stream.readInt64();
+			const int size = stream.readInt();
+			if (size < 0 || size > stream.getNumBytesRemaining())
+			{
+				DBG("Plugin state truncated in section " << section.name);
+				return false;
+			}
+			stream.readIntoMemoryBlock(section.data, size);
+			sections.push_back(std::move(section));
+		}
+		return true;
+	}
+
+	static juce::ValueTree decodeSection(const Section& section)
+	{
+		return juce::ValueTree::readFromData(section.data.getData(), section.data.getSize());
+	}
+
+private:
+	struct CachedSection
+	{
+		juce::ValueTree tree;
+		Section section;
+		juce::uint32 lastUsed = 0;
+	};
+
+	static juce::int64 hashBytes(const juce::MemoryBlock& block)
+	{
+		// FNV-1a: stable across platforms and runs, unlike std::hash.
+		juce::uint64 hash = 14695981039346656037ull;
+		auto* bytes = static_cast<const juce::uint8*>(block.getData());
+		for (size_t i = 0; i < block.getSize(); ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return static_cast<juce::int64>(hash);
+	}
+
+	std::map<juce::String, CachedSection> cache;
+	juce::uint32 encodePass = 1;
+};
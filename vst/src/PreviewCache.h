@@ -0,0 +1,143 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <list>
+#include <memory>
+
+/*
+	Sample bank audition clip, decoded once and resampled to the host rate
+	so the preview voice only has to copy samples. Immutable after decode.
+*/
+struct PreviewClip
+{
+	juce::String sampleId;
+	juce::AudioBuffer<float> audio;
+	double sampleRate = 0.0;
+
+	size_t getSizeInBytes() const
+	{
+		return sizeof(float) * static_cast<size_t>(audio.getNumChannels()) * static_cast<size_t>(audio.getNumSamples());
+	}
+
+	/** Decodes to stereo at targetSampleRate; returns nullptr if the file cannot be read. */
+	static std::shared_ptr<const PreviewClip> decode(const juce::String& sampleId, const juce::File& file, double targetSampleRate)
+	{
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
+		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+		if (!reader || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+			return nullptr;
+
+		const int numSamples = static_cast<int>(reader->lengthInSamples);
+		juce::AudioBuffer<float> decoded(2, numSamples);
+		reader->read(&decoded, 0, numSamples, 0, true, true);
+		if (reader->numChannels == 1)
+			decoded.copyFrom(1, 0, decoded, 0, 0, numSamples);
+
+		auto clip = std::make_shared<PreviewClip>();
+		clip->sampleId = sampleId;
+		if (targetSampleRate <= 0.0 || std::abs(reader->sampleRate - targetSampleRate) < 1.0)
+		{
+			clip->audio = std::move(decoded);
+			clip->sampleRate = reader->sampleRate;
+			return clip;
+		}
+
+		const double ratio = targetSampleRate / reader->sampleRate;
+		const int outputSamples = static_cast<int>(numSamples * ratio);
+		clip->audio.setSize(2, outputSamples);
+		for (int channel = 0; channel < 2; ++channel)
+		{
+			juce::LagrangeInterpolator interpolator;
+			interpolator.process(1.0 / ratio, decoded.getReadPointer(channel), clip->audio.getWritePointer(channel),
+				outputSamples, numSamples, 0);
+		}
+		clip->sampleRate = targetSampleRate;
+		return clip;
+	}
+};
+
+/*
+	Least-recently-used set of decoded previews, bounded by total bytes.
+	Clips are shared, so evicting one that is still playing only drops the
+	cache's reference. Guarded by its own lock; never touched by the audio
+	thread.
+*/
+class PreviewCache
+{
+public:
+	static constexpr size_t defaultBudgetBytes = 256u * 1024u * 1024u;
+
+	std::shared_ptr<const PreviewClip> find(const juce::String& sampleId, double sampleRate)
+	{
+		juce::ScopedLock lock(cacheLock);
+		for (auto it = clips.begin(); it != clips.end(); ++it)
+		{
+			if ((*it)->sampleId == sampleId && std::abs((*it)->sampleRate - sampleRate) < 1.0)
+			{
+				clips.splice(clips.begin(), clips, it);
+				return clips.front();
+			}
+		}
+		return nullptr;
+	}
+
+	void insert(std::shared_ptr<const PreviewClip> clip)
+	{
+		if (!clip)
+			return;
+
+		juce::ScopedLock lock(cacheLock);
+		removeLocked(clip->sampleId);
+		totalBytes += clip->getSizeInBytes();
+		clips.push_front(std::move(clip));
+
+		// Always keep the newest clip, even if it alone exceeds the budget.
+		while (totalBytes > budgetBytes && clips.size() > 1)
+		{
+			totalBytes -= clips.back()->getSizeInBytes();
+			clips.pop_back();
+		}
+	}
+
+	void remove(const juce::String& sampleId)
+	{
+		juce::ScopedLock lock(cacheLock);
+		removeLocked(sampleId);
+	}
+
+	void clear()
+	{
+		juce::ScopedLock lock(cacheLock);
+		clips.clear();
+		totalBytes = 0;
+	}
+
+private:
+	void removeLocked(const juce::String& sampleId)
+	{
+		for (auto it = clips.begin(); it != clips.end();)
+		{
+			if ((*it)->sampleId == sampleId)
+			{
+				totalBytes -= (*it)->getSizeInBytes();
+				it = clips.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	juce::CriticalSection cacheLock;
+	std::list<std::shared_ptr<const PreviewClip>> clips;
+	size_t totalBytes = 0;
+	size_t budgetBytes = defaultBudgetBytes;
+};
@@ -0,0 +1,97 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "RealtimeAllocationGuard.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	thread_local int realtimeSectionDepth = 0;
+	std::atomic<uint64_t> realtimeAllocationCount{ 0 };
+}
+
+RealtimeAllocationGuard::ScopedSection::ScopedSection() noexcept
+{
+	++realtimeSectionDepth;
+}
+
+RealtimeAllocationGuard::ScopedSection::~ScopedSection() noexcept
+{
+	--realtimeSectionDepth;
+}
+
+bool RealtimeAllocationGuard::isInRealtimeSection() noexcept
+{
+	return realtimeSectionDepth > 0;
+}
+
+void RealtimeAllocationGuard::noteAllocation() noexcept
+{
+	if (realtimeSectionDepth > 0)
+	{
+		realtimeAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+uint64_t RealtimeAllocationGuard::getAllocationCount() noexcept
+{
+	return realtimeAllocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t RealtimeAllocationGuard::getAndResetAllocationCount() noexcept
+{
+	return realtimeAllocationCount.exchange(0, std::memory_order_relaxed);
+}
+
+#if OBSIDIAN_DETECT_RT_ALLOCATIONS
+
+void* operator new(std::size_t size)
+{
+	RealtimeAllocationGuard::noteAllocation();
+	if (void* ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	RealtimeAllocationGuard::noteAllocation();
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,39 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#ifndef OBSIDIAN_DETECT_RT_ALLOCATIONS
+#define OBSIDIAN_DETECT_RT_ALLOCATIONS 0
+#endif
+
+/*
+	Counts heap allocations made while the current thread is inside a
+	ScopedSection (i.e. processBlock). With OBSIDIAN_DETECT_RT_ALLOCATIONS
+	enabled, global operator new is routed through here as well; otherwise
+	only explicit noteAllocation() calls from our own buffer code are counted.
+*/
+class RealtimeAllocationGuard
+{
+public:
+	class ScopedSection
+	{
+	public:
+		ScopedSection() noexcept;
+		~ScopedSection() noexcept;
+
+		ScopedSection(const ScopedSection&) = delete;
+		ScopedSection& operator=(const ScopedSection&) = delete;
+	};
+
+	static bool isInRealtimeSection() noexcept;
+	static void noteAllocation() noexcept;
+	static uint64_t getAllocationCount() noexcept;
+	static uint64_t getAndResetAllocationCount() noexcept;
+};
@@ -0,0 +1,208 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "RenderWorkerPool.h"
+#include "RealtimeAllocationGuard.h"
+#include <thread>
+
+#if JUCE_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif JUCE_MAC || JUCE_IOS
+#include <dispatch/dispatch.h>
+#else
+#include <semaphore.h>
+#include <ctime>
+#endif
+
+// juce::WaitableEvent signals under a std::mutex, which the audio thread
+// must not take. These primitives post without one.
+RenderWorkerPool::WakeSignal::WakeSignal()
+{
+#if JUCE_WINDOWS
+	handle = CreateSemaphoreW(nullptr, 0, maxThreads, nullptr);
+#elif JUCE_MAC || JUCE_IOS
+	handle = dispatch_semaphore_create(0);
+#else
+	auto* semaphore = new sem_t;
+	sem_init(semaphore, 0, 0);
+	handle = semaphore;
+#endif
+}
+
+RenderWorkerPool::WakeSignal::~WakeSignal()
+{
+#if JUCE_WINDOWS
+	CloseHandle(static_cast<HANDLE>(handle));
+#elif JUCE_MAC || JUCE_IOS
+	dispatch_release(static_cast<dispatch_semaphore_t>(handle));
+#else
+	auto* semaphore = static_cast<sem_t*>(handle);
+	sem_destroy(semaphore);
+	delete semaphore;
+#endif
+}
+
+void RenderWorkerPool::WakeSignal::post() noexcept
+{
+#if JUCE_WINDOWS
+	ReleaseSemaphore(static_cast<HANDLE>(handle), 1, nullptr);
+#elif JUCE_MAC || JUCE_IOS
+	dispatch_semaphore_signal(static_cast<dispatch_semaphore_t>(handle));
+#else
+	sem_post(static_cast<sem_t*>(handle));
+#endif
+}
+
+void RenderWorkerPool::WakeSignal::wait(int timeoutMs) noexcept
+{
+	// A post that lands after a timeout leaves the count at one, which only
+	// costs the worker one extra pass round its loop.
+#if JUCE_WINDOWS
+	WaitForSingleObject(static_cast<HANDLE>(handle), static_cast<DWORD>(timeoutMs));
+#elif JUCE_MAC || JUCE_IOS
+	dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(handle),
+		dispatch_time(DISPATCH_TIME_NOW, static_cast<int64_t>(timeoutMs) * NSEC_PER_MSEC));
+#else
+	timespec deadline{};
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += timeoutMs / 1000;
+	deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec += 1;
+		deadline.tv_nsec -= 1000000000L;
+	}
+	sem_timedwait(static_cast<sem_t*>(handle), &deadline);
+#endif
+}
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+	for (auto& worker : workers)
+	{
+		if (worker)
+		{
+			worker->signalThreadShouldExit();
+			worker->wakeSignal.post();
+		}
+	}
+	for (auto& worker : workers)
+	{
+		if (worker)
+			worker->stopThread(1000);
+	}
+}
+
+void RenderWorkerPool::prepare(double sampleRate, int samplesPerBlock)
+{
+	preparedSampleRate = sampleRate;
+	preparedBlockSize = samplesPerBlock;
+	ensureWorkers(activeThreads.load() - 1);
+}
+
+void RenderWorkerPool::setNumThreads(int numThreads)
+{
+	numThreads = juce::jlimit(1, maxThreads, numThreads);
+	ensureWorkers(numThreads - 1);
+	activeThreads.store(numThreads);
+	DBG("Render threads: " << numThreads);
+}
+
+void RenderWorkerPool::ensureWorkers(int count)
+{
+	count = juce::jlimit(0, maxThreads - 1, count);
+	for (int i = numWorkers.load(); i < count; ++i)
+	{
+		auto worker = std::make_unique<Worker>(*this, i);
+		const auto options = juce::Thread::RealtimeOptions{}
+			.withApproximateAudioProcessingTime(preparedBlockSize, preparedSampleRate);
+		if (!worker->startRealtimeThread(options))
+		{
+			DBG("Render worker " << i << " could not get realtime priority");
+			worker->startThread(juce::Thread::Priority::highest);
+		}
+		workers[static_cast<size_t>(i)] = std::move(worker);
+		numWorkers.store(i + 1);
+	}
+}
+
+void RenderWorkerPool::run(TaskFunction task, void* context, int numTasks) noexcept
+{
+	const int threads = std::min(activeThreads.load(), numWorkers.load() + 1);
+	if (threads <= 1 || numTasks <= 1)
+	{
+		for (int i = 0; i < numTasks; ++i)
+			task(context, i);
+		return;
+	}
+
+	currentTask = task;
+	currentContext = context;
+	remainingTasks.store(numTasks);
+	generation = (generation + 1) & 0xffff;
+	work.store(packWork(generation, static_cast<juce::uint64>(numTasks)));
+
+	for (int i = 0; i < threads - 1; ++i)
+	{
+		auto& worker = *workers[static_cast<size_t>(i)];
+		if (worker.sleeping.load())
+			worker.wakeSignal.post();
+	}
+
+	runClaimedTasks();
+	while (remainingTasks.load(std::memory_order_acquire) > 0)
+		std::this_thread::yield();
+}
+
+void RenderWorkerPool::runClaimedTasks() noexcept
+{
+	for (;;)
+	{
+		const juce::uint64 claimed = work.fetch_add(1, std::memory_order_acq_rel);
+		const int index = static_cast<int>(claimed & 0xffffffffu);
+		const int count = static_cast<int>((claimed >> 32) & 0xffffu);
+		if (index >= count)
+			return;
+
+		currentTask(currentContext, index);
+		remainingTasks.fetch_sub(1, std::memory_order_acq_rel);
+	}
+}
+
+void RenderWorkerPool::Worker::run()
+{
+	RealtimeAllocationGuard::ScopedSection realtimeSection;
+	juce::uint64 seenGeneration = pool.work.load() >> 48;
+
+	while (!threadShouldExit())
+	{
+		// Spin across the gap between two blocks, then fall back to the
+		// semaphore so an idle plugin does not keep the cores busy.
+		juce::uint64 latest = pool.work.load(std::memory_order_acquire) >> 48;
+		for (int spin = 0; latest == seenGeneration && spin < spinIterations; ++spin)
+		{
+			std::this_thread::yield();
+			latest = pool.work.load(std::memory_order_acquire) >> 48;
+		}
+
+		if (latest == seenGeneration)
+		{
+			sleeping.store(true);
+			if ((pool.work.load() >> 48) == seenGeneration)
+				wakeSignal.wait(100);
+			sleeping.store(false);
+			continue;
+		}
+
+		seenGeneration = latest;
+		if (workerIndex + 1 < pool.activeThreads.load())
+			pool.runClaimedTasks();
+	}
+}
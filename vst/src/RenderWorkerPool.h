@@ -0,0 +1,97 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+/*
+	Fork/join pool for the audio thread. run() hands a batch of tasks to the
+	workers, takes tasks itself and returns once all of them have finished.
+	Workers are realtime threads that spin briefly after each batch and then
+	sleep on an OS semaphore. Posting one is an atomic increment plus, when a
+	worker is parked, a kernel wake; it takes no lock, so nothing on the
+	audio path locks or allocates.
+*/
+class RenderWorkerPool
+{
+public:
+	using TaskFunction = void (*)(void* context, int taskIndex);
+
+	static constexpr int maxThreads = 8;
+
+	RenderWorkerPool() = default;
+	~RenderWorkerPool();
+
+	/** Message thread. Threads are created on demand and kept until destruction. */
+	void prepare(double sampleRate, int samplesPerBlock);
+	void setNumThreads(int numThreads);
+	int getNumThreads() const { return activeThreads.load(); }
+
+	/** Audio thread. numThreads counts the caller, so 1 renders serially. */
+	void run(TaskFunction task, void* context, int numTasks) noexcept;
+
+private:
+	/** Counting semaphore over the platform primitive; post() never takes a mutex. */
+	class WakeSignal
+	{
+	public:
+		WakeSignal();
+		~WakeSignal();
+		void post() noexcept;
+		void wait(int timeoutMs) noexcept;
+
+	private:
+		void* handle = nullptr;
+
+		JUCE_DECLARE_NON_COPYABLE(WakeSignal)
+	};
+
+	class Worker : public juce::Thread
+	{
+	public:
+		Worker(RenderWorkerPool& owner, int index)
+			: juce::Thread("RenderWorker" + juce::String(index)), pool(owner), workerIndex(index) {
+		}
+		void run() override;
+
+		WakeSignal wakeSignal;
+		std::atomic<bool> sleeping{ false };
+
+	private:
+		RenderWorkerPool& pool;
+		const int workerIndex;
+	};
+
+	static constexpr int spinIterations = 4000;
+
+	void ensureWorkers(int count);
+	void runClaimedTasks() noexcept;
+
+	static juce::uint64 packWork(juce::uint64 generation, juce::uint64 numTasks)
+	{
+		return (generation << 48) | (numTasks << 32);
+	}
+
+	std::array<std::unique_ptr<Worker>, maxThreads - 1> workers;
+	std::atomic<int> numWorkers{ 0 };
+	std::atomic<int> activeThreads{ 1 };
+	double preparedSampleRate = 44100.0;
+	int preparedBlockSize = 512;
+
+	// generation:16 | numTasks:16 | nextTask:32, claimed with a single fetch_add
+	// so a task index is always read together with the batch it belongs to.
+	std::atomic<juce::uint64> work{ 0 };
+	std::atomic<int> remainingTasks{ 0 };
+	juce::uint64 generation = 0;
+	TaskFunction currentTask = nullptr;
+	void* currentContext = nullptr;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderWorkerPool)
+};
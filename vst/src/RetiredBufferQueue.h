@@ -0,0 +1,50 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <array>
+
+/*
+	Single-producer / single-consumer ring of audio buffers the audio thread
+	no longer needs. Retiring moves the buffer's storage into a slot, so the
+	audio thread neither frees nor allocates; the processor timer releases
+	the slots on the message thread.
+*/
+class RetiredBufferQueue
+{
+public:
+	static constexpr int capacity = 64;
+
+	/** Audio thread. Leaves buffer empty; returns false, keeping it, when the ring is full. */
+	bool retire(juce::AudioBuffer<float>& buffer) noexcept
+	{
+		if (buffer.getNumChannels() == 0)
+			return true;
+
+		const auto scope = fifo.write(1);
+		if (scope.blockSize1 + scope.blockSize2 == 0)
+			return false;
+
+		buffers[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = std::move(buffer);
+		return true;
+	}
+
+	/** Message thread. */
+	void collect()
+	{
+		const auto scope = fifo.read(fifo.getNumReady());
+		for (int i = 0; i < scope.blockSize1; ++i)
+			buffers[static_cast<size_t>(scope.startIndex1 + i)] = juce::AudioBuffer<float>();
+		for (int i = 0; i < scope.blockSize2; ++i)
+			buffers[static_cast<size_t>(scope.startIndex2 + i)] = juce::AudioBuffer<float>();
+	}
+
+private:
+	juce::AbstractFifo fifo{ capacity };
+	std::array<juce::AudioBuffer<float>, capacity> buffers;
+};
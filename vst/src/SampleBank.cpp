@@ -11,8 +11,17 @@ SampleBank::SampleBank()
 {
 	bankDirectory = getBankDirectory();
 	bankIndexFile = bankDirectory.getChildFile("sample_bank.json");
+	bankJournalFile = bankDirectory.getChildFile("sample_bank.journal");
 	ensureBankDirectoryExists();
 	loadBankData();
+	prober.startThread(juce::Thread::Priority::background);
+}
+
+SampleBank::~SampleBank()
+{
+	prober.signalThreadShouldExit();
+	probeAvailable.signal();
+	prober.stopThread(5000);
 }
 
 juce::String SampleBank::addSample(const juce::String& prompt,
@@ -65,15 +74,12 @@ juce::String SampleBank::addSample(const juce::String& prompt,
 
 	entry->filePath = destinationFile.getFullPathName();
 
-	analyzeSampleFile(entry.get(), destinationFile);
-
 	juce::String sampleId = entry->id;
+	samplesById[sampleId] = entry.get();
+	journalEntry(*entry);
 	samples.push_back(std::move(entry));
-
-	saveBankData();
-
-	if (onBankChanged)
-		onBankChanged();
+	queueProbe(sampleId);
+	notifyBankChanged();
 
 	DBG("Sample added to bank: " + sampleId + " -> " + destinationFile.getFileName());
 	return sampleId;
@@ -97,11 +103,15 @@ bool SampleBank::removeSample(const juce::String& sampleId)
 		sampleFile.deleteFile();
 	}
 
+	index.remove(it->get());
+	samplesById.erase(sampleId);
 	samples.erase(it);
-	saveBankData();
 
-	if (onBankChanged)
-		onBankChanged();
+	juce::DynamicObject::Ptr record = new juce::DynamicObject();
+	record->setProperty("op", "remove");
+	record->setProperty("id", sampleId);
+	appendJournalRecord(record.get());
+	notifyBankChanged();
 
 	return true;
 }
@@ -110,12 +120,8 @@ SampleBankEntry* SampleBank::getSample(const juce::String& sampleId)
 {
 	juce::ScopedLock lock(bankLock);
 
-	auto it = std::find_if(samples.begin(), samples.end(),
-		[&sampleId](const std::unique_ptr<SampleBankEntry>& entry) {
-			return entry->id == sampleId;
-		});
-
-	return (it != samples.end()) ? it->get() : nullptr;
+	auto it = samplesById.find(sampleId);
+	return (it != samplesById.end()) ? it->second : nullptr;
 }
 
 std::vector<SampleBankEntry*> SampleBank::getAllSamples()
@@ -130,6 +136,12 @@ std::vector<SampleBankEntry*> SampleBank::getAllSamples()
 	return result;
 }
 
+std::vector<SampleBankEntry*> SampleBank::query(const SampleQuery& query)
+{
+	juce::ScopedLock lock(bankLock);
+	return index.query(query);
+}
+
 std::vector<juce::String> SampleBank::getUnusedSamples() const
 {
 	juce::ScopedLock lock(bankLock);
@@ -170,7 +182,7 @@ void SampleBank::markSampleAsUsed(const juce::String& sampleId, const juce::Stri
 		if (std::find(projects.begin(), projects.end(), projectId) == projects.end())
 		{
 			projects.push_back(projectId);
-			saveBankData();
+			journalEntry(*entry);
 		}
 	}
 }
@@ -183,11 +195,23 @@ void SampleBank::markSampleAsUnused(const juce::String& sampleId, const juce::St
 	if (entry)
 	{
 		auto& projects = entry->usedInProjects;
-		projects.erase(std::remove(projects.begin(), projects.end(), projectId), projects.end());
-		saveBankData();
+		auto removed = std::remove(projects.begin(), projects.end(), projectId);
+		if (removed != projects.end())
+		{
+			projects.erase(removed, projects.end());
+			journalEntry(*entry);
+		}
 	}
 }
 
+void SampleBank::updateSample(const juce::String& sampleId)
+{
+	juce::ScopedLock lock(bankLock);
+
+	if (auto* entry = getSample(sampleId))
+		journalEntry(*entry);
+}
+
 juce::String SampleBank::createSafeFilename(const juce::String& prompt, const juce::Time& timestamp)
 {
 	juce::String snakePrompt = promptToSnakeCase(prompt);
@@ -220,18 +244,70 @@ juce::String SampleBank::promptToSnakeCase(const juce::String& prompt)
 	return result.isEmpty() ? "sample" : result;
 }
 
-void SampleBank::analyzeSampleFile(SampleBankEntry* entry, const juce::File& audioFile)
+void SampleBank::queueProbe(const juce::String& sampleId)
 {
+	juce::ScopedLock lock(bankLock);
+	pendingProbes.add(sampleId);
+	probeAvailable.signal();
+}
+
+bool SampleBank::probeNextSample()
+{
+	juce::String sampleId;
+	juce::File audioFile;
+	{
+		juce::ScopedLock lock(bankLock);
+		if (pendingProbes.isEmpty())
+			return false;
+
+		sampleId = pendingProbes[0];
+		pendingProbes.remove(0);
+		auto* entry = getSample(sampleId);
+		if (!entry)
+			return true;
+		audioFile = juce::File(entry->filePath);
+	}
+
 	juce::AudioFormatManager formatManager;
 	formatManager.registerBasicFormats();
 
 	std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
-	if (reader)
+	if (!reader)
+		return true;
+
+	juce::ScopedLock lock(bankLock);
+	// The entry may have been removed while the file was open.
+	if (auto* entry = getSample(sampleId))
 	{
 		entry->duration = static_cast<float>(reader->lengthInSamples / reader->sampleRate);
 		entry->sampleRate = reader->sampleRate;
 		entry->numChannels = reader->numChannels;
 		entry->numSamples = static_cast<int>(reader->lengthInSamples);
+		journalEntry(*entry);
+	}
+	return true;
+}
+
+void SampleBank::notifyBankChanged()
+{
+	// Delivered asynchronously on the message thread; a bank deleted first
+	// simply cancels the pending message.
+	sendChangeMessage();
+}
+
+void SampleBank::MetadataProber::run()
+{
+	while (!threadShouldExit())
+	{
+		bool probedAny = false;
+		while (!threadShouldExit() && bank.probeNextSample())
+			probedAny = true;
+
+		// The probed fields were published under bankLock in probeNextSample.
+		if (probedAny)
+			bank.notifyBankChanged();
+
+		bank.probeAvailable.wait(-1);
 	}
 }
 
@@ -250,125 +326,340 @@ void SampleBank::ensureBankDirectoryExists()
 	}
 }
 
-void SampleBank::saveBankData()
+juce::var SampleBank::entryToVar(const SampleBankEntry& entry)
 {
-	juce::DynamicObject::Ptr bankData = new juce::DynamicObject();
-	juce::Array<juce::var> samplesArray;
+	juce::DynamicObject::Ptr sampleData = new juce::DynamicObject();
+	sampleData->setProperty("id", entry.id);
+	sampleData->setProperty("filename", entry.filename);
+	sampleData->setProperty("originalPrompt", entry.originalPrompt);
+	sampleData->setProperty("filePath", entry.filePath);
+	sampleData->setProperty("creationTime", entry.creationTime.toMilliseconds());
+	sampleData->setProperty("duration", entry.duration);
+	sampleData->setProperty("bpm", entry.bpm);
+	sampleData->setProperty("key", entry.key);
+	sampleData->setProperty("sampleRate", entry.sampleRate);
+	sampleData->setProperty("numChannels", entry.numChannels);
+	sampleData->setProperty("numSamples", entry.numSamples);
+	juce::Array<juce::var> categoriesArray;
+	for (const auto& category : entry.categories)
+		categoriesArray.add(category);
+	sampleData->setProperty("categories", categoriesArray);
+
+	juce::Array<juce::var> stemsArray;
+	for (const auto& stem : entry.stems)
+		stemsArray.add(stem);
+	sampleData->setProperty("stems", stemsArray);
+
+	juce::Array<juce::var> projectsArray;
+	for (const auto& project : entry.usedInProjects)
+		projectsArray.add(project);
+	sampleData->setProperty("usedInProjects", projectsArray);
+
+	return sampleData.get();
+}
 
-	for (const auto& entry : samples)
+std::unique_ptr<SampleBankEntry> SampleBank::entryFromVar(const juce::var& sampleVar)
+{
+	auto* sampleObj = sampleVar.getDynamicObject();
+	if (!sampleObj)
+		return nullptr;
+
+	auto entry = std::make_unique<SampleBankEntry>();
+	entry->id = sampleObj->getProperty("id").toString();
+	entry->filename = sampleObj->getProperty("filename").toString();
+	entry->originalPrompt = sampleObj->getProperty("originalPrompt").toString();
+	entry->filePath = sampleObj->getProperty("filePath").toString();
+	auto creationTimeVar = sampleObj->getProperty("creationTime");
+	entry->creationTime = juce::Time(creationTimeVar.isVoid() ? 0 : (juce::int64)creationTimeVar);
+	entry->duration = static_cast<float>(sampleObj->getProperty("duration"));
+	entry->bpm = static_cast<float>(sampleObj->getProperty("bpm"));
+	entry->key = sampleObj->getProperty("key").toString();
+	entry->sampleRate = sampleObj->getProperty("sampleRate");
+	entry->numChannels = sampleObj->getProperty("numChannels");
+	entry->numSamples = sampleObj->getProperty("numSamples");
+
+	auto categoriesVar = sampleObj->getProperty("categories");
+	if (categoriesVar.isArray())
 	{
-		juce::DynamicObject::Ptr sampleData = new juce::DynamicObject();
-		sampleData->setProperty("id", entry->id);
-		sampleData->setProperty("filename", entry->filename);
-		sampleData->setProperty("originalPrompt", entry->originalPrompt);
-		sampleData->setProperty("filePath", entry->filePath);
-		sampleData->setProperty("creationTime", entry->creationTime.toMilliseconds());
-		sampleData->setProperty("duration", entry->duration);
-		sampleData->setProperty("bpm", entry->bpm);
-		sampleData->setProperty("key", entry->key);
-		sampleData->setProperty("sampleRate", entry->sampleRate);
-		sampleData->setProperty("numChannels", entry->numChannels);
-		sampleData->setProperty("numSamples", entry->numSamples);
-		juce::Array<juce::var> categoriesArray;
-		for (const auto& category : entry->categories)
-			categoriesArray.add(category);
-		sampleData->setProperty("categories", categoriesArray);
-
-		juce::Array<juce::var> stemsArray;
-		for (const auto& stem : entry->stems)
-			stemsArray.add(stem);
-		sampleData->setProperty("stems", stemsArray);
-
-		juce::Array<juce::var> projectsArray;
-		for (const auto& project : entry->usedInProjects)
-			projectsArray.add(project);
-		sampleData->setProperty("usedInProjects", projectsArray);
-
-		samplesArray.add(sampleData.get());
+		auto* categoriesArray = categoriesVar.getArray();
+		for (int j = 0; j < categoriesArray->size(); ++j)
+			entry->categories.push_back(categoriesArray->getUnchecked(j).toString());
 	}
 
-	bankData->setProperty("samples", samplesArray);
-	bankData->setProperty("version", "1.0");
+	auto stemsVar = sampleObj->getProperty("stems");
+	if (stemsVar.isArray())
+	{
+		auto* stemsArray = stemsVar.getArray();
+		for (int j = 0; j < stemsArray->size(); ++j)
+			entry->stems.push_back(stemsArray->getUnchecked(j).toString());
+	}
 
-	juce::String jsonString = juce::JSON::toString(juce::var(bankData.get()));
-	bankIndexFile.replaceWithText(jsonString);
+	auto projectsVar = sampleObj->getProperty("usedInProjects");
+	if (projectsVar.isArray())
+	{
+		auto* projectsArray = projectsVar.getArray();
+		for (int j = 0; j < projectsArray->size(); ++j)
+			entry->usedInProjects.push_back(projectsArray->getUnchecked(j).toString());
+	}
+
+	if (entry->id.isEmpty())
+		return nullptr;
+	return entry;
 }
 
-void SampleBank::loadBankData()
+void SampleBank::journalEntry(SampleBankEntry& entry)
+{
+	// Every persisted change also refreshes the entry's index keys.
+	index.update(&entry);
+
+	juce::DynamicObject::Ptr record = new juce::DynamicObject();
+	record->setProperty("op", "put");
+	record->setProperty("sample", entryToVar(entry));
+	appendJournalRecord(record.get());
+}
+
+void SampleBank::appendJournalRecord(const juce::var& record)
 {
 	juce::ScopedLock lock(bankLock);
-	if (!bankIndexFile.exists())
-		return;
 
-	juce::var bankJson = juce::JSON::parse(bankIndexFile);
-	if (!bankJson.isObject())
-		return;
+	if (auto* object = record.getDynamicObject())
+		object->setProperty("writer", writerId);
 
-	auto* bankObj = bankJson.getDynamicObject();
-	if (!bankObj)
-		return;
+	bool appended;
+	{
+		const juce::InterProcessLock::ScopedLockType fileGuard(fileLock);
+		appended = bankJournalFile.appendText(juce::JSON::toString(record, true) + "\n");
+	}
 
-	auto samplesVar = bankObj->getProperty("samples");
-	if (!samplesVar.isArray())
+	if (!appended)
+	{
+		DBG("Failed to append to sample bank journal, writing snapshot instead");
+		saveBankData();
 		return;
+	}
 
-	auto* samplesArray = samplesVar.getArray();
-	samples.clear();
+	if (++journalRecords > compactThreshold)
+		saveBankData();
+}
+
+bool SampleBank::mergeForeignJournalRecords()
+{
+	if (!bankJournalFile.exists())
+		return false;
 
-	for (int i = 0; i < samplesArray->size(); ++i)
+	std::vector<juce::var> records;
+	juce::StringArray lines;
+	bankJournalFile.readLines(lines);
+	for (const auto& line : lines)
 	{
-		auto sampleVar = samplesArray->getUnchecked(i);
-		if (!sampleVar.isObject())
+		juce::var record;
+		if (line.isNotEmpty() && juce::JSON::parse(line, record).wasOk())
+			records.push_back(record);
+	}
+
+	auto recordSampleId = [](const juce::var& record)
+		{
+			if (record.getProperty("op", {}).toString() == "remove")
+				return record.getProperty("id", {}).toString();
+			return record.getProperty("sample", {}).getProperty("id", {}).toString();
+		};
+
+	// Memory already holds our own records, so a foreign record only applies
+	// when it is newer than the last one we wrote for the same sample.
+	std::map<juce::String, size_t> lastOwnRecord;
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		if (records[i].getProperty("writer", {}).toString() == writerId)
+			lastOwnRecord[recordSampleId(records[i])] = i;
+	}
+
+	bool changed = false;
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		const auto& record = records[i];
+		if (record.getProperty("writer", {}).toString() == writerId)
 			continue;
 
-		auto* sampleObj = sampleVar.getDynamicObject();
-		if (!sampleObj)
+		const auto sampleId = recordSampleId(record);
+		const auto own = lastOwnRecord.find(sampleId);
+		if (own != lastOwnRecord.end() && own->second > i)
 			continue;
 
-		auto entry = std::make_unique<SampleBankEntry>();
-		entry->id = sampleObj->getProperty("id").toString();
-		entry->filename = sampleObj->getProperty("filename").toString();
-		entry->originalPrompt = sampleObj->getProperty("originalPrompt").toString();
-		entry->filePath = sampleObj->getProperty("filePath").toString();
-		auto creationTimeVar = sampleObj->getProperty("creationTime");
-		entry->creationTime = juce::Time(creationTimeVar.isVoid() ? 0 : (juce::int64)creationTimeVar);
-		entry->duration = static_cast<float>(sampleObj->getProperty("duration"));
-		entry->bpm = static_cast<float>(sampleObj->getProperty("bpm"));
-		entry->key = sampleObj->getProperty("key").toString();
-		entry->sampleRate = sampleObj->getProperty("sampleRate");
-		entry->numChannels = sampleObj->getProperty("numChannels");
-		entry->numSamples = sampleObj->getProperty("numSamples");
-
-		auto categoriesVar = sampleObj->getProperty("categories");
-		if (categoriesVar.isArray())
+		if (record.getProperty("op", {}).toString() == "remove")
 		{
-			auto* categoriesArray = categoriesVar.getArray();
-			for (int j = 0; j < categoriesArray->size(); ++j)
-				entry->categories.push_back(categoriesArray->getUnchecked(j).toString());
+			auto it = std::find_if(samples.begin(), samples.end(),
+				[&sampleId](const std::unique_ptr<SampleBankEntry>& entry) { return entry->id == sampleId; });
+			if (it != samples.end())
+			{
+				index.remove(it->get());
+				samplesById.erase(sampleId);
+				samples.erase(it);
+				changed = true;
+			}
+			continue;
 		}
 
-		auto stemsVar = sampleObj->getProperty("stems");
-		if (stemsVar.isArray())
+		auto entry = entryFromVar(record.getProperty("sample", {}));
+		if (!entry || !juce::File(entry->filePath).exists())
+			continue;
+
+		auto existing = samplesById.find(entry->id);
+		if (existing != samplesById.end())
+		{
+			*existing->second = *entry;
+		}
+		else
+		{
+			samplesById[entry->id] = entry.get();
+			samples.push_back(std::move(entry));
+		}
+		changed = true;
+	}
+	return changed;
+}
+
+void SampleBank::saveBankData()
+{
+	juce::ScopedLock lock(bankLock);
+	const juce::InterProcessLock::ScopedLockType fileGuard(fileLock);
+
+	// Another process may have appended since we loaded; deleting the
+	// journal without folding those records in would lose them.
+	const bool merged = mergeForeignJournalRecords();
+
+	// Callers edit entries in bulk before saving, so re-index them all.
+	index.clear();
+	for (const auto& entry : samples)
+		index.add(entry.get());
+
+	juce::DynamicObject::Ptr bankData = new juce::DynamicObject();
+	juce::Array<juce::var> samplesArray;
+	samplesArray.ensureStorageAllocated(static_cast<int>(samples.size()));
+
+	for (const auto& entry : samples)
+		samplesArray.add(entryToVar(*entry));
+
+	bankData->setProperty("samples", samplesArray);
+	bankData->setProperty("version", "1.0");
+
+	// Replace the snapshot atomically so a crash never leaves it half written.
+	juce::TemporaryFile snapshot(bankIndexFile);
+	if (!snapshot.getFile().replaceWithText(juce::JSON::toString(juce::var(bankData.get())))
+		|| !snapshot.overwriteTargetFileWithTemporary())
+	{
+		DBG("Failed to write sample bank snapshot");
+		return;
+	}
+
+	bankJournalFile.deleteFile();
+	journalRecords = 0;
+
+	if (merged)
+		notifyBankChanged();
+}
+
+void SampleBank::loadBankData()
+{
+	// Parse outside the lock; only the final swap blocks other callers.
+	std::vector<std::unique_ptr<SampleBankEntry>> loaded;
+	std::map<juce::String, size_t> loadedIndex;
+
+	auto putEntry = [&loaded, &loadedIndex](std::unique_ptr<SampleBankEntry> entry)
+		{
+			auto it = loadedIndex.find(entry->id);
+			if (it != loadedIndex.end())
+			{
+				loaded[it->second] = std::move(entry);
+			}
+			else
+			{
+				loadedIndex[entry->id] = loaded.size();
+				loaded.push_back(std::move(entry));
+			}
+		};
+
+	// Held while reading so a compaction elsewhere cannot swap the snapshot
+	// between our reads of it and of the journal.
+	fileLock.enter();
+
+	if (bankIndexFile.exists())
+	{
+		juce::var bankJson = juce::JSON::parse(bankIndexFile);
+		if (auto* samplesArray = bankJson.getProperty("samples", {}).getArray())
 		{
-			auto* stemsArray = stemsVar.getArray();
-			for (int j = 0; j < stemsArray->size(); ++j)
-				entry->stems.push_back(stemsArray->getUnchecked(j).toString());
+			loaded.reserve(static_cast<size_t>(samplesArray->size()));
+			for (const auto& sampleVar : *samplesArray)
+			{
+				if (auto entry = entryFromVar(sampleVar))
+					putEntry(std::move(entry));
+			}
 		}
+	}
 
-		auto projectsVar = sampleObj->getProperty("usedInProjects");
-		if (projectsVar.isArray())
+	int records = 0;
+	if (bankJournalFile.exists())
+	{
+		juce::StringArray lines;
+		bankJournalFile.readLines(lines);
+		for (const auto& line : lines)
 		{
-			auto* projectsArray = projectsVar.getArray();
-			for (int j = 0; j < projectsArray->size(); ++j)
-				entry->usedInProjects.push_back(projectsArray->getUnchecked(j).toString());
+			if (line.isEmpty())
+				continue;
+
+			// A torn last line from an interrupted append simply fails to parse.
+			juce::var record;
+			if (juce::JSON::parse(line, record).failed())
+				continue;
+
+			++records;
+			const juce::String op = record.getProperty("op", {}).toString();
+			if (op == "put")
+			{
+				if (auto entry = entryFromVar(record.getProperty("sample", {})))
+					putEntry(std::move(entry));
+			}
+			else if (op == "remove")
+			{
+				auto it = loadedIndex.find(record.getProperty("id", {}).toString());
+				if (it != loadedIndex.end())
+				{
+					loaded[it->second].reset();
+					loadedIndex.erase(it);
+				}
+			}
 		}
+	}
+
+	fileLock.exit();
 
-		juce::File sampleFile(entry->filePath);
-		if (sampleFile.exists())
+	juce::StringArray unprobed;
+	{
+		juce::ScopedLock lock(bankLock);
+		samples.clear();
+		samplesById.clear();
+		index.clear();
+
+		for (auto& entry : loaded)
 		{
+			if (!entry || !juce::File(entry->filePath).exists())
+				continue;
+
+			if (entry->numSamples <= 0)
+				unprobed.add(entry->id);
+			samplesById[entry->id] = entry.get();
+			index.add(entry.get());
 			samples.push_back(std::move(entry));
 		}
+
+		journalRecords = records;
+		pendingProbes.addArray(unprobed);
 	}
 
-	DBG("Loaded " + juce::String(samples.size()) + " samples from bank");
-}
\ No newline at end of file
+	if (!unprobed.isEmpty())
+		probeAvailable.signal();
+
+	DBG("Loaded " + juce::String(samples.size()) + " samples from bank (" + juce::String(records) + " journal records)");
+
+	if (records > compactThreshold)
+		saveBankData();
+}
@@ -7,8 +7,10 @@
 
 #pragma once
 #include "JuceHeader.h"
+#include "SampleBankIndex.h"
 #include <vector>
 #include <memory>
+#include <map>
 
 struct SampleBankEntry
 {
@@ -34,11 +36,27 @@ struct SampleBankEntry
 	}
 };
 
-class SampleBank
+/*
+	The index is a snapshot (sample_bank.json) plus an append-only journal
+	(sample_bank.journal) holding one JSON record per line. Every change
+	appends a single "put" or "remove" record instead of rewriting the whole
+	bank; loading replays the journal over the snapshot, and the journal is
+	folded back into the snapshot once it grows past compactThreshold.
+
+	One bank lives in SharedResources for the whole process. Hosts that run
+	plugins in several processes still share the files, so appends and
+	compaction hold an InterProcessLock, records carry their writer's id and
+	compaction first folds in what other processes appended.
+
+	Audio metadata (duration, rate, channels, length) is probed on a
+	background thread, so adding a sample never opens the file on the
+	caller's thread.
+*/
+class SampleBank : public juce::ChangeBroadcaster
 {
 public:
 	SampleBank();
-	~SampleBank() = default;
+	~SampleBank();
 
 	juce::String addSample(const juce::String& prompt,
 		const juce::File& audioFile,
@@ -49,28 +67,64 @@ public:
 	bool removeSample(const juce::String& sampleId);
 	SampleBankEntry* getSample(const juce::String& sampleId);
 	std::vector<SampleBankEntry*> getAllSamples();
+	/** Filtered and sorted through the secondary indexes. */
+	std::vector<SampleBankEntry*> query(const SampleQuery& query);
 
 	std::vector<juce::String> getUnusedSamples() const;
 	int removeUnusedSamples();
 	void markSampleAsUsed(const juce::String& sampleId, const juce::String& projectId);
 	void markSampleAsUnused(const juce::String& sampleId, const juce::String& projectId);
+	/** Journals the current state of one entry after it was edited in place. */
+	void updateSample(const juce::String& sampleId);
 
+	/** Writes a full snapshot and clears the journal. */
 	void saveBankData();
 	void loadBankData();
 
-	std::function<void()> onBankChanged;
+	static juce::File getBankDirectory();
+
+	// Listeners are called on the message thread, whichever thread changed the bank.
 
 private:
+	class MetadataProber : public juce::Thread
+	{
+	public:
+		explicit MetadataProber(SampleBank& owner) : juce::Thread("SampleBankProber"), bank(owner) {}
+		void run() override;
+
+	private:
+		SampleBank& bank;
+	};
+
+	static constexpr int compactThreshold = 512;
+
 	std::vector<std::unique_ptr<SampleBankEntry>> samples;
+	std::map<juce::String, SampleBankEntry*> samplesById;
+	SampleBankIndex index;
 	juce::File bankDirectory;
 	juce::File bankIndexFile;
+	juce::File bankJournalFile;
 	juce::CriticalSection bankLock;
+	int journalRecords = 0;
+	juce::InterProcessLock fileLock{ "ObsidianNeuralSampleBank" };
+	const juce::String writerId = juce::Uuid().toString();
+
+	juce::StringArray pendingProbes;
+	juce::WaitableEvent probeAvailable;
+	MetadataProber prober{ *this };
 
 	juce::String createSafeFilename(const juce::String& prompt, const juce::Time& timestamp);
 	juce::String promptToSnakeCase(const juce::String& prompt);
-	void analyzeSampleFile(SampleBankEntry* entry, const juce::File& audioFile);
-	juce::File getBankDirectory();
+	bool probeNextSample();
+	void queueProbe(const juce::String& sampleId);
+	void notifyBankChanged();
+	void appendJournalRecord(const juce::var& record);
+	void journalEntry(SampleBankEntry& entry);
+	bool mergeForeignJournalRecords();
 	void ensureBankDirectoryExists();
 
+	static juce::var entryToVar(const SampleBankEntry& entry);
+	static std::unique_ptr<SampleBankEntry> entryFromVar(const juce::var& sampleVar);
+
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleBank)
 };
\ No newline at end of file
@@ -0,0 +1,221 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "SampleBankIndex.h"
+#include "SampleBank.h"
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+juce::StringArray SampleBankIndex::tokenize(const juce::String& text)
+{
+	auto tokens = juce::StringArray::fromTokens(text.toLowerCase(), " \t\r\n_-,.;:!?()[]{}\"'/\\&+", "");
+	tokens.removeEmptyStrings();
+	tokens.removeDuplicates(false);
+	return tokens;
+}
+
+SampleBankIndex::Keys SampleBankIndex::extractKeys(const SampleBankEntry& entry)
+{
+	Keys keys;
+	keys.bpm = entry.bpm;
+	keys.duration = entry.duration;
+	keys.creationTime = entry.creationTime.toMilliseconds();
+	keys.usage = static_cast<int>(entry.usedInProjects.size());
+	keys.id = entry.id;
+	keys.prompt = entry.originalPrompt.toLowerCase();
+	keys.key = entry.key;
+	keys.categories = entry.categories;
+	keys.tokens = tokenize(entry.originalPrompt);
+	return keys;
+}
+
+void SampleBankIndex::add(SampleBankEntry* entry)
+{
+	if (entry == nullptr || indexedKeys.count(entry) > 0)
+		return;
+
+	Keys keys = extractKeys(*entry);
+	byCreationTime.emplace(std::make_pair(keys.creationTime, keys.id), entry);
+	byPrompt.emplace(std::make_pair(keys.prompt, keys.id), entry);
+	byUsage.emplace(std::make_pair(keys.usage, keys.id), entry);
+	byBpm.emplace(std::make_pair(keys.bpm, keys.id), entry);
+	byDuration.emplace(std::make_pair(keys.duration, keys.id), entry);
+	for (const auto& category : keys.categories)
+		byCategory[category].insert(entry);
+	if (keys.key.isNotEmpty())
+		byKey[keys.key].insert(entry);
+	for (const auto& token : keys.tokens)
+		byToken[token].insert(entry);
+
+	indexedKeys.emplace(entry, std::move(keys));
+}
+
+void SampleBankIndex::eraseFrom(std::map<juce::String, Postings>& inverted, const juce::String& term, SampleBankEntry* entry)
+{
+	auto it = inverted.find(term);
+	if (it == inverted.end())
+		return;
+
+	it->second.erase(entry);
+	if (it->second.empty())
+		inverted.erase(it);
+}
+
+void SampleBankIndex::remove(SampleBankEntry* entry)
+{
+	auto found = indexedKeys.find(entry);
+	if (found == indexedKeys.end())
+		return;
+
+	const Keys& keys = found->second;
+	eraseFrom(byCreationTime, keys.creationTime, keys.id, entry);
+	eraseFrom(byPrompt, keys.prompt, keys.id, entry);
+	eraseFrom(byUsage, keys.usage, keys.id, entry);
+	eraseFrom(byBpm, keys.bpm, keys.id, entry);
+	eraseFrom(byDuration, keys.duration, keys.id, entry);
+	for (const auto& category : keys.categories)
+		eraseFrom(byCategory, category, entry);
+	eraseFrom(byKey, keys.key, entry);
+	for (const auto& token : keys.tokens)
+		eraseFrom(byToken, token, entry);
+
+	indexedKeys.erase(found);
+}
+
+void SampleBankIndex::update(SampleBankEntry* entry)
+{
+	remove(entry);
+	add(entry);
+}
+
+void SampleBankIndex::clear()
+{
+	indexedKeys.clear();
+	byCreationTime.clear();
+	byPrompt.clear();
+	byUsage.clear();
+	byBpm.clear();
+	byDuration.clear();
+	byCategory.clear();
+	byKey.clear();
+	byToken.clear();
+}
+
+bool SampleBankIndex::matchesRanges(const Keys& keys, const SampleQuery& query) const
+{
+	if (query.minBpm > 0.0f && keys.bpm < query.minBpm) return false;
+	if (query.maxBpm > 0.0f && keys.bpm > query.maxBpm) return false;
+	if (query.minDuration > 0.0f && keys.duration < query.minDuration) return false;
+	if (query.maxDuration > 0.0f && keys.duration > query.maxDuration) return false;
+	return true;
+}
+
+/*
+	Ties are broken on id in the sort's direction, which is the order the
+	ordered indexes (keyed by value and id) are walked in, so a query gives
+	the same order whichever path resolves it.
+*/
+bool SampleBankIndex::comesBefore(const Keys& a, const Keys& b, SampleQuery::Sort sort) const
+{
+	switch (sort)
+	{
+	case SampleQuery::Sort::Newest: return std::tie(b.creationTime, b.id) < std::tie(a.creationTime, a.id);
+	case SampleQuery::Sort::Prompt: return std::tie(a.prompt, a.id) < std::tie(b.prompt, b.id);
+	case SampleQuery::Sort::Usage: return std::tie(b.usage, b.id) < std::tie(a.usage, a.id);
+	case SampleQuery::Sort::Bpm: return std::tie(b.bpm, b.id) < std::tie(a.bpm, a.id);
+	case SampleQuery::Sort::Duration: return std::tie(b.duration, b.id) < std::tie(a.duration, a.id);
+	}
+	return false;
+}
+
+std::vector<SampleBankEntry*> SampleBankIndex::query(const SampleQuery& query) const
+{
+	// Candidates stay sorted by pointer so the posting sets intersect linearly.
+	std::vector<SampleBankEntry*> candidates;
+	bool filtered = false;
+
+	auto intersect = [&candidates, &filtered](const Postings& postings)
+		{
+			if (!filtered)
+			{
+				candidates.assign(postings.begin(), postings.end());
+				filtered = true;
+				return;
+			}
+			std::vector<SampleBankEntry*> narrowed;
+			std::set_intersection(candidates.begin(), candidates.end(), postings.begin(), postings.end(),
+				std::back_inserter(narrowed));
+			candidates.swap(narrowed);
+		};
+
+	if (query.category.isNotEmpty())
+	{
+		auto it = byCategory.find(query.category);
+		if (it == byCategory.end())
+			return {};
+		intersect(it->second);
+	}
+
+	if (query.key.isNotEmpty())
+	{
+		auto it = byKey.find(query.key);
+		if (it == byKey.end())
+			return {};
+		intersect(it->second);
+	}
+
+	for (const auto& word : tokenize(query.text))
+	{
+		Postings matches;
+		for (auto it = byToken.lower_bound(word); it != byToken.end() && it->first.startsWith(word); ++it)
+			matches.insert(it->second.begin(), it->second.end());
+		if (matches.empty())
+			return {};
+		intersect(matches);
+	}
+
+	std::vector<SampleBankEntry*> result;
+
+	if (filtered && candidates.size() * 8 < indexedKeys.size())
+	{
+		for (auto* entry : candidates)
+		{
+			if (matchesRanges(indexedKeys.at(entry), query))
+				result.push_back(entry);
+		}
+		std::stable_sort(result.begin(), result.end(),
+			[this, &query](SampleBankEntry* a, SampleBankEntry* b)
+			{
+				return comesBefore(indexedKeys.at(a), indexedKeys.at(b), query.sort);
+			});
+		return result;
+	}
+
+	result.reserve(filtered ? candidates.size() : indexedKeys.size());
+	auto collect = [this, &query, &candidates, filtered, &result](auto begin, auto end)
+		{
+			for (auto it = begin; it != end; ++it)
+			{
+				SampleBankEntry* entry = it->second;
+				if (filtered && !std::binary_search(candidates.begin(), candidates.end(), entry))
+					continue;
+				if (matchesRanges(indexedKeys.at(entry), query))
+					result.push_back(entry);
+			}
+		};
+
+	switch (query.sort)
+	{
+	case SampleQuery::Sort::Newest: collect(byCreationTime.rbegin(), byCreationTime.rend()); break;
+	case SampleQuery::Sort::Prompt: collect(byPrompt.begin(), byPrompt.end()); break;
+	case SampleQuery::Sort::Usage: collect(byUsage.rbegin(), byUsage.rend()); break;
+	case SampleQuery::Sort::Bpm: collect(byBpm.rbegin(), byBpm.rend()); break;
+	case SampleQuery::Sort::Duration: collect(byDuration.rbegin(), byDuration.rend()); break;
+	}
+	return result;
+}
@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+struct SampleBankEntry;
+
+struct SampleQuery
+{
+	enum class Sort
+	{
+		Newest,
+		Prompt,
+		Usage,
+		Bpm,
+		Duration
+	};
+
+	Sort sort = Sort::Prompt;
+	/** Every word must prefix-match a word of the prompt. */
+	juce::String text;
+	juce::String category;
+	juce::String key;
+	/** Zero leaves that side of the range open. */
+	float minBpm = 0.0f;
+	float maxBpm = 0.0f;
+	float minDuration = 0.0f;
+	float maxDuration = 0.0f;
+};
+
+/*
+	Secondary indexes over the bank: one ordered index per sort key and
+	inverted indexes for categories, musical key and prompt words. Each
+	entry's indexed values are kept alongside so it can be removed even
+	after it was edited in place.
+
+	Filters are resolved by intersecting posting sets; a small result is
+	sorted directly, a large one is read back in order by walking the index
+	of the requested sort key. Not thread-safe: SampleBank holds bankLock.
+*/
+class SampleBankIndex
+{
+public:
+	void add(SampleBankEntry* entry);
+	void remove(SampleBankEntry* entry);
+	void update(SampleBankEntry* entry);
+	void clear();
+
+	std::vector<SampleBankEntry*> query(const SampleQuery& query) const;
+	size_t size() const { return indexedKeys.size(); }
+
+	static juce::StringArray tokenize(const juce::String& text);
+
+private:
+	struct Keys
+	{
+		float bpm = 0.0f;
+		float duration = 0.0f;
+		juce::int64 creationTime = 0;
+		int usage = 0;
+		juce::String id;
+		juce::String prompt;
+		juce::String key;
+		std::vector<juce::String> categories;
+		juce::StringArray tokens;
+	};
+
+	using Postings = std::set<SampleBankEntry*>;
+	template <typename KeyType>
+	using Ordered = std::multimap<std::pair<KeyType, juce::String>, SampleBankEntry*>;
+
+	template <typename KeyType>
+	static void eraseFrom(Ordered<KeyType>& ordered, const KeyType& key, const juce::String& id, SampleBankEntry* entry)
+	{
+		auto range = ordered.equal_range({ key, id });
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second == entry)
+			{
+				ordered.erase(it);
+				return;
+			}
+		}
+	}
+
+	static void eraseFrom(std::map<juce::String, Postings>& inverted, const juce::String& term, SampleBankEntry* entry);
+	static Keys extractKeys(const SampleBankEntry& entry);
+	bool matchesRanges(const Keys& keys, const SampleQuery& query) const;
+	bool comesBefore(const Keys& a, const Keys& b, SampleQuery::Sort sort) const;
+
+	std::map<SampleBankEntry*, Keys> indexedKeys;
+	Ordered<juce::int64> byCreationTime;
+	Ordered<juce::String> byPrompt;
+	Ordered<int> byUsage;
+	Ordered<float> byBpm;
+	Ordered<float> byDuration;
+	std::map<juce::String, Postings> byCategory;
+	std::map<juce::String, Postings> byKey;
+	std::map<juce::String, Postings> byToken;
+};
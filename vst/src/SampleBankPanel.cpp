@@ -73,13 +73,18 @@ SampleBankItem::~SampleBankItem()
 }
 
 int SampleBankItem::getRequiredHeight()
+{
+	return getRequiredHeight(sampleEntry);
+}
+
+int SampleBankItem::getRequiredHeight(const SampleBankEntry* entry)
 {
 	const int labelsHeight = 16 + 16 + 4;
 	const int waveformHeight = 30;
 	const int margins = 16;
 	const int baseHeight = labelsHeight + waveformHeight + margins;
 
-	if (sampleEntry && !sampleEntry->categories.empty())
+	if (entry && !entry->categories.empty())
 	{
 		return baseHeight + 25;
 	}
@@ -89,7 +94,7 @@ int SampleBankItem::getRequiredHeight()
 
 void SampleBankItem::loadAudioDataIfNeeded()
 {
-	if (audioBuffer.getNumSamples() == 0)
+	if (!pyramid && !audioLoadRequested)
 	{
 		loadAudioData();
 		if (!waveformBounds.isEmpty())
@@ -356,49 +361,54 @@ void SampleBankItem::loadAudioData()
 	juce::File audioFile(sampleEntry->filePath);
 	if (!audioFile.exists()) return;
 
+	audioLoadRequested = true;
 	double currentSampleRate = audioProcessor.getSampleRate();
 	auto validity = validityFlag;
+	auto& analysisCache = audioProcessor.getAnalysisCache();
 
-	juce::Thread::launch([this, audioFile, currentSampleRate, validity]()
+	juce::Thread::launch([this, audioFile, currentSampleRate, validity, &analysisCache]()
 		{
 			if (!validity->load()) return;
 
-			juce::AudioFormatManager formatManager;
-			formatManager.registerBasicFormats();
+			const juce::String cacheKey = AnalysisCache::computeFileKey(audioFile);
+			std::shared_ptr<const WaveformPyramid> loaded = analysisCache.loadPyramid(cacheKey);
 
-			auto reader = std::unique_ptr<juce::AudioFormatReader>(
-				formatManager.createReaderFor(audioFile));
-
-			if (reader && validity->load())
+			if (!loaded)
 			{
-				const int downsampleRatio = std::max(1, (int)(reader->lengthInSamples / 4096));
-				const int numSamples = (int)(reader->lengthInSamples / downsampleRatio);
+				juce::AudioFormatManager formatManager;
+				formatManager.registerBasicFormats();
 
-				auto tempBuffer = std::make_shared<juce::AudioBuffer<float>>(reader->numChannels, numSamples);
+				auto reader = std::unique_ptr<juce::AudioFormatReader>(
+					formatManager.createReaderFor(audioFile));
+				if (!reader || reader->lengthInSamples <= 0 || !validity->load()) return;
 
-				for (int i = 0; i < numSamples; ++i)
-				{
-					if (!validity->load()) return;
-					reader->read(tempBuffer.get(), i, 1, i * downsampleRatio, true, true);
-				}
+				const int numSamples = static_cast<int>(reader->lengthInSamples);
+				juce::AudioBuffer<float> decoded(static_cast<int>(reader->numChannels), numSamples);
+				reader->read(&decoded, 0, numSamples, 0, true, true);
 
-				if (validity->load())
-				{
-					juce::MessageManager::callAsync([this, tempBuffer, currentSampleRate, validity]()
+				auto built = WaveformPyramid::build(decoded, numSamples);
+				if (!built) return;
+
+				analysisCache.storePyramid(cacheKey, *built);
+				loaded = built;
+			}
+
+			if (validity->load())
+			{
+				juce::MessageManager::callAsync([this, loaded, currentSampleRate, validity]()
+					{
+						if (validity->load() && !isDestroyed.load() && sampleEntry)
 						{
-							if (validity->load() && !isDestroyed.load() && sampleEntry)
+							pyramid = loaded;
+							sampleRate = currentSampleRate;
+
+							if (!waveformBounds.isEmpty())
 							{
-								audioBuffer = *tempBuffer;
-								sampleRate = currentSampleRate;
-
-								if (!waveformBounds.isEmpty())
-								{
-									generateThumbnail();
-									repaint();
-								}
+								generateThumbnail();
+								repaint();
 							}
-						});
-				}
+						}
+					});
 			}
 		});
 }
@@ -488,38 +498,18 @@ void SampleBankItem::generateThumbnail()
 {
 	thumbnail.clear();
 
-	if (audioBuffer.getNumSamples() == 0) return;
+	if (!pyramid) return;
 
 	int targetPoints = waveformBounds.getWidth();
 	if (targetPoints <= 0) targetPoints = 100;
 
-	int samplesPerPoint = juce::jmax(1, audioBuffer.getNumSamples() / targetPoints);
+	std::vector<WaveformPyramid::Bin> bins;
+	pyramid->getBins(0, pyramid->getNumSamples(), targetPoints, bins);
 
-	for (int point = 0; point < targetPoints; ++point)
+	thumbnail.reserve(bins.size());
+	for (const auto& bin : bins)
 	{
-		int sampleStart = point * samplesPerPoint;
-		int sampleEnd = std::min(sampleStart + samplesPerPoint, audioBuffer.getNumSamples());
-
-		if (sampleStart >= audioBuffer.getNumSamples()) break;
-
-		float rmsSum = 0.0f;
-		float peak = 0.0f;
-		int count = 0;
-
-		for (int sample = sampleStart; sample < sampleEnd; ++sample)
-		{
-			for (int ch = 0; ch < audioBuffer.getNumChannels(); ++ch)
-			{
-				float val = audioBuffer.getSample(ch, sample);
-				rmsSum += val * val;
-				peak = std::max(peak, std::abs(val));
-				count++;
-			}
-		}
-
-		float rms = count > 0 ? std::sqrt(rmsSum / count) : 0.0f;
-		float finalValue = (rms * 0.7f) + (peak * 0.3f);
-
+		float finalValue = (bin.getRms() * 0.7f) + (bin.getPeak() * 0.3f);
 		thumbnail.push_back(finalValue);
 	}
 }
@@ -703,31 +693,31 @@ SampleBankPanel::SampleBankPanel(DjIaVstProcessor& processor)
 	setupUI();
 	refreshSampleList();
 
-	juce::Timer::callAfterDelay(500, [this]()
+	juce::Component::SafePointer<SampleBankPanel> safeThis(this);
+	juce::Timer::callAfterDelay(500, [safeThis]()
 		{
-			rebuildCategoryFilter();
-			refreshSampleList();
+			if (safeThis == nullptr)
+				return;
+			safeThis->rebuildCategoryFilter();
+			safeThis->refreshSampleList();
 		});
 
+	// The bank is shared by every instance in the process, so each panel
+	// listens rather than owning a single callback.
 	if (auto* bank = audioProcessor.getSampleBank())
-	{
-		bank->onBankChanged = [this]()
-			{
-				juce::MessageManager::callAsync([this]()
-					{
-						refreshSampleList();
-					});
-			};
-	}
+		bank->addChangeListener(this);
 }
 
 SampleBankPanel::~SampleBankPanel()
 {
 	stopPreview();
 	if (auto* bank = audioProcessor.getSampleBank())
-	{
-		bank->onBankChanged = nullptr;
-	}
+		bank->removeChangeListener(this);
+}
+
+void SampleBankPanel::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+	refreshSampleList();
 }
 
 void SampleBankPanel::playPreview(SampleBankEntry* entry)
@@ -749,12 +739,12 @@ void SampleBankPanel::playPreview(SampleBankEntry* entry)
 
 	currentPreviewEntry = entry;
 
-	for (auto& item : sampleItems)
+	for (auto& row : sampleItems)
 	{
-		if (item->getSampleEntry() == entry)
+		if (row.second->getSampleEntry() == entry)
 		{
-			item->setIsPlaying(true);
-			currentPreviewItem = item.get();
+			row.second->setIsPlaying(true);
+			currentPreviewItem = row.second.get();
 			break;
 		}
 	}
@@ -823,101 +813,124 @@ void SampleBankPanel::resized()
 	buttonArea.removeFromLeft(5);
 	deleteCategoryButton.setBounds(buttonArea.removeFromLeft(60).reduced(5));
 
+	area.removeFromTop(5);
+	searchInput.setBounds(area.removeFromTop(28));
+
 	area.removeFromTop(5);
 	samplesViewport.setBounds(area);
 
-	int totalHeight = 5;
-	for (auto& item : sampleItems)
-	{
-		totalHeight += item->getRequiredHeight() + 5;
-	}
-	samplesContainer.setSize(area.getWidth() - 20, totalHeight);
+	layoutRows();
+	updateVisibleItems();
 }
 
 void SampleBankPanel::refreshSampleList()
 {
 	sampleItems.clear();
+	currentPreviewItem = nullptr;
 	samplesContainer.removeAllChildren();
-	auto* bank = audioProcessor.getSampleBank();
-	if (!bank) return;
+	listedSamples.clear();
 
-	auto samples = bank->getAllSamples();
+	auto* bank = audioProcessor.getSampleBank();
+	if (!bank)
+	{
+		layoutRows();
+		return;
+	}
 
-	DBG("Before filtering: " + juce::String(samples.size()) + " samples");
-	DBG("Current category ID: " + juce::String(currentCategoryId));
+	SampleQuery query;
+	query.text = searchInput.getText();
 
 	if (currentCategoryId != 0)
 	{
-		juce::String selectedCategoryName;
 		for (const auto& info : categoryInfos)
 		{
 			if (info.id == currentCategoryId)
 			{
-				selectedCategoryName = info.name;
+				query.category = info.name;
 				break;
 			}
 		}
+	}
+
+	switch (currentSortType)
+	{
+	case SortType::Time: query.sort = SampleQuery::Sort::Newest; break;
+	case SortType::Prompt: query.sort = SampleQuery::Sort::Prompt; break;
+	case SortType::Usage: query.sort = SampleQuery::Sort::Usage; break;
+	case SortType::BPM: query.sort = SampleQuery::Sort::Bpm; break;
+	case SortType::Duration: query.sort = SampleQuery::Sort::Duration; break;
+	}
+
+	listedSamples = bank->query(query);
+	DBG("Sample bank query: " + juce::String(static_cast<int>(listedSamples.size())) + " samples (category ID "
+		+ juce::String(currentCategoryId) + ")");
+
+	layoutRows();
+	updateVisibleItems();
+}
+
+void SampleBankPanel::layoutRows()
+{
+	rowOffsets.assign(1, 5);
+	rowOffsets.reserve(listedSamples.size() + 1);
+	for (auto* entry : listedSamples)
+		rowOffsets.push_back(rowOffsets.back() + SampleBankItem::getRequiredHeight(entry) + 5);
+
+	samplesContainer.setSize(samplesViewport.getWidth() - 20, rowOffsets.back() + 5);
+
+	const int rowWidth = samplesContainer.getWidth() - 10;
+	for (auto& row : sampleItems)
+		row.second->setBounds(5, rowOffsets[row.first], rowWidth, rowOffsets[row.first + 1] - rowOffsets[row.first] - 5);
+}
+
+void SampleBankPanel::updateVisibleItems()
+{
+	if (rowOffsets.size() != listedSamples.size() + 1)
+		return;
+
+	const auto viewArea = samplesViewport.getViewArea();
+	const auto rowsBegin = rowOffsets.begin();
+	const auto rowsEnd = rowOffsets.end() - 1;
 
-		DBG("Filtering by category: " + selectedCategoryName);
+	// Row i spans [rowOffsets[i], rowOffsets[i + 1]).
+	auto firstIt = std::upper_bound(rowsBegin, rowsEnd, viewArea.getY() - overscanPixels);
+	const size_t first = firstIt == rowsBegin ? 0 : static_cast<size_t>(firstIt - rowsBegin - 1);
+	const size_t last = static_cast<size_t>(std::lower_bound(rowsBegin, rowsEnd, viewArea.getBottom() + overscanPixels) - rowsBegin);
 
-		if (!selectedCategoryName.isEmpty())
+	for (auto it = sampleItems.begin(); it != sampleItems.end();)
+	{
+		if (it->first >= first && it->first < last)
 		{
-			samples.erase(
-				std::remove_if(samples.begin(), samples.end(),
-					[&selectedCategoryName](const SampleBankEntry* entry)
-					{
-						return std::find(entry->categories.begin(), entry->categories.end(),
-							selectedCategoryName) == entry->categories.end();
-					}),
-				samples.end()
-			);
+			++it;
+			continue;
 		}
+		if (it->second.get() == currentPreviewItem)
+			currentPreviewItem = nullptr;
+		it = sampleItems.erase(it);
 	}
 
-	switch (currentSortType)
+	const int rowWidth = samplesContainer.getWidth() - 10;
+	for (size_t row = first; row < last; ++row)
 	{
-	case SortType::Time:
-		std::sort(samples.begin(), samples.end(),
-			[](const SampleBankEntry* a, const SampleBankEntry* b)
-			{
-				return a->creationTime > b->creationTime;
-			});
-		break;
+		auto& item = sampleItems[row];
+		if (item)
+			continue;
 
-	case SortType::Prompt:
-		std::sort(samples.begin(), samples.end(),
-			[](const SampleBankEntry* a, const SampleBankEntry* b)
-			{
-				return a->originalPrompt.compareIgnoreCase(b->originalPrompt) < 0;
-			});
-		break;
-
-	case SortType::Usage:
-		std::sort(samples.begin(), samples.end(),
-			[](const SampleBankEntry* a, const SampleBankEntry* b)
-			{
-				return a->usedInProjects.size() > b->usedInProjects.size();
-			});
-		break;
+		item = createSampleItem(listedSamples[row]);
+		item->setBounds(5, rowOffsets[row], rowWidth, rowOffsets[row + 1] - rowOffsets[row] - 5);
+		samplesContainer.addAndMakeVisible(item.get());
 
-	case SortType::BPM:
-		std::sort(samples.begin(), samples.end(),
-			[](const SampleBankEntry* a, const SampleBankEntry* b)
-			{
-				return a->bpm > b->bpm;
-			});
-		break;
+		if (isVisible())
+		{
+			item->loadAudioDataIfNeeded();
+		}
 
-	case SortType::Duration:
-		std::sort(samples.begin(), samples.end(),
-			[](const SampleBankEntry* a, const SampleBankEntry* b)
-			{
-				return a->duration > b->duration;
-			});
-		break;
+		if (listedSamples[row] == currentPreviewEntry)
+		{
+			item->setIsPlaying(true);
+			currentPreviewItem = item.get();
+		}
 	}
-
-	createSampleItems(samples);
 }
 
 void SampleBankPanel::setVisible(bool shouldBeVisible)
@@ -925,9 +938,9 @@ void SampleBankPanel::setVisible(bool shouldBeVisible)
 	Component::setVisible(shouldBeVisible);
 	if (shouldBeVisible)
 	{
-		for (auto& item : sampleItems)
+		for (auto& row : sampleItems)
 		{
-			item->loadAudioDataIfNeeded();
+			row.second->loadAudioDataIfNeeded();
 		}
 		juce::Timer::callAfterDelay(100, [this]()
 			{
@@ -973,9 +986,14 @@ void SampleBankPanel::setupUI()
 			refreshSampleList();
 		};
 
+	addAndMakeVisible(searchInput);
+	searchInput.setTextToShowWhenEmpty("Search prompts...", ColourPalette::textSecondary);
+	searchInput.onTextChange = [this]() { refreshSampleList(); };
+
 	addAndMakeVisible(samplesViewport);
 	samplesViewport.setViewedComponent(&samplesContainer, false);
 	samplesViewport.setScrollBarsShown(true, false);
+	samplesViewport.onVisibleAreaChanged = [this]() { updateVisibleItems(); };
 
 	addAndMakeVisible(categoryFilter);
 	for (const auto& info : categoryInfos)
@@ -1024,68 +1042,49 @@ void SampleBankPanel::setupUI()
 	deleteCategoryButton.setEnabled(false);
 }
 
-void SampleBankPanel::createSampleItems(const std::vector<SampleBankEntry*>& samples)
+std::unique_ptr<SampleBankItem> SampleBankPanel::createSampleItem(SampleBankEntry* sampleEntry)
 {
-	int yPos = 5;
-
-	for (auto* sampleEntry : samples)
-	{
-		auto item = std::make_unique<SampleBankItem>(sampleEntry, audioProcessor);
+	auto item = std::make_unique<SampleBankItem>(sampleEntry, audioProcessor);
 
-		item->onPreviewRequested = [this](SampleBankEntry* entry)
-			{
-				playPreview(entry);
-			};
-		item->onStopRequested = [this]()
-			{
-				stopPreview();
-			};
-		item->onDeleteRequested = [this](const juce::String& sampleId)
+	item->onPreviewRequested = [this](SampleBankEntry* entry)
+		{
+			playPreview(entry);
+		};
+	item->onStopRequested = [this]()
+		{
+			stopPreview();
+		};
+	item->onDeleteRequested = [this](const juce::String& sampleId)
+		{
+			auto* entry = audioProcessor.getSampleBank()->getSample(sampleId);
+			if (entry)
 			{
-				auto* entry = audioProcessor.getSampleBank()->getSample(sampleId);
-				if (entry)
-				{
-					showDeleteConfirmation(sampleId, entry->originalPrompt);
-				}
-			};
-		item->onCategoriesChanged = [this](SampleBankEntry* entry, const std::vector<juce::String>& /*newCategories*/)
+				showDeleteConfirmation(sampleId, entry->originalPrompt);
+			}
+		};
+	item->onCategoriesChanged = [this](SampleBankEntry* entry, const std::vector<juce::String>& /*newCategories*/)
+		{
+			auto* bank = audioProcessor.getSampleBank();
+			if (bank)
 			{
-				auto* bank = audioProcessor.getSampleBank();
-				if (bank)
-				{
-					bank->saveBankData();
-				}
-				refreshSampleList();
-				DBG("Categories updated for sample: " + entry->originalPrompt);
-			};
-		item->getCategoriesList = [this]() -> std::vector<juce::String>
+				bank->updateSample(entry->id);
+			}
+			refreshSampleList();
+			DBG("Categories updated for sample: " + entry->originalPrompt);
+		};
+	item->getCategoriesList = [this]() -> std::vector<juce::String>
+		{
+			std::vector<juce::String> categories;
+			for (const auto& info : categoryInfos)
 			{
-				std::vector<juce::String> categories;
-				for (const auto& info : categoryInfos)
+				if (info.id > 0)
 				{
-					if (info.id > 0)
-					{
-						categories.push_back(info.name);
-					}
+					categories.push_back(info.name);
 				}
-				return categories;
-			};
-		int itemHeight = item->getRequiredHeight();
-		item->setBounds(5, yPos, samplesContainer.getWidth() - 10, itemHeight);
-
-		samplesContainer.addAndMakeVisible(item.get());
-
-		if (isVisible())
-		{
-			item->loadAudioDataIfNeeded();
-		}
-
-		sampleItems.push_back(std::move(item));
-		yPos += itemHeight + 5;
-	}
-
-	samplesContainer.setSize(samplesViewport.getWidth() - 20, yPos + 5);
-	resized();
+			}
+			return categories;
+		};
+	return item;
 }
 
 void SampleBankPanel::deleteSample(const juce::String& sampleId)
@@ -1275,6 +1274,7 @@ void SampleBankPanel::editCategory()
 				*catIt = newName;
 			}
 		}
+		bank->saveBankData();
 	}
 
 	categoryInput.clear();
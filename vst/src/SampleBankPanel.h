@@ -9,6 +9,7 @@
 #include "JuceHeader.h"
 #include "SampleBank.h"
 #include "ColourPalette.h"
+#include "WaveformPyramid.h"
 
 class DjIaVstProcessor;
 
@@ -29,6 +30,7 @@ public:
 	void loadAudioDataIfNeeded();
 	void showCategoryMenu();
 	int getRequiredHeight();
+	static int getRequiredHeight(const SampleBankEntry* entry);
 
 	SampleBankEntry* getSampleEntry() const { return sampleEntry; }
 
@@ -52,7 +54,8 @@ private:
 
 	juce::Rectangle<int> waveformBounds;
 	std::vector<float> thumbnail;
-	juce::AudioBuffer<float> audioBuffer;
+	std::shared_ptr<const WaveformPyramid> pyramid;
+	bool audioLoadRequested = false;
 	std::shared_ptr<std::atomic<bool>> validityFlag;
 	std::atomic<bool> isDestroyed{ false };
 
@@ -111,8 +114,21 @@ struct CategoryInfo {
 	juce::String name;
 };
 
+class SampleListViewport : public juce::Viewport
+{
+public:
+	std::function<void()> onVisibleAreaChanged;
+
+	void visibleAreaChanged(const juce::Rectangle<int>&) override
+	{
+		if (onVisibleAreaChanged)
+			onVisibleAreaChanged();
+	}
+};
+
 class SampleBankPanel : public juce::Component,
-	public juce::Timer
+	public juce::Timer,
+	private juce::ChangeListener
 {
 public:
 	SampleBankPanel(DjIaVstProcessor& processor);
@@ -127,14 +143,17 @@ public:
 	std::function<void(const juce::String&, const juce::String&)> onSampleDroppedToTrack;
 
 private:
+	void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
 	DjIaVstProcessor& audioProcessor;
 
 	juce::Label titleLabel;
 	juce::TextButton cleanupButton;
-	juce::Viewport samplesViewport;
+	SampleListViewport samplesViewport;
 	juce::Component samplesContainer;
 	juce::Label infoLabel;
 	juce::ComboBox sortMenu;
+	juce::TextEditor searchInput;
 
 	juce::TextEditor categoryInput;
 	juce::TextButton addCategoryButton;
@@ -180,13 +199,23 @@ private:
 	};
 	SortType currentSortType = SortType::Prompt;
 
-	std::vector<std::unique_ptr<SampleBankItem>> sampleItems;
+	/*
+		Rows are virtualized: the whole query result is laid out as offsets,
+		but SampleBankItems only exist for the rows in (or near) the view and
+		are created and dropped as it scrolls.
+	*/
+	static constexpr int overscanPixels = 400;
+	std::vector<SampleBankEntry*> listedSamples;
+	std::vector<int> rowOffsets;
+	std::map<size_t, std::unique_ptr<SampleBankItem>> sampleItems;
 
 	SampleBankEntry* currentPreviewEntry = nullptr;
 	SampleBankItem* currentPreviewItem = nullptr;
 
 	void setupUI();
-	void createSampleItems(const std::vector<SampleBankEntry*>& samples);
+	std::unique_ptr<SampleBankItem> createSampleItem(SampleBankEntry* sampleEntry);
+	void layoutRows();
+	void updateVisibleItems();
 	void playPreview(SampleBankEntry* entry);
 	void stopPreview();
 	void deleteSample(const juce::String& sampleId);
@@ -0,0 +1,52 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "AnalysisCache.h"
+#include "DecodedSampleCache.h"
+#include "LocalGenerationSlots.h"
+#include "PreviewCache.h"
+#include "SampleBank.h"
+#include "StableAudioEngine.h"
+#include <memory>
+
+/*
+	Caches and engines that every OBSIDIAN-Neural instance in the process
+	can share. Processors hold them through juce::SharedResourcePointer, so
+	the first instance creates them and the last one to close frees them.
+	Decoding, analysis and model warm-up then happen once per process
+	instead of once per instance, and local generations from every
+	instance count against one limit. Every member does its own locking.
+	The sample bank is shared too, so instances never compact the journal
+	out from under each other.
+*/
+struct SharedResources
+{
+	DecodedSampleCache decodedSamples;
+	PreviewCache previews;
+	AnalysisCache analysis;
+
+	// Loaded once for the process so its resident inference worker stays
+	// warm for every instance; generateSample is safe from several threads.
+	StableAudioEngine localEngine;
+	juce::CriticalSection localEngineLock;
+	LocalGenerationSlots localGenerations;
+
+	/** Any thread; the first call loads the bank from disk. */
+	SampleBank& getSampleBank()
+	{
+		const juce::ScopedLock lock(sampleBankLock);
+		if (!sampleBank)
+			sampleBank = std::make_unique<SampleBank>();
+		return *sampleBank;
+	}
+
+private:
+	juce::CriticalSection sampleBankLock;
+	std::unique_ptr<SampleBank> sampleBank;
+};
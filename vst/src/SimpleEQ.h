@@ -7,6 +7,7 @@
 
 #pragma once
 #include "JuceHeader.h"
+#include "StereoBiquad.h"
 
 class SimpleEQ
 {
@@ -16,15 +17,13 @@ public:
 	void prepare(double newSampleRate, int /*samplesPerBlock*/)
 	{
 		sampleRate = newSampleRate;
-		for (int ch = 0; ch < 2; ++ch)
-		{
-			highFilters[ch].setCoefficients(
-				juce::IIRCoefficients::makeHighShelf(sampleRate, 8000.0, 0.7, 1.0));
-			midFilters[ch].setCoefficients(
-				juce::IIRCoefficients::makePeakFilter(sampleRate, 1000.0, 1.0, 1.0));
-			lowFilters[ch].setCoefficients(
-				juce::IIRCoefficients::makeLowShelf(sampleRate, 200.0, 0.7, 1.0));
-		}
+		filters.setStageImmediately(lowStage,
+			juce::IIRCoefficients::makeLowShelf(sampleRate, 200.0, 0.7, juce::Decibels::decibelsToGain(lowGain)));
+		filters.setStageImmediately(midStage,
+			juce::IIRCoefficients::makePeakFilter(sampleRate, 1000.0, 1.0, juce::Decibels::decibelsToGain(midGain)));
+		filters.setStageImmediately(highStage,
+			juce::IIRCoefficients::makeHighShelf(sampleRate, 8000.0, 0.7, juce::Decibels::decibelsToGain(highGain)));
+		filters.prepare(sampleRate);
 	}
 
 	void processBlock(juce::AudioBuffer<float> &buffer)
@@ -33,15 +32,11 @@ public:
 			return;
 
 		const int numChannels = std::min(2, buffer.getNumChannels());
-		const int numSamples = buffer.getNumSamples();
-
-		for (int ch = 0; ch < numChannels; ++ch)
-		{
-			auto *channelData = buffer.getWritePointer(ch);
-			lowFilters[ch].processSamples(channelData, numSamples);
-			midFilters[ch].processSamples(channelData, numSamples);
-			highFilters[ch].processSamples(channelData, numSamples);
-		}
+		if (numChannels == 0)
+			return;
+
+		filters.process(buffer.getWritePointer(0), numChannels > 1 ? buffer.getWritePointer(1) : nullptr,
+			buffer.getNumSamples());
 	}
 
 	void setHighGain(float gainDb)
@@ -51,12 +46,7 @@ public:
 
 		highGain = gainDb;
 		float linearGain = juce::Decibels::decibelsToGain(gainDb);
-
-		for (int ch = 0; ch < 2; ++ch)
-		{
-			highFilters[ch].setCoefficients(
-				juce::IIRCoefficients::makeHighShelf(sampleRate, 8000.0, 0.7, linearGain));
-		}
+		filters.setStage(highStage, juce::IIRCoefficients::makeHighShelf(sampleRate, 8000.0, 0.7, linearGain));
 	}
 
 	void setMidGain(float gainDb)
@@ -66,12 +56,7 @@ public:
 
 		midGain = gainDb;
 		float linearGain = juce::Decibels::decibelsToGain(gainDb);
-
-		for (int ch = 0; ch < 2; ++ch)
-		{
-			midFilters[ch].setCoefficients(
-				juce::IIRCoefficients::makePeakFilter(sampleRate, 1000.0, 1.0, linearGain));
-		}
+		filters.setStage(midStage, juce::IIRCoefficients::makePeakFilter(sampleRate, 1000.0, 1.0, linearGain));
 	}
 
 	void setLowGain(float gainDb)
@@ -81,12 +66,7 @@ public:
 
 		lowGain = gainDb;
 		float linearGain = juce::Decibels::decibelsToGain(gainDb);
-
-		for (int ch = 0; ch < 2; ++ch)
-		{
-			lowFilters[ch].setCoefficients(
-				juce::IIRCoefficients::makeLowShelf(sampleRate, 200.0, 0.7, linearGain));
-		}
+		filters.setStage(lowStage, juce::IIRCoefficients::makeLowShelf(sampleRate, 200.0, 0.7, linearGain));
 	}
 
 	float getHighGain() const { return highGain; }
@@ -98,12 +78,7 @@ public:
 
 	void reset()
 	{
-		for (int ch = 0; ch < 2; ++ch)
-		{
-			highFilters[ch].reset();
-			midFilters[ch].reset();
-			lowFilters[ch].reset();
-		}
+		filters.reset();
 	}
 
 private:
@@ -115,7 +90,8 @@ private:
 
 	bool bypass = false;
 
-	juce::IIRFilter highFilters[2];
-	juce::IIRFilter midFilters[2];
-	juce::IIRFilter lowFilters[2];
+	static constexpr int lowStage = 0;
+	static constexpr int midStage = 1;
+	static constexpr int highStage = 2;
+	StereoBiquadCascade<3> filters;
 };
\ No newline at end of file
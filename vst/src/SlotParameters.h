@@ -0,0 +1,119 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <memory>
+
+/*
+	Per-slot host parameters ("slot<N><Name>", N from 1) for a configurable
+	number of slots. The first eight slots keep the order they always had,
+	so hosts that address parameters by index still find them; parameters
+	of slots 9 and up are appended after them.
+*/
+namespace SlotParameters
+{
+	static constexpr int legacySlots = 8;
+	static constexpr int maxSlots = 32;
+
+	/** 0-based slot of an ID like "slot12Volume", or -1. Allocation-free, so usable from parameterChanged. */
+	inline int getSlotIndex(const juce::String& parameterId) noexcept
+	{
+		if (!parameterId.startsWith("slot"))
+			return -1;
+
+		int slotNumber = 0;
+		int i = 4;
+		for (; juce::CharacterFunctions::isDigit(parameterId[i]); ++i)
+			slotNumber = slotNumber * 10 + static_cast<int>(parameterId[i] - '0');
+		return i > 4 && slotNumber >= 1 ? slotNumber - 1 : -1;
+	}
+
+	/** "slot12Volume" -> "Volume"; the ID itself when it is not a slot parameter. */
+	inline juce::String getSuffix(const juce::String& parameterId)
+	{
+		if (getSlotIndex(parameterId) < 0)
+			return parameterId;
+		int i = 4;
+		while (juce::CharacterFunctions::isDigit(parameterId[i]))
+			++i;
+		return parameterId.substring(i);
+	}
+
+	/** Unlike startsWith("slot1"), does not match "slot12Volume". */
+	inline bool belongsToSlot(const juce::String& parameterId, int slotNumber) noexcept
+	{
+		return getSlotIndex(parameterId) == slotNumber - 1;
+	}
+
+	inline void addMixerParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, int slotNumber)
+	{
+		const juce::String id = "slot" + juce::String(slotNumber);
+		const juce::String name = "Slot " + juce::String(slotNumber);
+		layout.add(std::make_unique<juce::AudioParameterFloat>(id + "Volume", name + " Volume", 0.0f, 1.0f, 0.8f),
+			std::make_unique<juce::AudioParameterFloat>(id + "Pan", name + " Pan", -1.0f, 1.0f, 0.0f),
+			std::make_unique<juce::AudioParameterBool>(id + "Mute", name + " Mute", false),
+			std::make_unique<juce::AudioParameterBool>(id + "Solo", name + " Solo", false),
+			std::make_unique<juce::AudioParameterBool>(id + "Play", name + " Play", false),
+			std::make_unique<juce::AudioParameterBool>(id + "Stop", name + " Stop", false),
+			std::make_unique<juce::AudioParameterBool>(id + "Generate", name + " Generate", false),
+			std::make_unique<juce::AudioParameterFloat>(id + "Pitch", name + " Pitch", -12.0f, 12.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>(id + "Fine", name + " Fine", -50.0f, 50.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>(id + "BpmOffset", name + " BPM Offset", -20.0f, 20.0f, 0.0f));
+	}
+
+	inline void addRetriggerParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, int slotNumber)
+	{
+		const juce::String id = "slot" + juce::String(slotNumber);
+		const juce::String name = "Slot " + juce::String(slotNumber);
+		layout.add(std::make_unique<juce::AudioParameterBool>(id + "RandomRetrigger", name + " Random Retrigger", false),
+			std::make_unique<juce::AudioParameterFloat>(id + "RetriggerInterval", name + " Retrigger Interval",
+				juce::NormalisableRange<float>(1.0f, 10.0f, 1.0f), 3.0f));
+	}
+
+	inline void addInsertParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, int slotNumber)
+	{
+		const juce::String id = "slot" + juce::String(slotNumber);
+		const juce::String name = "Slot " + juce::String(slotNumber);
+		layout.add(std::make_unique<juce::AudioParameterFloat>(id + "EqLow", name + " Low EQ", -12.0f, 12.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>(id + "EqMid", name + " Mid EQ", -12.0f, 12.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>(id + "EqHigh", name + " High EQ", -12.0f, 12.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>(id + "Filter", name + " Filter", -1.0f, 1.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>(id + "Comp", name + " Compressor", 0.0f, 1.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>(id + "DelaySend", name + " Delay Send", 0.0f, 1.0f, 0.0f));
+	}
+
+	inline juce::AudioProcessorValueTreeState::ParameterLayout createLayout(int numSlots)
+	{
+		juce::AudioProcessorValueTreeState::ParameterLayout layout;
+		layout.add(std::make_unique<juce::AudioParameterBool>("generate", "Generate Loop", false),
+			std::make_unique<juce::AudioParameterBool>("play", "Play Loop", false),
+			std::make_unique<juce::AudioParameterFloat>("bpm", "BPM", 60.0f, 200.0f, 126.0f),
+			std::make_unique<juce::AudioParameterFloat>("masterVolume", "Master Volume", 0.0f, 1.0f, 0.8f),
+			std::make_unique<juce::AudioParameterFloat>("masterPan", "Master Pan", -1.0f, 1.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>("masterHigh", "Master High EQ", -12.0f, 12.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>("masterMid", "Master Mid EQ", -12.0f, 12.0f, 0.0f),
+			std::make_unique<juce::AudioParameterFloat>("masterLow", "Master Low EQ", -12.0f, 12.0f, 0.0f));
+
+		for (int slot = 1; slot <= legacySlots; ++slot)
+			addMixerParameters(layout, slot);
+		for (int slot = 1; slot <= legacySlots; ++slot)
+			addRetriggerParameters(layout, slot);
+		layout.add(std::make_unique<juce::AudioParameterBool>("nextTrack", "Next Track", false),
+			std::make_unique<juce::AudioParameterBool>("prevTrack", "Previous Track", false));
+		for (int slot = 1; slot <= legacySlots; ++slot)
+			addInsertParameters(layout, slot);
+
+		for (int slot = legacySlots + 1; slot <= numSlots; ++slot)
+		{
+			addMixerParameters(layout, slot);
+			addRetriggerParameters(layout, slot);
+			addInsertParameters(layout, slot);
+		}
+		return layout;
+	}
+}
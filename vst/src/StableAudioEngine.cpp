@@ -7,16 +7,187 @@
 
 #include "StableAudioEngine.h"
 
-#ifdef _WIN32
-#include <direct.h>
-#define GETCWD _getcwd
-#define CHDIR _chdir
+#if JUCE_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
 #else
+#include <csignal>
+#include <string>
+#include <sys/wait.h>
 #include <unistd.h>
-#define GETCWD getcwd
-#define CHDIR chdir
 #endif
 
+namespace
+{
+	/*
+		Starts an executable directly, without a shell, inside a given working
+		directory. juce::ChildProcess cannot set the child's directory, and
+		going through cmd.exe would let the prompt reach a command line that
+		the shell interprets.
+	*/
+	class DirectChildProcess
+	{
+	public:
+		~DirectChildProcess()
+		{
+			if (isRunning())
+				kill();
+#if JUCE_WINDOWS
+			if (process != nullptr)
+				CloseHandle(process);
+#endif
+		}
+
+		bool start(const juce::StringArray& arguments, const juce::File& workingDirectory)
+		{
+			if (arguments.isEmpty())
+				return false;
+
+#if JUCE_WINDOWS
+			juce::StringArray quoted;
+			for (const auto& argument : arguments)
+				quoted.add(quoteArgument(argument));
+			std::wstring commandLine(quoted.joinIntoString(" ").toWideCharPointer());
+			const std::wstring executable(arguments[0].toWideCharPointer());
+			const std::wstring directory(workingDirectory.getFullPathName().toWideCharPointer());
+
+			STARTUPINFOW startupInfo{};
+			startupInfo.cb = sizeof(startupInfo);
+			PROCESS_INFORMATION processInfo{};
+			if (!CreateProcessW(executable.c_str(), commandLine.data(), nullptr, nullptr, FALSE,
+				CREATE_NO_WINDOW, nullptr, directory.c_str(), &startupInfo, &processInfo))
+				return false;
+
+			CloseHandle(processInfo.hThread);
+			process = processInfo.hProcess;
+			return true;
+#else
+			// Everything the child needs is built before fork, which only
+			// leaves async-signal-safe calls between fork and exec.
+			std::vector<std::string> storage;
+			for (const auto& argument : arguments)
+				storage.push_back(argument.toStdString());
+			std::vector<char*> argv;
+			for (auto& argument : storage)
+				argv.push_back(argument.data());
+			argv.push_back(nullptr);
+			const std::string directory = workingDirectory.getFullPathName().toStdString();
+
+			pid = fork();
+			if (pid < 0)
+				return false;
+			if (pid == 0)
+			{
+				if (chdir(directory.c_str()) == 0)
+					execv(argv[0], argv.data());
+				_exit(127);
+			}
+			return true;
+#endif
+		}
+
+		bool waitForProcessToFinish(int timeoutMs)
+		{
+#if JUCE_WINDOWS
+			return process != nullptr && WaitForSingleObject(process, static_cast<DWORD>(timeoutMs)) == WAIT_OBJECT_0;
+#else
+			const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+			while (isRunning())
+			{
+				if (juce::Time::getMillisecondCounter() >= deadline)
+					return false;
+				juce::Thread::sleep(50);
+			}
+			return pid > 0;
+#endif
+		}
+
+		void kill()
+		{
+#if JUCE_WINDOWS
+			if (process != nullptr)
+			{
+				TerminateProcess(process, 1);
+				WaitForSingleObject(process, 5000);
+			}
+#else
+			if (pid > 0 && !finished)
+			{
+				::kill(pid, SIGKILL);
+				int status = 0;
+				if (waitpid(pid, &status, 0) == pid)
+					recordStatus(status);
+			}
+#endif
+		}
+
+		int getExitCode()
+		{
+#if JUCE_WINDOWS
+			DWORD code = 0;
+			return process != nullptr && GetExitCodeProcess(process, &code) ? static_cast<int>(code) : -1;
+#else
+			return exitCode;
+#endif
+		}
+
+	private:
+		bool isRunning()
+		{
+#if JUCE_WINDOWS
+			return process != nullptr && WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+#else
+			if (pid <= 0 || finished)
+				return false;
+			int status = 0;
+			if (waitpid(pid, &status, WNOHANG) != pid)
+				return true;
+			recordStatus(status);
+			return false;
+#endif
+		}
+
+#if JUCE_WINDOWS
+		// The quoting CommandLineToArgvW and the C runtime undo.
+		static juce::String quoteArgument(const juce::String& argument)
+		{
+			if (argument.isNotEmpty() && !argument.containsAnyOf(" \t\n\v\""))
+				return argument;
+
+			juce::String quoted("\"");
+			int backslashes = 0;
+			for (auto character : argument)
+			{
+				if (character == '\\')
+				{
+					++backslashes;
+					continue;
+				}
+				const int count = character == '"' ? backslashes * 2 + 1 : backslashes;
+				quoted << juce::String::repeatedString("\\", count) << juce::String::charToString(character);
+				backslashes = 0;
+			}
+			quoted << juce::String::repeatedString("\\", backslashes * 2) << "\"";
+			return quoted;
+		}
+
+		HANDLE process = nullptr;
+#else
+		void recordStatus(int status)
+		{
+			finished = true;
+			exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+		}
+
+		pid_t pid = -1;
+		bool finished = false;
+		int exitCode = -1;
+#endif
+	};
+}
+
 bool StableAudioEngine::initialize(const juce::String& modelsDir)
 {
 	try
@@ -37,6 +208,17 @@ bool StableAudioEngine::initialize(const juce::String& modelsDir)
 			return false;
 		}
 
+		auto serverExecutable = baseDir.getChildFile("audiogen_server.exe");
+		if (!serverExecutable.exists())
+		{
+			serverExecutable = baseDir.getChildFile("audiogen_server");
+		}
+		if (serverExecutable.existsAsFile())
+		{
+			residentWorker = std::make_unique<LocalInferenceWorker>(serverExecutable, modelsDirectory);
+			DBG("Resident inference worker available: " << serverExecutable.getFullPathName());
+		}
+
 		isInitialized = true;
 		DBG("Stable Audio Engine ready! Using executable: " << audiogenExecutable.getFullPathName());
 		return true;
@@ -88,52 +270,46 @@ StableAudioEngine::GenerationResult StableAudioEngine::generateSample(const Gene
 	{
 		DBG("Generating audio: '" << params.prompt << "' (" << params.duration << "s)");
 
-		auto startTime = juce::Time::getMillisecondCounterHiRes();
-		cleanupTempFiles();
-
-		auto sanitizedPrompt = sanitizePrompt(params.prompt);
 		auto seed = (params.seed == -1) ? generateRandomSeed() : params.seed;
+		if (residentWorker != nullptr)
+		{
+			auto workerResult = generateWithResidentWorker(params, seed);
+			if (workerResult.success)
+				return workerResult;
+			DBG("Resident worker failed (" << workerResult.errorMessage << "), falling back to audiogen");
+		}
 
-		juce::StringArray command;
-		command.add(audiogenExecutable.getFullPathName());
-		command.add(modelsDirectory);
-		command.add(sanitizedPrompt);
-		command.add(juce::String(params.numThreads));
-		command.add(juce::String(seed));
-
-		DBG("Executing command: " << command.joinIntoString(" "));
-
-		char originalDir[1024];
-		GETCWD(originalDir, sizeof(originalDir));
-
-		auto workingDir = juce::File(modelsDirectory);
-		DBG("Changing working directory to: " << workingDir.getFullPathName());
+		auto startTime = juce::Time::getMillisecondCounterHiRes();
 
-		if (CHDIR(workingDir.getFullPathName().toRawUTF8()) != 0)
+		// audiogen writes output.wav into its working directory, so every
+		// request gets its own directory and the child is started inside it.
+		// The host's working directory is never touched, which lets several
+		// local generations run side by side.
+		ScopedRequestDirectory workDir;
+		if (workDir.directory.createDirectory().failed())
 		{
-			result.errorMessage = "Failed to change working directory";
+			result.errorMessage = "Failed to create working directory";
 			return result;
 		}
 
-		juce::ChildProcess childProcess;
+		auto command = buildCommand(sanitizePrompt(params.prompt), params.numThreads, seed);
+		DBG("Executing command: " << command.joinIntoString(" "));
+
+		DirectChildProcess childProcess;
 
-		if (!childProcess.start(command))
+		if (!childProcess.start(command, workDir.directory))
 		{
-			CHDIR(originalDir);
 			result.errorMessage = "Failed to start audiogen process";
 			return result;
 		}
 
-		if (!childProcess.waitForProcessToFinish(600000))
+		if (!childProcess.waitForProcessToFinish(generationTimeoutMs))
 		{
 			childProcess.kill();
-			CHDIR(originalDir);
 			result.errorMessage = "Process timeout (10min)";
 			return result;
 		}
 
-		CHDIR(originalDir);
-
 		auto exitCode = childProcess.getExitCode();
 		if (exitCode != 0)
 		{
@@ -141,31 +317,28 @@ StableAudioEngine::GenerationResult StableAudioEngine::generateSample(const Gene
 			return result;
 		}
 
-		auto outputFile = juce::File(modelsDirectory).getChildFile("output.wav");
+		auto outputFile = workDir.directory.getChildFile("output.wav");
 		if (!outputFile.exists())
 		{
 			result.errorMessage = "Output file not found: " + outputFile.getFullPathName();
 			return result;
 		}
 
-		auto audioData = loadAndResampleWavFile(outputFile, params.sampleRate);
-		if (audioData.empty())
+		result.audio = loadAndResampleWavFile(outputFile, params.sampleRate);
+		if (result.audio.getNumSamples() == 0)
 		{
 			result.errorMessage = "Failed to load and resample generated audio file";
 			return result;
 		}
 
 		auto endTime = juce::Time::getMillisecondCounterHiRes();
-		result.audioData = audioData;
-		result.leftChannel = audioData;
-		result.rightChannel = audioData;
-		result.actualDuration = static_cast<float>(audioData.size()) / params.sampleRate;
+		result.sampleRate = params.sampleRate;
+		result.actualDuration = static_cast<float>(result.audio.getNumSamples()) / params.sampleRate;
 		result.success = true;
 		result.performanceInfo = "Generated in " + juce::String(endTime - startTime, 0) + "ms";
 
-		DBG("Generation successful: " << result.audioData.size() << " samples in "
+		DBG("Generation successful: " << result.audio.getNumSamples() << " samples in "
 			<< (endTime - startTime) << "ms");
-		outputFile.deleteFile();
 
 		return result;
 	}
@@ -177,78 +350,93 @@ StableAudioEngine::GenerationResult StableAudioEngine::generateSample(const Gene
 	}
 }
 
-std::vector<float> StableAudioEngine::loadAndResampleWavFile(const juce::File& wavFile, double targetSampleRate)
+StableAudioEngine::GenerationResult StableAudioEngine::generateWithResidentWorker(const GenerationParams& params, int seed)
 {
-	std::vector<float> audioData;
+	GenerationResult result;
+	auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+	LocalInferenceWorker::Request request;
+	request.prompt = sanitizePrompt(params.prompt);
+	request.seed = seed;
+	request.numThreads = params.numThreads;
+	request.duration = params.duration;
+
+	auto response = residentWorker->generate(request, generationTimeoutMs);
+	if (!response.success)
+	{
+		result.errorMessage = response.errorMessage;
+		return result;
+	}
 
+	result.audio = toStereoAtRate(std::move(response.audio), response.sampleRate, params.sampleRate);
+	if (result.audio.getNumSamples() == 0)
+	{
+		result.errorMessage = "Resident worker returned no audio";
+		return result;
+	}
+
+	auto endTime = juce::Time::getMillisecondCounterHiRes();
+	result.sampleRate = params.sampleRate;
+	result.actualDuration = static_cast<float>(result.audio.getNumSamples()) / params.sampleRate;
+	result.success = true;
+	result.performanceInfo = "Generated in " + juce::String(endTime - startTime, 0) + "ms (resident)";
+
+	DBG("Resident generation: " << result.audio.getNumSamples() << " samples in " << (endTime - startTime) << "ms");
+	return result;
+}
+
+juce::AudioBuffer<float> StableAudioEngine::loadAndResampleWavFile(const juce::File& wavFile, double targetSampleRate)
+{
 	try
 	{
 		juce::AudioFormatManager formatManager;
 		formatManager.registerBasicFormats();
 
-		auto* reader = formatManager.createReaderFor(wavFile);
+		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(wavFile));
 		if (reader == nullptr)
 		{
 			DBG("Failed to create audio reader for: " << wavFile.getFullPathName());
-			return audioData;
+			return {};
 		}
 
-		std::unique_ptr<juce::AudioFormatReader> readerPtr(reader);
-
 		auto numSamples = static_cast<int>(reader->lengthInSamples);
 		auto numChannels = static_cast<int>(reader->numChannels);
-		double originalSampleRate = reader->sampleRate;
 
 		juce::AudioBuffer<float> buffer(numChannels, numSamples);
 		reader->read(&buffer, 0, numSamples, 0, true, true);
+		return toStereoAtRate(std::move(buffer), reader->sampleRate, targetSampleRate);
+	}
+	catch (const std::exception& e)
+	{
+		DBG("Exception loading/resampling WAV file: " << e.what());
+		return {};
+	}
+}
 
-		juce::AudioBuffer<float> monoBuffer(1, numSamples);
-		if (numChannels == 1)
-		{
-			monoBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-		}
-		else
+juce::AudioBuffer<float> StableAudioEngine::toStereoAtRate(juce::AudioBuffer<float>&& buffer, double originalSampleRate, double targetSampleRate)
+{
+	try
+	{
+		const int numSamples = buffer.getNumSamples();
+		if (buffer.getNumChannels() == 1)
 		{
-			for (int sample = 0; sample < numSamples; ++sample)
-			{
-				float left = buffer.getSample(0, sample);
-				float right = buffer.getSample(1, sample);
-				monoBuffer.setSample(0, sample, (left + right) * 0.5f);
-			}
+			buffer.setSize(2, numSamples, true, false, false);
+			buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
 		}
 
 		DBG("Original: " << numSamples << " samples at " << originalSampleRate << "Hz");
 		if (std::abs(originalSampleRate - targetSampleRate) > 1.0)
 		{
 			DBG("Resampling from " << originalSampleRate << "Hz to " << targetSampleRate << "Hz");
-
-			juce::AudioBuffer<float> resampledBuffer = resampleBuffer(monoBuffer, originalSampleRate, targetSampleRate);
-
-			audioData.reserve(resampledBuffer.getNumSamples());
-			for (int sample = 0; sample < resampledBuffer.getNumSamples(); ++sample)
-			{
-				audioData.push_back(resampledBuffer.getSample(0, sample));
-			}
-
-			DBG("Resampled to: " << audioData.size() << " samples at " << targetSampleRate << "Hz");
-		}
-		else
-		{
-			audioData.reserve(numSamples);
-			for (int sample = 0; sample < numSamples; ++sample)
-			{
-				audioData.push_back(monoBuffer.getSample(0, sample));
-			}
-			DBG("No resampling needed: " << audioData.size() << " samples");
+			return resampleBuffer(buffer, originalSampleRate, targetSampleRate);
 		}
+		return std::move(buffer);
 	}
 	catch (const std::exception& e)
 	{
-		DBG("Exception loading/resampling WAV file: " << e.what());
-		audioData.clear();
+		DBG("Exception resampling generated audio: " << e.what());
+		return {};
 	}
-
-	return audioData;
 }
 
 juce::AudioBuffer<float> StableAudioEngine::resampleBuffer(const juce::AudioBuffer<float>& inputBuffer,
@@ -258,50 +446,42 @@ juce::AudioBuffer<float> StableAudioEngine::resampleBuffer(const juce::AudioBuff
 	double ratio = outputSampleRate / inputSampleRate;
 	int outputNumSamples = static_cast<int>(inputBuffer.getNumSamples() * ratio);
 
-	juce::AudioBuffer<float> outputBuffer(1, outputNumSamples);
-	juce::LagrangeInterpolator interpolator;
-	interpolator.reset();
-
-	const float* inputData = inputBuffer.getReadPointer(0);
-	float* outputData = outputBuffer.getWritePointer(0);
-
-	interpolator.process(1.0 / ratio, inputData, outputData, outputNumSamples, inputBuffer.getNumSamples(), 0);
+	juce::AudioBuffer<float> outputBuffer(inputBuffer.getNumChannels(), outputNumSamples);
+	for (int channel = 0; channel < inputBuffer.getNumChannels(); ++channel)
+	{
+		juce::LagrangeInterpolator interpolator;
+		interpolator.process(1.0 / ratio, inputBuffer.getReadPointer(channel), outputBuffer.getWritePointer(channel),
+			outputNumSamples, inputBuffer.getNumSamples(), 0);
+	}
 
 	return outputBuffer;
 }
 
-std::vector<float> StableAudioEngine::generateAudio(const juce::String& prompt, float duration)
+juce::String StableAudioEngine::sanitizePrompt(const juce::String& prompt)
 {
-	GenerationParams params(prompt, duration);
-	auto result = generateSample(params);
-	return result.isValid() ? result.audioData : std::vector<float>();
+	// No shell sits between us and audiogen any more, so quotes, & and the
+	// like reach it as typed; only the length needs bounding.
+	return prompt.substring(0, maxPromptLength);
 }
 
-juce::String StableAudioEngine::sanitizePrompt(const juce::String& prompt)
+int StableAudioEngine::generateRandomSeed()
 {
-	auto sanitized = prompt.replace("\"", "\\\"")
-		.replace("'", "\\'")
-		.replace("|", "")
-		.replace("&", "and")
-		.replace(";", "");
-	if (sanitized.length() > 200)
-	{
-		sanitized = sanitized.substring(0, 200);
-	}
-
-	return sanitized;
+	// A fresh generator per call: requests may come from several threads.
+	return juce::Random().nextInt(1000000);
 }
 
-int StableAudioEngine::generateRandomSeed()
+juce::StringArray StableAudioEngine::buildCommand(const juce::String& prompt, int numThreads, int seed) const
 {
-	return random.nextInt(1000000);
+	juce::StringArray command;
+	command.add(audiogenExecutable.getFullPathName());
+	command.add(modelsDirectory);
+	command.add(prompt);
+	command.add(juce::String(numThreads));
+	command.add(juce::String(seed));
+	return command;
 }
 
-void StableAudioEngine::cleanupTempFiles()
+int StableAudioEngine::getDefaultThreadCount(int reservedCores)
 {
-	auto outputFile = juce::File(modelsDirectory).getChildFile("output.wav");
-	if (outputFile.exists())
-	{
-		outputFile.deleteFile();
-	}
+	return juce::jmax(1, juce::SystemStats::getNumCpus() - juce::jmax(0, reservedCores));
 }
\ No newline at end of file
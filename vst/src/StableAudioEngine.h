@@ -7,6 +7,7 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "LocalInferenceWorker.h"
 #include <vector>
 #include <memory>
 
@@ -28,42 +29,72 @@ public:
 		}
 	};
 
+	/*
+		Move-only: the stereo, channel-planar loop at the requested sample
+		rate travels from the engine to the track's staging buffer without
+		being copied.
+	*/
 	struct GenerationResult
 	{
-		std::vector<float> audioData;
-		std::vector<float> leftChannel;
-		std::vector<float> rightChannel;
+		juce::AudioBuffer<float> audio;
+		double sampleRate = 0.0;
 		float actualDuration = 0.0f;
 		bool success = false;
 		juce::String errorMessage = "";
 		juce::String performanceInfo = "";
 
+		GenerationResult() = default;
+		GenerationResult(GenerationResult&&) = default;
+		GenerationResult& operator=(GenerationResult&&) = default;
+		GenerationResult(const GenerationResult&) = delete;
+		GenerationResult& operator=(const GenerationResult&) = delete;
+
 		bool isValid() const
 		{
-			return success && !audioData.empty() && actualDuration > 0.0f;
+			return success && audio.getNumSamples() > 0 && actualDuration > 0.0f;
 		}
 	};
 	StableAudioEngine() {}
 
 	bool initialize(const juce::String& modelsDir);
 	bool isReady() const { return isInitialized; }
+	bool hasResidentWorker() const { return residentWorker != nullptr; }
+
+	/** Every core except the ones kept for the audio and render threads. */
+	static int getDefaultThreadCount(int reservedCores);
 
+	/** Safe to call from several threads at once. */
 	GenerationResult generateSample(const GenerationParams& params);
-	std::vector<float> generateAudio(const juce::String& prompt, float duration = 10.0f);
 
 private:
 	bool isInitialized = false;
 	juce::String modelsDirectory;
 	juce::File audiogenExecutable;
-	juce::Random random;
+	std::unique_ptr<LocalInferenceWorker> residentWorker;
+
+	struct ScopedRequestDirectory
+	{
+		juce::File directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+			.getChildFile("obsidian-audiogen")
+			.getChildFile(juce::Uuid().toString());
+
+		~ScopedRequestDirectory() { directory.deleteRecursively(); }
+	};
+
+	static constexpr int generationTimeoutMs = 600000;
 
 	bool checkRequiredFiles();
-	std::vector<float> loadAndResampleWavFile(const juce::File& wavFile, double targetSampleRate);
+	GenerationResult generateWithResidentWorker(const GenerationParams& params, int seed);
+	juce::AudioBuffer<float> loadAndResampleWavFile(const juce::File& wavFile, double targetSampleRate);
+	juce::AudioBuffer<float> toStereoAtRate(juce::AudioBuffer<float>&& buffer, double originalSampleRate, double targetSampleRate);
 	juce::AudioBuffer<float> resampleBuffer(const juce::AudioBuffer<float>& inputBuffer,
 		double inputSampleRate,
 		double outputSampleRate);
-	void cleanupTempFiles();
-	juce::String sanitizePrompt(const juce::String& prompt);
+	/** The executable and its arguments, passed to the child without a shell. */
+	juce::StringArray buildCommand(const juce::String& prompt, int numThreads, int seed) const;
+	/** The prompt as both generation paths send it: verbatim, capped at maxPromptLength. */
+	static juce::String sanitizePrompt(const juce::String& prompt);
+	static constexpr int maxPromptLength = 200;
 	int generateRandomSeed();
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StableAudioEngine)
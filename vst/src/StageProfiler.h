@@ -0,0 +1,195 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "SlotParameters.h"
+#include <array>
+#include <atomic>
+#include <cmath>
+
+/*
+	Log-spaced histogram of stage times. Recording is one relaxed increment,
+	and only one thread writes a histogram at a time. Readers never clear it:
+	they subtract an earlier snapshot, so the audio side never gets reset.
+*/
+class alignas(64) StageHistogram
+{
+public:
+	// Quarter-octave buckets from 1 us; the last one holds everything above 65 ms.
+	static constexpr int bucketsPerOctave = 4;
+	static constexpr int numBuckets = 16 * bucketsPerOctave + 1;
+
+	struct Snapshot
+	{
+		std::array<juce::uint32, numBuckets> counts{};
+
+		juce::uint64 getTotal() const noexcept
+		{
+			juce::uint64 total = 0;
+			for (auto count : counts)
+				total += count;
+			return total;
+		}
+
+		/** Upper edge, in microseconds, of the bucket the given fraction of calls falls in. */
+		double getPercentile(double fraction) const noexcept
+		{
+			const auto total = getTotal();
+			if (total == 0)
+				return 0.0;
+
+			const auto target = static_cast<juce::uint64>(std::ceil(fraction * static_cast<double>(total)));
+			juce::uint64 seen = 0;
+			for (int bucket = 0; bucket < numBuckets; ++bucket)
+			{
+				seen += counts[static_cast<size_t>(bucket)];
+				if (seen >= target)
+					return getBucketUpperEdge(bucket);
+			}
+			return getBucketUpperEdge(numBuckets - 1);
+		}
+
+		Snapshot operator-(const Snapshot& earlier) const noexcept
+		{
+			Snapshot difference;
+			for (size_t i = 0; i < counts.size(); ++i)
+				difference.counts[i] = counts[i] - earlier.counts[i];
+			return difference;
+		}
+	};
+
+	void record(double microseconds) noexcept
+	{
+		counts[static_cast<size_t>(getBucket(microseconds))].fetch_add(1, std::memory_order_relaxed);
+		if (microseconds > peak.load(std::memory_order_relaxed))
+			peak.store(microseconds, std::memory_order_relaxed);
+	}
+
+	Snapshot getSnapshot() const noexcept
+	{
+		Snapshot snapshot;
+		for (size_t i = 0; i < counts.size(); ++i)
+			snapshot.counts[i] = counts[i].load(std::memory_order_relaxed);
+		return snapshot;
+	}
+
+	/** Slowest call since the previous takePeak. */
+	double takePeak() noexcept { return peak.exchange(0.0, std::memory_order_relaxed); }
+
+	static int getBucket(double microseconds) noexcept
+	{
+		if (microseconds < 1.0)
+			return 0;
+		return std::min(numBuckets - 1, 1 + static_cast<int>(std::log2(microseconds) * bucketsPerOctave));
+	}
+
+	static double getBucketUpperEdge(int bucket) noexcept
+	{
+		return std::exp2(static_cast<double>(bucket) / bucketsPerOctave);
+	}
+
+private:
+	std::array<std::atomic<juce::uint32>, numBuckets> counts{};
+	std::atomic<double> peak{ 0.0 };
+};
+
+/*
+	Per-stage timings of processBlock, plus one histogram per slot filled by
+	the render workers. A timed stage costs two tick reads and a histogram
+	increment, so this stays on in release builds. The offline bounce passes
+	no profiler, which keeps its blocks out of the live figures.
+*/
+class StageProfiler
+{
+public:
+	enum Stage
+	{
+		swapStagingBuffers,
+		sequencers,
+		midi,
+		renderTracks,
+		masterEffects,
+		wholeBlock,
+		numStages
+	};
+
+	static const char* getStageName(int stage) noexcept
+	{
+		static const char* const names[numStages] = {
+			"Swap staging buffers", "Sequencers", "MIDI", "Render tracks", "Master effects", "Whole block"
+		};
+		return stage >= 0 && stage < numStages ? names[stage] : "";
+	}
+
+	/** Times its scope into a histogram; does nothing without one. */
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(StageHistogram* histogramToUse) noexcept
+			: histogram(histogramToUse), start(histogramToUse != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+		{
+		}
+
+		ScopedTimer(StageProfiler* profiler, Stage stage) noexcept
+			: ScopedTimer(profiler != nullptr ? &profiler->getStage(stage) : nullptr)
+		{
+		}
+
+		~ScopedTimer() noexcept
+		{
+			if (histogram != nullptr)
+				histogram->record(ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start));
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		StageHistogram* histogram;
+		juce::int64 start;
+	};
+
+	StageHistogram& getStage(Stage stage) noexcept { return stages[static_cast<size_t>(stage)]; }
+	StageHistogram& getSlot(int slot) noexcept { return slots[static_cast<size_t>(juce::jlimit(0, SlotParameters::maxSlots - 1, slot))]; }
+
+	/** Audio thread, once per block, with the time the whole block took. */
+	void recordBlock(juce::int64 elapsedTicks, int numSamples, double sampleRate) noexcept
+	{
+		const double microseconds = ticksToMicroseconds(elapsedTicks);
+		const double deadline = sampleRate > 0.0 ? numSamples / sampleRate * 1.0e6 : 0.0;
+		const float load = deadline > 0.0 ? static_cast<float>(microseconds / deadline) : 0.0f;
+
+		stages[wholeBlock].record(microseconds);
+		deadlineMicroseconds.store(deadline, std::memory_order_relaxed);
+		lastLoad.store(load, std::memory_order_relaxed);
+		if (load > peakLoad.load(std::memory_order_relaxed))
+			peakLoad.store(load, std::memory_order_relaxed);
+		if (load > 1.0f)
+			overruns.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	double getDeadlineMicroseconds() const noexcept { return deadlineMicroseconds.load(std::memory_order_relaxed); }
+	float getLastLoad() const noexcept { return lastLoad.load(std::memory_order_relaxed); }
+	/** Highest load since the previous takePeakLoad. */
+	float takePeakLoad() noexcept { return peakLoad.exchange(0.0f, std::memory_order_relaxed); }
+	/** Blocks that took longer than their buffer lasts. */
+	juce::uint32 getOverruns() const noexcept { return overruns.load(std::memory_order_relaxed); }
+
+	static double ticksToMicroseconds(juce::int64 ticks) noexcept
+	{
+		return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+	}
+
+private:
+	std::array<StageHistogram, numStages> stages;
+	std::array<StageHistogram, SlotParameters::maxSlots> slots;
+	std::atomic<double> deadlineMicroseconds{ 0.0 };
+	std::atomic<float> lastLoad{ 0.0f };
+	std::atomic<float> peakLoad{ 0.0f };
+	std::atomic<juce::uint32> overruns{ 0 };
+};
@@ -0,0 +1,127 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <array>
+
+/*
+	Cascade of transposed direct form II biquads running left and right as
+	two lanes of the same loop, so both channels share one pass over the
+	coefficients and the compiler can pair the lane arithmetic. New
+	coefficients are approached linearly once per sub-block instead of being
+	swapped in, which keeps gain moves free of clicks.
+*/
+template <int NumStages>
+class StereoBiquadCascade
+{
+public:
+	static constexpr int subBlockSize = 32;
+
+	struct Coefficients
+	{
+		float b0 = 1.0f;
+		float b1 = 0.0f;
+		float b2 = 0.0f;
+		float a1 = 0.0f;
+		float a2 = 0.0f;
+
+		static Coefficients from(const juce::IIRCoefficients& source)
+		{
+			return { source.coefficients[0], source.coefficients[1], source.coefficients[2],
+				source.coefficients[3], source.coefficients[4] };
+		}
+	};
+
+	void prepare(double sampleRate, double rampSeconds = 0.02)
+	{
+		rampSubBlocks = std::max(1, static_cast<int>(sampleRate * rampSeconds / subBlockSize));
+		remainingSubBlocks = 0;
+		current = target;
+		reset();
+	}
+
+	void reset()
+	{
+		for (auto& stage : state)
+			stage = {};
+	}
+
+	void setStage(int stageIndex, const juce::IIRCoefficients& coefficients)
+	{
+		target[static_cast<size_t>(stageIndex)] = Coefficients::from(coefficients);
+		remainingSubBlocks = rampSubBlocks;
+	}
+
+	void setStageImmediately(int stageIndex, const juce::IIRCoefficients& coefficients)
+	{
+		target[static_cast<size_t>(stageIndex)] = Coefficients::from(coefficients);
+		current[static_cast<size_t>(stageIndex)] = target[static_cast<size_t>(stageIndex)];
+	}
+
+	/** right may be nullptr for a mono signal. */
+	void process(float* left, float* right, int numSamples) noexcept
+	{
+		float discard = 0.0f;
+		for (int start = 0; start < numSamples; start += subBlockSize)
+		{
+			advanceRamp();
+			const int end = std::min(numSamples, start + subBlockSize);
+			for (int i = start; i < end; ++i)
+			{
+				float lanes[2] = { left[i], right != nullptr ? right[i] : 0.0f };
+				for (int stageIndex = 0; stageIndex < NumStages; ++stageIndex)
+				{
+					const auto& c = current[static_cast<size_t>(stageIndex)];
+					auto& s = state[static_cast<size_t>(stageIndex)];
+					for (int lane = 0; lane < 2; ++lane)
+					{
+						const float x = lanes[lane];
+						const float y = c.b0 * x + s.z1[lane];
+						s.z1[lane] = c.b1 * x - c.a1 * y + s.z2[lane];
+						s.z2[lane] = c.b2 * x - c.a2 * y;
+						lanes[lane] = y;
+					}
+				}
+				left[i] = lanes[0];
+				(right != nullptr ? right[i] : discard) = lanes[1];
+			}
+		}
+	}
+
+private:
+	struct StageState
+	{
+		float z1[2] = { 0.0f, 0.0f };
+		float z2[2] = { 0.0f, 0.0f };
+	};
+
+	std::array<Coefficients, NumStages> current{};
+	std::array<Coefficients, NumStages> target{};
+	std::array<StageState, NumStages> state{};
+	int rampSubBlocks = 1;
+	int remainingSubBlocks = 0;
+
+	void advanceRamp() noexcept
+	{
+		if (remainingSubBlocks <= 0)
+			return;
+
+		const float fraction = 1.0f / static_cast<float>(remainingSubBlocks);
+		for (int stageIndex = 0; stageIndex < NumStages; ++stageIndex)
+		{
+			auto& c = current[static_cast<size_t>(stageIndex)];
+			const auto& t = target[static_cast<size_t>(stageIndex)];
+			c.b0 += (t.b0 - c.b0) * fraction;
+			c.b1 += (t.b1 - c.b1) * fraction;
+			c.b2 += (t.b2 - c.b2) * fraction;
+			c.a1 += (t.a1 - c.a1) * fraction;
+			c.a2 += (t.a2 - c.a2) * fraction;
+		}
+		--remainingSubBlocks;
+	}
+};
@@ -0,0 +1,167 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include "SoundTouch.h"
+
+/*
+	Pitch-preserving stretch of a track's source as it plays. The stretcher
+	keeps its own feed position, which runs ahead of what is heard by the
+	SoundTouch latency; the renderer reports the heard position instead.
+	When the source ends, silence is fed until the buffered tail is out.
+*/
+class StreamingTimeStretch
+{
+public:
+	static constexpr int inputChunkSize = 256;
+	static constexpr int maxChunksPerBlock = 64;
+	static constexpr double minTempo = 0.25;
+	static constexpr double maxTempo = 4.0;
+
+	void prepare(double sampleRate, int maxBlockSize)
+	{
+		soundTouch.setSampleRate(static_cast<juce::uint32>(sampleRate));
+		soundTouch.setChannels(2);
+		soundTouch.setSetting(SETTING_USE_QUICKSEEK, 1);
+
+		maxFrames = std::max(maxBlockSize, inputChunkSize);
+		interleaved.assign(static_cast<size_t>(maxFrames) * 2, 0.0f);
+		inputBuffer.setSize(2, inputChunkSize);
+		inputBuffer.clear();
+
+		for (double tempo : { minTempo, maxTempo })
+		{
+			soundTouch.setTempo(tempo);
+			for (int chunk = 0; chunk < maxChunksPerBlock; ++chunk)
+			{
+				pushInput(inputChunkSize);
+				while (soundTouch.numSamples() > 0)
+				{
+					soundTouch.receiveSamples(interleaved.data(), static_cast<juce::uint32>(maxFrames));
+				}
+			}
+		}
+		reset();
+	}
+
+	void reset()
+	{
+		soundTouch.clear();
+		soundTouch.setTempo(1.0);
+		currentTempo = 1.0;
+		feedPosition = -1.0;
+		reportedPosition = -1.0;
+		drainFramesLeft = 0;
+	}
+
+	/** Feed from a new position without dropping what is still buffered. */
+	void startFeedingFrom(double position)
+	{
+		feedPosition = position;
+		drainFramesLeft = 0;
+	}
+
+	/** The source has run out: play out the buffered tail, then stop. */
+	void startDraining()
+	{
+		drainFramesLeft = static_cast<int>(std::ceil(getBufferedSourceFrames() / currentTempo)) + 1;
+	}
+
+	bool isRunning() const { return feedPosition >= 0.0; }
+	bool isDraining() const { return drainFramesLeft > 0; }
+
+	/** Source frames pushed but not heard yet. */
+	double getBufferedSourceFrames() const
+	{
+		return static_cast<double>(soundTouch.numUnprocessedSamples()) + soundTouch.numSamples() * currentTempo;
+	}
+
+	void pushSilence()
+	{
+		inputBuffer.clear();
+		pushInput(inputChunkSize);
+	}
+
+	void setTempo(double tempo)
+	{
+		tempo = juce::jlimit(minTempo, maxTempo, tempo);
+		if (std::abs(tempo - currentTempo) > 1.0e-4)
+		{
+			soundTouch.setTempo(tempo);
+			currentTempo = tempo;
+		}
+	}
+
+	int getNumAvailable() const
+	{
+		return static_cast<int>(soundTouch.numSamples());
+	}
+
+	juce::AudioBuffer<float>& getInputBuffer()
+	{
+		return inputBuffer;
+	}
+
+	void pushInput(int numFrames)
+	{
+		numFrames = juce::jlimit(0, inputBuffer.getNumSamples(), numFrames);
+		if (numFrames == 0)
+			return;
+
+		const float* left = inputBuffer.getReadPointer(0);
+		const float* right = inputBuffer.getReadPointer(1);
+		for (int i = 0; i < numFrames; ++i)
+		{
+			interleaved[static_cast<size_t>(i) * 2] = left[i];
+			interleaved[static_cast<size_t>(i) * 2 + 1] = right[i];
+		}
+		soundTouch.putSamples(interleaved.data(), static_cast<juce::uint32>(numFrames));
+	}
+
+	int pull(juce::AudioBuffer<float>& destination, int startFrame, int numFrames)
+	{
+		startFrame = juce::jlimit(0, destination.getNumSamples(), startFrame);
+		numFrames = juce::jlimit(0, std::min(maxFrames, destination.getNumSamples() - startFrame), numFrames);
+		if (numFrames == 0 || destination.getNumChannels() < 2)
+			return 0;
+
+		const int received = static_cast<int>(soundTouch.receiveSamples(interleaved.data(), static_cast<juce::uint32>(numFrames)));
+		float* left = destination.getWritePointer(0, startFrame);
+		float* right = destination.getWritePointer(1, startFrame);
+		for (int i = 0; i < received; ++i)
+		{
+			left[i] = interleaved[static_cast<size_t>(i) * 2];
+			right[i] = interleaved[static_cast<size_t>(i) * 2 + 1];
+		}
+		if (isDraining())
+		{
+			drainFramesLeft = std::max(0, drainFramesLeft - received);
+			if (drainFramesLeft == 0)
+				reset();
+		}
+		return received;
+	}
+
+	double getFeedPosition() const { return feedPosition; }
+	void setFeedPosition(double position) { feedPosition = position; }
+	double getReportedPosition() const { return reportedPosition; }
+	void setReportedPosition(double position) { reportedPosition = position; }
+	const float* getSource() const { return source; }
+	void setSource(const float* newSource) { source = newSource; }
+
+private:
+	soundtouch::SoundTouch soundTouch;
+	juce::AudioBuffer<float> inputBuffer;
+	std::vector<float> interleaved;
+	int maxFrames = inputChunkSize;
+	double currentTempo = 1.0;
+	double feedPosition = -1.0;
+	double reportedPosition = -1.0;
+	int drainFramesLeft = 0;
+	const float* source = nullptr;
+};
@@ -0,0 +1,229 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <cstring>
+#include <vector>
+
+/*
+	Push decoder for a WAV body arriving in arbitrary pieces, e.g. straight
+	off an HTTP stream. The header is parsed as soon as it is complete and
+	every whole frame after that is converted into a stereo float buffer,
+	so no temporary file or seekable stream is needed. Mono input is copied
+	to both channels to match the staging layout of the tracks.
+*/
+class StreamingWavDecoder
+{
+public:
+	/** Returns false once the data cannot be decoded; getError() says why. */
+	bool write(const void* data, size_t numBytes)
+	{
+		if (failed)
+			return false;
+
+		const auto* bytes = static_cast<const juce::uint8*>(data);
+		pending.insert(pending.end(), bytes, bytes + numBytes);
+
+		if (!inData && !parseHeader())
+			return !failed;
+
+		decodePendingFrames();
+		return true;
+	}
+
+	/** Trims the buffer to the decoded length. */
+	void finish()
+	{
+		if (inData)
+			buffer.setSize(2, numFrames, true, false, true);
+	}
+
+	bool hasFormat() const { return inData; }
+	bool hasFailed() const { return failed; }
+	bool isComplete() const { return inData && dataBytesRemaining == 0; }
+	const juce::String& getError() const { return error; }
+	double getSampleRate() const { return sampleRate; }
+	int getNumFrames() const { return numFrames; }
+	juce::AudioBuffer<float>& getBuffer() { return buffer; }
+
+private:
+	enum Encoding
+	{
+		pcm = 1,
+		ieeeFloat = 3,
+		extensible = 0xfffe
+	};
+
+	static constexpr juce::uint32 unknownDataSize = 0xffffffffu;
+	static constexpr int initialCapacity = 65536;
+
+	std::vector<juce::uint8> pending;
+	size_t readOffset = 0;
+	bool headerChecked = false;
+	bool hasFormatChunk = false;
+	bool inData = false;
+	bool failed = false;
+	juce::String error;
+
+	int encoding = 0;
+	int numChannels = 0;
+	int bitsPerSample = 0;
+	int blockAlign = 0;
+	double sampleRate = 0.0;
+	juce::uint32 dataBytesRemaining = 0;
+
+	juce::AudioBuffer<float> buffer;
+	int numFrames = 0;
+
+	static juce::uint32 readLE32(const juce::uint8* p) { return juce::ByteOrder::littleEndianInt(p); }
+	static juce::uint16 readLE16(const juce::uint8* p) { return juce::ByteOrder::littleEndianShort(p); }
+
+	size_t available() const { return pending.size() - readOffset; }
+
+	bool fail(const juce::String& message)
+	{
+		failed = true;
+		error = message;
+		return false;
+	}
+
+	bool parseHeader()
+	{
+		if (!headerChecked)
+		{
+			if (available() < 12)
+				return false;
+			const auto* p = pending.data() + readOffset;
+			if (std::memcmp(p, "RIFF", 4) != 0 || std::memcmp(p + 8, "WAVE", 4) != 0)
+				return fail("Response is not a WAV stream");
+			readOffset += 12;
+			headerChecked = true;
+		}
+
+		while (available() >= 8)
+		{
+			const auto* p = pending.data() + readOffset;
+			const juce::uint32 chunkSize = readLE32(p + 4);
+
+			if (std::memcmp(p, "data", 4) == 0)
+			{
+				if (!hasFormatChunk)
+					return fail("WAV data chunk before format chunk");
+				readOffset += 8;
+				// Streamed WAVs may leave the size at zero or all ones.
+				dataBytesRemaining = chunkSize == 0 ? unknownDataSize : chunkSize;
+				inData = true;
+
+				const int expectedFrames = dataBytesRemaining != unknownDataSize
+					? static_cast<int>(dataBytesRemaining / static_cast<juce::uint32>(blockAlign))
+					: initialCapacity;
+				buffer.setSize(2, juce::jmax(1, expectedFrames), false, true, false);
+				return true;
+			}
+
+			const size_t paddedSize = static_cast<size_t>(chunkSize) + (chunkSize & 1u);
+			if (available() < 8 + paddedSize)
+				return false;
+
+			if (std::memcmp(p, "fmt ", 4) == 0 && !parseFormat(p + 8, chunkSize))
+				return false;
+
+			readOffset += 8 + paddedSize;
+		}
+		return false;
+	}
+
+	bool parseFormat(const juce::uint8* p, juce::uint32 size)
+	{
+		if (size < 16)
+			return fail("WAV format chunk too short");
+
+		encoding = readLE16(p);
+		numChannels = readLE16(p + 2);
+		sampleRate = static_cast<double>(readLE32(p + 4));
+		blockAlign = readLE16(p + 12);
+		bitsPerSample = readLE16(p + 14);
+
+		if (encoding == extensible && size >= 40)
+			encoding = readLE16(p + 24);
+
+		const bool supported = (encoding == pcm && (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32))
+			|| (encoding == ieeeFloat && bitsPerSample == 32);
+		if (!supported || numChannels < 1 || sampleRate <= 0.0 || blockAlign < numChannels * (bitsPerSample / 8))
+			return fail("Unsupported WAV encoding");
+
+		hasFormatChunk = true;
+		return true;
+	}
+
+	float decodeSample(const juce::uint8* p) const
+	{
+		switch (bitsPerSample)
+		{
+		case 8:
+			return (static_cast<float>(*p) - 128.0f) / 128.0f;
+		case 16:
+			return static_cast<float>(static_cast<juce::int16>(readLE16(p))) / 32768.0f;
+		case 24:
+		{
+			const juce::int32 value = static_cast<juce::int32>((static_cast<juce::uint32>(p[0]) << 8)
+				| (static_cast<juce::uint32>(p[1]) << 16) | (static_cast<juce::uint32>(p[2]) << 24)) >> 8;
+			return static_cast<float>(value) / 8388608.0f;
+		}
+		default:
+		{
+			const juce::uint32 bits = readLE32(p);
+			if (encoding == ieeeFloat)
+			{
+				float value;
+				std::memcpy(&value, &bits, sizeof(value));
+				return value;
+			}
+			return static_cast<float>(static_cast<double>(static_cast<juce::int32>(bits)) / 2147483648.0);
+		}
+		}
+	}
+
+	void decodePendingFrames()
+	{
+		size_t usableBytes = available();
+		if (dataBytesRemaining != unknownDataSize)
+			usableBytes = juce::jmin(usableBytes, static_cast<size_t>(dataBytesRemaining));
+
+		const int framesReady = static_cast<int>(usableBytes / static_cast<size_t>(blockAlign));
+		if (framesReady > 0)
+		{
+			if (numFrames + framesReady > buffer.getNumSamples())
+				buffer.setSize(2, juce::jmax(numFrames + framesReady, buffer.getNumSamples() * 2), true, false, false);
+
+			const int bytesPerSample = bitsPerSample / 8;
+			const auto* frame = pending.data() + readOffset;
+			float* left = buffer.getWritePointer(0, numFrames);
+			float* right = buffer.getWritePointer(1, numFrames);
+			for (int i = 0; i < framesReady; ++i, frame += blockAlign)
+			{
+				left[i] = decodeSample(frame);
+				right[i] = numChannels > 1 ? decodeSample(frame + bytesPerSample) : left[i];
+			}
+
+			const size_t consumed = static_cast<size_t>(framesReady) * static_cast<size_t>(blockAlign);
+			readOffset += consumed;
+			numFrames += framesReady;
+			if (dataBytesRemaining != unknownDataSize)
+				dataBytesRemaining -= static_cast<juce::uint32>(consumed);
+		}
+
+		// Keep only the partial frame so the pending bytes stay bounded; trailing
+		// chunks after the data are not needed.
+		if (dataBytesRemaining == 0)
+			pending.clear();
+		else
+			pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(readOffset));
+		readOffset = 0;
+	}
+};
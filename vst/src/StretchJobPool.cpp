@@ -0,0 +1,173 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#include "StretchJobPool.h"
+
+void StretchJobPool::JobContext::setProgress(float progress)
+{
+	int percent = juce::jlimit(0, 100, static_cast<int>(progress * 100.0f));
+	if (percent / 10 == lastReportedPercent / 10 && lastReportedPercent >= 0)
+		return;
+
+	lastReportedPercent = percent;
+	pool.reportProgress(key, percent / 100.0f);
+}
+
+StretchJobPool::StretchJobPool(int numWorkers)
+{
+	for (int i = 0; i < std::max(1, numWorkers); ++i)
+	{
+		workers.push_back(std::make_unique<Worker>(*this, i));
+		workers.back()->startThread(juce::Thread::Priority::low);
+	}
+}
+
+StretchJobPool::~StretchJobPool()
+{
+	stop();
+}
+
+void StretchJobPool::submit(const juce::String& key, int priority, JobFunction function)
+{
+	if (stopping.load())
+		return;
+
+	{
+		juce::ScopedLock lock(queueLock);
+		cancel(key);
+
+		Job job;
+		job.key = key;
+		job.priority = priority;
+		job.sequence = nextSequence++;
+		job.function = std::move(function);
+		job.context.reset(new JobContext(*this, key, stopping));
+		pendingJobs.push_back(std::move(job));
+	}
+	jobAvailable.signal();
+}
+
+void StretchJobPool::cancel(const juce::String& key)
+{
+	juce::ScopedLock lock(queueLock);
+	pendingJobs.erase(std::remove_if(pendingJobs.begin(), pendingJobs.end(),
+		[&key](const Job& job) { return job.key == key; }),
+		pendingJobs.end());
+
+	for (auto& context : runningJobs)
+	{
+		if (context->getKey() == key)
+			context->cancelled = true;
+	}
+}
+
+void StretchJobPool::cancelAll()
+{
+	juce::ScopedLock lock(queueLock);
+	pendingJobs.clear();
+	for (auto& context : runningJobs)
+	{
+		context->cancelled = true;
+	}
+}
+
+void StretchJobPool::stop()
+{
+	if (stopping.exchange(true))
+		return;
+
+	cancelAll();
+	for (auto& worker : workers)
+	{
+		worker->signalThreadShouldExit();
+	}
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		jobAvailable.signal();
+	}
+	for (auto& worker : workers)
+	{
+		worker->stopThread(10000);
+	}
+	workers.clear();
+}
+
+int StretchJobPool::getNumPendingJobs() const
+{
+	juce::ScopedLock lock(queueLock);
+	return static_cast<int>(pendingJobs.size() + runningJobs.size());
+}
+
+bool StretchJobPool::takeNextJob(Job& job)
+{
+	juce::ScopedLock lock(queueLock);
+
+	auto best = pendingJobs.end();
+	for (auto it = pendingJobs.begin(); it != pendingJobs.end(); ++it)
+	{
+		bool keyRunning = std::any_of(runningJobs.begin(), runningJobs.end(),
+			[&it](const std::shared_ptr<JobContext>& context) { return context->getKey() == it->key; });
+		if (keyRunning)
+			continue;
+
+		if (best == pendingJobs.end() ||
+			it->priority > best->priority ||
+			(it->priority == best->priority && it->sequence < best->sequence))
+		{
+			best = it;
+		}
+	}
+
+	if (best == pendingJobs.end())
+		return false;
+
+	job = std::move(*best);
+	pendingJobs.erase(best);
+	runningJobs.push_back(job.context);
+	return true;
+}
+
+void StretchJobPool::finishJob(const juce::String& key)
+{
+	{
+		juce::ScopedLock lock(queueLock);
+		runningJobs.erase(std::remove_if(runningJobs.begin(), runningJobs.end(),
+			[&key](const std::shared_ptr<JobContext>& context) { return context->getKey() == key; }),
+			runningJobs.end());
+	}
+	jobAvailable.signal();
+}
+
+void StretchJobPool::reportProgress(const juce::String& key, float progress)
+{
+	if (onProgress)
+		onProgress(key, progress);
+}
+
+void StretchJobPool::Worker::run()
+{
+	while (!threadShouldExit())
+	{
+		Job job;
+		if (!pool.takeNextJob(job))
+		{
+			pool.jobAvailable.wait(200);
+			continue;
+		}
+
+		try
+		{
+			if (!job.context->isCancelled())
+				job.function(*job.context);
+		}
+		catch (const std::exception& e)
+		{
+			DBG("Stretch job failed for " << job.key << ": " << e.what());
+		}
+		pool.finishJob(job.key);
+	}
+}
@@ -0,0 +1,86 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+
+class StretchJobPool
+{
+public:
+	class JobContext
+	{
+	public:
+		bool isCancelled() const { return cancelled.load() || poolStopping.load(); }
+		void setProgress(float progress);
+		const juce::String& getKey() const { return key; }
+
+	private:
+		friend class StretchJobPool;
+		JobContext(StretchJobPool& owner, const juce::String& jobKey, const std::atomic<bool>& stopping)
+			: pool(owner), key(jobKey), poolStopping(stopping) {
+		}
+
+		StretchJobPool& pool;
+		juce::String key;
+		const std::atomic<bool>& poolStopping;
+		std::atomic<bool> cancelled{ false };
+		int lastReportedPercent = -1;
+	};
+
+	using JobFunction = std::function<void(JobContext&)>;
+
+	explicit StretchJobPool(int numWorkers = 2);
+	~StretchJobPool();
+
+	void submit(const juce::String& key, int priority, JobFunction job);
+	void cancel(const juce::String& key);
+	void cancelAll();
+	void stop();
+	int getNumPendingJobs() const;
+
+	std::function<void(const juce::String& key, float progress)> onProgress;
+
+private:
+	struct Job
+	{
+		juce::String key;
+		int priority = 0;
+		juce::int64 sequence = 0;
+		JobFunction function;
+		std::shared_ptr<JobContext> context;
+	};
+
+	class Worker : public juce::Thread
+	{
+	public:
+		Worker(StretchJobPool& owner, int index)
+			: juce::Thread("StretchWorker" + juce::String(index)), pool(owner) {
+		}
+		void run() override;
+
+	private:
+		StretchJobPool& pool;
+	};
+
+	bool takeNextJob(Job& job);
+	void finishJob(const juce::String& key);
+	void reportProgress(const juce::String& key, float progress);
+
+	mutable juce::CriticalSection queueLock;
+	std::vector<Job> pendingJobs;
+	std::vector<std::shared_ptr<JobContext>> runningJobs;
+	juce::WaitableEvent jobAvailable;
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<bool> stopping{ false };
+	juce::int64 nextSequence = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StretchJobPool)
+};
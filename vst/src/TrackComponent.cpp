@@ -67,7 +67,7 @@ void TrackComponent::updateUIFromParameter(const juce::String& paramName,
 
 	if (paramName == slotPrefix + " Generate")
 	{
-		if (newValue > 0.5 && audioProcessor.getIsGenerating())
+		if (newValue > 0.5 && audioProcessor.isTrackGenerating(trackId))
 		{
 			return;
 		}
@@ -221,7 +221,10 @@ void TrackComponent::toggleWaveformDisplay()
 
 		if (track && track->numSamples > 0)
 		{
-			waveformDisplay->setAudioData(track->audioBuffer, track->sampleRate);
+			if (track->usePages.load())
+				setWaveformFromPage(track->getCurrentPage());
+			else
+				waveformDisplay->setAudioData(track->audioBuffer, track->sampleRate);
 			waveformDisplay->setLoopPoints(track->loopStart, track->loopEnd);
 			calculateHostBasedDisplay();
 		}
@@ -310,6 +313,8 @@ void TrackComponent::updateFromTrackData()
 	showWaveformButton.setToggleState(track->showWaveform, juce::dontSendNotification);
 	sequencerToggleButton.setToggleState(track->showSequencer, juce::dontSendNotification);
 	randomDurationToggle.setToggleState(track->randomRetriggerDurationEnabled.load(), juce::dontSendNotification);
+	updateInterpolationQualityButton();
+	streamingStretchToggle.setToggleState(track->streamingStretch.load(), juce::dontSendNotification);
 
 	if (track->usePages.load()) {
 		const auto& currentPage = track->getCurrentPage();
@@ -523,6 +528,10 @@ void TrackComponent::resized()
 	headerArea.removeFromRight(5);
 	randomDurationToggle.setBounds(headerArea.removeFromRight(35));
 	headerArea.removeFromRight(5);
+	interpolationQualityButton.setBounds(headerArea.removeFromRight(35));
+	headerArea.removeFromRight(5);
+	streamingStretchToggle.setBounds(headerArea.removeFromRight(35));
+	headerArea.removeFromRight(5);
 
 	auto knobArea = headerArea.removeFromRight(50);
 	auto knobBounds = knobArea.withHeight(55).withY(knobArea.getY() - 8);
@@ -643,12 +652,20 @@ void TrackComponent::onPageSelected(int pageIndex)
 
 	DBG("Switching to page " << (char)('A' + pageIndex) << " for track " << track->trackName);
 
+	if (audioProcessor.queuePageSwitch(track->trackId, pageIndex)) {
+		char pageName = 'A' + static_cast<char>(pageIndex);
+		statusCallback("Page " + juce::String(pageName) + " queued for next bar");
+		updatePagesDisplay();
+		return;
+	}
+
 	bool wasPlaying = track->isPlaying.load();
 	bool wasArmed = track->isArmed.load();
 	bool wasArmedToStop = track->isArmedToStop.load();
 	bool wasCurrentlyPlaying = track->isCurrentlyPlaying.load();
 	double currentReadPosition = track->readPosition.load();
 
+	track->pendingPageIndex = -1;
 	track->setCurrentPage(pageIndex);
 
 	track->isPlaying = wasPlaying;
@@ -657,9 +674,17 @@ void TrackComponent::onPageSelected(int pageIndex)
 	track->isCurrentlyPlaying = wasCurrentlyPlaying;
 	track->readPosition = currentReadPosition;
 
+	audioProcessor.updatePagePrefetch(track->trackId);
+	onPageSwitched(pageIndex, currentReadPosition);
+}
+
+void TrackComponent::onPageSwitched(int pageIndex, double currentReadPosition)
+{
+	if (!track || !pagesMode) return;
+
 	const auto& newPage = track->getCurrentPage();
 
-	if (newPage.numSamples == 0 && wasPlaying) {
+	if (newPage.numSamples == 0 && track->isPlaying.load()) {
 		track->isPlaying = false;
 		track->isCurrentlyPlaying = false;
 		track->readPosition = 0.0;
@@ -674,7 +699,7 @@ void TrackComponent::onPageSelected(int pageIndex)
 
 	if (waveformDisplay && showWaveformButton.getToggleState()) {
 		if (newPage.numSamples > 0 && newPage.isLoaded.load()) {
-			waveformDisplay->setAudioData(newPage.audioBuffer, newPage.sampleRate);
+			setWaveformFromPage(newPage);
 			waveformDisplay->setLoopPoints(newPage.loopStart, newPage.loopEnd);
 			calculateHostBasedDisplay();
 		}
@@ -722,7 +747,11 @@ void TrackComponent::updatePagesDisplay()
 	for (int i = 0; i < 4; ++i) {
 		pageButtons[i].setToggleState(i == track->currentPageIndex, juce::dontSendNotification);
 
-		if (track->pages[i].numSamples > 0) {
+		if (i == track->pendingPageIndex.load()) {
+			pageButtons[i].setColour(juce::TextButton::textColourOffId, ColourPalette::amber);
+			pageButtons[i].setColour(juce::TextButton::buttonColourId, ColourPalette::backgroundLight);
+		}
+		else if (track->pages[i].numSamples > 0) {
 			pageButtons[i].setColour(juce::TextButton::textColourOffId, ColourPalette::textSuccess);
 			pageButtons[i].setColour(juce::TextButton::buttonColourId,
 				i == track->currentPageIndex ? ColourPalette::buttonSuccess : ColourPalette::backgroundLight);
@@ -738,6 +767,19 @@ void TrackComponent::updatePagesDisplay()
 	}
 }
 
+void TrackComponent::setWaveformFromPage(const TrackPage& page)
+{
+	if (!waveformDisplay) return;
+
+	const auto* mapped = page.getMappedAudio();
+	if (page.audioBuffer.getNumSamples() == 0 && mapped != nullptr) {
+		auto view = mapped->createView();
+		waveformDisplay->setAudioData(view, page.sampleRate);
+		return;
+	}
+	waveformDisplay->setAudioData(page.audioBuffer, page.sampleRate);
+}
+
 void TrackComponent::loadPageIfNeeded(int pageIndex)
 {
 	if (!track || pageIndex < 0 || pageIndex >= 4) return;
@@ -790,6 +832,9 @@ void TrackComponent::loadPageAudioFile(int pageIndex, const juce::File& audioFil
 
 		page.numSamples = numSamples;
 		page.sampleRate = reader->sampleRate;
+		if (audioProcessor.getMemoryMappedPages()) {
+			TrackManager::mapPageAudio(page);
+		}
 		page.isLoaded = true;
 		page.isLoading = false;
 
@@ -849,7 +894,7 @@ void TrackComponent::stopGeneratingAnimation()
 		if (track->usePages.load()) {
 			const auto& currentPage = track->getCurrentPage();
 			if (currentPage.numSamples > 0) {
-				waveformDisplay->setAudioData(currentPage.audioBuffer, currentPage.sampleRate);
+				setWaveformFromPage(currentPage);
 				waveformDisplay->setLoopPoints(currentPage.loopStart, currentPage.loopEnd);
 			}
 		}
@@ -881,7 +926,7 @@ void TrackComponent::refreshWaveformDisplay()
 		const auto& currentPage = track->getCurrentPage();
 
 		if (currentPage.numSamples > 0 && currentPage.isLoaded.load()) {
-			waveformDisplay->setAudioData(currentPage.audioBuffer, currentPage.sampleRate);
+			setWaveformFromPage(currentPage);
 			waveformDisplay->setLoopPoints(currentPage.loopStart, currentPage.loopEnd);
 
 			if (!currentPage.audioFilePath.isEmpty()) {
@@ -1155,9 +1200,52 @@ void TrackComponent::setupUI()
 		}
 		};
 
+	addAndMakeVisible(interpolationQualityButton);
+	interpolationQualityButton.setButtonText("LIN");
+	interpolationQualityButton.setTooltip("Varispeed interpolation quality (linear / cubic / sinc)");
+	interpolationQualityButton.setColour(juce::TextButton::buttonColourId, ColourPalette::backgroundDark);
+	interpolationQualityButton.onClick = [this]()
+		{
+			cycleInterpolationQuality();
+		};
+
+	addAndMakeVisible(streamingStretchToggle);
+	streamingStretchToggle.setButtonText("ST");
+	streamingStretchToggle.setTooltip("Follow host tempo changes with pitch-preserving streaming stretch (host BPM modes)");
+	streamingStretchToggle.setColour(juce::ToggleButton::textColourId, ColourPalette::textSecondary);
+	streamingStretchToggle.onClick = [this]() {
+		if (track) {
+			track->streamingStretch = streamingStretchToggle.getToggleState();
+			statusCallback("Streaming stretch: " + juce::String(track->streamingStretch.load() ? "ON" : "OFF")
+				+ " (applies from the next sample load)");
+		}
+		};
+
 	setupPagesUI();
 }
 
+void TrackComponent::cycleInterpolationQuality()
+{
+	if (!track)
+		return;
+
+	int next = (track->interpolationQuality.load() + 1) % PlaybackKernel::numInterpolationQualities;
+	track->interpolationQuality = static_cast<juce::uint8>(next);
+	updateInterpolationQualityButton();
+
+	const juce::String names[] = { "linear", "cubic", "sinc" };
+	statusCallback("Interpolation: " + names[next]);
+}
+
+void TrackComponent::updateInterpolationQualityButton()
+{
+	if (!track)
+		return;
+
+	auto quality = PlaybackKernel::toInterpolationQuality(track->interpolationQuality.load());
+	interpolationQualityButton.setButtonText(PlaybackKernel::getInterpolationQualityName(quality));
+}
+
 void TrackComponent::onRandomRetriggerToggled()
 {
 	if (!track) return;
@@ -1442,6 +1530,13 @@ void TrackComponent::updateTrackInfo()
 	if (!track)
 		return;
 
+	if (track->audioRestorePending.load())
+	{
+		infoLabel.setText("Restoring audio...", juce::dontSendNotification);
+		repaint();
+		return;
+	}
+
 	if (!track->prompt.isEmpty())
 	{
 		float effectiveBpm = calculateEffectiveBpm();
@@ -84,6 +84,7 @@ public:
 	void setupMidiLearn();
 	void updatePromptSelection(const juce::String& promptText);
 	void onPageSelected(int pageIndex);
+	void onPageSwitched(int pageIndex, double readPosition);
 
 	bool isEditingLabel = false;
 	MidiLearnableComboBox promptPresetSelector;
@@ -120,6 +121,8 @@ private:
 	juce::Label intervalLabel;
 
 	juce::ToggleButton randomDurationToggle;
+	juce::TextButton interpolationQualityButton;
+	juce::ToggleButton streamingStretchToggle;
 
 	juce::Slider bpmOffsetSlider;
 	juce::Label bpmOffsetLabel;
@@ -140,6 +143,7 @@ private:
 	void onTogglePagesMode();
 	void loadPageIfNeeded(int pageIndex);
 	void loadPageAudioFile(int pageIndex, const juce::File& audioFile);
+	void setWaveformFromPage(const TrackPage& page);
 	void layoutPagesButtons(juce::Rectangle<int> area);
 	void calculateHostBasedDisplay();
 	void paint(juce::Graphics& g);
@@ -164,6 +168,8 @@ private:
 	void statusCallback(const juce::String& message);
 	void onRandomRetriggerToggled();
 	void onIntervalChanged();
+	void cycleInterpolationQuality();
+	void updateInterpolationQualityButton();
 	void setSliderParameter(juce::String name, juce::Slider& slider);
 	void addEventListeners();
 
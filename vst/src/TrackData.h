@@ -8,6 +8,10 @@
 #pragma once
 #include <JuceHeader.h>
 #include "DjIaClient.h"
+#include "MappedAudioSource.h"
+#include "UIUpdateFlags.h"
+#include <array>
+#include <vector>
 
 struct TrackPage
 {
@@ -35,6 +39,14 @@ struct TrackPage
 	std::atomic<bool> isLoaded{ false };
 	std::atomic<bool> isLoading{ false };
 
+	std::shared_ptr<MappedAudioSource> mappedAudio;
+	std::atomic<const MappedAudioSource*> mappedAudioView{ nullptr };
+	// The source the renderer last read through this page. A replaced source
+	// waits in retiredMappedAudio until this no longer points at it.
+	mutable std::atomic<const MappedAudioSource*> mappedAudioInUse{ nullptr };
+	double prefaultedLoopStart = -1.0;
+	double prefaultedLoopEnd = -1.0;
+
 	TrackPage() = default;
 
 	TrackPage(const TrackPage& other) {
@@ -58,6 +70,89 @@ struct TrackPage
 		originalStagingBuffer = other.originalStagingBuffer;
 		isLoaded = other.isLoaded.load();
 		isLoading = other.isLoading.load();
+		mappedAudio = other.mappedAudio;
+		mappedAudioView = mappedAudio.get();
+	}
+
+	const MappedAudioSource* getMappedAudio() const {
+		return mappedAudioView.load();
+	}
+
+	void setMappedAudio(std::shared_ptr<MappedAudioSource> source) {
+		mappedAudioView = source.get();
+		if (mappedAudio) {
+			const juce::SpinLock::ScopedLockType lock(retiredMappedAudioLock);
+			retiredMappedAudio.push_back(std::move(mappedAudio));
+		}
+		mappedAudio = std::move(source);
+		prefaultedLoopStart = -1.0;
+		prefaultedLoopEnd = -1.0;
+	}
+
+	bool hasAudioData() const {
+		return audioBuffer.getNumSamples() > 0 || getMappedAudio() != nullptr;
+	}
+
+	/** Loaded and not being replaced, so a queued switch to it plays at once. */
+	bool isReadyToPlay() const {
+		return isLoaded.load() && !isLoading.load() && hasAudioData();
+	}
+
+	/** Audio thread. Publishes the source it returns so it is not released while the block reads it. */
+	const MappedAudioSource* acquireMappedAudio() const {
+		const MappedAudioSource* mapped = mappedAudioView.load();
+		for (;;) {
+			mappedAudioInUse.store(mapped);
+			const MappedAudioSource* latest = mappedAudioView.load();
+			if (latest == mapped)
+				return mapped;
+			mapped = latest;
+		}
+	}
+
+	/** Message thread. Releases replaced sources the renderer has moved past. */
+	void collectRetiredMappedAudio() {
+		std::vector<std::shared_ptr<MappedAudioSource>> released;
+		{
+			const juce::SpinLock::ScopedLockType lock(retiredMappedAudioLock);
+			const MappedAudioSource* inUse = mappedAudioInUse.load();
+			for (auto it = retiredMappedAudio.begin(); it != retiredMappedAudio.end();) {
+				if (it->get() != inUse) {
+					released.push_back(std::move(*it));
+					it = retiredMappedAudio.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+		}
+	}
+
+	/** Audio thread, when it stops reading this page's mapped source. */
+	void releaseMappedAudio() const {
+		mappedAudioInUse.store(nullptr);
+	}
+
+	/** Audio thread; see acquireMappedAudio. */
+	int getAudioChannels(const float* channels[2]) const {
+		if (audioBuffer.getNumSamples() > 0 && audioBuffer.getNumChannels() > 0) {
+			releaseMappedAudio();
+			channels[0] = audioBuffer.getReadPointer(0);
+			channels[1] = audioBuffer.getReadPointer(std::min(1, audioBuffer.getNumChannels() - 1));
+			return audioBuffer.getNumSamples();
+		}
+		if (const auto* mapped = acquireMappedAudio()) {
+			channels[0] = mapped->getReadPointer(0);
+			channels[1] = mapped->getReadPointer(1);
+			return mapped->getNumSamples();
+		}
+		channels[0] = channels[1] = nullptr;
+		return 0;
+	}
+
+	juce::String getMappedAudioKey() const {
+		const auto* source = getMappedAudio();
+		return source != nullptr ? source->getKey() : juce::String();
 	}
 
 	void reset() {
@@ -79,61 +174,132 @@ struct TrackPage
 		useOriginalFile = false;
 		hasOriginalVersion = false;
 		originalStagingBuffer.setSize(0, 0);
+		setMappedAudio(nullptr);
 		isLoaded = false;
 		isLoading = false;
 	}
+
+	juce::SpinLock retiredMappedAudioLock;
+	std::vector<std::shared_ptr<MappedAudioSource>> retiredMappedAudio;
 };
 
 struct TrackData
 {
+	/*
+		Hot state comes first, in this order on purpose. The renderer reads
+		the first cache line every block and writes the second; the third
+		describes the loop it plays. Control threads store only into the
+		first, so a fader move no longer invalidates the line the audio thread
+		keeps writing. Names, prompts, callbacks, pages and the sequencer
+		follow as cold data the render loop does not touch.
+	*/
+
+	// Written by the message and MIDI threads, read by the renderer.
+	alignas(64) std::atomic<bool> isEnabled{ true };
+	std::atomic<bool> isSolo{ false };
+	std::atomic<bool> isMuted{ false };
+	std::atomic<bool> isPlaying{ false };
+	std::atomic<bool> usePages{ false };
+	std::atomic<bool> streamingStretch{ false };
+	// Restored from a project while its audio is still being decoded on the
+	// job pool; the renderer skips the track until this clears.
+	std::atomic<bool> audioRestorePending{ false };
+	// Start/stop requests from the UI and parameters; the processor turns
+	// them into beatRepeatEventSample.
+	std::atomic<bool> beatRepeatPending{ false };
+	std::atomic<bool> beatRepeatStopPending{ false };
+	// A byte so the group above still fits one line with the offsets below.
+	std::atomic<juce::uint8> interpolationQuality{ 0 };
+	int timeStretchMode = 4;
+	int slotIndex = -1;
+	std::atomic<float> volume{ 0.8f };
+	std::atomic<float> pan{ 0.0f };
+	std::atomic<float> insertEqLow{ 0.0f };
+	std::atomic<float> insertEqMid{ 0.0f };
+	std::atomic<float> insertEqHigh{ 0.0f };
+	std::atomic<float> insertFilter{ 0.0f };
+	std::atomic<float> insertCompression{ 0.0f };
+	std::atomic<float> insertDelaySend{ 0.0f };
+	float fineOffset = 0.0f;
+	double bpmOffset = 0.0;
+
+	// Written by the audio thread while rendering.
+	alignas(64) std::atomic<double> readPosition{ 0.0 };
+	std::atomic<double> originalReadPosition{ 0.0 };
+	std::atomic<double> beatRepeatStartPosition{ 0.0 };
+	std::atomic<double> beatRepeatEndPosition{ 0.0 };
+	std::atomic<double> cachedPlaybackRatio{ 1.0 };
+	std::atomic<bool> beatRepeatActive{ false };
+	bool renderedPlaying = false;
+	int numScheduledEvents = 0;
+	// Absolute sample of the next quantized beat-repeat event, -1 if none.
+	juce::int64 beatRepeatEventSample = -1;
+
+	// The loop being played: a legacy track's own, or the current page's as
+	// synced by syncLegacyPlaybackProperties.
+	alignas(64) int numSamples = 0;
+	float originalBpm = 126.0f;
+	double sampleRate = 48000.0;
+	double loopStart = 0.0;
+	double loopEnd = 4.0;
+	// Switched on the audio thread at a bar line, read everywhere.
+	std::atomic<int> currentPageIndex{ 0 };
+
 	juce::String trackId;
 	juce::String trackName;
-	int slotIndex = -1;
 
 	TrackPage pages[4];
-	int currentPageIndex = 0;
-	std::atomic<bool> usePages{ false };
+	std::atomic<int> pendingPageIndex{ -1 };
+	std::atomic<bool> pageSwitchApplied{ false };
+	// Held by the audio thread while it applies a queued switch and by the
+	// message thread while it releases an inactive page's buffer, so a
+	// page cannot become current between the release's check and its free.
+	juce::SpinLock pageSwitchLock;
 
-	std::atomic<bool> isPlaying{ false };
 	std::atomic<bool> isArmed{ false };
 	std::atomic<bool> isArmedToStop{ false };
 	std::atomic<bool> isCurrentlyPlaying{ false };
 
-	float fineOffset = 0.0f;
-	std::atomic<double> cachedPlaybackRatio{ 1.0 };
-
 	juce::AudioSampleBuffer stagingBuffer;
 	std::atomic<bool> hasStagingData{ false };
 	std::atomic<bool> swapRequested{ false };
+	// Set by the audio thread after a swap; the processor timer then copies
+	// the page's prompts and stems, which may allocate, on the message thread.
+	std::atomic<bool> legacySyncPending{ false };
 	std::atomic<int> stagingNumSamples{ 0 };
 	std::atomic<double> stagingSampleRate{ 48000.0 };
 	float stagingOriginalBpm = 126.0f;
 
-	int timeStretchMode = 4;
+	// Generated loop waiting to be picked up by processIncomingAudio, either as
+	// a file or already decoded. Both are written by a generation worker, so
+	// they are only touched under the lock. Once the audio thread has handed
+	// them to a stretch job it sets pendingAudioConsumed, and the timer drops
+	// its references so the decoded buffer is not kept until the next loop.
+	juce::SpinLock pendingAudioLock;
+	juce::File pendingAudioFile;
+	std::shared_ptr<DjIaClient::DecodedAudio> pendingDecodedAudio;
+	bool pendingAudioConsumed = false;
+	std::atomic<bool> hasPendingAudio{ false };
+	std::atomic<bool> waitingForMidiToLoad{ false };
+	std::atomic<bool> correctMidiNoteReceived{ false };
+	// A progressive generation's first bar was delivered; the complete loop
+	// that follows it, like a requested variation, loads without waiting for
+	// a note or a manual load.
+	std::atomic<bool> previewDelivered{ false };
+	std::atomic<bool> pendingLoadsImmediately{ false };
+
 	double timeStretchRatio = 1.0;
-	double bpmOffset = 0.0;
 	int midiNote = 60;
 
-	std::atomic<bool> isEnabled{ true };
-	std::atomic<bool> isSolo{ false };
-	std::atomic<bool> isMuted{ false };
 	std::atomic<bool> loopPointsLocked{ false };
-	std::atomic<float> volume{ 0.8f };
-	std::atomic<float> pan{ 0.0f };
 
 	float bpm = 126.0f;
-	std::atomic<double> readPosition{ 0.0 };
 
 	bool showWaveform = false;
 	bool showSequencer = false;
 
 	juce::AudioSampleBuffer audioBuffer;
 	juce::String audioFilePath;
-	double sampleRate = 48000.0;
-	int numSamples = 0;
-	double loopStart = 0.0;
-	double loopEnd = 4.0;
-	float originalBpm = 126.0f;
 	juce::String prompt;
 	juce::String style;
 	juce::String stems;
@@ -158,17 +324,69 @@ struct TrackData
 	std::atomic<double> lastRetriggerTime{ -1.0 };
 	std::atomic<double> nextRetriggerTime{ 0.0 };
 	std::atomic<bool> randomRetriggerActive{ false };
-	std::atomic<bool> beatRepeatActive{ false };
-	std::atomic<double> beatRepeatStartPosition{ 0.0 };
-	std::atomic<double> beatRepeatEndPosition{ 0.0 };
 	std::atomic<double> beatRepeatDuration{ 0.25 };
-	std::atomic<double> originalReadPosition{ 0.0 };
-	std::atomic<bool> beatRepeatPending{ false };
 	std::atomic<double> lastBeatTime{ -1.0 };
-	std::atomic<bool> beatRepeatStopPending{ false };
 	std::atomic<bool> randomRetriggerDurationEnabled{ false };
-	std::atomic<int64_t> pendingBeatNumber{ -1 };
-	std::atomic<int64_t> pendingStopBeatNumber{ -1 };
+
+	/*
+		The event beatRepeatEventSample points at, placed on the half-beat
+		grid when a request comes in and moved only if the tempo changes.
+		Audio thread only.
+	*/
+	struct BeatRepeatTimeline
+	{
+		bool stop = false;
+		double placedAtBpm = 0.0;
+		double repeatSamples = 0.0;
+	} beatRepeatTimeline;
+
+	/*
+		Transport changes that land inside the current block, in sample order.
+		Control code still sets the end-of-block state; the renderer uses these
+		only to place each change at its offset. Audio thread only.
+	*/
+	struct ScheduledEvent
+	{
+		enum class Type
+		{
+			Start,
+			Stop,
+			BeatRepeatStart,
+			BeatRepeatStop
+		};
+
+		Type type = Type::Start;
+		int offset = 0;
+		double value = 0.0;
+	};
+
+	static constexpr int maxScheduledEvents = 16;
+	std::array<ScheduledEvent, maxScheduledEvents> scheduledEvents{};
+	// Events that did not fit; their end-of-block state still applies, only
+	// the in-block timing is lost. Shown by the diagnostics panel.
+	std::atomic<juce::uint32> droppedScheduledEvents{ 0 };
+
+	void scheduleEvent(ScheduledEvent::Type type, int offset, double value = 0.0)
+	{
+		if (numScheduledEvents >= maxScheduledEvents)
+		{
+			droppedScheduledEvents.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		int index = numScheduledEvents++;
+		while (index > 0 && scheduledEvents[static_cast<size_t>(index - 1)].offset > offset)
+		{
+			scheduledEvents[static_cast<size_t>(index)] = scheduledEvents[static_cast<size_t>(index - 1)];
+			--index;
+		}
+		scheduledEvents[static_cast<size_t>(index)] = { type, offset, value };
+	}
+
+	void scheduleStart(int offset)
+	{
+		scheduleEvent(ScheduledEvent::Type::Start, offset, beatRepeatActive.load() ? -1.0 : 0.0);
+	}
 
 	int customStepCounter = 0;
 	double lastPpqPosition = -1.0;
@@ -179,6 +397,20 @@ struct TrackData
 	std::function<void(bool)> onArmedStateChanged;
 	std::function<void(bool)> onArmedToStopStateChanged;
 
+	// State callbacks raised by the setters below, which run on the audio
+	// thread. They are only recorded here; the processor timer delivers
+	// them through dispatchStateNotifications on the message thread.
+	enum StateNotification : juce::uint32
+	{
+		notifyPlaying = 1u << 0,
+		notifyStopped = 1u << 1,
+		notifyArmed = 1u << 2,
+		notifyDisarmed = 1u << 3,
+		notifyArmedToStop = 1u << 4,
+		notifyArmedToStopCleared = 1u << 5
+	};
+	std::atomic<juce::uint32> pendingStateNotifications{ 0 };
+
 	enum class PendingAction
 	{
 		None,
@@ -229,13 +461,25 @@ struct TrackData
 		return pages[currentPageIndex];
 	}
 
-	void syncLegacyProperties() {
+	int getActiveAudioChannels(const float* channels[2]) const {
+		if (usePages)
+			return getCurrentPage().getAudioChannels(channels);
+
+		if (audioBuffer.getNumSamples() == 0 || audioBuffer.getNumChannels() == 0) {
+			channels[0] = channels[1] = nullptr;
+			return 0;
+		}
+		channels[0] = audioBuffer.getReadPointer(0);
+		channels[1] = audioBuffer.getReadPointer(std::min(1, audioBuffer.getNumChannels() - 1));
+		return audioBuffer.getNumSamples();
+	}
+
+	/** The fields the renderer reads; plain stores, safe on the audio thread. */
+	void syncLegacyPlaybackProperties() noexcept {
 		if (!usePages) return;
 
 		auto& currentPage = getCurrentPage();
 
-		audioBuffer = currentPage.audioBuffer;
-		audioFilePath = currentPage.audioFilePath;
 		numSamples = currentPage.numSamples;
 		sampleRate = currentPage.sampleRate;
 		originalBpm = currentPage.originalBpm;
@@ -243,6 +487,18 @@ struct TrackData
 		loopStart = currentPage.loopStart;
 		loopEnd = currentPage.loopEnd;
 
+		useOriginalFile = currentPage.useOriginalFile.load();
+		hasOriginalVersion = currentPage.hasOriginalVersion.load();
+	}
+
+	void syncLegacyProperties() {
+		if (!usePages) return;
+
+		auto& currentPage = getCurrentPage();
+
+		syncLegacyPlaybackProperties();
+		audioFilePath = currentPage.audioFilePath;
+
 		prompt = currentPage.prompt;
 		selectedPrompt = currentPage.selectedPrompt;
 		generationPrompt = currentPage.generationPrompt;
@@ -252,10 +508,6 @@ struct TrackData
 		preferredStems = currentPage.preferredStems;
 		stems = currentPage.stems;
 
-		useOriginalFile = currentPage.useOriginalFile.load();
-		hasOriginalVersion = currentPage.hasOriginalVersion.load();
-		originalStagingBuffer = currentPage.originalStagingBuffer;
-
 		DBG("Synced legacy properties - loops: " << loopStart << " to " << loopEnd);
 	}
 
@@ -373,62 +625,63 @@ struct TrackData
 		}
 	}
 
-	void setPlaying(bool playing)
+	void setPlaying(bool playing, UIUpdateFlags& uiUpdates)
 	{
 		bool wasPlaying = isPlaying.load();
 		isPlaying = playing;
-		if (wasPlaying != playing && onPlayStateChanged && getCurrentAudioBuffer().getNumChannels() > 0 && isPlaying.load())
-		{
-			juce::MessageManager::callAsync([this, playing]()
-				{
-					if (onPlayStateChanged) {
-						onPlayStateChanged(playing);
-					}
-				});
-		}
+		if (wasPlaying != playing && hasCurrentAudio() && isPlaying.load())
+			notifyStateChanged(playing ? notifyPlaying : notifyStopped, uiUpdates);
 	}
 
-	void setArmed(bool armed)
+	void setArmed(bool armed, UIUpdateFlags& uiUpdates)
 	{
 		bool wasArmed = isArmed.load();
 		isArmed = armed;
-		if (wasArmed != armed && onArmedStateChanged && getCurrentAudioBuffer().getNumChannels() > 0 && isPlaying.load())
-		{
-			juce::MessageManager::callAsync([this, armed]()
-				{
-					if (onArmedStateChanged) {
-						onArmedStateChanged(armed);
-					}
-				});
-		}
+		if (wasArmed != armed && hasCurrentAudio() && isPlaying.load())
+			notifyStateChanged(armed ? notifyArmed : notifyDisarmed, uiUpdates);
 	}
 
-	void setArmedToStop(bool armedToStop)
+	void setArmedToStop(bool armedToStop, UIUpdateFlags& uiUpdates)
 	{
 		isArmedToStop = armedToStop;
-		if (onArmedToStopStateChanged && getCurrentAudioBuffer().getNumChannels() > 0 && isCurrentlyPlaying.load())
-		{
-			juce::MessageManager::callAsync([this, armedToStop]()
-				{
-					if (onArmedToStopStateChanged) {
-						onArmedToStopStateChanged(armedToStop);
-					}
-				});
-		}
+		if (hasCurrentAudio() && isCurrentlyPlaying.load())
+			notifyStateChanged(armedToStop ? notifyArmedToStop : notifyArmedToStopCleared, uiUpdates);
 	}
 
-	void setStop()
+	void setStop(UIUpdateFlags& uiUpdates)
 	{
-		juce::MessageManager::callAsync([this]()
-			{
-				if (onPlayStateChanged) {
-					onPlayStateChanged(false);
-				}
-			});
+		notifyStateChanged(notifyStopped, uiUpdates);
+	}
+
+	/** Message thread: runs the callbacks the setters recorded since the last call. */
+	void dispatchStateNotifications()
+	{
+		const juce::uint32 pending = pendingStateNotifications.exchange(0, std::memory_order_acquire);
+		if ((pending & notifyPlaying) != 0 && onPlayStateChanged)
+			onPlayStateChanged(true);
+		if ((pending & notifyStopped) != 0 && onPlayStateChanged)
+			onPlayStateChanged(false);
+		if ((pending & notifyArmed) != 0 && onArmedStateChanged)
+			onArmedStateChanged(true);
+		if ((pending & notifyDisarmed) != 0 && onArmedStateChanged)
+			onArmedStateChanged(false);
+		if ((pending & notifyArmedToStop) != 0 && onArmedToStopStateChanged)
+			onArmedToStopStateChanged(true);
+		if ((pending & notifyArmedToStopCleared) != 0 && onArmedToStopStateChanged)
+			onArmedToStopStateChanged(false);
 	}
 
 private:
-	juce::AudioSampleBuffer& getCurrentAudioBuffer() {
-		return usePages ? pages[currentPageIndex].audioBuffer : audioBuffer;
+	bool hasCurrentAudio() const {
+		if (!usePages)
+			return audioBuffer.getNumChannels() > 0;
+		const auto& page = pages[currentPageIndex];
+		return page.audioBuffer.getNumChannels() > 0 || page.getMappedAudio() != nullptr;
+	}
+
+	void notifyStateChanged(StateNotification notification, UIUpdateFlags& uiUpdates) noexcept
+	{
+		pendingStateNotifications.fetch_or(notification, std::memory_order_release);
+		uiUpdates.raise(UIUpdateFlags::trackState);
 	}
 };
\ No newline at end of file
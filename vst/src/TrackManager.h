@@ -8,28 +8,59 @@
 #pragma once
 #include "JuceHeader.h"
 #include "TrackData.h"
+#include "RealtimeAllocationGuard.h"
+#include "PlaybackKernel.h"
+#include "StreamingTimeStretch.h"
+#include "MappedAudioSource.h"
+#include "AnalysisCache.h"
+#include "LevelMeter.h"
+#include "RenderWorkerPool.h"
+#include "InsertChain.h"
+#include "StageProfiler.h"
 
 class TrackManager
 {
 public:
-	TrackManager() = default;
+	struct TrackListSnapshot
+	{
+		std::vector<std::shared_ptr<TrackData>> owners;
+		std::vector<TrackData*> tracks;
+	};
+
+	/*
+		Audio that loadState left for later: the current page of a paged
+		track (pageIndex >= 0) or a legacy track's buffer (pageIndex -1).
+		Holding the track keeps it alive if the project is reloaded before
+		the decode runs. Inactive pages are not queued; they load on first
+		use or through the page prefetch.
+	*/
+	struct RestoreRequest
+	{
+		std::shared_ptr<TrackData> track;
+		int pageIndex = -1;
+		juce::File audioFile;
+		juce::String mappedAudioKey;
+	};
+
+	TrackManager()
+	{
+		publishSnapshot();
+	}
+
+	/** Number of slots tracks can occupy; set once by the processor before tracks are created. */
+	void setSlotCapacity(int capacity)
+	{
+		juce::ScopedLock lock(tracksLock);
+		slotCapacity = juce::jlimit(1, 64, capacity);
+		refreshUsedSlots();
+	}
 
-	std::function<void(int slot, TrackData* track)> parameterUpdateCallback;
+	int getSlotCapacity() const { return slotCapacity; }
 
 	juce::String createTrack(const juce::String& name = "Track")
 	{
 		juce::ScopedLock lock(tracksLock);
-		for (int i = 0; i < 8; ++i)
-		{
-			usedSlots[i] = false;
-		}
-		for (const auto& pair : tracks)
-		{
-			if (pair.second->slotIndex >= 0 && pair.second->slotIndex < 8)
-			{
-				usedSlots[pair.second->slotIndex] = true;
-			}
-		}
+		refreshUsedSlots();
 
 		auto track = std::make_unique<TrackData>();
 		track->trackName = name + " " + juce::String(tracks.size() + 1);
@@ -45,6 +76,7 @@ public:
 		}
 		tracks[stdId] = std::move(track);
 		trackOrder.push_back(stdId);
+		publishSnapshot();
 		return trackId;
 	}
 
@@ -54,13 +86,14 @@ public:
 		std::string stdId = trackId.toStdString();
 		if (auto* track = getTrack(trackId))
 		{
-			if (track->slotIndex != -1)
+			if (track->slotIndex >= 0 && track->slotIndex < slotCapacity)
 			{
 				usedSlots[track->slotIndex] = false;
 			}
 		}
 		tracks.erase(stdId);
 		trackOrder.erase(std::remove(trackOrder.begin(), trackOrder.end(), stdId), trackOrder.end());
+		publishSnapshot();
 	}
 
 	void reorderTracks(const juce::String& fromTrackId, const juce::String& toTrackId)
@@ -81,6 +114,7 @@ public:
 
 		toIt = std::find(trackOrder.begin(), trackOrder.end(), toStdId);
 		trackOrder.insert(toIt, movedId);
+		publishSnapshot();
 	}
 
 	TrackData* getTrack(const juce::String& trackId)
@@ -103,70 +137,197 @@ public:
 		}
 		return ids;
 	}
-	void renderAllTracks(juce::AudioBuffer<float>& outputBuffer,
-		std::vector<juce::AudioBuffer<float>>& individualOutputs,
-		double hostBpm)
+
+	const TrackListSnapshot& acquireAudioSnapshot() noexcept
 	{
-		const int numSamples = outputBuffer.getNumSamples();
-		bool anyTrackSolo = false;
+		TrackListSnapshot* snapshot = currentSnapshot.load();
+		for (;;)
+		{
+			audioThreadSnapshot.store(snapshot);
+			TrackListSnapshot* latest = currentSnapshot.load();
+			if (latest == snapshot)
+				break;
+			snapshot = latest;
+		}
+		return *snapshot;
+	}
+
+	const std::vector<TrackData*>& getAudioThreadTracks() const noexcept
+	{
+		return audioThreadSnapshot.load(std::memory_order_relaxed)->tracks;
+	}
 
+	TrackData* findAudioThreadTrack(const juce::String& trackId) const noexcept
+	{
+		for (auto* track : getAudioThreadTracks())
 		{
-			juce::ScopedLock lock(tracksLock);
-			for (const auto& pair : tracks)
-			{
-				if (pair.second->isSolo.load())
-				{
-					anyTrackSolo = true;
-					break;
-				}
-			}
+			if (track->trackId == trackId)
+				return track;
 		}
+		return nullptr;
+	}
+
+	void collectRetiredSnapshots()
+	{
+		juce::ScopedLock lock(tracksLock);
+		reclaimRetiredSnapshots();
+	}
 
-		outputBuffer.clear();
-		for (auto& buffer : individualOutputs)
+	/** Message thread; see TrackPage::acquireMappedAudio. */
+	void collectRetiredMappedAudio()
+	{
+		juce::ScopedLock lock(tracksLock);
+		for (auto& pair : tracks)
 		{
-			buffer.clear();
+			for (auto& page : pair.second->pages)
+				page.collectRetiredMappedAudio();
 		}
+	}
 
+	void prepareToPlay(double sampleRate, int samplesPerBlock, int maxTracks)
+	{
 		juce::ScopedLock lock(tracksLock);
+		scratchBuffers.resize(static_cast<size_t>(maxTracks));
+		for (auto& scratch : scratchBuffers)
+		{
+			scratch.individual.setSize(2, samplesPerBlock, false, true, false);
+			scratch.meter.prepare(sampleRate);
+			for (auto& ramp : scratch.gainRamps)
+				ramp.reset(sampleRate, gainRampSeconds);
+			scratch.inserts.prepare(sampleRate, samplesPerBlock);
+		}
+		streamingStretchers.resize(static_cast<size_t>(maxTracks));
+		for (auto& stretcher : streamingStretchers)
+		{
+			if (!stretcher)
+				stretcher = std::make_unique<StreamingTimeStretch>();
+			stretcher->prepare(sampleRate, samplesPerBlock);
+		}
+		renderJobs.resize(static_cast<size_t>(maxTracks));
+		renderPool.prepare(sampleRate, samplesPerBlock);
+		preparedBlockSize = samplesPerBlock;
+		PlaybackKernel::prepareTables();
+	}
 
-		for (const auto& pair : tracks)
+	void setRenderThreads(int numThreads) { renderPool.setNumThreads(numThreads); }
+	int getRenderThreads() const { return renderPool.getNumThreads(); }
+
+	/*
+		Each slot renders straight into its individualOutputs entry, which may
+		be a view of the host bus, and is summed into outputBuffer in place.
+		A slot whose entry has no channels renders into its scratch buffer and
+		only reaches the main mix. Entries may alias, e.g. extra slots grouped
+		onto a shared bus: the first slot renders into it directly and the
+		others render into scratch and are added afterwards. outputBuffer and
+		the individual outputs must already be cleared.
+	*/
+	void renderAllTracks(juce::AudioBuffer<float>& outputBuffer,
+		std::vector<juce::AudioBuffer<float>>& individualOutputs,
+		double hostBpm, MeterFeed* meterFeed = nullptr, StageProfiler* profiler = nullptr)
+	{
+		const int numSamples = outputBuffer.getNumSamples();
+		const auto& audioTracks = getAudioThreadTracks();
+		bool anyTrackSolo = false;
+
+		for (auto* track : audioTracks)
 		{
-			auto* track = pair.second.get();
+			if (track->isSolo.load())
+			{
+				anyTrackSolo = true;
+				break;
+			}
+		}
 
+		int numJobs = 0;
+		juce::uint64 claimedSlots = 0;
+		for (auto* track : audioTracks)
+		{
 			if (track->isEnabled.load() && track->numSamples > 0 &&
-				track->slotIndex >= 0 && track->slotIndex < individualOutputs.size())
+				track->slotIndex >= 0 && track->slotIndex < individualOutputs.size() &&
+				track->slotIndex < static_cast<int>(scratchBuffers.size()) && track->slotIndex < 64 &&
+				(claimedSlots & (juce::uint64(1) << track->slotIndex)) == 0 &&
+				numJobs < static_cast<int>(renderJobs.size()))
 			{
 				int bufferIndex = track->slotIndex;
+				claimedSlots |= juce::uint64(1) << bufferIndex;
 
-				juce::AudioBuffer<float> tempMixBuffer(outputBuffer.getNumChannels(), numSamples);
-				juce::AudioBuffer<float> tempIndividualBuffer(2, numSamples);
-				tempMixBuffer.clear();
-				tempIndividualBuffer.clear();
-
-				renderSingleTrack(*track, tempMixBuffer, tempIndividualBuffer,
-					numSamples, bufferIndex, hostBpm);
-
-				bool shouldHearTrack = !track->isMuted.load() &&
-					(!anyTrackSolo || track->isSolo.load());
-
-				if (shouldHearTrack)
+				auto* output = &individualOutputs[static_cast<size_t>(bufferIndex)];
+				juce::AudioBuffer<float>* sharedOutput = nullptr;
+				const bool hasOutput = output->getNumChannels() >= 2 && output->getNumSamples() >= numSamples;
+				for (int j = 0; hasOutput && j < numJobs; ++j)
 				{
-					for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
+					const auto& other = renderJobs[static_cast<size_t>(j)];
+					if (other.output->getReadPointer(0) == output->getReadPointer(0))
 					{
-						outputBuffer.addFrom(ch, 0, tempMixBuffer, ch, 0, numSamples);
+						sharedOutput = output;
+						break;
 					}
 				}
 
-				for (int ch = 0; ch < std::min(2, individualOutputs[bufferIndex].getNumChannels()); ++ch)
+				if (!hasOutput || sharedOutput != nullptr)
 				{
-					individualOutputs[bufferIndex].copyFrom(ch, 0, tempIndividualBuffer, ch, 0, numSamples);
-
-					if (!shouldHearTrack)
+					if (numSamples > preparedBlockSize)
 					{
-						individualOutputs[bufferIndex].applyGain(ch, 0, numSamples, 0.0f);
+						RealtimeAllocationGuard::noteAllocation();
 					}
+
+					output = &scratchBuffers[static_cast<size_t>(bufferIndex)].individual;
+					output->setSize(2, numSamples, false, false, true);
+					output->clear();
 				}
+				renderJobs[static_cast<size_t>(numJobs++)] = { track, bufferIndex, output, sharedOutput };
+			}
+			else
+			{
+				track->numScheduledEvents = 0;
+				track->renderedPlaying = false;
+			}
+		}
+
+		// Slots only touch their own track, scratch and stretcher, so they can
+		// render concurrently; summing and metering stay on this thread.
+		renderBlockSamples = numSamples;
+		renderBlockBpm = hostBpm;
+		renderProfiler = profiler;
+		if (numSamples >= minParallelBlockSize)
+		{
+			renderPool.run(&TrackManager::renderJob, this, numJobs);
+		}
+		else
+		{
+			for (int i = 0; i < numJobs; ++i)
+				renderJob(this, i);
+		}
+
+		for (int i = 0; i < numJobs; ++i)
+		{
+			auto* track = renderJobs[static_cast<size_t>(i)].track;
+			const int bufferIndex = renderJobs[static_cast<size_t>(i)].bufferIndex;
+			auto& scratch = scratchBuffers[static_cast<size_t>(bufferIndex)];
+			auto& rendered = *renderJobs[static_cast<size_t>(i)].output;
+			auto* sharedOutput = renderJobs[static_cast<size_t>(i)].sharedOutput;
+
+			bool shouldHearTrack = !track->isMuted.load() &&
+				(!anyTrackSolo || track->isSolo.load());
+
+			if (shouldHearTrack)
+			{
+				for (int ch = 0; ch < std::min(2, outputBuffer.getNumChannels()); ++ch)
+				{
+					outputBuffer.addFrom(ch, 0, rendered, ch, 0, numSamples);
+				}
+				scratch.meter.process(rendered, numSamples, bufferIndex, meterFeed);
+				if (sharedOutput != nullptr)
+				{
+					for (int ch = 0; ch < 2; ++ch)
+						sharedOutput->addFrom(ch, 0, rendered, ch, 0, numSamples);
+				}
+			}
+			else
+			{
+				scratch.meter.processSilence(numSamples, bufferIndex, meterFeed);
+				if (sharedOutput == nullptr)
+					rendered.clear(0, numSamples);
 			}
 		}
 	}
@@ -190,6 +351,8 @@ public:
 			trackState.setProperty("bpm", track->bpm, nullptr);
 			trackState.setProperty("originalBpm", track->originalBpm, nullptr);
 			trackState.setProperty("timeStretchMode", track->timeStretchMode, nullptr);
+			trackState.setProperty("interpolationQuality", static_cast<int>(track->interpolationQuality.load()), nullptr);
+			trackState.setProperty("streamingStretch", track->streamingStretch.load(), nullptr);
 			trackState.setProperty("bpmOffset", track->bpmOffset, nullptr);
 			trackState.setProperty("midiNote", track->midiNote, nullptr);
 			trackState.setProperty("loopStart", track->loopStart, nullptr);
@@ -227,7 +390,7 @@ public:
 			trackState.setProperty("beatRepeatActive", track->beatRepeatActive.load(), nullptr);
 			trackState.setProperty("randomRetriggerDurationEnabled", track->randomRetriggerDurationEnabled.load(), nullptr);
 			trackState.setProperty("usePages", track->usePages.load(), nullptr);
-			trackState.setProperty("currentPageIndex", track->currentPageIndex, nullptr);
+			trackState.setProperty("currentPageIndex", track->currentPageIndex.load(), nullptr);
 			for (int pageIndex = 0; pageIndex < 4; ++pageIndex) {
 				auto pageState = juce::ValueTree("Page");
 				const auto& page = track->pages[pageIndex];
@@ -249,6 +412,7 @@ public:
 				pageState.setProperty("useOriginalFile", page.useOriginalFile.load(), nullptr);
 				pageState.setProperty("hasOriginalVersion", page.hasOriginalVersion.load(), nullptr);
 				pageState.setProperty("isLoaded", page.isLoaded.load(), nullptr);
+				pageState.setProperty("mappedAudioKey", page.getMappedAudioKey(), nullptr);
 
 				juce::String stemsString;
 				for (int i = 0; i < page.preferredStems.size(); ++i) {
@@ -281,17 +445,20 @@ public:
 			sequencerState.setProperty("currentMeasure", track->sequencerData.currentMeasure, nullptr);
 			sequencerState.setProperty("numMeasures", track->sequencerData.numMeasures, nullptr);
 			sequencerState.setProperty("beatsPerMeasure", track->sequencerData.beatsPerMeasure, nullptr);
+			// Steps as one bit mask and velocities as a float blob instead of 128 properties.
+			juce::int64 stepMask = 0;
+			juce::MemoryOutputStream velocities;
 			for (int m = 0; m < 4; ++m)
 			{
 				for (int s = 0; s < 16; ++s)
 				{
-					juce::String stepKey = "step_" + juce::String(m) + "_" + juce::String(s);
-					sequencerState.setProperty(stepKey, track->sequencerData.steps[m][s], nullptr);
-
-					juce::String velocityKey = "velocity_" + juce::String(m) + "_" + juce::String(s);
-					sequencerState.setProperty(velocityKey, track->sequencerData.velocities[m][s], nullptr);
+					if (track->sequencerData.steps[m][s])
+						stepMask |= juce::int64(1) << (m * 16 + s);
+					velocities.writeFloat(track->sequencerData.velocities[m][s]);
 				}
 			}
+			sequencerState.setProperty("stepMask", stepMask, nullptr);
+			sequencerState.setProperty("velocities", velocities.getMemoryBlock(), nullptr);
 			trackState.appendChild(sequencerState, nullptr);
 			state.appendChild(trackState, nullptr);
 		}
@@ -304,7 +471,8 @@ public:
 		juce::ScopedLock lock(tracksLock);
 		tracks.clear();
 		trackOrder.clear();
-		usedSlots.fill(false);
+		pendingRestores.clear();
+		usedSlots.assign(static_cast<size_t>(slotCapacity), false);
 		for (int i = 0; i < state.getNumChildren(); ++i)
 		{
 			auto trackState = state.getChild(i);
@@ -314,6 +482,7 @@ public:
 			}
 
 			auto track = std::make_unique<TrackData>();
+			std::vector<RestoreRequest> restores;
 
 			track->trackId = trackState.getProperty("id", juce::Uuid().toString());
 			track->trackName = trackState.getProperty("name", "Track");
@@ -324,6 +493,8 @@ public:
 			track->bpm = trackState.getProperty("bpm", 126.0f);
 			track->originalBpm = trackState.getProperty("originalBpm", 126.0f);
 			track->timeStretchMode = 4;
+			track->interpolationQuality = static_cast<juce::uint8>(PlaybackKernel::toInterpolationQuality(trackState.getProperty("interpolationQuality", 0)));
+			track->streamingStretch = trackState.getProperty("streamingStretch", false);
 			track->bpmOffset = trackState.getProperty("bpmOffset", 0.0);
 			track->midiNote = trackState.getProperty("midiNote", 60);
 			track->loopStart = trackState.getProperty("loopStart", 0.0);
@@ -362,7 +533,7 @@ public:
 			track->randomRetriggerDurationEnabled = trackState.getProperty("randomRetriggerDurationEnabled", false);
 
 			track->usePages = trackState.getProperty("usePages", false);
-			track->currentPageIndex = trackState.getProperty("currentPageIndex", 0);
+			track->currentPageIndex = static_cast<int>(trackState.getProperty("currentPageIndex", 0));
 
 			if (track->usePages.load()) {
 				DBG("Loading track " << track->trackName << " with pages system");
@@ -412,8 +583,10 @@ public:
 						if (!page.audioFilePath.isEmpty()) {
 							juce::File audioFile(page.audioFilePath);
 							if (audioFile.existsAsFile()) {
-								DBG("Loading page " << (char)('A' + pageIndex) << " from: " << audioFile.getFullPathName());
-								loadAudioFileForPage(track.get(), pageIndex, audioFile);
+								if (pageIndex == track->currentPageIndex) {
+									DBG("Queueing restore of page " << (char)('A' + pageIndex) << " from: " << audioFile.getFullPathName());
+									restores.push_back({ nullptr, pageIndex, audioFile, pageState.getProperty("mappedAudioKey", "").toString() });
+								}
 							}
 							else {
 								DBG("Page " << (char)('A' + pageIndex) << " file not found: " << page.audioFilePath);
@@ -425,8 +598,9 @@ public:
 
 									if (newFile.existsAsFile()) {
 										DBG("Found file with new naming: " << newFile.getFullPathName());
-										loadAudioFileForPage(track.get(), pageIndex, newFile);
 										page.audioFilePath = newFile.getFullPathName();
+										if (pageIndex == track->currentPageIndex)
+											restores.push_back({ nullptr, pageIndex, newFile, {} });
 									}
 								}
 							}
@@ -464,8 +638,8 @@ public:
 							}
 						}
 
-						loadAudioFileForTrack(track.get(), fileToLoad);
-						DBG("Loaded track audio from: " + fileToLoad.getFullPathName().toStdString());
+						restores.push_back({ nullptr, -1, fileToLoad, {} });
+						DBG("Queueing restore of track audio from: " + fileToLoad.getFullPathName().toStdString());
 					}
 					else {
 						DBG("File exists: NO");
@@ -498,33 +672,114 @@ public:
 				track->sequencerData.currentMeasure = 0;
 				track->sequencerData.numMeasures = sequencerState.getProperty("numMeasures", 1);
 				track->sequencerData.beatsPerMeasure = sequencerState.getProperty("beatsPerMeasure", 4);
-				for (int m = 0; m < 4; ++m) {
-					for (int s = 0; s < 16; ++s) {
-						juce::String stepKey = "step_" + juce::String(m) + "_" + juce::String(s);
-						track->sequencerData.steps[m][s] = sequencerState.getProperty(stepKey, false);
+				auto* velocityBlob = sequencerState.getProperty("velocities").getBinaryData();
+				if (sequencerState.hasProperty("stepMask") && velocityBlob != nullptr
+					&& velocityBlob->getSize() == sizeof(float) * 64) {
+					const juce::int64 stepMask = sequencerState.getProperty("stepMask");
+					juce::MemoryInputStream velocities(*velocityBlob, false);
+					for (int m = 0; m < 4; ++m) {
+						for (int s = 0; s < 16; ++s) {
+							track->sequencerData.steps[m][s] = (stepMask >> (m * 16 + s)) & 1;
+							track->sequencerData.velocities[m][s] = velocities.readFloat();
+						}
+					}
+				}
+				else {
+					for (int m = 0; m < 4; ++m) {
+						for (int s = 0; s < 16; ++s) {
+							juce::String stepKey = "step_" + juce::String(m) + "_" + juce::String(s);
+							track->sequencerData.steps[m][s] = sequencerState.getProperty(stepKey, false);
 
-						juce::String velocityKey = "velocity_" + juce::String(m) + "_" + juce::String(s);
-						track->sequencerData.velocities[m][s] = sequencerState.getProperty(velocityKey, 0.8f);
+							juce::String velocityKey = "velocity_" + juce::String(m) + "_" + juce::String(s);
+							track->sequencerData.velocities[m][s] = sequencerState.getProperty(velocityKey, 0.8f);
+						}
 					}
 				}
 			}
 
-			if (track->slotIndex < 0 || track->slotIndex >= 8 || usedSlots[track->slotIndex]) {
+			if (track->slotIndex < 0 || track->slotIndex >= slotCapacity || usedSlots[track->slotIndex]) {
 				track->slotIndex = findFreeSlot();
 			}
-			if (track->slotIndex >= 0 && track->slotIndex < 8) {
+			if (track->slotIndex >= 0 && track->slotIndex < slotCapacity) {
 				usedSlots[track->slotIndex] = true;
 			}
 
+			if (!restores.empty())
+			{
+				track->audioRestorePending = true;
+				for (const auto& restore : restores)
+				{
+					if (restore.pageIndex >= 0)
+						track->pages[restore.pageIndex].isLoading = true;
+				}
+			}
+
 			std::string stdId = track->trackId.toStdString();
 			tracks[stdId] = std::move(track);
 			trackOrder.push_back(stdId);
+
+			for (auto& restore : restores)
+			{
+				restore.track = tracks[stdId];
+				pendingRestores.push_back(std::move(restore));
+			}
 		}
+		publishSnapshot();
 	}
 
-	std::array<bool, 8> usedSlots{ false };
+	/** Hands the audio queued by loadState to the caller, which decodes it off the message thread. */
+	std::vector<RestoreRequest> takeRestoreRequests()
+	{
+		juce::ScopedLock lock(tracksLock);
+		return std::exchange(pendingRestores, {});
+	}
 
-	void loadAudioFileForPage(TrackData* track, int pageIndex, const juce::File& audioFile)
+	/** Job pool thread. The track is not rendered until this returns. */
+	void restoreTrackAudio(const RestoreRequest& request)
+	{
+		TrackData* track = request.track.get();
+		if (!track)
+			return;
+
+		if (request.pageIndex >= 0)
+		{
+			loadAudioFileForPage(track, request.pageIndex, request.audioFile, request.mappedAudioKey);
+			track->pages[request.pageIndex].isLoading = false;
+		}
+		else
+		{
+			loadAudioFileForTrack(track, request.audioFile);
+		}
+		track->audioRestorePending = false;
+	}
+
+	int slotCapacity = 8;
+	std::vector<bool> usedSlots = std::vector<bool>(8, false);
+
+	void setMemoryMappedPages(bool enabled) { memoryMappedPages = enabled; }
+	bool getMemoryMappedPages() const { return memoryMappedPages.load(); }
+
+	static std::shared_ptr<MappedAudioSource> createMappedAudio(const juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate)
+	{
+		if (buffer.getNumSamples() == 0 || numSamples <= 0)
+			return nullptr;
+
+		const juce::String key = AnalysisCache::computeContentKey(buffer, numSamples, sampleRate);
+		return MappedAudioSource::createFromBuffer(key, buffer, numSamples, sampleRate);
+	}
+
+	static bool mapPageAudio(TrackPage& page)
+	{
+		auto source = createMappedAudio(page.audioBuffer, page.numSamples, page.sampleRate);
+		if (!source)
+			return false;
+
+		page.setMappedAudio(std::move(source));
+		page.audioBuffer.setSize(0, 0);
+		return true;
+	}
+
+	void loadAudioFileForPage(TrackData* track, int pageIndex, const juce::File& audioFile, const juce::String& mappedAudioKey = {})
 	{
 		if (!track || pageIndex < 0 || pageIndex >= 4) {
 			DBG("loadAudioFileForPage: Invalid parameters - track=" << (track ? "valid" : "null") << ", pageIndex=" << pageIndex);
@@ -533,14 +788,24 @@ public:
 
 		auto& page = track->pages[pageIndex];
 
+		if (memoryMappedPages.load() && mappedAudioKey.isNotEmpty()) {
+			if (auto source = MappedAudioSource::open(mappedAudioKey)) {
+				page.audioBuffer.setSize(0, 0);
+				page.numSamples = source->getNumSamples();
+				page.sampleRate = source->getSampleRate();
+				page.setMappedAudio(std::move(source));
+				page.isLoaded = true;
+				page.isLoading = false;
+				DBG("loadAudioFileForPage: Page " << (char)('A' + pageIndex) << " mapped from cache " << mappedAudioKey);
+				return;
+			}
+		}
+
 		DBG("loadAudioFileForPage: Attempting to load page " << (char)('A' + pageIndex) << " from: " << audioFile.getFullPathName());
 
-		static juce::AudioFormatManager formatManager;
-		static bool initialized = false;
-		if (!initialized) {
-			formatManager.registerBasicFormats();
-			initialized = true;
-		}
+		// Pages restore on several job threads at once, so each load gets its own manager.
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
 
 		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
 		if (!reader) {
@@ -598,16 +863,16 @@ public:
 			}
 		}
 		DBG("loadAudioFileForPage: Max sample amplitude: " << maxSample);
+
+		if (memoryMappedPages.load() && mapPageAudio(page)) {
+			DBG("loadAudioFileForPage: Page " << (char)('A' + pageIndex) << " now plays from mapped cache " << page.getMappedAudioKey());
+		}
 	}
 
 	void loadAudioFileForTrack(TrackData* track, const juce::File& audioFile)
 	{
-		static juce::AudioFormatManager formatManager;
-		static bool initialized = false;
-		if (!initialized) {
-			formatManager.registerBasicFormats();
-			initialized = true;
-		}
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
 
 		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
 
@@ -640,31 +905,149 @@ public:
 	}
 
 private:
+	static constexpr double gainRampSeconds = 0.02;
+	static constexpr int minParallelBlockSize = 64;
+
+	struct RenderJob
+	{
+		TrackData* track = nullptr;
+		int bufferIndex = -1;
+		juce::AudioBuffer<float>* output = nullptr;
+		// Set when output aliases an earlier slot's; rendered into scratch and added.
+		juce::AudioBuffer<float>* sharedOutput = nullptr;
+	};
+
+	static void renderJob(void* context, int jobIndex)
+	{
+		auto& manager = *static_cast<TrackManager*>(context);
+		const auto& job = manager.renderJobs[static_cast<size_t>(jobIndex)];
+		auto& scratch = manager.scratchBuffers[static_cast<size_t>(job.bufferIndex)];
+		StageProfiler::ScopedTimer timer(manager.renderProfiler != nullptr ? &manager.renderProfiler->getSlot(job.bufferIndex) : nullptr);
+		manager.renderSingleTrack(*job.track, scratch, *job.output, manager.renderBlockSamples, job.bufferIndex, manager.renderBlockBpm);
+	}
+
+	// Aligned so render workers writing neighbouring slots never share a line.
+	struct alignas(64) ScratchBuffers
+	{
+		// Render target for a slot without an individual output.
+		juce::AudioBuffer<float> individual;
+		LevelMeter meter;
+		// Per-sample left/right gain, so volume and pan moves glide instead of
+		// stepping once per block.
+		std::array<juce::SmoothedValue<float>, 2> gainRamps;
+		// The track the ramps and inserts last rendered; see claimScratch.
+		const TrackData* owner = nullptr;
+		InsertChain::TrackChain inserts;
+		// Samples of silence still to run through the inserts after the
+		// track stopped, so echoes and filter ringing decay instead of cutting.
+		int insertTailSamples = 0;
+	};
+
+	struct PlaybackSection
+	{
+		const float* channelData[2] = { nullptr, nullptr };
+		int sourceChannels = 0;
+		int sourceLength = 0;
+		double startSample = 0.0;
+		double endSample = 0.0;
+		double playbackEnd = 0.0;
+		double beatRepeatStart = 0.0;
+		double beatRepeatEnd = 0.0;
+		bool beatRepeatLooping = false;
+	};
+
 	mutable juce::CriticalSection tracksLock;
-	std::unordered_map<std::string, std::unique_ptr<TrackData>> tracks;
+	std::unordered_map<std::string, std::shared_ptr<TrackData>> tracks;
 	std::vector<std::string> trackOrder;
 
+	std::atomic<bool> memoryMappedPages{ false };
+	std::vector<RestoreRequest> pendingRestores;
+	std::unique_ptr<TrackListSnapshot> publishedSnapshot;
+	std::vector<std::unique_ptr<TrackListSnapshot>> retiredSnapshots;
+	std::atomic<TrackListSnapshot*> currentSnapshot{ nullptr };
+	std::atomic<TrackListSnapshot*> audioThreadSnapshot{ nullptr };
+	std::vector<ScratchBuffers> scratchBuffers;
+	std::vector<RenderJob> renderJobs;
+	RenderWorkerPool renderPool;
+	int renderBlockSamples = 0;
+	double renderBlockBpm = 126.0;
+	StageProfiler* renderProfiler = nullptr;
+	std::vector<std::unique_ptr<StreamingTimeStretch>> streamingStretchers;
+	int preparedBlockSize = 0;
+
+	void publishSnapshot()
+	{
+		auto snapshot = std::make_unique<TrackListSnapshot>();
+		snapshot->owners.reserve(trackOrder.size());
+		snapshot->tracks.reserve(trackOrder.size());
+		for (const auto& stdId : trackOrder)
+		{
+			auto it = tracks.find(stdId);
+			if (it != tracks.end())
+			{
+				snapshot->owners.push_back(it->second);
+				snapshot->tracks.push_back(it->second.get());
+			}
+		}
+
+		TrackListSnapshot* newSnapshot = snapshot.get();
+		currentSnapshot.store(newSnapshot);
+		if (audioThreadSnapshot.load() == nullptr)
+		{
+			audioThreadSnapshot.store(newSnapshot);
+		}
+		if (publishedSnapshot)
+		{
+			retiredSnapshots.push_back(std::move(publishedSnapshot));
+		}
+		publishedSnapshot = std::move(snapshot);
+		reclaimRetiredSnapshots();
+	}
+
+	void reclaimRetiredSnapshots()
+	{
+		TrackListSnapshot* inUse = audioThreadSnapshot.load();
+		retiredSnapshots.erase(std::remove_if(retiredSnapshots.begin(), retiredSnapshots.end(),
+			[inUse](const std::unique_ptr<TrackListSnapshot>& snapshot)
+			{
+				return snapshot.get() != inUse;
+			}),
+			retiredSnapshots.end());
+	}
+
+	void refreshUsedSlots()
+	{
+		usedSlots.assign(static_cast<size_t>(slotCapacity), false);
+		for (const auto& pair : tracks)
+		{
+			if (pair.second->slotIndex >= 0 && pair.second->slotIndex < slotCapacity)
+			{
+				usedSlots[pair.second->slotIndex] = true;
+			}
+		}
+	}
+
 	int findFreeSlot()
 	{
 		DBG("Finding free slot - Current usedSlots state:");
-		for (int i = 0; i < 8; ++i)
+		for (int i = 0; i < slotCapacity; ++i)
 		{
 			DBG("  Slot " << i << ": " << (usedSlots[i] ? "USED" : "FREE"));
 		}
 
 		DBG("Actual slot usage from tracks:");
-		std::vector<bool> actualUsage(8, false);
+		std::vector<bool> actualUsage(static_cast<size_t>(slotCapacity), false);
 		for (const auto& pair : tracks)
 		{
 			const auto& track = pair.second;
-			if (track->slotIndex >= 0 && track->slotIndex < 8)
+			if (track->slotIndex >= 0 && track->slotIndex < slotCapacity)
 			{
 				actualUsage[track->slotIndex] = true;
 				DBG("  Slot " << track->slotIndex << ": USED by " << track->trackName);
 			}
 		}
 
-		for (int i = 0; i < 8; ++i)
+		for (int i = 0; i < slotCapacity; ++i)
 		{
 			if (usedSlots[i] != actualUsage[i])
 			{
@@ -672,7 +1055,7 @@ private:
 			}
 		}
 
-		for (int i = 0; i < 8; ++i)
+		for (int i = 0; i < slotCapacity; ++i)
 		{
 			if (!usedSlots[i])
 			{
@@ -686,20 +1069,12 @@ private:
 	}
 
 	void renderSingleTrack(TrackData& track,
-		juce::AudioBuffer<float>& mixOutput,
-		juce::AudioBuffer<float>& individualOutput,
-		int numSamples, int /*trackIndex*/, double hostBpm) const
+		ScratchBuffers& scratch, juce::AudioBuffer<float>& individualOutput,
+		int numSamples, int trackIndex, double hostBpm) const
 	{
-		if (parameterUpdateCallback)
-		{
-			int slot = track.slotIndex;
-			if (slot != -1)
-			{
-				parameterUpdateCallback(slot, &track);
-			}
-		}
+		claimScratch(track, scratch);
+		auto& gainRamps = scratch.gainRamps;
 
-		const juce::AudioSampleBuffer* bufferToUse = nullptr;
 		int numSamplesToUse = 0;
 		double sampleRateToUse = 0;
 		double loopStartToUse = 0;
@@ -708,7 +1083,6 @@ private:
 
 		if (track.usePages.load()) {
 			const auto& currentPage = track.getCurrentPage();
-			bufferToUse = &currentPage.audioBuffer;
 			numSamplesToUse = currentPage.numSamples;
 			sampleRateToUse = currentPage.sampleRate;
 			loopStartToUse = currentPage.loopStart;
@@ -716,7 +1090,6 @@ private:
 			originalBpmToUse = currentPage.originalBpm;
 		}
 		else {
-			bufferToUse = &track.audioBuffer;
 			numSamplesToUse = track.numSamples;
 			sampleRateToUse = track.sampleRate;
 			loopStartToUse = track.loopStart;
@@ -724,11 +1097,17 @@ private:
 			originalBpmToUse = track.originalBpm;
 		}
 
-		if (numSamplesToUse == 0 || !track.isPlaying.load() || !bufferToUse)
+		if (numSamplesToUse == 0 || track.audioRestorePending.load() || (!track.isPlaying.load() && track.numScheduledEvents == 0))
+		{
+			track.numScheduledEvents = 0;
+			track.renderedPlaying = false;
+			if (trackIndex >= 0 && trackIndex < static_cast<int>(streamingStretchers.size()))
+				streamingStretchers[static_cast<size_t>(trackIndex)]->reset();
+			if (scratch.insertTailSamples > 0)
+				renderInsertTail(track, scratch, individualOutput, numSamples, hostBpm);
 			return;
+		}
 
-		const float volume = juce::jlimit(0.0f, 1.0f, track.volume.load());
-		const float pan = juce::jlimit(-1.0f, 1.0f, track.pan.load());
 		double currentPosition = track.readPosition.load();
 		double playbackRatio = 1.0;
 
@@ -778,87 +1157,302 @@ private:
 			sectionLength = numSamplesToUse;
 		}
 
-		for (int i = 0; i < numSamples; ++i)
+		PlaybackSection section;
+		section.sourceLength = track.getActiveAudioChannels(section.channelData);
+		section.sourceChannels = section.sourceLength > 0 ? 2 : 0;
+		section.startSample = startSample;
+		section.endSample = endSample;
+		section.playbackEnd = std::min(endSample, static_cast<double>(section.sourceLength));
+		section.beatRepeatStart = track.beatRepeatStartPosition.load();
+		section.beatRepeatEnd = track.beatRepeatEndPosition.load();
+		section.beatRepeatLooping = track.beatRepeatActive.load() && section.beatRepeatEnd > section.beatRepeatStart;
+
+		float channelGains[2];
+		getChannelGains(track, channelGains);
+
+		// Streaming stretch only follows the host tempo; manual BPM stays varispeed.
+		const bool hasStretcher = trackIndex >= 0 && trackIndex < static_cast<int>(streamingStretchers.size());
+		const bool useStreamingStretch = playbackRatio != 1.0 && track.streamingStretch.load() && hasStretcher &&
+			(track.timeStretchMode == 3 || track.timeStretchMode == 4);
+		if (!useStreamingStretch && hasStretcher && streamingStretchers[static_cast<size_t>(trackIndex)]->isRunning())
+			streamingStretchers[static_cast<size_t>(trackIndex)]->reset();
+
+		const auto quality = playbackRatio == 1.0
+			? PlaybackKernel::InterpolationQuality::Linear
+			: PlaybackKernel::toInterpolationQuality(track.interpolationQuality.load());
+
+		bool playing = track.isPlaying.load();
+		for (int i = 0; i < track.numScheduledEvents; ++i)
 		{
-			if (track.beatRepeatActive.load())
+			const auto type = track.scheduledEvents[static_cast<size_t>(i)].type;
+			if (type == TrackData::ScheduledEvent::Type::Start || type == TrackData::ScheduledEvent::Type::Stop)
+			{
+				playing = track.renderedPlaying;
+				break;
+			}
+		}
+
+		int frame = 0;
+		int renderedEnd = 0;
+		bool reachedEnd = false;
+		auto renderUntil = [&](int endFrame)
 			{
-				double beatRepeatStart = track.beatRepeatStartPosition.load();
-				double beatRepeatEnd = track.beatRepeatEndPosition.load();
-				if (track.readPosition.load() >= beatRepeatEnd)
+				if (playing && endFrame > frame)
 				{
-					currentPosition = beatRepeatStart - startSample;
-					track.readPosition.store(beatRepeatStart);
+					int framesWritten = 0;
+					const bool stillPlaying = useStreamingStretch
+						? renderStretched(*streamingStretchers[static_cast<size_t>(trackIndex)], section,
+							currentPosition, playbackRatio, individualOutput, frame, endFrame - frame, framesWritten)
+						: readSection(section, currentPosition, playbackRatio, quality,
+							individualOutput, frame, endFrame - frame, framesWritten);
+					renderedEnd = std::max(renderedEnd, frame + framesWritten);
+					if (!stillPlaying)
+					{
+						playing = false;
+						reachedEnd = true;
+					}
 				}
-			}
-			double absolutePosition = startSample + currentPosition;
-			float leftGain = 1.0f;
-			float rightGain = 1.0f;
+				frame = std::max(frame, endFrame);
+			};
 
-			if (pan < 0.0f)
+		for (int i = 0; i < track.numScheduledEvents; ++i)
+		{
+			const auto& event = track.scheduledEvents[static_cast<size_t>(i)];
+			renderUntil(juce::jlimit(0, numSamples, event.offset));
+
+			switch (event.type)
 			{
-				rightGain = 1.0f + pan;
+			case TrackData::ScheduledEvent::Type::Start:
+				playing = true;
+				reachedEnd = false;
+				if (event.value >= 0.0)
+					currentPosition = event.value;
+				break;
+			case TrackData::ScheduledEvent::Type::Stop:
+				playing = false;
+				if (useStreamingStretch)
+					streamingStretchers[static_cast<size_t>(trackIndex)]->reset();
+				break;
+			case TrackData::ScheduledEvent::Type::BeatRepeatStart:
+				track.originalReadPosition = currentPosition;
+				track.beatRepeatStartPosition = currentPosition;
+				track.beatRepeatEndPosition = std::min(currentPosition + event.value, static_cast<double>(numSamplesToUse));
+				track.beatRepeatActive = true;
+				section.beatRepeatStart = track.beatRepeatStartPosition.load();
+				section.beatRepeatEnd = track.beatRepeatEndPosition.load();
+				section.beatRepeatLooping = section.beatRepeatEnd > section.beatRepeatStart;
+				break;
+			case TrackData::ScheduledEvent::Type::BeatRepeatStop:
+				track.beatRepeatActive = false;
+				section.beatRepeatLooping = false;
+				currentPosition = track.originalReadPosition.load();
+				break;
 			}
-			else if (pan > 0.0f)
+		}
+		track.numScheduledEvents = 0;
+		renderUntil(numSamples);
+
+		// Inserts run pre-fader over the whole block, so an echo or filter
+		// tail is not cut at the frame where the sample stopped in this block.
+		if (section.sourceChannels > 0)
+		{
+			if (scratch.inserts.process(getInsertSettings(track, hostBpm), individualOutput.getArrayOfWritePointers(),
+				section.sourceChannels, numSamples))
+				renderedEnd = numSamples;
+			scratch.insertTailSamples = scratch.inserts.getTailSamples();
+		}
+
+		for (int ch = 0; ch < section.sourceChannels; ++ch)
+		{
+			auto& ramp = gainRamps[static_cast<size_t>(ch)];
+			ramp.setTargetValue(channelGains[ch]);
+			ramp.applyGain(individualOutput.getWritePointer(ch), renderedEnd);
+			ramp.skip(numSamples - renderedEnd);
+		}
+
+		if (reachedEnd && !playing)
+		{
+			track.isPlaying = false;
+			track.renderedPlaying = false;
+			return;
+		}
+		track.readPosition = currentPosition;
+		track.renderedPlaying = playing;
+	}
+
+	/*
+		A slot's ramps glide from the gain it last rendered at. When another
+		track has taken the slot since, that gain and any insert tail belong
+		to the previous occupant, so the new one starts at its own gain.
+	*/
+	static void claimScratch(const TrackData& track, ScratchBuffers& scratch)
+	{
+		if (scratch.owner == &track)
+			return;
+
+		scratch.owner = &track;
+		float channelGains[2];
+		getChannelGains(track, channelGains);
+		for (size_t ch = 0; ch < scratch.gainRamps.size(); ++ch)
+			scratch.gainRamps[ch].setCurrentAndTargetValue(channelGains[ch]);
+		scratch.insertTailSamples = 0;
+		scratch.inserts.reset();
+	}
+
+	static void getChannelGains(const TrackData& track, float channelGains[2])
+	{
+		const float volume = juce::jlimit(0.0f, 1.0f, track.volume.load());
+		const float pan = juce::jlimit(-1.0f, 1.0f, track.pan.load());
+		channelGains[0] = channelGains[1] = volume;
+		if (pan < 0.0f)
+		{
+			channelGains[1] *= 1.0f + pan;
+		}
+		else if (pan > 0.0f)
+		{
+			channelGains[0] *= 1.0f - pan;
+		}
+	}
+
+	static InsertChain::Settings getInsertSettings(const TrackData& track, double hostBpm)
+	{
+		InsertChain::Settings inserts;
+		inserts.eqLowDb = track.insertEqLow.load();
+		inserts.eqMidDb = track.insertEqMid.load();
+		inserts.eqHighDb = track.insertEqHigh.load();
+		inserts.filter = track.insertFilter.load();
+		inserts.compression = track.insertCompression.load();
+		inserts.delaySend = track.insertDelaySend.load();
+		inserts.hostBpm = hostBpm;
+		return inserts;
+	}
+
+	/*
+		A stopped slot feeds silence through its inserts until their tail has
+		decayed, then resets them, so a restart never replays a stale echo.
+	*/
+	void renderInsertTail(const TrackData& track, ScratchBuffers& scratch,
+		juce::AudioBuffer<float>& individualOutput, int numSamples, double hostBpm) const
+	{
+		const int numChannels = std::min(2, individualOutput.getNumChannels());
+		if (!scratch.inserts.process(getInsertSettings(track, hostBpm), individualOutput.getArrayOfWritePointers(),
+			numChannels, numSamples))
+		{
+			scratch.insertTailSamples = 0;
+			return;
+		}
+
+		float channelGains[2];
+		getChannelGains(track, channelGains);
+		for (int ch = 0; ch < numChannels; ++ch)
+		{
+			auto& ramp = scratch.gainRamps[static_cast<size_t>(ch)];
+			ramp.setTargetValue(channelGains[ch]);
+			ramp.applyGain(individualOutput.getWritePointer(ch), numSamples);
+		}
+
+		scratch.insertTailSamples -= numSamples;
+		if (scratch.insertTailSamples <= 0)
+		{
+			scratch.insertTailSamples = 0;
+			scratch.inserts.reset();
+		}
+	}
+
+	bool readSection(const PlaybackSection& section, double& currentPosition, double ratio,
+		PlaybackKernel::InterpolationQuality quality,
+		juce::AudioBuffer<float>& destination, int startFrame, int numFrames, int& framesWritten) const
+	{
+		framesWritten = 0;
+		while (framesWritten < numFrames)
+		{
+			if (section.beatRepeatLooping && currentPosition >= section.beatRepeatEnd)
 			{
-				leftGain = 1.0f - pan;
+				currentPosition = section.beatRepeatStart;
 			}
-			if (absolutePosition >= endSample)
+
+			const double absolutePosition = section.startSample + currentPosition;
+			if (absolutePosition >= section.playbackEnd)
 			{
-				currentPosition = 0.0;
-				absolutePosition = startSample;
-				track.isPlaying = false;
-				return;
+				return false;
 			}
 
-			if (absolutePosition >= numSamplesToUse)
+			double segmentLimit = section.playbackEnd;
+			if (section.beatRepeatLooping)
 			{
-				currentPosition = 0.0;
-				absolutePosition = startSample;
+				segmentLimit = std::min(segmentLimit, section.startSample + section.beatRepeatEnd);
 			}
 
-			for (int ch = 0; ch < std::min(2, bufferToUse->getNumChannels()); ++ch)
-			{
-				int sampleIndex = static_cast<int>(absolutePosition);
-				if (sampleIndex >= bufferToUse->getNumSamples())
-				{
-					track.isPlaying = false;
-					break;
-				}
+			const int segmentLength = PlaybackKernel::countSamplesBefore(absolutePosition, segmentLimit,
+				ratio, numFrames - framesWritten);
 
-				float sample = interpolateLinear(
-					bufferToUse->getReadPointer(ch),
-					absolutePosition,
-					bufferToUse->getNumSamples());
-				sample *= volume;
-				if (ch == 0)
-				{
-					sample *= leftGain;
-				}
-				else
-				{
-					sample *= rightGain;
-				}
-				if (absolutePosition > (endSample - 64))
-				{
-					float fadeGain = (static_cast<float>(endSample) - static_cast<float>(absolutePosition)) / 64.0f;
-					fadeGain = juce::jlimit(0.0f, 1.0f, fadeGain);
-					sample *= fadeGain;
-				}
-				mixOutput.addSample(ch, i, sample);
-				individualOutput.setSample(ch, i, sample);
+			for (int ch = 0; ch < section.sourceChannels; ++ch)
+			{
+				float* output = destination.getWritePointer(ch, startFrame + framesWritten);
+				PlaybackKernel::interpolate(quality, section.channelData[ch], section.sourceLength,
+					absolutePosition, ratio, output, segmentLength);
+				PlaybackKernel::applyEndFade(output, segmentLength, absolutePosition, ratio, section.endSample);
 			}
-			currentPosition += playbackRatio;
+
+			currentPosition += segmentLength * ratio;
+			framesWritten += segmentLength;
 		}
-		track.readPosition = currentPosition;
+		return true;
 	}
 
-	float interpolateLinear(const float* buffer, double position, int bufferSize) const
+	bool renderStretched(StreamingTimeStretch& stretcher, const PlaybackSection& section,
+		double& currentPosition, double tempo,
+		juce::AudioBuffer<float>& destination, int startFrame, int numFrames, int& framesWritten) const
 	{
-		int index = static_cast<int>(position);
-		if (index >= bufferSize - 1)
-			return buffer[bufferSize - 1];
+		if (stretcher.getSource() != section.channelData[0])
+		{
+			stretcher.reset();
+			stretcher.setSource(section.channelData[0]);
+		}
 
-		float fraction = static_cast<float>(position - index);
-		return buffer[index] + fraction * (buffer[index + 1] - buffer[index]);
+		// A restart or jump feeds from the new position but keeps playing
+		// what is still buffered, so the previous pass's tail is not cut.
+		const bool jumped = !stretcher.isRunning() || stretcher.getReportedPosition() != currentPosition;
+		if (jumped)
+			stretcher.startFeedingFrom(currentPosition);
+		stretcher.setTempo(tempo);
+
+		double feedPosition = stretcher.getFeedPosition();
+		auto& input = stretcher.getInputBuffer();
+		for (int chunk = 0; chunk < StreamingTimeStretch::maxChunksPerBlock &&
+			stretcher.getNumAvailable() < numFrames; ++chunk)
+		{
+			if (stretcher.isDraining())
+			{
+				stretcher.pushSilence();
+				continue;
+			}
+
+			int framesRead = 0;
+			input.clear();
+			const bool sourceLeft = readSection(section, feedPosition, 1.0, PlaybackKernel::InterpolationQuality::Linear,
+				input, 0, input.getNumSamples(), framesRead);
+			stretcher.pushInput(framesRead);
+			if (!sourceLeft)
+				stretcher.startDraining();
+		}
+		stretcher.setFeedPosition(feedPosition);
+
+		framesWritten = stretcher.pull(destination, startFrame, numFrames);
+		if (!stretcher.isRunning())
+			return false;
+
+		// Report what is heard, not what was fed: the stretcher latency
+		// would otherwise put the playhead and beat repeat ahead of the audio.
+		double heardPosition = feedPosition - stretcher.getBufferedSourceFrames();
+		if (section.beatRepeatLooping && feedPosition >= section.beatRepeatStart && heardPosition < section.beatRepeatStart)
+			heardPosition += section.beatRepeatEnd - section.beatRepeatStart;
+		if (stretcher.isDraining() && !jumped)
+			heardPosition = std::max(heardPosition, stretcher.getReportedPosition());
+		heardPosition = std::max(0.0, heardPosition);
+
+		stretcher.setReportedPosition(heardPosition);
+		currentPosition = heardPosition;
+		return true;
 	}
 };
\ No newline at end of file
@@ -0,0 +1,82 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <atomic>
+
+/*
+	Lock-free hand-off of UI work from the audio thread. The audio thread
+	only ORs bits in; the processor timer takes each word with a single
+	exchange, so any number of blocks between two ticks coalesce into one
+	update and nothing is posted to the message queue from processBlock.
+*/
+class UIUpdateFlags
+{
+public:
+	enum Flag : juce::uint32
+	{
+		general = 1u << 0,
+		midiActivity = 1u << 1,
+		loadingSample = 1u << 2,
+		// Some track recorded pendingStateNotifications.
+		trackState = 1u << 3
+	};
+
+	static constexpr int maxSlots = 64;
+
+	void raise(Flag flag) noexcept
+	{
+		flags.fetch_or(flag, std::memory_order_release);
+	}
+
+	void markSequencerDirty(int slot) noexcept
+	{
+		if (slot >= 0 && slot < maxSlots)
+			sequencerSlots.fetch_or(juce::uint64(1) << slot, std::memory_order_release);
+	}
+
+	void markAllSequencersDirty() noexcept
+	{
+		sequencerSlots.store(~juce::uint64(0), std::memory_order_release);
+	}
+
+	void markWaveformDirty(int slot) noexcept
+	{
+		if (slot >= 0 && slot < maxSlots)
+			waveformSlots.fetch_or(juce::uint64(1) << slot, std::memory_order_release);
+	}
+
+	void noteMidiTriggered(juce::uint64 slotMask, double hostBpm) noexcept
+	{
+		midiBpm.store(hostBpm, std::memory_order_relaxed);
+		midiSlots.fetch_or(slotMask, std::memory_order_release);
+		raise(midiActivity);
+	}
+
+	juce::uint32 takeFlags() noexcept { return flags.exchange(0, std::memory_order_acquire); }
+	juce::uint64 takeSequencerSlots() noexcept { return sequencerSlots.exchange(0, std::memory_order_acquire); }
+	juce::uint64 takeWaveformSlots() noexcept { return waveformSlots.exchange(0, std::memory_order_acquire); }
+
+	juce::uint64 takeMidiSlots(double& hostBpm) noexcept
+	{
+		hostBpm = midiBpm.load(std::memory_order_relaxed);
+		return midiSlots.exchange(0, std::memory_order_acquire);
+	}
+
+	static bool hasSlot(juce::uint64 mask, int slot) noexcept
+	{
+		return slot >= 0 && slot < maxSlots && (mask & (juce::uint64(1) << slot)) != 0;
+	}
+
+private:
+	std::atomic<juce::uint32> flags{ 0 };
+	std::atomic<juce::uint64> sequencerSlots{ 0 };
+	std::atomic<juce::uint64> waveformSlots{ 0 };
+	std::atomic<juce::uint64> midiSlots{ 0 };
+	std::atomic<double> midiBpm{ 126.0 };
+};
@@ -0,0 +1,60 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	A host transport for driving the processor without a host: constant
+	tempo and time signature, advanced by the caller after every block.
+	Used by the offline bounce and the processBlock benchmark.
+*/
+class VirtualPlayHead : public juce::AudioPlayHead
+{
+public:
+	void setTempo(double newBpm, int newNumerator, int newDenominator)
+	{
+		bpm = newBpm > 0.0 ? newBpm : 126.0;
+		numerator = juce::jmax(1, newNumerator);
+		denominator = juce::jmax(1, newDenominator);
+	}
+
+	/** Rewinds to sample 0. */
+	void reset(double newSampleRate, bool isPlaying)
+	{
+		sampleRate = newSampleRate;
+		playing = isPlaying;
+		samplePosition = 0;
+	}
+
+	void advance(int numSamples) { samplePosition += numSamples; }
+
+	juce::Optional<PositionInfo> getPosition() const override
+	{
+		PositionInfo info;
+		const double seconds = static_cast<double>(samplePosition) / sampleRate;
+		const double ppq = seconds * bpm / 60.0;
+		const double quarterNotesPerBar = numerator * 4.0 / denominator;
+
+		info.setIsPlaying(playing);
+		info.setBpm(bpm);
+		info.setTimeInSamples(samplePosition);
+		info.setTimeInSeconds(seconds);
+		info.setPpqPosition(ppq);
+		info.setPpqPositionOfLastBarStart(std::floor(ppq / quarterNotesPerBar) * quarterNotesPerBar);
+		info.setTimeSignature(juce::AudioPlayHead::TimeSignature{ numerator, denominator });
+		return info;
+	}
+
+private:
+	double sampleRate = 48000.0;
+	double bpm = 126.0;
+	int numerator = 4;
+	int denominator = 4;
+	bool playing = false;
+	juce::int64 samplePosition = 0;
+};
@@ -10,7 +10,10 @@
 #include "PluginProcessor.h"
 #include "TrackData.h"
 
-WaveformDisplay::WaveformDisplay(DjIaVstProcessor& processor, TrackData& trackData) : audioProcessor(processor), track(trackData)
+WaveformDisplay::WaveformDisplay(DjIaVstProcessor& processor, TrackData& trackData)
+	: audioBuffer(std::make_shared<juce::AudioBuffer<float>>()),
+	validityFlag(std::make_shared<std::atomic<bool>>(true)),
+	audioProcessor(processor), track(trackData)
 {
 	setSize(400, 80);
 
@@ -25,6 +28,7 @@ WaveformDisplay::WaveformDisplay(DjIaVstProcessor& processor, TrackData& trackDa
 
 WaveformDisplay::~WaveformDisplay()
 {
+	validityFlag->store(false);
 }
 
 void WaveformDisplay::setSampleBpm(float bpm)
@@ -46,7 +50,9 @@ void WaveformDisplay::setAudioData(const juce::AudioBuffer<float>& newAudioBuffe
 
 	if (newAudioBuffer.getNumChannels() == 0 || newAudioBuffer.getNumSamples() == 0) {
 		DBG("WaveformDisplay: Empty buffer received");
-		audioBuffer.setSize(0, 0);
+		audioBuffer = std::make_shared<juce::AudioBuffer<float>>();
+		pyramid.reset();
+		++pyramidGeneration;
 		sampleRate = newSampleRate;
 		thumbnail.clear();
 		repaint();
@@ -54,26 +60,28 @@ void WaveformDisplay::setAudioData(const juce::AudioBuffer<float>& newAudioBuffe
 	}
 
 	try {
-		audioBuffer.setSize(newAudioBuffer.getNumChannels(), newAudioBuffer.getNumSamples(), false, true, true);
-
-		for (int channel = 0; channel < newAudioBuffer.getNumChannels(); ++channel) {
-			audioBuffer.copyFrom(channel, 0, newAudioBuffer, channel, 0, newAudioBuffer.getNumSamples());
-		}
+		auto newBuffer = std::make_shared<juce::AudioBuffer<float>>();
+		newBuffer->makeCopyOf(newAudioBuffer);
+		audioBuffer = std::move(newBuffer);
+		pyramid.reset();
 
 		sampleRate = newSampleRate;
 		zoomFactor = 1.0;
 		viewStartTime = 0.0;
 
+		buildPyramidInBackground();
 		generateThumbnail();
 		repaint();
 
 		DBG("WaveformDisplay: Buffer set successfully - "
-			<< audioBuffer.getNumChannels() << " channels, "
-			<< audioBuffer.getNumSamples() << " samples");
+			<< audioBuffer->getNumChannels() << " channels, "
+			<< audioBuffer->getNumSamples() << " samples");
 	}
 	catch (const std::exception& e) {
 		DBG("WaveformDisplay: Exception during buffer set: " << e.what());
-		audioBuffer.setSize(0, 0);
+		audioBuffer = std::make_shared<juce::AudioBuffer<float>>();
+		pyramid.reset();
+		++pyramidGeneration;
 		sampleRate = newSampleRate;
 		thumbnail.clear();
 		repaint();
@@ -382,11 +390,35 @@ float WaveformDisplay::getHostBpm() const
 	return static_cast<float>(audioProcessor.getHostBpm());
 }
 
+void WaveformDisplay::buildPyramidInBackground()
+{
+	const int generation = ++pyramidGeneration;
+	auto source = audioBuffer;
+	auto validity = validityFlag;
+
+	juce::Thread::launch([this, source, generation, validity]()
+		{
+			std::shared_ptr<const WaveformPyramid> built = WaveformPyramid::build(*source, source->getNumSamples());
+			if (!built || !validity->load())
+				return;
+
+			juce::MessageManager::callAsync([this, built, generation, validity]()
+				{
+					if (!validity->load() || generation != pyramidGeneration)
+						return;
+
+					pyramid = built;
+					generateThumbnail();
+					repaint();
+				});
+		});
+}
+
 void WaveformDisplay::generateThumbnail()
 {
 	thumbnail.clear();
 
-	if (audioBuffer.getNumSamples() == 0)
+	if (audioBuffer->getNumSamples() == 0)
 		return;
 
 	double totalDuration = getTotalDuration();
@@ -395,8 +427,8 @@ void WaveformDisplay::generateThumbnail()
 
 	int startSample = (int)(viewStartTime * sampleRate);
 	int endSample = (int)(viewEndTime * sampleRate);
-	startSample = juce::jlimit(0, audioBuffer.getNumSamples() - 1, startSample);
-	endSample = juce::jlimit(startSample + 1, audioBuffer.getNumSamples(), endSample);
+	startSample = juce::jlimit(0, audioBuffer->getNumSamples() - 1, startSample);
+	endSample = juce::jlimit(startSample + 1, audioBuffer->getNumSamples(), endSample);
 
 	int viewSamples = endSample - startSample;
 
@@ -408,6 +440,17 @@ void WaveformDisplay::generateThumbnail()
 
 	int samplesPerPoint = juce::jmax(1, viewSamples / targetPoints);
 
+	if (pyramid && samplesPerPoint >= WaveformPyramid::baseBinSize)
+	{
+		pyramid->getBins(startSample, startSample + samplesPerPoint * targetPoints, targetPoints, pyramidBins);
+		thumbnail.reserve(pyramidBins.size());
+		for (const auto& bin : pyramidBins)
+		{
+			thumbnail.push_back((bin.getRms() * 0.7f) + (bin.getPeak() * 0.3f));
+		}
+		return;
+	}
+
 	for (int point = 0; point < targetPoints; ++point)
 	{
 		int retFlag;
@@ -421,8 +464,9 @@ void WaveformDisplay::feedThumbnail(int startSample, int point, int samplesPerPo
 {
 	retFlag = 1;
 	int sampleStart = startSample + (point * samplesPerPoint);
-	int sampleEnd = std::min(sampleStart + samplesPerPoint, audioBuffer.getNumSamples());
-	if (sampleStart >= audioBuffer.getNumSamples())
+	const int totalSamples = audioBuffer->getNumSamples();
+	int sampleEnd = std::min(sampleStart + samplesPerPoint, totalSamples);
+	if (sampleStart >= totalSamples)
 	{
 		{
 			retFlag = 2;
@@ -433,16 +477,12 @@ void WaveformDisplay::feedThumbnail(int startSample, int point, int samplesPerPo
 	float peak = 0.0f;
 	int count = 0;
 
-	for (int sample = sampleStart; sample < sampleEnd; ++sample)
+	for (int ch = 0; ch < audioBuffer->getNumChannels(); ++ch)
 	{
-
-		if (sample >= audioBuffer.getNumSamples())
-		{
-			break;
-		}
-		for (int ch = 0; ch < audioBuffer.getNumChannels(); ++ch)
+		const float* data = audioBuffer->getReadPointer(ch);
+		for (int sample = sampleStart; sample < sampleEnd; ++sample)
 		{
-			float val = audioBuffer.getSample(ch, sample);
+			float val = data[sample];
 			rmsSum += val * val;
 			peak = std::max(peak, std::abs(val));
 			count++;
@@ -913,10 +953,10 @@ double WaveformDisplay::xToTime(float x)
 
 double WaveformDisplay::getTotalDuration() const
 {
-	if (audioBuffer.getNumSamples() == 0 || sampleRate <= 0)
+	if (audioBuffer->getNumSamples() == 0 || sampleRate <= 0)
 		return 0.0;
 
-	return audioBuffer.getNumSamples() / sampleRate;
+	return audioBuffer->getNumSamples() / sampleRate;
 }
 
 double WaveformDisplay::getViewStartTime() const
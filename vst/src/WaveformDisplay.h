@@ -7,6 +7,9 @@
 
 #pragma once
 #include "JuceHeader.h"
+#include "WaveformPyramid.h"
+#include <atomic>
+#include <memory>
 
 class DjIaVstProcessor;
 struct TrackData;
@@ -28,7 +31,11 @@ public:
 	void setAudioFile(const juce::File &file);
 
 private:
-	juce::AudioBuffer<float> audioBuffer;
+	std::shared_ptr<juce::AudioBuffer<float>> audioBuffer;
+	std::shared_ptr<const WaveformPyramid> pyramid;
+	std::shared_ptr<std::atomic<bool>> validityFlag;
+	std::vector<WaveformPyramid::Bin> pyramidBins;
+	int pyramidGeneration = 0;
 	juce::File currentAudioFile;
 	juce::Point<int> dragStartPosition;
 	std::unique_ptr<juce::ScrollBar> horizontalScrollBar;
@@ -61,6 +68,7 @@ private:
 	float timeToX(double time);
 
 	void generateThumbnail();
+	void buildPyramidInBackground();
 	void feedThumbnail(int startSample, int point, int samplesPerPoint, int &retFlag);
 	void drawWaveform(juce::Graphics &g);
 	void setColorDependingTimeStretchRatio(juce::Colour &waveformColor) const;
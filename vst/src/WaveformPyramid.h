@@ -0,0 +1,183 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2025 Anthony Charretier
+ */
+
+#pragma once
+#include "JuceHeader.h"
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/*
+	Mipmapped min/max/RMS summary of a buffer. Level 0 holds one bin per
+	baseBinSize samples and every level above halves the bin count, so a
+	view of any zoom reads a handful of bins per pixel instead of every
+	sample. Built once off the message thread and shared read-only.
+*/
+class WaveformPyramid
+{
+public:
+	static constexpr int baseBinSize = 64;
+	static constexpr juce::uint32 fileMagic = 0x5059524f; // "ORYP"
+
+	struct Bin
+	{
+		float minValue = 0.0f;
+		float maxValue = 0.0f;
+		float meanSquare = 0.0f;
+
+		float getPeak() const { return std::max(std::abs(minValue), std::abs(maxValue)); }
+		float getRms() const { return std::sqrt(meanSquare); }
+	};
+
+	static std::shared_ptr<WaveformPyramid> build(const juce::AudioBuffer<float>& buffer, int numSamples)
+	{
+		numSamples = juce::jlimit(0, buffer.getNumSamples(), numSamples);
+		const int numChannels = buffer.getNumChannels();
+		if (numSamples == 0 || numChannels == 0)
+			return nullptr;
+
+		auto pyramid = std::make_shared<WaveformPyramid>();
+		pyramid->numSamples = numSamples;
+
+		auto& base = pyramid->levels.emplace_back();
+		base.resize(static_cast<size_t>((numSamples + baseBinSize - 1) / baseBinSize));
+		for (size_t index = 0; index < base.size(); ++index)
+		{
+			const int start = static_cast<int>(index) * baseBinSize;
+			const int count = std::min(baseBinSize, numSamples - start);
+
+			Bin bin;
+			bin.minValue = std::numeric_limits<float>::max();
+			bin.maxValue = std::numeric_limits<float>::lowest();
+			float sumSquares = 0.0f;
+			for (int channel = 0; channel < numChannels; ++channel)
+			{
+				const float* data = buffer.getReadPointer(channel, start);
+				auto range = juce::FloatVectorOperations::findMinAndMax(data, count);
+				bin.minValue = std::min(bin.minValue, range.getStart());
+				bin.maxValue = std::max(bin.maxValue, range.getEnd());
+				for (int i = 0; i < count; ++i)
+					sumSquares += data[i] * data[i];
+			}
+			bin.meanSquare = sumSquares / static_cast<float>(count * numChannels);
+			base[index] = bin;
+		}
+
+		pyramid->buildUpperLevels();
+		return pyramid;
+	}
+
+	static std::shared_ptr<WaveformPyramid> readFrom(juce::InputStream& stream)
+	{
+		if (static_cast<juce::uint32>(stream.readInt()) != fileMagic)
+			return nullptr;
+
+		auto pyramid = std::make_shared<WaveformPyramid>();
+		pyramid->numSamples = stream.readInt();
+		const int numBins = stream.readInt();
+		if (pyramid->numSamples <= 0
+			|| static_cast<juce::int64>(numBins) != (static_cast<juce::int64>(pyramid->numSamples) + baseBinSize - 1) / baseBinSize)
+			return nullptr;
+
+		// The counts come from the file, so a truncated or corrupt cache must
+		// not size the allocation: the bins have to actually be there.
+		const juce::int64 bytes = static_cast<juce::int64>(numBins) * static_cast<juce::int64>(sizeof(Bin));
+		if (bytes > std::numeric_limits<int>::max() || stream.getNumBytesRemaining() < bytes)
+			return nullptr;
+
+		auto& base = pyramid->levels.emplace_back(static_cast<size_t>(numBins));
+		if (stream.read(base.data(), static_cast<int>(bytes)) != static_cast<int>(bytes))
+			return nullptr;
+
+		pyramid->buildUpperLevels();
+		return pyramid;
+	}
+
+	bool writeTo(juce::OutputStream& stream) const
+	{
+		if (levels.empty())
+			return false;
+
+		const auto& base = levels.front();
+		stream.writeInt(static_cast<int>(fileMagic));
+		stream.writeInt(numSamples);
+		stream.writeInt(static_cast<int>(base.size()));
+		return stream.write(base.data(), base.size() * sizeof(Bin));
+	}
+
+	int getNumSamples() const { return numSamples; }
+
+	/** Summarises [startSample, endSample) into at most numPoints bins of equal width. */
+	void getBins(int startSample, int endSample, int numPoints, std::vector<Bin>& result) const
+	{
+		result.clear();
+		startSample = juce::jlimit(0, numSamples, startSample);
+		endSample = juce::jlimit(startSample, numSamples, endSample);
+		if (levels.empty() || numPoints <= 0 || endSample <= startSample)
+			return;
+
+		const int samplesPerPoint = juce::jmax(1, (endSample - startSample) / numPoints);
+		int level = 0;
+		while (level + 1 < static_cast<int>(levels.size()) && (baseBinSize << (level + 1)) <= samplesPerPoint)
+			++level;
+
+		const auto& bins = levels[static_cast<size_t>(level)];
+		const int binSize = baseBinSize << level;
+		result.reserve(static_cast<size_t>(numPoints));
+
+		for (int point = 0; point < numPoints; ++point)
+		{
+			const int pointStart = startSample + point * samplesPerPoint;
+			if (pointStart >= numSamples)
+				break;
+			const int pointEnd = std::min(pointStart + samplesPerPoint, numSamples);
+
+			const int firstBin = pointStart / binSize;
+			const int lastBin = std::min(static_cast<int>(bins.size()) - 1, (pointEnd - 1) / binSize);
+			Bin merged = bins[static_cast<size_t>(firstBin)];
+			float sumMeanSquares = merged.meanSquare;
+			for (int index = firstBin + 1; index <= lastBin; ++index)
+			{
+				const auto& bin = bins[static_cast<size_t>(index)];
+				merged.minValue = std::min(merged.minValue, bin.minValue);
+				merged.maxValue = std::max(merged.maxValue, bin.maxValue);
+				sumMeanSquares += bin.meanSquare;
+			}
+			merged.meanSquare = sumMeanSquares / static_cast<float>(lastBin - firstBin + 1);
+			result.push_back(merged);
+		}
+	}
+
+private:
+	int numSamples = 0;
+	std::vector<std::vector<Bin>> levels;
+
+	static Bin merge(const Bin& a, const Bin& b)
+	{
+		Bin bin;
+		bin.minValue = std::min(a.minValue, b.minValue);
+		bin.maxValue = std::max(a.maxValue, b.maxValue);
+		bin.meanSquare = 0.5f * (a.meanSquare + b.meanSquare);
+		return bin;
+	}
+
+	void buildUpperLevels()
+	{
+		while (levels.back().size() > 1)
+		{
+			const auto& lower = levels.back();
+			std::vector<Bin> upper((lower.size() + 1) / 2);
+			for (size_t index = 0; index < upper.size(); ++index)
+			{
+				const size_t left = index * 2;
+				upper[index] = left + 1 < lower.size() ? merge(lower[left], lower[left + 1]) : lower[left];
+			}
+			levels.push_back(std::move(upper));
+		}
+	}
+};